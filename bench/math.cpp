@@ -0,0 +1,411 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/* *
+ * Headless math microbenchmarks. Prints one JSON document with ns/op and
+ * ops/s for every benchmark, kernel set and data size. Options:
+ *
+ *   --baseline FILE   Compare against a previous run and exit with 1 if
+ *                     anything got slower by more than the tolerance
+ *   --tolerance PCT   Allowed slowdown against the baseline; default 15
+ *   --save FILE       Also write the results to FILE, e.g. a new baseline
+ *   --quick           Shorter runs, for smoke testing
+ *
+ * Needs no window or GL context, so it runs on build machines.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bakge/Bakge.h>
+
+#define MAX_SIZE 16384
+#define MAX_RESULTS 256
+#define NAME_LENGTH 64
+
+/* Keeps benchmarked results alive so the loops aren't optimized out */
+volatile bakge::Scalar Sink;
+
+bakge::Matrix* Matrices;
+bakge::Matrix* MatrixOut;
+bakge::Vector4* Vectors;
+bakge::Scalar* StreamA;
+bakge::Scalar* StreamB;
+bakge::Scalar* StreamOut;
+bakge::uint32* Bits;
+bakge::Frustum View;
+
+struct BenchResult
+{
+    char Name[NAME_LENGTH];
+    int Size;
+    double NsPerOp;
+};
+
+BenchResult Results[MAX_RESULTS];
+int NumResults = 0;
+bakge::Microseconds MinTime = 20000;
+
+typedef void (*BenchFunc)(int Count);
+
+
+void BenchMatrixMultiply(int Count)
+{
+    bakge::Matrix M = Matrices[0];
+
+    for(int i = 0; i < Count; ++i)
+        M = M * Matrices[i];
+
+    Sink = M[0];
+}
+
+
+void BenchMultiplyMatrices(int Count)
+{
+    bakge::MultiplyMatrices(Matrices, Matrices[0], MatrixOut, Count);
+}
+
+
+void BenchMultiplyMatricesSoA(int Count)
+{
+    bakge::MultiplyMatricesSoA(StreamA, Matrices[0], StreamOut, Count);
+}
+
+
+void BenchTransformVectors(int Count)
+{
+    bakge::TransformVectors(Matrices[0], Vectors, Vectors, Count);
+}
+
+
+void BenchTransformPointsSoA(int Count)
+{
+    bakge::TransformPointsSoA(Matrices[0], StreamA, StreamA + Count,
+                                            StreamA + Count * 2, Count);
+}
+
+
+void BenchNormalizeVectors(int Count)
+{
+    bakge::NormalizeVectors(Vectors, Count);
+}
+
+
+void BenchQuaternionMultiply(int Count)
+{
+    /* Unit length, or R would shrink into denormals and then to zero */
+    bakge::Quaternion Q = bakge::Quaternion(0.1f, 0.2f, 0.3f,
+                                                0.9f).Normalized();
+    bakge::Quaternion R = Q;
+
+    for(int i = 0; i < Count; ++i)
+        R = R * Q;
+
+    Sink = R.Length();
+}
+
+
+void BenchMultiplyQuaternionsSoA(int Count)
+{
+    bakge::MultiplyQuaternionsSoA(StreamA, StreamB, StreamOut, Count);
+}
+
+
+void BenchSlerpQuaternionsSoA(int Count)
+{
+    /* StreamB past its four quaternion streams doubles as the factors */
+    bakge::SlerpQuaternionsSoA(StreamA, StreamB, StreamB + Count * 4,
+                                                    StreamOut, Count);
+}
+
+
+void BenchQuaternionsToMatricesSoA(int Count)
+{
+    bakge::QuaternionsToMatricesSoA(StreamA, MatrixOut, Count);
+}
+
+
+void BenchCullSpheresSoA(int Count)
+{
+    bakge::CullSpheresSoA(View, StreamA, Count, Bits);
+}
+
+
+void BenchCullBoxesSoA(int Count)
+{
+    bakge::CullBoxesSoA(View, StreamA, Count, Bits);
+}
+
+
+void BenchIntersectRaysBoxesSoA(int Count)
+{
+    bakge::IntersectRaysBoxesSoA(StreamB, StreamA, Count, Bits);
+}
+
+
+struct Benchmark
+{
+    const char* Name;
+    BenchFunc Func;
+    bool FastPrecision;
+};
+
+Benchmark Benchmarks[] = {
+    { "Matrix::operator*", BenchMatrixMultiply, false },
+    { "MultiplyMatrices", BenchMultiplyMatrices, false },
+    { "MultiplyMatricesSoA", BenchMultiplyMatricesSoA, false },
+    { "TransformVectors", BenchTransformVectors, false },
+    { "TransformPointsSoA", BenchTransformPointsSoA, false },
+    { "NormalizeVectors", BenchNormalizeVectors, false },
+    { "NormalizeVectorsFast", BenchNormalizeVectors, true },
+    { "Quaternion::operator*", BenchQuaternionMultiply, false },
+    { "MultiplyQuaternionsSoA", BenchMultiplyQuaternionsSoA, false },
+    { "SlerpQuaternionsSoA", BenchSlerpQuaternionsSoA, false },
+    { "QuaternionsToMatricesSoA", BenchQuaternionsToMatricesSoA, false },
+    { "CullSpheresSoA", BenchCullSpheresSoA, false },
+    { "CullBoxesSoA", BenchCullBoxesSoA, false },
+    { "IntersectRaysBoxesSoA", BenchIntersectRaysBoxesSoA, false },
+};
+
+int Sizes[] = { 64, 1024, MAX_SIZE };
+
+#define NUM_BENCHMARKS (int)(sizeof(Benchmarks) / sizeof(Benchmarks[0]))
+#define NUM_SIZES (int)(sizeof(Sizes) / sizeof(Sizes[0]))
+
+
+/* Fill every buffer with well behaved data: unit quaternions and vectors */
+void FillData()
+{
+    srand(1234);
+
+    for(int i = 0; i < MAX_SIZE; ++i) {
+        Matrices[i] = bakge::Matrix::Rotation((bakge::Radians)i * 0.01f,
+                                            0.2f, 0.3f)
+                        * bakge::Matrix::Translation(1, 2, 3);
+        Vectors[i] = bakge::Vector4((bakge::Scalar)(rand() % 100 + 1),
+                        (bakge::Scalar)(rand() % 100), 1, 0);
+    }
+
+    for(int i = 0; i < MAX_SIZE * 16; ++i) {
+        StreamA[i] = (bakge::Scalar)(rand() % 200 - 100) / 100 + 1.5f;
+        StreamB[i] = (bakge::Scalar)(rand() % 200 - 100) / 100 - 1.5f;
+    }
+
+    bakge::NormalizeQuaternionsSoA(StreamA, MAX_SIZE);
+    bakge::NormalizeQuaternionsSoA(StreamB, MAX_SIZE);
+
+    bakge::Matrix Proj, Look;
+    Proj.SetPerspective(60.0f, 1.5f, 1.0f, 100.0f);
+    Look.SetLookAt(bakge::Vector4::Point(0, 0, 3),
+                    bakge::Vector4::Point(0, 0, 0),
+                    bakge::Vector4::Vector(0, 1, 0));
+    View = bakge::Frustum::FromMatrix(Look * Proj);
+}
+
+
+/* Best of three runs, each at least MinTime long */
+double Measure(BenchFunc Func, int Count)
+{
+    double Best = 0;
+
+    for(int Run = 0; Run < 3; ++Run) {
+        int Reps = 0;
+        bakge::Microseconds Start = bakge::GetRunningTime();
+        bakge::Microseconds Elapsed;
+
+        do {
+            Func(Count);
+            ++Reps;
+            Elapsed = bakge::GetRunningTime() - Start;
+        } while(Elapsed < MinTime);
+
+        double Ns = (double)Elapsed * 1000.0 / ((double)Reps * Count);
+        if(Run == 0 || Ns < Best)
+            Best = Ns;
+    }
+
+    /* In place benchmarks drift their data; start each from the same */
+    FillData();
+
+    return Best;
+}
+
+
+void WriteResults(FILE* Out)
+{
+    fprintf(Out, "{\n  \"best_isa\": \"%s\",\n  \"results\": [\n",
+            bakge::GetMathISAName(bakge::GetBestMathISA()));
+
+    for(int i = 0; i < NumResults; ++i) {
+        fprintf(Out, "    { \"name\": \"%s\", \"size\": %d, "
+                "\"ns_per_op\": %.4f, \"ops_per_sec\": %.0f }%s\n",
+                Results[i].Name, Results[i].Size, Results[i].NsPerOp,
+                1e9 / Results[i].NsPerOp, i + 1 < NumResults ? "," : "");
+    }
+
+    fprintf(Out, "  ]\n}\n");
+}
+
+
+/* *
+ * Only reads files written by WriteResults, so a full JSON parser isn't
+ * needed: scan for each result's fields in order
+ * */
+int Compare(const char* Path, double Tolerance)
+{
+    FILE* In = fopen(Path, "rb");
+    if(In == NULL) {
+        fprintf(stderr, "bench_math: Couldn't open baseline %s\n", Path);
+        return 1;
+    }
+
+    fseek(In, 0, SEEK_END);
+    long Length = ftell(In);
+    fseek(In, 0, SEEK_SET);
+
+    char* Text = new char[Length + 1];
+    Text[fread(Text, 1, Length, In)] = '\0';
+    fclose(In);
+
+    int Regressions = 0, Compared = 0;
+    const char* At = Text;
+
+    while((At = strstr(At, "\"name\": \"")) != NULL) {
+        char Name[NAME_LENGTH];
+        int Size;
+        double Ns;
+
+        At += 9;
+        if(sscanf(At, "%63[^\"]\", \"size\": %d, \"ns_per_op\": %lf",
+                                                Name, &Size, &Ns) != 3)
+            continue;
+
+        for(int i = 0; i < NumResults; ++i) {
+            if(strcmp(Results[i].Name, Name) != 0 || Results[i].Size != Size)
+                continue;
+
+            ++Compared;
+            double Change = (Results[i].NsPerOp - Ns) / Ns * 100;
+            if(Change > Tolerance) {
+                fprintf(stderr, "bench_math: %s (%d) regressed %.1f%%: "
+                        "%.3f ns/op, baseline %.3f\n", Name, Size, Change,
+                                                Results[i].NsPerOp, Ns);
+                ++Regressions;
+            }
+        }
+    }
+
+    delete[] Text;
+
+    fprintf(stderr, "bench_math: %d of %d results within %.0f%% of %s\n",
+                    Compared - Regressions, Compared, Tolerance, Path);
+
+    return Regressions > 0 ? 1 : 0;
+}
+
+
+int main(int argc, char* argv[])
+{
+    const char* Baseline = NULL;
+    const char* SavePath = NULL;
+    double Tolerance = 15;
+
+    for(int i = 1; i < argc; ++i) {
+        if(strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            Baseline = argv[++i];
+        } else if(strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            SavePath = argv[++i];
+        } else if(strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            Tolerance = atof(argv[++i]);
+        } else if(strcmp(argv[i], "--quick") == 0) {
+            MinTime = 2000;
+        } else {
+            fprintf(stderr, "Usage: %s [--baseline FILE] [--tolerance PCT]"
+                                " [--save FILE] [--quick]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    Matrices = new bakge::Matrix[MAX_SIZE];
+    MatrixOut = new bakge::Matrix[MAX_SIZE];
+    Vectors = new bakge::Vector4[MAX_SIZE];
+    StreamA = new bakge::Scalar[MAX_SIZE * 16];
+    StreamB = new bakge::Scalar[MAX_SIZE * 16];
+    StreamOut = new bakge::Scalar[MAX_SIZE * 16];
+    Bits = new bakge::uint32[MAX_SIZE / 32];
+
+    FillData();
+
+    for(int i = 0; i < bakge::NUM_MATH_ISAS; ++i) {
+        bakge::MATH_ISA ISA = (bakge::MATH_ISA)i;
+
+        if(!bakge::IsMathISASupported(ISA))
+            continue;
+
+        bakge::SetMathISA(ISA);
+
+        for(int b = 0; b < NUM_BENCHMARKS; ++b) {
+            bakge::SetMathPrecision(Benchmarks[b].FastPrecision
+                                    ? bakge::MATH_PRECISION_FAST
+                                    : bakge::MATH_PRECISION_EXACT);
+
+            for(int s = 0; s < NUM_SIZES && NumResults < MAX_RESULTS; ++s) {
+                BenchResult* R = &Results[NumResults++];
+
+                sprintf(R->Name, "%s/%s", Benchmarks[b].Name,
+                                    bakge::GetMathISAName(ISA));
+                R->Size = Sizes[s];
+                R->NsPerOp = Measure(Benchmarks[b].Func, Sizes[s]);
+            }
+        }
+    }
+
+    bakge::SetMathPrecision(bakge::MATH_PRECISION_EXACT);
+
+    WriteResults(stdout);
+
+    if(SavePath != NULL) {
+        FILE* Out = fopen(SavePath, "wb");
+        if(Out == NULL) {
+            fprintf(stderr, "bench_math: Couldn't write %s\n", SavePath);
+        } else {
+            WriteResults(Out);
+            fclose(Out);
+        }
+    }
+
+    int Status = 0;
+    if(Baseline != NULL)
+        Status = Compare(Baseline, Tolerance);
+
+    delete[] Matrices;
+    delete[] MatrixOut;
+    delete[] Vectors;
+    delete[] StreamA;
+    delete[] StreamB;
+    delete[] StreamOut;
+    delete[] Bits;
+
+    return Status;
+}
@@ -1,107 +1,73 @@
-# Check if SSE instructions are available on the machine where
-# the project is compiled.
+# Check which SIMD instruction sets the compiler can generate code for.
+#
+# This deliberately says nothing about the machine doing the build: Bakge
+# compiles its hot math kernels once per instruction set and picks the best
+# one the running CPU supports when bakge::Init is called. Only SSE2 is
+# required by the rest of the engine when BGE_USE_SIMD is defined.
+#
+# Sets SSE2_FOUND, SSE4_1_FOUND and AVX2_FOUND, along with SSE2_FLAGS,
+# SSE4_1_FLAGS and AVX2_FLAGS holding the compiler flags to enable each.
 
-IF(CMAKE_SYSTEM_NAME MATCHES "Linux")
-   EXEC_PROGRAM(cat ARGS "/proc/cpuinfo" OUTPUT_VARIABLE CPUINFO)
+include(CheckCXXSourceCompiles)
 
-   STRING(REGEX REPLACE "^.*(sse2).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "sse2" "${SSE_THERE}" SSE2_TRUE)
-   IF (SSE2_TRUE)
-      set(SSE2_FOUND true CACHE BOOL "SSE2 available on host")
-   ELSE (SSE2_TRUE)
-      set(SSE2_FOUND false CACHE BOOL "SSE2 available on host")
-   ENDIF (SSE2_TRUE)
+if(MSVC)
+  # SSE2 is implied on x64, and MSVC emits SSE4.1 intrinsics without flags
+  if(CMAKE_SIZEOF_VOID_P EQUAL 4)
+    set(SSE2_FLAGS "/arch:SSE2")
+  else()
+    set(SSE2_FLAGS "")
+  endif()
+  set(SSE4_1_FLAGS "")
+  set(AVX2_FLAGS "/arch:AVX2")
+else()
+  set(SSE2_FLAGS "-msse -msse2")
+  set(SSE4_1_FLAGS "-msse4.1")
+  set(AVX2_FLAGS "-mavx2 -mfma")
+endif()
 
-   # /proc/cpuinfo apparently omits sse3 :(
-   STRING(REGEX REPLACE "^.*[^s](sse3).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "sse3" "${SSE_THERE}" SSE3_TRUE)
-   IF (NOT SSE3_TRUE)
-      STRING(REGEX REPLACE "^.*(T2300).*$" "\\1" SSE_THERE ${CPUINFO})
-      STRING(COMPARE EQUAL "T2300" "${SSE_THERE}" SSE3_TRUE)
-   ENDIF (NOT SSE3_TRUE)
+set(CMAKE_REQUIRED_FLAGS "${SSE2_FLAGS}")
+check_cxx_source_compiles("
+#include <emmintrin.h>
+int main()
+{
+    __m128 A = _mm_setzero_ps();
+    __m128i B = _mm_castps_si128(A);
+    return _mm_cvtsi128_si32(B);
+}" SSE2_FOUND)
 
-   STRING(REGEX REPLACE "^.*(ssse3).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "ssse3" "${SSE_THERE}" SSSE3_TRUE)
-   IF (SSE3_TRUE OR SSSE3_TRUE)
-      set(SSE3_FOUND true CACHE BOOL "SSE3 available on host")
-   ELSE (SSE3_TRUE OR SSSE3_TRUE)
-      set(SSE3_FOUND false CACHE BOOL "SSE3 available on host")
-   ENDIF (SSE3_TRUE OR SSSE3_TRUE)
-   IF (SSSE3_TRUE)
-      set(SSSE3_FOUND true CACHE BOOL "SSSE3 available on host")
-   ELSE (SSSE3_TRUE)
-      set(SSSE3_FOUND false CACHE BOOL "SSSE3 available on host")
-   ENDIF (SSSE3_TRUE)
+set(CMAKE_REQUIRED_FLAGS "${SSE4_1_FLAGS}")
+check_cxx_source_compiles("
+#include <smmintrin.h>
+int main()
+{
+    __m128 A = _mm_setzero_ps();
+    return (int)_mm_cvtss_f32(_mm_dp_ps(A, A, 0xFF));
+}" SSE4_1_FOUND)
 
-   STRING(REGEX REPLACE "^.*(sse4_1).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "sse4_1" "${SSE_THERE}" SSE41_TRUE)
-   IF (SSE41_TRUE)
-      set(SSE4_1_FOUND true CACHE BOOL "SSE4.1 available on host")
-   ELSE (SSE41_TRUE)
-      set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
-   ENDIF (SSE41_TRUE)
-ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Darwin")
-   EXEC_PROGRAM("/usr/sbin/sysctl -n machdep.cpu.features" OUTPUT_VARIABLE
-      CPUINFO)
+set(CMAKE_REQUIRED_FLAGS "${AVX2_FLAGS}")
+check_cxx_source_compiles("
+#include <immintrin.h>
+int main()
+{
+    __m256 A = _mm256_setzero_ps();
+    A = _mm256_fmadd_ps(A, A, A);
+    __m256i B = _mm256_add_epi32(_mm256_castps_si256(A),
+                                    _mm256_castps_si256(A));
+    return _mm256_extract_epi32(B, 0);
+}" AVX2_FOUND)
 
-   STRING(REGEX REPLACE "^.*[^S](SSE2).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "SSE2" "${SSE_THERE}" SSE2_TRUE)
-   IF (SSE2_TRUE)
-      set(SSE2_FOUND true CACHE BOOL "SSE2 available on host")
-   ELSE (SSE2_TRUE)
-      set(SSE2_FOUND false CACHE BOOL "SSE2 available on host")
-   ENDIF (SSE2_TRUE)
-
-   STRING(REGEX REPLACE "^.*[^S](SSE3).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "SSE3" "${SSE_THERE}" SSE3_TRUE)
-   IF (SSE3_TRUE)
-      set(SSE3_FOUND true CACHE BOOL "SSE3 available on host")
-   ELSE (SSE3_TRUE)
-      set(SSE3_FOUND false CACHE BOOL "SSE3 available on host")
-   ENDIF (SSE3_TRUE)
-
-   STRING(REGEX REPLACE "^.*(SSSE3).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "SSSE3" "${SSE_THERE}" SSSE3_TRUE)
-   IF (SSSE3_TRUE)
-      set(SSSE3_FOUND true CACHE BOOL "SSSE3 available on host")
-   ELSE (SSSE3_TRUE)
-      set(SSSE3_FOUND false CACHE BOOL "SSSE3 available on host")
-   ENDIF (SSSE3_TRUE)
-
-   STRING(REGEX REPLACE "^.*(SSE4.1).*$" "\\1" SSE_THERE ${CPUINFO})
-   STRING(COMPARE EQUAL "SSE4.1" "${SSE_THERE}" SSE41_TRUE)
-   IF (SSE41_TRUE)
-      set(SSE4_1_FOUND true CACHE BOOL "SSE4.1 available on host")
-   ELSE (SSE41_TRUE)
-      set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
-   ENDIF (SSE41_TRUE)
-ELSEIF(CMAKE_SYSTEM_NAME MATCHES "Windows")
-   # TODO
-   set(SSE2_FOUND   true  CACHE BOOL "SSE2 available on host")
-   set(SSE3_FOUND   false CACHE BOOL "SSE3 available on host")
-   set(SSSE3_FOUND  false CACHE BOOL "SSSE3 available on host")
-   set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
-ELSE(CMAKE_SYSTEM_NAME MATCHES "Linux")
-   set(SSE2_FOUND   true  CACHE BOOL "SSE2 available on host")
-   set(SSE3_FOUND   false CACHE BOOL "SSE3 available on host")
-   set(SSSE3_FOUND  false CACHE BOOL "SSSE3 available on host")
-   set(SSE4_1_FOUND false CACHE BOOL "SSE4.1 available on host")
-ENDIF(CMAKE_SYSTEM_NAME MATCHES "Linux")
+set(CMAKE_REQUIRED_FLAGS)
 
 if(SSE2_FOUND)
-      MESSAGE(STATUS "Found hardware support for SSE2 on this machine.")
+  message(STATUS "Compiler supports SSE2")
 endif(SSE2_FOUND)
 
-if(SSE3_FOUND)
-      MESSAGE(STATUS "Found hardware support for SSE3 on this machine.")
-endif(SSE3_FOUND)
-
-if(SSSE3_FOUND)
-      MESSAGE(STATUS "Found hardware support for SSSE3 on this machine.")
-endif(SSSE3_FOUND)
-
 if(SSE4_1_FOUND)
-      MESSAGE(STATUS "Found hardware support for SSE4.1 on this machine.")
+  message(STATUS "Compiler supports SSE4.1")
 endif(SSE4_1_FOUND)
 
-mark_as_advanced(SSE2_FOUND SSE3_FOUND SSSE3_FOUND SSE4_1_FOUND)
\ No newline at end of file
+if(AVX2_FOUND)
+  message(STATUS "Compiler supports AVX2 and FMA")
+endif(AVX2_FOUND)
+
+mark_as_advanced(SSE2_FOUND SSE4_1_FOUND AVX2_FOUND)
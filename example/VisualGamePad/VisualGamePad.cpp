@@ -28,7 +28,8 @@ const char* VertexShader =
     "\n"
     "void main()\n"
     "{\n"
-    "    vec4 VertexPosition = bge_View * bge_Model * bge_Vertex;\n"
+    "    vec4 VertexPosition = bge_View * vec4(bge_Vertex * bge_Model,\n"
+    "                                                bge_Vertex.w);\n"
     "    gl_Position = bge_Projection * VertexPosition;\n"
     "}\n"
     "\n";
@@ -205,23 +205,41 @@ namespace bakge
 
 /* Math modules */
 #include <bakge/math/Math.h>
+#include <bakge/math/Dispatch.h>
+#include <bakge/math/FastMath.h>
 #include <bakge/math/Vector3.h>
 #include <bakge/math/Vector4.h>
 #include <bakge/math/Matrix.h>
 #include <bakge/math/Quaternion.h>
+#include <bakge/math/Affine.h>
+#include <bakge/math/Plane.h>
+#include <bakge/math/AABB.h>
+#include <bakge/math/Sphere.h>
+#include <bakge/math/Ray.h>
+#include <bakge/math/Frustum.h>
+#include <bakge/math/Batch.h>
 
 /* Additional Bakge classes */
 #include <bakge/graphics/Shader.h>
+#include <bakge/graphics/ShaderHandle.h>
+#include <bakge/graphics/ShaderVariants.h>
+#include <bakge/graphics/FrameUniforms.h>
+#include <bakge/graphics/InstanceBuffer.h>
 #include <bakge/graphics/Mesh.h>
 #include <bakge/graphics/Node.h>
 #include <bakge/graphics/Pawn.h>
 #include <bakge/graphics/Crowd.h>
+#include <bakge/graphics/SceneGraph.h>
+#include <bakge/graphics/AABBTree.h>
+#include <bakge/graphics/OcclusionCuller.h>
 #include <bakge/graphics/shapes/Cube.h>
 #include <bakge/graphics/shapes/Rectangle.h>
 #include <bakge/graphics/Texture.h>
 #include <bakge/graphics/Font.h>
 #include <bakge/graphics/Camera2D.h>
 #include <bakge/graphics/Camera3D.h>
+#include <bakge/core/CommandList.h>
+#include <bakge/core/Renderer.h>
 #include <bakge/ui/Anchor.h>
 #include <bakge/ui/Frame.h>
 #include <bakge/ui/Hoverable.h>
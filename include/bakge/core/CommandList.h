@@ -0,0 +1,322 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file CommandList.h
+ * @brief CommandList class declaration.
+ */
+
+#ifndef BAKGE_CORE_COMMANDLIST_H
+#define BAKGE_CORE_COMMANDLIST_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Recorded sequence of rendering commands.
+ *
+ * A CommandList records binds, uniform data and draws as compact binary
+ * commands without touching OpenGL, so any thread can build one. The
+ * thread owning the OpenGL context then replays lists with Execute, which
+ * is a tight loop over the recorded commands. Scene traversal, culling
+ * and packing of uniform data can so happen on worker threads while the
+ * context thread only submits.
+ *
+ * A list must only be recorded by one thread at a time; give each worker
+ * its own list and execute them in the desired order once the workers are
+ * done. Objects referenced by commands must stay alive until the list is
+ * executed. Uniform data such as model transforms and camera data is
+ * copied into the list when recorded.
+ */
+class BGE_API CommandList
+{
+    enum COMMAND_TYPE
+    {
+        COMMAND_BIND_PROGRAM = 0,
+        COMMAND_UNBIND_PROGRAM,
+        COMMAND_BIND_TEXTURE,
+        COMMAND_UNBIND_TEXTURE,
+        COMMAND_BIND_MESH,
+        COMMAND_UNBIND_MESH,
+        COMMAND_BIND_MODEL,
+        COMMAND_UNBIND_MODEL,
+        COMMAND_SET_MODELS,
+        COMMAND_SET_CAMERA,
+        COMMAND_DRAW,
+        COMMAND_DRAW_INSTANCED
+    };
+
+    /* *
+     * Every command starts with a header, padded to 16 bytes so data
+     * following it can hold aligned math types. The size of the data is
+     * implied by the type and count
+     * */
+    struct Command
+    {
+        uint32 Type;
+        int32 Count;
+        const void* Object;
+    };
+
+    /* Data of COMMAND_SET_CAMERA */
+    struct CameraData
+    {
+        Matrix Projection;
+        Matrix View;
+        Vector4 Position;
+    };
+
+    /* 16-byte aligned, from AlignedAlloc */
+    char* Data;
+    int Size;
+    int Capacity;
+    int NumCommands;
+
+    CommandList();
+
+    Result Reserve(int NewCapacity);
+
+    /* Add a command with room for data after it; NULL on failure */
+    Command* Append(COMMAND_TYPE Type, int Count, const void* Object,
+                                                        int DataSize);
+
+    static int GetHeaderSize();
+    static int GetDataSize(Command BGE_NCP Cmd);
+
+
+public:
+
+    /*! @brief CommandList destructor.
+     *
+     * CommandList destructor.
+     */
+    ~CommandList();
+
+    /*! @brief Create an empty CommandList.
+     *
+     * Create an empty CommandList with room for a number of bytes of
+     * commands. The list grows as needed.
+     *
+     * @param[in] ReserveBytes Number of bytes to make room for.
+     *
+     * @return Pointer to allocated CommandList; NULL if any errors
+     * occurred.
+     */
+    BGE_FACTORY CommandList* Create(int ReserveBytes);
+
+    /*! @brief Record binding a Shader.
+     *
+     * Record binding a Shader.
+     *
+     * @param[in] Program Shader to bind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result BindProgram(const Shader* Program);
+
+    /*! @brief Record unbinding a Shader.
+     *
+     * Record unbinding a Shader.
+     *
+     * @param[in] Program Shader to unbind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result UnbindProgram(const Shader* Program);
+
+    /*! @brief Record binding a Texture.
+     *
+     * Record binding a Texture.
+     *
+     * @param[in] Tex Texture to bind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result BindTexture(const Texture* Tex);
+
+    /*! @brief Record unbinding a Texture.
+     *
+     * Record unbinding a Texture.
+     *
+     * @param[in] Tex Texture to unbind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result UnbindTexture(const Texture* Tex);
+
+    /*! @brief Record binding a Mesh.
+     *
+     * Record binding a Mesh.
+     *
+     * @param[in] Geometry Mesh to bind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result BindMesh(const Mesh* Geometry);
+
+    /*! @brief Record unbinding a Mesh.
+     *
+     * Record unbinding a Mesh.
+     *
+     * @param[in] Geometry Mesh to unbind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result UnbindMesh(const Mesh* Geometry);
+
+    /*! @brief Record binding a Node.
+     *
+     * Record binding a Node, for Nodes that bind more than a model
+     * transform, such as a Crowd.
+     *
+     * @param[in] Model Node to bind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result BindModel(const Node* Model);
+
+    /*! @brief Record unbinding a Node.
+     *
+     * Record unbinding a Node.
+     *
+     * @param[in] Model Node to unbind.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result UnbindModel(const Node* Model);
+
+    /*! @brief Record binding model transforms for the next draw.
+     *
+     * Record binding model transforms to bge_Model through the
+     * InstanceBuffer. The transforms are copied into the list.
+     *
+     * @param[in] Count Number of transforms; at most
+     * BGE_INSTANCE_RING_SIZE.
+     * @param[in] Models Array of Count transforms.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result SetModels(int Count, const Affine* Models);
+
+    /*! @brief Record setting the camera data of the frame uniform block.
+     *
+     * Record setting the camera data with FrameUniforms::SetCamera. The
+     * data is copied into the list.
+     *
+     * @param[in] Projection Projection transform.
+     * @param[in] View Viewing transform.
+     * @param[in] Position Position of the camera.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result SetCamera(Matrix BGE_NCP Projection, Matrix BGE_NCP View,
+                                            Vector4 BGE_NCP Position);
+
+    /*! @brief Record drawing a Mesh.
+     *
+     * Record drawing a Mesh once with the bound state.
+     *
+     * @param[in] Geometry Mesh to draw.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result Draw(const Mesh* Geometry);
+
+    /*! @brief Record drawing instances of a Mesh.
+     *
+     * Record drawing a number of instances of a Mesh with the bound state.
+     *
+     * @param[in] Geometry Mesh to draw.
+     * @param[in] Count Number of instances.
+     *
+     * @return BGE_SUCCESS if the command was recorded; BGE_FAILURE if any
+     * errors occurred.
+     */
+    Result DrawInstanced(const Mesh* Geometry, int Count);
+
+    /*! @brief Replay the recorded commands.
+     *
+     * Replay the recorded commands in order. Must be called on the thread
+     * owning the OpenGL context. The list is left as it is, so it can be
+     * replayed again.
+     *
+     * @return BGE_SUCCESS if all commands succeeded; BGE_FAILURE if any
+     * of them failed. The remaining commands are still replayed.
+     */
+    Result Execute() const;
+
+    /*! @brief Replay several lists in order.
+     *
+     * Replay several lists in order, as recorded by different threads.
+     * Must be called on the thread owning the OpenGL context.
+     *
+     * @param[in] NumLists Number of lists.
+     * @param[in] Lists Array of lists to replay. NULL entries are skipped.
+     *
+     * @return BGE_SUCCESS if all commands succeeded; BGE_FAILURE if any
+     * of them failed.
+     */
+    static Result Execute(int NumLists, const CommandList* const* Lists);
+
+    /*! @brief Remove all recorded commands.
+     *
+     * Remove all recorded commands, keeping the memory for reuse.
+     *
+     * @return BGE_SUCCESS if the list was cleared.
+     */
+    Result Clear();
+
+    /*! @brief Get the number of recorded commands.
+     *
+     * Get the number of recorded commands.
+     *
+     * @return Number of commands.
+     */
+    int GetNumCommands() const;
+
+    /*! @brief Get the size of the recorded commands.
+     *
+     * Get the number of bytes the recorded commands take up.
+     *
+     * @return Size of the commands in bytes.
+     */
+    int GetSize() const;
+
+}; /* CommandList */
+
+} /* bakge */
+
+#endif /* BAKGE_CORE_COMMANDLIST_H */
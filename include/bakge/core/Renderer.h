@@ -0,0 +1,320 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Renderer.h
+ * @brief Renderer class declaration.
+ */
+
+#ifndef BAKGE_CORE_RENDERER_H
+#define BAKGE_CORE_RENDERER_H
+
+#include <bakge/Bakge.h>
+
+/* Number of layers draw items can be sorted into */
+#define BGE_RENDER_LAYERS 256
+
+namespace bakge
+{
+
+/*! @brief Render queue that sorts draws to minimize state changes.
+ *
+ * Instead of binding Shaders, Textures, Meshes and Pawns in whatever order
+ * they come up, draws are submitted to a Renderer as draw items and
+ * issued together with Flush. Each item gets a 64-bit sort key holding,
+ * from most to least significant, its layer, program, texture, mesh and
+ * view depth. Items are radix sorted by key, so draws sharing state end
+ * up next to each other and each state is bound once per run instead of
+ * once per draw.
+ *
+ * Within a layer, draws are ordered front to back to make the most of
+ * early depth testing. Layers holding translucent geometry can be set to
+ * sort by depth alone, back to front, with SetBackToFront.
+ *
+ * Consecutive draws of the same Mesh with the same Shader and Texture are
+ * combined into a single instanced draw: the model transforms of their
+ * Nodes are packed into the InstanceBuffer and the Mesh is drawn once,
+ * the way a Crowd is. Nodes without a single model transform, such as
+ * Crowds, are bound and drawn on their own, with as many instances as
+ * Node::GetNumInstances returns.
+ *
+ * Before sorting, draws are culled against the view frustum of the camera
+ * set in FrameUniforms, the same frustum Camera3D::GetFrustum returns. The
+ * Mesh bounds of every draw are transformed by its model transform and
+ * the boxes are tested in one batch with CullBoxesSoA, which leaves a
+ * visibility bit per draw. Draws without a model transform are never
+ * culled. Draws surviving the frustum can further be tested against an
+ * OcclusionCuller set with SetOcclusionCuller.
+ *
+ * Sorting, culling and packing of model transforms don't touch OpenGL.
+ * Record does all of it and writes the binds and draws to a CommandList,
+ * so Renderers on worker threads can each record a list for the thread
+ * owning the context to execute. Flush records into a list of its own and
+ * executes it right away.
+ *
+ * The Renderer counts the draw calls and binds issued by the last Flush,
+ * and the draws it culled, to keep an eye on how well draws batch.
+ */
+class BGE_API Renderer
+{
+    struct DrawItem
+    {
+        int Layer;
+        const Shader* Program;
+        const Texture* Tex;
+        const Mesh* Geometry;
+        const Node* Model;
+
+        /* Set when Model has a single transform, stored in Transforms */
+        bool HasTransform;
+    };
+
+    DrawItem* Items;
+    int NumItems;
+    int Capacity;
+
+    /* Sort keys and item indices, plus scratch space for the radix sort */
+    uint64* Keys;
+    uint64* KeysScratch;
+    int* Order;
+    int* OrderScratch;
+
+    /* Model transforms of a run of draws being instanced */
+    Affine* Models;
+
+    /* Model transforms, world-space bounds (SoA) and visibility of items */
+    Affine* Transforms;
+    Scalar* Boxes;
+    uint32* Visible;
+    bool Culling;
+    const OcclusionCuller* Occlusion;
+
+    /* Commands recorded and executed by Flush */
+    CommandList* Commands;
+
+    bool BackToFront[BGE_RENDER_LAYERS];
+
+    int NumDraws;
+    int NumBinds;
+    int NumInstanced;
+    int NumVisible;
+    int NumCulled;
+    int NumOccluded;
+
+    Renderer();
+
+    Result Reserve(int NewCapacity);
+
+    /* Get model transforms and set the visibility bit of every item */
+    void Cull();
+
+    /* Build sort keys of visible items; returns how many there are */
+    int BuildKeys();
+
+    /* Sort the first Count entries of Order by Keys */
+    void SortKeys(int Count);
+
+
+public:
+
+    /*! @brief Renderer destructor.
+     *
+     * Renderer destructor.
+     */
+    ~Renderer();
+
+    /*! @brief Create a Renderer.
+     *
+     * Create a Renderer with room for a number of draw items. The queue
+     * grows as needed.
+     *
+     * @param[in] ReserveItems Number of draw items to make room for.
+     *
+     * @return Pointer to allocated Renderer; NULL if any errors occurred.
+     */
+    BGE_FACTORY Renderer* Create(int ReserveItems);
+
+    /*! @brief Queue a draw for the next Flush.
+     *
+     * Queue a draw of a Mesh with a Shader and Texture, at the transform of
+     * a Node (such as a Pawn). Nothing is bound or drawn until Flush. The
+     * objects must stay alive until then.
+     *
+     * @param[in] Layer Layer to draw in; lower layers are drawn first.
+     * @param[in] Program Shader to draw with.
+     * @param[in] Tex Texture to draw with; NULL for none.
+     * @param[in] Geometry Mesh to draw.
+     * @param[in] Model Node to draw at; NULL to leave the model transform
+     * as it is.
+     *
+     * @return BGE_SUCCESS if the draw was queued; BGE_FAILURE if any
+     * arguments are invalid or the queue couldn't grow.
+     */
+    Result Submit(int Layer, const Shader* Program, const Texture* Tex,
+                                const Mesh* Geometry, const Node* Model);
+
+    /*! @brief Sort and issue every queued draw, then empty the queue.
+     *
+     * Sort the queued draws and issue them, binding each Shader, Texture
+     * and Mesh only when it differs from the previous draw's. Runs of draws
+     * sharing all three are issued as one instanced draw. View depth is
+     * measured with the camera set in FrameUniforms, so bind the camera
+     * before flushing. Everything bound is unbound afterwards.
+     *
+     * @return BGE_SUCCESS if every draw was issued; BGE_FAILURE if any
+     * binds or draws failed.
+     */
+    Result Flush();
+
+    /*! @brief Record every queued draw to a CommandList, then empty the
+     * queue.
+     *
+     * Cull and sort the queued draws like Flush, but record the binds and
+     * draws to a CommandList instead of issuing them. Makes no OpenGL
+     * calls, so it can run on any thread, as long as the camera in
+     * FrameUniforms doesn't change while recording. Execute the list on the
+     * thread owning the context to issue the draws.
+     *
+     * @param[in] Target List to append the commands to.
+     *
+     * @return BGE_SUCCESS if every draw was recorded; BGE_FAILURE if the
+     * list couldn't grow.
+     */
+    Result Record(CommandList* Target);
+
+    /*! @brief Empty the queue without drawing.
+     *
+     * Empty the queue without drawing.
+     *
+     * @return BGE_SUCCESS if the queue was emptied.
+     */
+    Result Clear();
+
+    /*! @brief Set the order draws in a layer are issued in.
+     *
+     * By default draws in a layer are grouped by state and ordered front to
+     * back within each group. Layers with translucent geometry need draws
+     * ordered back to front instead, regardless of state.
+     *
+     * @param[in] Layer Layer to set the order of.
+     * @param[in] Enabled true to order back to front; false to group by
+     * state.
+     *
+     * @return BGE_SUCCESS if the order was set; BGE_FAILURE if the layer is
+     * out of range.
+     */
+    Result SetBackToFront(int Layer, bool Enabled);
+
+    /*! @brief Enable or disable frustum culling.
+     *
+     * Enable or disable frustum culling of queued draws. Culling is enabled
+     * by default.
+     *
+     * @param[in] Enabled true to cull draws outside the view frustum; false
+     * to draw everything.
+     *
+     * @return BGE_SUCCESS.
+     */
+    Result SetCulling(bool Enabled);
+
+    /*! @brief Set the OcclusionCuller draws are tested against.
+     *
+     * Set an OcclusionCuller to test draws against after frustum culling.
+     * The Renderer doesn't render it: add occluders and call
+     * OcclusionCuller::Render with the camera's view-projection transform
+     * before Flush.
+     *
+     * @param[in] Culler OcclusionCuller to test against; NULL for none.
+     *
+     * @return BGE_SUCCESS.
+     */
+    Result SetOcclusionCuller(const OcclusionCuller* Culler);
+
+    /*! @brief Get the number of queued draws.
+     *
+     * Get the number of draws queued since the last Flush or Clear.
+     *
+     * @return Number of queued draws.
+     */
+    int GetNumItems() const;
+
+    /*! @brief Get the number of draws found visible by the last Flush.
+     *
+     * Get the number of queued draws the last Flush found inside the view
+     * frustum, or could not cull, and issued.
+     *
+     * @return Number of visible draws.
+     */
+    int GetNumVisible() const;
+
+    /*! @brief Get the number of draws culled by the last Flush.
+     *
+     * Get the number of queued draws the last Flush skipped because they
+     * were outside the view frustum or occluded.
+     *
+     * @return Number of culled draws.
+     */
+    int GetNumCulled() const;
+
+    /*! @brief Get the number of draws occluded in the last Flush.
+     *
+     * Get the number of queued draws the last Flush skipped because the
+     * OcclusionCuller found them hidden. These are included in the number
+     * of culled draws.
+     *
+     * @return Number of occluded draws.
+     */
+    int GetNumOccluded() const;
+
+    /*! @brief Get the number of draw calls issued by the last Flush.
+     *
+     * Get the number of draw calls issued by the last Flush.
+     *
+     * @return Number of draw calls.
+     */
+    int GetNumDraws() const;
+
+    /*! @brief Get the number of draws combined into instanced draws.
+     *
+     * Get the number of queued draws the last Flush issued as part of an
+     * instanced draw of two or more Nodes.
+     *
+     * @return Number of instanced draws.
+     */
+    int GetNumInstanced() const;
+
+    /*! @brief Get the number of binds issued by the last Flush.
+     *
+     * Get the number of Shader, Texture and Mesh binds issued by the last
+     * Flush. Model transforms are not counted.
+     *
+     * @return Number of binds.
+     */
+    int GetNumBinds() const;
+
+}; /* Renderer */
+
+} /* bakge */
+
+#endif /* BAKGE_CORE_RENDERER_H */
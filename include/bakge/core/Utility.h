@@ -64,6 +64,38 @@
 #define BGE_ASSERT_EX(PRED, MSG)
 #endif
 
+/*! @brief Declare class-specific aligned operators new and delete.
+ *
+ * Place in the public section of classes which are BGE_ALIGN'd so that
+ * instances created with new or new[] are properly aligned on every
+ * platform, not only those whose malloc happens to align to 16 bytes.
+ * Allocation failure returns NULL rather than throwing.
+ */
+#define BGE_ALIGNED_NEW(X) \
+    BGE_INL static void* operator new(size_t Size) throw() \
+    { \
+        return bakge::AlignedAlloc(Size, X); \
+    } \
+    BGE_INL static void* operator new[](size_t Size) throw() \
+    { \
+        return bakge::AlignedAlloc(Size, X); \
+    } \
+    BGE_INL static void* operator new(size_t, void* Where) throw() \
+    { \
+        return Where; \
+    } \
+    BGE_INL static void operator delete(void* Memory) \
+    { \
+        bakge::AlignedFree(Memory); \
+    } \
+    BGE_INL static void operator delete[](void* Memory) \
+    { \
+        bakge::AlignedFree(Memory); \
+    } \
+    BGE_INL static void operator delete(void*, void*) \
+    { \
+    }
+
 namespace bakge
 {
 
@@ -112,6 +144,29 @@ BGE_WUNUSED BGE_FUNC Byte* LoadFileContents(const char* Path);
  */
 BGE_FUNC int Log(const char* Format, ...);
 
+/*! @brief Allocate a block of memory aligned to a given boundary.
+ *
+ * Allocate a block of memory whose address is a multiple of Alignment.
+ * Used for arrays of SIMD types such as Vector4, Matrix and Quaternion,
+ * which need 16-byte alignment. Memory must be released with AlignedFree.
+ *
+ * @param[in] Size Size of the block in bytes.
+ * @param[in] Alignment Alignment in bytes. Must be a power of two.
+ *
+ * @return Pointer to the aligned block; NULL if allocation failed or the
+ * alignment is invalid.
+ */
+BGE_WUNUSED BGE_FUNC void* AlignedAlloc(size_t Size, size_t Alignment);
+
+/*! @brief Free a block of memory allocated with AlignedAlloc.
+ *
+ * Free a block of memory allocated with AlignedAlloc. Passing NULL does
+ * nothing.
+ *
+ * @param[in] Memory Block to free.
+ */
+BGE_FUNC void AlignedFree(void* Memory);
+
 } /* bakge */
 
 #endif /* BAKGE_CORE_UTILITY_H */
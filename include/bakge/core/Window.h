@@ -63,6 +63,7 @@ class BGE_API Window : public Bindable
 {
     friend BGE_API Result Init(int argc, char* argv[]);
     friend BGE_API Result Deinit();
+    friend class ShaderHandle;
 
     static GLFWwindow* SharedContext;
 
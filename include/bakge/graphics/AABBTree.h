@@ -0,0 +1,286 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file AABBTree.h
+ * @brief AABBTree class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_AABBTREE_H
+#define BAKGE_GRAPHICS_AABBTREE_H
+
+#include <bakge/Bakge.h>
+
+/* Deep enough for any tree the balancing lets through */
+#define BGE_AABBTREE_STACK_SIZE 256
+
+namespace bakge
+{
+
+/*! @brief Dynamic bounding volume hierarchy for spatial queries.
+ *
+ * An AABBTree holds a set of proxies, each with a bounding box and a user
+ * pointer such as the Pawn or Node it stands for. The boxes are kept in a
+ * binary tree of nested bounding boxes, so frustum culling, picking and
+ * proximity queries only visit the branches near what they're looking
+ * for instead of scanning every object.
+ *
+ * Each proxy stores a box enlarged by a margin. Moving an object within
+ * its enlarged box costs nothing; once it leaves, its proxy is removed
+ * and reinserted where it costs the least, and the branches above it are
+ * rebalanced with tree rotations. Rebuild rebuilds the whole tree from
+ * scratch, which is worth it after large batches of changes such as
+ * loading a level.
+ *
+ * Queries test the enlarged boxes, so they return candidates that the
+ * caller can refine with exact bounds.
+ */
+class BGE_API AABBTree
+{
+    /* Free nodes have height -1 and chain through Parent */
+    struct TreeNode
+    {
+        Scalar Min[3];
+        Scalar Max[3];
+        void* Data;
+        int Parent;
+        int Left;
+        int Right;
+        int Height;
+    };
+
+    TreeNode* Nodes;
+    int Capacity;
+    int Root;
+    int FreeList;
+    int NumProxies;
+    Scalar Margin;
+
+    AABBTree();
+
+    Result Reserve(int NewCapacity);
+
+    int AllocateNode();
+    void FreeNode(int Node);
+
+    void InsertLeaf(int Leaf);
+    void RemoveLeaf(int Leaf);
+
+    /* Store the bounds of a leaf enlarged by the margin */
+    void SetFatBounds(int Leaf, AABB BGE_NCP Bounds);
+
+    /* Recompute the box and height of an internal node */
+    void Refit(int Node);
+
+    /* Walk from a node to the root, rebalancing and refitting */
+    void FixUpwards(int Node);
+
+    /* Rotate a child above its parent if the branches are unbalanced */
+    int Balance(int Node);
+    int Rotate(int Node, int Up);
+
+    /* Build a balanced subtree over leaves; return its root */
+    int BuildRange(int* Leaves, int Count);
+
+    /* Partition leaves around the K-th center along an axis */
+    void SelectLeaves(int* Leaves, int Count, int K, int Axis) const;
+
+    AABB GetNodeBox(int Node) const;
+
+
+public:
+
+    /*! @brief AABBTree destructor.
+     *
+     * AABBTree destructor.
+     */
+    ~AABBTree();
+
+    /*! @brief Create an empty AABBTree.
+     *
+     * Create an empty AABBTree. Proxy boxes are enlarged by a margin on
+     * each side, so objects can move that far without updating the tree.
+     *
+     * @param[in] FatMargin Margin added to each side of proxy boxes.
+     *
+     * @return Pointer to allocated AABBTree; NULL if any errors occurred.
+     */
+    BGE_FACTORY AABBTree* Create(Scalar FatMargin);
+
+    /*! @brief Add a proxy to the tree.
+     *
+     * Add a proxy for an object to the tree.
+     *
+     * @param[in] Bounds Bounding box of the object.
+     * @param[in] Data User pointer stored with the proxy.
+     *
+     * @return Proxy ID, which stays valid until the proxy is removed; -1
+     * if any errors occurred.
+     */
+    int Insert(AABB BGE_NCP Bounds, void* Data);
+
+    /*! @brief Remove a proxy from the tree.
+     *
+     * Remove a proxy from the tree. Its ID may be reused by later
+     * insertions.
+     *
+     * @param[in] Proxy Proxy to remove.
+     *
+     * @return BGE_SUCCESS if the proxy was removed; BGE_FAILURE if the
+     * proxy is invalid.
+     */
+    Result Remove(int Proxy);
+
+    /*! @brief Update the bounds of a moving object.
+     *
+     * Update the bounds of an object. Nothing happens while the bounds
+     * stay within the enlarged box of the proxy; otherwise the proxy is
+     * reinserted with new enlarged bounds.
+     *
+     * @param[in] Proxy Proxy of the object.
+     * @param[in] Bounds New bounding box of the object.
+     *
+     * @return BGE_SUCCESS if the proxy was updated; BGE_FAILURE if the
+     * proxy is invalid.
+     */
+    Result Move(int Proxy, AABB BGE_NCP Bounds);
+
+    /*! @brief Rebuild the tree from scratch.
+     *
+     * Rebuild the tree top-down, splitting proxies at the median along
+     * the longest axis. Gives a better tree than incremental updates
+     * after large batches of insertions or moves. Proxy IDs are kept.
+     *
+     * @return BGE_SUCCESS if the tree was rebuilt; BGE_FAILURE if any
+     * errors occurred. The tree is left as it was.
+     */
+    Result Rebuild();
+
+    /*! @brief Find proxies overlapping a box.
+     *
+     * Find proxies whose enlarged boxes overlap a box.
+     *
+     * @param[in] Box Box to test.
+     * @param[out] Proxies Array receiving up to MaxProxies proxy IDs.
+     * @param[in] MaxProxies Length of the Proxies array.
+     *
+     * @return Number of proxies found, which may exceed MaxProxies.
+     */
+    int QueryBox(AABB BGE_NCP Box, int* Proxies, int MaxProxies) const;
+
+    /*! @brief Find proxies overlapping a sphere.
+     *
+     * Find proxies whose enlarged boxes overlap a sphere.
+     *
+     * @param[in] Target Sphere to test.
+     * @param[out] Proxies Array receiving up to MaxProxies proxy IDs.
+     * @param[in] MaxProxies Length of the Proxies array.
+     *
+     * @return Number of proxies found, which may exceed MaxProxies.
+     */
+    int QuerySphere(Sphere BGE_NCP Target, int* Proxies,
+                                        int MaxProxies) const;
+
+    /*! @brief Find proxies inside or overlapping a frustum.
+     *
+     * Find proxies whose enlarged boxes are inside or overlap a frustum.
+     * Branches entirely inside the frustum are accepted without testing
+     * their proxies.
+     *
+     * @param[in] View Frustum to test.
+     * @param[out] Proxies Array receiving up to MaxProxies proxy IDs.
+     * @param[in] MaxProxies Length of the Proxies array.
+     *
+     * @return Number of proxies found, which may exceed MaxProxies.
+     */
+    int QueryFrustum(Frustum BGE_NCP View, int* Proxies,
+                                        int MaxProxies) const;
+
+    /*! @brief Find proxies hit by a ray.
+     *
+     * Find proxies whose enlarged boxes a ray hits within a distance, in
+     * no particular order.
+     *
+     * @param[in] Target Ray to cast.
+     * @param[in] MaxDistance Distance along the ray to search, in units
+     * of its direction's length.
+     * @param[out] Proxies Array receiving up to MaxProxies proxy IDs.
+     * @param[in] MaxProxies Length of the Proxies array.
+     *
+     * @return Number of proxies found, which may exceed MaxProxies.
+     */
+    int QueryRay(Ray BGE_NCP Target, Scalar MaxDistance, int* Proxies,
+                                                int MaxProxies) const;
+
+    /*! @brief Check if an ID refers to a proxy in the tree.
+     *
+     * Check if an ID refers to a proxy in the tree.
+     *
+     * @param[in] Proxy ID to check.
+     *
+     * @return true if the proxy is valid; false otherwise.
+     */
+    bool IsValid(int Proxy) const;
+
+    /*! @brief Get the user pointer of a proxy.
+     *
+     * Get the user pointer stored with a proxy.
+     *
+     * @param[in] Proxy Proxy to query.
+     *
+     * @return User pointer; NULL if the proxy is invalid.
+     */
+    void* GetData(int Proxy) const;
+
+    /*! @brief Get the enlarged box of a proxy.
+     *
+     * Get the enlarged box the tree stores for a proxy.
+     *
+     * @param[in] Proxy Proxy to query. Must be valid.
+     *
+     * @return Enlarged bounding box of the proxy.
+     */
+    AABB GetFatBounds(int Proxy) const;
+
+    /*! @brief Get the number of proxies in the tree.
+     *
+     * Get the number of proxies in the tree.
+     *
+     * @return Number of proxies.
+     */
+    int GetNumProxies() const;
+
+    /*! @brief Get the height of the tree.
+     *
+     * Get the number of levels between the root and the deepest proxy.
+     *
+     * @return Height of the tree; -1 if the tree is empty.
+     */
+    int GetHeight() const;
+
+}; /* AABBTree */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_AABBTREE_H */
@@ -57,6 +57,22 @@ protected:
     Vector4 Span;
 
 
+private:
+
+    /* *
+     * Transforms are cached and rebuilt only when the span or position
+     * change. Position changes made through Node are caught by comparing
+     * against the position of the cached projection
+     * */
+    mutable bool Dirty;
+    mutable Vector4 CachedPosition;
+    mutable Matrix CachedProjection;
+    mutable Matrix CachedInverseProjection;
+    mutable Frustum CachedFrustum;
+
+    void UpdateTransforms() const;
+
+
 public:
 
     /*! @brief Default Camera2D constructor.
@@ -75,9 +91,11 @@ public:
      *
      * Binding a Camera2D sets up OpenGL state so that the scene is rendered
      * from the camera's position and span. The camera's position and span
-     * are measured in pixels. If certain shader uniforms are not present in
-     * the currently bound Shader, Bind will return BGE_FAILURE, even when
-     * the uniforms that are present have successfully been bound.
+     * are measured in pixels. The transforms are stored in the FrameUniforms
+     * shared by every Shader. If the bound Shader doesn't use the frame
+     * uniform block and certain uniforms are not present in it, Bind will
+     * return BGE_FAILURE, even when the uniforms that are present have
+     * successfully been bound.
      *
      * @return BGE_SUCCESS if the Camera2D's view and projection transforms
      * were set in OpenGL; BGE_FAILURE if any errors occurred or an incomplete
@@ -114,6 +132,7 @@ public:
         Span[0] = Width;
         Span[1] = Height;
         Span[2] = Far;
+        Dirty = true;
 
         return Span;
     }
@@ -130,6 +149,43 @@ public:
         return Span;
     }
 
+    /*! @brief Get the Camera2D's orthographic projection transform.
+     *
+     * Get the Camera2D's orthographic projection transform, as bound to the
+     * projection uniform. Recomputed only when the position or span change.
+     * Camera2D has an identity viewing transform, so this is also its
+     * view-projection transform.
+     *
+     * @return const reference to the orthographic projection transform.
+     */
+    Matrix BGE_NCP GetProjection() const;
+
+    /*! @brief Get the Camera2D's combined viewing and projection transform.
+     *
+     * Get the Camera2D's combined viewing and projection transform. Since
+     * the viewing transform is identity, this is the projection transform.
+     *
+     * @return const reference to the view-projection transform.
+     */
+    Matrix BGE_NCP GetViewProjection() const;
+
+    /*! @brief Get the inverse of the Camera2D's view-projection transform.
+     *
+     * Get the inverse of the Camera2D's view-projection transform, which
+     * takes clip space back to scene space.
+     *
+     * @return const reference to the inverse view-projection transform.
+     */
+    Matrix BGE_NCP GetInverseViewProjection() const;
+
+    /*! @brief Get the Camera2D's view volume.
+     *
+     * Get the Camera2D's view volume as a Frustum, for culling.
+     *
+     * @return const reference to the view volume of the camera.
+     */
+    Frustum BGE_NCP GetFrustum() const;
+
 }; /* Camera2D */
 
 } /* bakge */
@@ -57,6 +57,25 @@ protected:
     Scalar Far;
 
 
+private:
+
+    /* *
+     * Transforms are cached and rebuilt only when an input changes. The
+     * setters below flag changes; position changes made through Node are
+     * caught by comparing against the eye position of the cached view
+     * */
+    mutable bool ProjectionDirty;
+    mutable bool ViewDirty;
+    mutable Vector4 CachedEye;
+    mutable Matrix CachedProjection;
+    mutable Matrix CachedView;
+    mutable Matrix CachedViewProjection;
+    mutable Matrix CachedInverseViewProjection;
+    mutable Frustum CachedFrustum;
+
+    void UpdateTransforms() const;
+
+
 public:
 
     /*! @brief Default Camera3D constructor.
@@ -94,10 +113,11 @@ public:
 
     /*! @brief Bind the Camera3D's viewing and projection transforms in OpenGL.
      *
-     * Bind the Camera3D's viewing and projection transforms in OpenGL. If
-     * certain shader uniforms are not present in the currently bound Shader,
-     * Bind will return BGE_FAILURE, even when the uniforms that are present
-     * have successfully been bound.
+     * Bind the Camera3D's viewing and projection transforms in OpenGL. They
+     * are stored in the FrameUniforms shared by every Shader. If the bound
+     * Shader doesn't use the frame uniform block and certain uniforms are
+     * not present in it, Bind will return BGE_FAILURE, even when the
+     * uniforms that are present have successfully been bound.
      *
      * @return BGE_SUCCESS if the camera's transforms were successfully bound
      * to OpenGL state; BGE_FAILURE if any errors occurred or an incomplete
@@ -105,6 +125,51 @@ public:
      */
     virtual Result Bind() const;
 
+    /*! @brief Get the Camera3D's perspective projection transform.
+     *
+     * Get the Camera3D's perspective projection transform, as bound to the
+     * projection uniform. Recomputed only when the field of view, aspect
+     * ratio or clipping planes change.
+     *
+     * @return const reference to the perspective projection transform.
+     */
+    Matrix BGE_NCP GetProjection() const;
+
+    /*! @brief Get the Camera3D's viewing transform.
+     *
+     * Get the Camera3D's viewing transform, as bound to the view uniform.
+     * Recomputed only when the position or target change.
+     *
+     * @return const reference to the viewing transform.
+     */
+    Matrix BGE_NCP GetView() const;
+
+    /*! @brief Get the Camera3D's combined viewing and projection transform.
+     *
+     * Get the Camera3D's combined viewing and projection transform, which
+     * takes world space to clip space.
+     *
+     * @return const reference to the view-projection transform.
+     */
+    Matrix BGE_NCP GetViewProjection() const;
+
+    /*! @brief Get the inverse of the Camera3D's view-projection transform.
+     *
+     * Get the inverse of the Camera3D's view-projection transform, which
+     * takes clip space back to world space, e.g. for picking rays.
+     *
+     * @return const reference to the inverse view-projection transform.
+     */
+    Matrix BGE_NCP GetInverseViewProjection() const;
+
+    /*! @brief Get the Camera3D's view frustum in world space.
+     *
+     * Get the Camera3D's view frustum in world space, for culling.
+     *
+     * @return const reference to the view frustum of the camera.
+     */
+    Frustum BGE_NCP GetFrustum() const;
+
     /*! @brief Bind default viewing and projection transforms in OpenGL.
      *
      * Bind default viewing and projection transforms in OpenGL. If certain
@@ -129,6 +194,7 @@ public:
     BGE_INL Degrees SetFOV(Degrees F)
     {
         FOV = F;
+        ProjectionDirty = true;
 
         return FOV;
     }
@@ -156,6 +222,7 @@ public:
     BGE_INL Scalar SetAspect(Scalar R)
     {
         Aspect = R;
+        ProjectionDirty = true;
 
         return Aspect;
     }
@@ -171,6 +238,7 @@ public:
     BGE_INL Scalar SetNearClip(Scalar N)
     {
         Near = N;
+        ProjectionDirty = true;
 
         return Near;
     }
@@ -197,6 +265,7 @@ public:
     BGE_INL Scalar SetFarClip(Scalar F)
     {
         Far = F;
+        ProjectionDirty = true;
 
         return Far;
     }
@@ -68,7 +68,7 @@ protected:
     Quaternion* Rotations;
     Scalar* Scales;
 
-    /* Buffer for the Crowd's members' model matrices */
+    /* Buffer for the Crowd's members' model transformations (Affine) */
     GLuint CrowdBuffer;
 
     /*! @brief Default Crowd constructor.
@@ -119,6 +119,25 @@ public:
      */
     virtual Result Bind() const;
 
+    /*! @brief Crowds have no single model transform.
+     *
+     * Crowds have one model transform per member, kept in their own
+     * buffer, so they are always drawn by binding them.
+     *
+     * @param[out] Model Unused.
+     *
+     * @return BGE_FAILURE.
+     */
+    virtual Result GetModelTransform(Affine* Model) const;
+
+    /*! @brief Crowds draw one instance per member.
+     *
+     * Crowds draw one instance per member.
+     *
+     * @return Number of members in the Crowd.
+     */
+    virtual int GetNumInstances() const;
+
     /*! @brief Unbind the Crowd, setting OpenGL state to arbitrary defaults.
      *
      * Unbind the Crowd, setting OpenGL state to arbitrary defaults.
@@ -0,0 +1,151 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file FrameUniforms.h
+ * @brief FrameUniforms class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_FRAMEUNIFORMS_H
+#define BAKGE_GRAPHICS_FRAMEUNIFORMS_H
+
+#include <bakge/Bakge.h>
+
+/* Uniform buffer binding point of the per-frame uniform block */
+#define BGE_FRAME_BINDING 0
+
+namespace bakge
+{
+
+/*! @brief Per-frame camera and time data shared by every Shader.
+ *
+ * The Bakge shader library declares a std140 uniform block holding
+ * bge_Projection, bge_View, bge_ViewProjection, bge_CameraPosition and
+ * bge_Time. Where uniform buffers are supported the block is backed by a
+ * single buffer bound to BGE_FRAME_BINDING, so the data is uploaded once
+ * when it changes instead of once per program switch. Otherwise the same
+ * names are plain uniforms, set whenever a Shader is bound.
+ *
+ * Camera2D and Camera3D set the camera data when bound. Call BeginFrame
+ * once per frame to update bge_Time, which holds the running time in
+ * seconds, the time since the previous frame and the frame number.
+ */
+class BGE_API FrameUniforms
+{
+    friend class Shader;
+
+    /* Matches the std140 layout of the uniform block */
+    struct Block
+    {
+        Matrix Projection;
+        Matrix View;
+        Matrix ViewProjection;
+        Vector4 CameraPosition;
+        Vector4 Time;
+    };
+
+    static Block Data;
+    static GLuint Buffer;
+    static bool Dirty;
+    static Microseconds LastFrame;
+    static int FrameNumber;
+
+    static Result Init();
+    static Result Deinit();
+
+    /* Upload the data if it changed and bind the buffer in this context */
+    static Result Upload();
+
+    /* Set the data as plain uniforms of a Shader without the block */
+    static Result Apply(const Shader* Target);
+
+
+public:
+
+    /*! @brief Check if frame data is kept in a uniform buffer.
+     *
+     * Check if frame data is kept in a uniform buffer.
+     *
+     * @return true if uniform buffers are supported; false if frame data is
+     * set as plain uniforms.
+     */
+    static bool IsBufferAvailable();
+
+    /*! @brief Update the time data for a new frame.
+     *
+     * Update bge_Time for a new frame. Call once per frame, before drawing.
+     *
+     * @return BGE_SUCCESS if the time data was updated; BGE_FAILURE if any
+     * errors occurred.
+     */
+    static Result BeginFrame();
+
+    /*! @brief Set the camera data used for rendering.
+     *
+     * Set the projection and view transforms and the camera position used
+     * for rendering. The view-projection transform is derived from them.
+     * Programs without the uniform block receive the data as plain uniforms
+     * of the current Shader.
+     *
+     * @param[in] Projection Projection transform.
+     * @param[in] View Viewing transform.
+     * @param[in] Position Position of the camera.
+     *
+     * @return BGE_SUCCESS if the camera data was set; BGE_FAILURE if any
+     * errors occurred or the current Shader is missing some of the frame
+     * uniforms.
+     */
+    static Result SetCamera(Matrix BGE_NCP Projection, Matrix BGE_NCP View,
+                                                Vector4 BGE_NCP Position);
+
+    /*! @brief Get the current projection transform.
+     *
+     * Get the projection transform last set with SetCamera.
+     *
+     * @return const reference to the projection transform.
+     */
+    static Matrix BGE_NCP GetProjection();
+
+    /*! @brief Get the current viewing transform.
+     *
+     * Get the viewing transform last set with SetCamera.
+     *
+     * @return const reference to the viewing transform.
+     */
+    static Matrix BGE_NCP GetView();
+
+    /*! @brief Get the current view-projection transform.
+     *
+     * Get the combined viewing and projection transform last set with
+     * SetCamera.
+     *
+     * @return const reference to the view-projection transform.
+     */
+    static Matrix BGE_NCP GetViewProjection();
+
+}; /* FrameUniforms */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_FRAMEUNIFORMS_H */
@@ -0,0 +1,138 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file InstanceBuffer.h
+ * @brief InstanceBuffer class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_INSTANCEBUFFER_H
+#define BAKGE_GRAPHICS_INSTANCEBUFFER_H
+
+#include <bakge/Bakge.h>
+
+/* Number of model transforms (Affine) the ring buffer holds */
+#define BGE_INSTANCE_RING_SIZE 4096
+
+namespace bakge
+{
+
+/*! @brief Shared ring buffer holding model transforms of bound Nodes.
+ *
+ * Instead of each Node owning a buffer object that is reallocated on every
+ * bind, model transforms are suballocated from a single ring buffer. Each
+ * bind writes its transform to the next free slot without synchronizing
+ * with the GPU. When the ring is full the buffer is orphaned, so draws
+ * still reading the previous storage are not stalled, and writing starts
+ * over at the beginning.
+ *
+ * Where base instances are supported the bge_Model attribute always points
+ * at the start of the ring and Mesh draws select the slot with their base
+ * instance. Otherwise the attribute pointer is offset to the slot.
+ */
+class BGE_API InstanceBuffer
+{
+    friend class Shader;
+
+    static GLuint Buffer;
+    static int Head;
+    static GLuint BaseInstance;
+
+    static Result Init();
+    static Result Deinit();
+
+    /* Reserve consecutive slots; returns index of the first or -1 */
+    static int Allocate(int Count);
+
+
+public:
+
+    /*! @brief Check if Mesh draws select instance data by base instance.
+     *
+     * Check if Mesh draws select instance data by base instance.
+     *
+     * @return true if base instances are supported; false if attribute
+     * pointers are offset instead.
+     */
+    static bool IsBaseInstanceAvailable();
+
+    /*! @brief Write a model transform and bind it to bge_Model.
+     *
+     * Write a model transform to the next free slot of the ring and set up
+     * the bge_Model attribute of the current Shader to read from it.
+     *
+     * @param[in] Model Model transform to bind.
+     *
+     * @return BGE_SUCCESS if the transform was bound; BGE_FAILURE if there
+     * is no current Shader, it has no bge_Model attribute or any other
+     * errors occurred.
+     */
+    static Result BindModel(Affine BGE_NCP Model);
+
+    /*! @brief Write consecutive model transforms and bind them to bge_Model.
+     *
+     * Write a number of model transforms to consecutive slots of the ring
+     * and set up the bge_Model attribute of the current Shader so instance
+     * i of the next Mesh::DrawInstanced reads Models[i].
+     *
+     * @param[in] Count Number of transforms, at most BGE_INSTANCE_RING_SIZE.
+     * @param[in] Models Model transforms to bind.
+     *
+     * @return BGE_SUCCESS if the transforms were bound; BGE_FAILURE if
+     * there is no current Shader, it has no bge_Model attribute or any
+     * other errors occurred.
+     */
+    static Result BindModels(int Count, const Affine* Models);
+
+    /*! @brief Disable the bge_Model attribute and reset the base instance.
+     *
+     * Disable the bge_Model attribute of the current Shader and reset the
+     * base instance used by Mesh draws to zero.
+     *
+     * @return BGE_SUCCESS if the attribute was disabled; BGE_FAILURE if
+     * there is no current Shader or it has no bge_Model attribute.
+     */
+    static Result UnbindModel();
+
+    /*! @brief Reset the base instance used by Mesh draws to zero.
+     *
+     * Reset the base instance used by Mesh draws to zero. Used by objects
+     * that bind their own instance data, such as Crowds.
+     */
+    static void ResetBaseInstance();
+
+    /*! @brief Get the base instance used by Mesh draws.
+     *
+     * Get the base instance used by Mesh draws, which selects the slot of
+     * the last bound model transform.
+     *
+     * @return Base instance for the next draw.
+     */
+    static GLuint GetBaseInstance();
+
+}; /* InstanceBuffer */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_INSTANCEBUFFER_H */
@@ -84,6 +84,46 @@ enum MESH_BUFFERS
     NUM_MESH_BUFFERS
 };
 
+/*! @brief Mesh vertex data usage hints.
+ *
+ * Usage hints tell OpenGL how often a Mesh's vertex data is expected to
+ * change, so the driver can place it in the most suitable memory.
+ */
+enum MESH_USAGE
+{
+    /*! @brief Vertex data is set once and drawn many times.
+     *
+     * Maps to GL_STATIC_DRAW. This is the default for every Mesh.
+     */
+    MESH_USAGE_STATIC = 0,
+
+    /*! @brief Vertex data is modified repeatedly and drawn many times.
+     *
+     * Maps to GL_DYNAMIC_DRAW. Use for deformable meshes or UI elements
+     * which are resized often.
+     */
+    MESH_USAGE_DYNAMIC,
+
+    /*! @brief Vertex data is modified once and drawn at most a few times.
+     *
+     * Maps to GL_STREAM_DRAW. Use for procedurally animated meshes which
+     * are regenerated every frame.
+     */
+    MESH_USAGE_STREAM,
+
+    /*! @brief Total number of mesh usage hints.
+     */
+    NUM_MESH_USAGES
+};
+
+/*! @brief Maximum number of copies of each Mesh vertex buffer.
+ *
+ * Dynamic meshes may keep up to this many copies of their vertex buffers
+ * (triple buffering) so updates never write into a buffer the GPU may
+ * still be reading from.
+ */
+#define BGE_MESH_MAX_COPIES 3
+
 /*! @brief A collection of vertex data describing an arbitrary object
  *
  * Meshes data and their associated metadata are used to describe objects
@@ -109,17 +149,57 @@ protected:
     Scalar* TexCoords;
     int* Indices;
 
+    /* Bounds of the vertex positions, for culling */
+    AABB Bounds;
+
     GLuint MeshBuffers[NUM_MESH_BUFFERS];
 
+    /* OpenGL usage hint passed when (re)allocating vertex buffers */
+    GLenum Usage;
+
+    /* Number of copies of each vertex buffer. 1 means no multi-buffering */
+    int NumCopies;
+
+    /* Extra copies of the vertex buffers when multi-buffering is enabled */
+    GLuint BufferCopies[BGE_MESH_MAX_COPIES - 1][NUM_MESH_BUFFERS];
+
+    /* Index of the copy of each buffer which holds the latest data */
+    int CurrentCopy[NUM_MESH_BUFFERS];
+
+    /* *
+     * Range of vertices in each copy of each buffer which hasn't received
+     * the latest updates yet. Empty when StaleFirst >= StaleLast
+     * */
+    int StaleFirst[BGE_MESH_MAX_COPIES][NUM_MESH_BUFFERS];
+    int StaleLast[BGE_MESH_MAX_COPIES][NUM_MESH_BUFFERS];
+
     /*! @brief Default Mesh constructor.
      *
      * Default Mesh constructor.
      */
     Mesh();
 
+    /* Get the OpenGL handle of a given copy of a buffer */
+    GLuint GetBufferCopy(MESH_BUFFERS Buffer, int Copy) const;
+
+    /* *
+     * (Re)allocate every copy of a vertex buffer and fill it with the
+     * contents of its client-side data store
+     * */
+    Result AllocateBuffer(MESH_BUFFERS Buffer, int Components);
+
+    /* *
+     * Upload a range of vertices from a client-side data store into the
+     * next copy of a vertex buffer, and make that copy current
+     * */
+    Result UploadRange(MESH_BUFFERS Buffer, int Components, int First,
+                                                            int Count);
+
 
 public:
 
+    BGE_ALIGNED_NEW(16)
+
     /*! @brief Virtual Mesh destructor.
      *
      * Virtual Mesh destructor.
@@ -212,17 +292,48 @@ public:
 
     /*! @brief Deallocate the OpenGL vertex buffers that store Mesh data.
     *
-    * Deallocate the OpenGL vertex buffers that store Mesh data.
+    * Deallocate the OpenGL vertex buffers that store Mesh data. The usage
+    * hint goes back to static with a single copy.
     *
     * @return BGE_SUCCESS if vertex buffers were successfully deallocated;
     * BGE_FAILURE if any errors occurred.
     */
     Result ClearBuffers();
 
+    /*! @brief Set the usage hint and multi-buffering of the Mesh.
+     *
+     * Static meshes (the default) are uploaded once. Dynamic and stream
+     * meshes are expected to be updated often through UpdatePositions and
+     * friends. Keeping 2 or 3 copies of each vertex buffer lets updates
+     * write into a copy the GPU is done with instead of waiting for
+     * pending draws to finish. Must be called after CreateBuffers; any
+     * existing vertex data is re-uploaded with the new hint.
+     *
+     * @param[in] Hint How often the vertex data is expected to change.
+     * @param[in] Copies Number of copies of each vertex buffer, from 1 to
+     * BGE_MESH_MAX_COPIES.
+     *
+     * @return BGE_SUCCESS if the usage was successfully changed;
+     * BGE_FAILURE if any errors occurred.
+     */
+    Result SetUsage(MESH_USAGE Hint, int Copies);
+
+    /*! @brief Get the number of copies of each vertex buffer.
+     *
+     * Get the number of copies of each vertex buffer.
+     *
+     * @return Number of copies of each vertex buffer.
+     */
+    BGE_INL int GetNumCopies() const
+    {
+        return NumCopies;
+    }
+
     /*! @brief Set the contents of the Mesh's vertex position data store.
      *
      * Set the mesh's vertex position data. Data must be fed as an array of
-     * structs.
+     * structs. If the number of vertices is unchanged the existing buffers
+     * are updated in place instead of being reallocated.
      *
      * @param[in] NumPositions Number of vertices in the Mesh.
      * @param[in] Data Pointer to buffer holding vertex x, y and z positions.
@@ -271,6 +382,49 @@ public:
      */
     Result SetTexCoordData(int NumTexCoords, const Scalar* Data);
 
+    /*! @brief Update a range of the Mesh's vertex positions.
+     *
+     * Update a range of the Mesh's vertex positions without reallocating
+     * its buffers. Only the given range is uploaded.
+     *
+     * @param[in] First Index of the first vertex to update.
+     * @param[in] Count Number of vertices to update.
+     * @param[in] Data Pointer to buffer holding Count x, y and z positions.
+     *
+     * @return BGE_SUCCESS if the positions were successfully updated;
+     * BGE_FAILURE if any errors occurred or the range is out of bounds.
+     */
+    Result UpdatePositions(int First, int Count, const Scalar* Data);
+
+    /*! @brief Update a range of the Mesh's vertex normals.
+     *
+     * Update a range of the Mesh's vertex normals without reallocating its
+     * buffers. Only the given range is uploaded.
+     *
+     * @param[in] First Index of the first vertex to update.
+     * @param[in] Count Number of vertices to update.
+     * @param[in] Data Pointer to buffer holding Count x, y and z components.
+     *
+     * @return BGE_SUCCESS if the normals were successfully updated;
+     * BGE_FAILURE if any errors occurred or the range is out of bounds.
+     */
+    Result UpdateNormals(int First, int Count, const Scalar* Data);
+
+    /*! @brief Update a range of the Mesh's texture coordinates.
+     *
+     * Update a range of the Mesh's texture coordinates without reallocating
+     * its buffers. Only the given range is uploaded.
+     *
+     * @param[in] First Index of the first vertex to update.
+     * @param[in] Count Number of vertices to update.
+     * @param[in] Data Pointer to buffer holding Count x and y components.
+     *
+     * @return BGE_SUCCESS if the texture coordinates were successfully
+     * updated; BGE_FAILURE if any errors occurred or the range is out of
+     * bounds.
+     */
+    Result UpdateTexCoords(int First, int Count, const Scalar* Data);
+
     /*! @brief Get the Mesh's vertex position data.
      *
      * Get the Mesh's vertex position data. These positions are relative to
@@ -283,6 +437,21 @@ public:
         return Positions;
     }
 
+    /*! @brief Get the bounding box of the Mesh's vertex positions.
+     *
+     * Get the axis-aligned box bounding the Mesh's vertex positions,
+     * relative to the origin. SetPositionData computes it exactly;
+     * UpdatePositions only grows it, so it may be loose after positions
+     * move inwards.
+     *
+     * @return const reference to the bounding box. Empty if the Mesh has
+     * no positions.
+     */
+    BGE_INL AABB BGE_NCP GetBounds() const
+    {
+        return Bounds;
+    }
+
     /*! @brief Get the Mesh's vertex normal data.
      *
      * Get the Mesh's vertex normal data. Vertex normals are unit vectors
@@ -49,8 +49,6 @@ protected:
 
     Vector4 Position;
 
-    GLuint ModelMatrixBuffer;
-
     /*! @brief Default constructor.
      *
      * Default constructor.
@@ -60,6 +58,8 @@ protected:
 
 public:
 
+    BGE_ALIGNED_NEW(16)
+
     /*! @brief Pure-virtual destructor.
      *
      * Pure-virtual destructor.
@@ -78,9 +78,35 @@ public:
      * position.
      *
      * Set OpenGL state so objects are rendered from this node's position.
+     * The model transform is written to the shared InstanceBuffer.
      */
     virtual Result Bind() const;
 
+    /*! @brief Get the model transform objects are rendered with.
+     *
+     * Get the model transform objects bound to this node are rendered
+     * with. Sub-classes with more than a position override this, and Bind
+     * writes whatever it returns to the InstanceBuffer. The Renderer uses
+     * it to draw many nodes sharing a Mesh in one instanced draw.
+     *
+     * @param[out] Model Model transform of the node.
+     *
+     * @return BGE_SUCCESS if the node has a single model transform;
+     * BGE_FAILURE if it doesn't, like a Crowd, and must be bound to draw.
+     */
+    virtual Result GetModelTransform(Affine* Model) const;
+
+    /*! @brief Get the number of instances objects are drawn with.
+     *
+     * Get the number of instances of an object drawn at this node. Most
+     * nodes draw one; sub-classes holding many transforms, like a Crowd,
+     * draw one per transform. The Renderer uses it to draw nodes that must
+     * be bound to draw.
+     *
+     * @return Number of instances to draw.
+     */
+    virtual int GetNumInstances() const;
+
     /*! @brief Set OpenGL state so objects are rendered from the origin.
      *
      * Set OpenGL state so objects are rendered from the origin.
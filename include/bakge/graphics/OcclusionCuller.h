@@ -0,0 +1,275 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file OcclusionCuller.h
+ * @brief OcclusionCuller class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_OCCLUSIONCULLER_H
+#define BAKGE_GRAPHICS_OCCLUSIONCULLER_H
+
+#include <bakge/Bakge.h>
+
+/* Most levels the depth pyramid can have */
+#define BGE_OCCLUSION_MAX_LEVELS 12
+
+/* Most threads Render spreads rasterization over */
+#define BGE_OCCLUSION_MAX_THREADS 16
+
+namespace bakge
+{
+
+/*! @brief CPU software occlusion culler.
+ *
+ * An OcclusionCuller rasterizes designated occluder meshes into a small
+ * depth buffer on the CPU, then tests bounding boxes against it to find
+ * objects hidden behind the occluders. Nothing touches OpenGL, so it runs
+ * headless and gives the same results for the same scene on any machine.
+ *
+ * Rasterization is split into horizontal bands, one per thread, and fills
+ * four pixels at a time with SIMD where available. Every pixel keeps the
+ * nearest occluder depth, so the result doesn't depend on the order
+ * triangles are drawn in. Rasterization is conservative: an occluder only
+ * writes pixels it covers entirely, at the farthest depth it has inside
+ * them, so a box showing past an occluder's outline by a fraction of a
+ * pixel is still found visible. Where two triangles of an occluder meet
+ * side by side on screen, the pixels along their shared edge are split
+ * between them as usual, so meshes don't leave gaps along inner edges.
+ *
+ * A depth pyramid is then built, each level holding the farthest depth of
+ * four texels below, so a box is tested against a handful of texels
+ * whatever its size on screen. A box is occluded when its nearest point is
+ * behind the farthest occluder depth everywhere it covers.
+ *
+ * Occluder triangles crossing the near plane are skipped and boxes
+ * crossing it are always visible, so culling errs on the visible side.
+ * The Renderer tests draws that survive frustum culling against an
+ * OcclusionCuller set with Renderer::SetOcclusionCuller.
+ */
+class BGE_API OcclusionCuller
+{
+    struct Occluder
+    {
+        int NumVertices;
+        const Scalar* Positions;
+        int NumTriangles;
+        const int* Indices;
+
+        /* Offset of the triangles' entries in Opposites */
+        int FirstEdge;
+    };
+
+    /* Work for one thread of rasterization */
+    struct RasterJob
+    {
+        OcclusionCuller* Culler;
+        int FirstRow;
+        int EndRow;
+    };
+
+    int Width;
+    int Height;
+
+    /* Level 0 is the depth buffer; each level above is half the size */
+    int NumLevels;
+    int LevelWidths[BGE_OCCLUSION_MAX_LEVELS];
+    int LevelHeights[BGE_OCCLUSION_MAX_LEVELS];
+    Scalar* Levels[BGE_OCCLUSION_MAX_LEVELS];
+
+    Occluder* Occluders;
+    Affine* OccluderModels;
+    int NumOccluders;
+    int OccluderCapacity;
+
+    /* *
+     * For every triangle corner, the vertex of the triangle sharing the
+     * opposite edge; -1 if the edge is on the mesh's boundary
+     * */
+    int* Opposites;
+    int NumOpposites;
+    int OppositeCapacity;
+
+    /* Screen x, y, depth and a valid flag for every occluder vertex */
+    Scalar* ScreenVertices;
+    int ScreenCapacity;
+
+    Matrix ViewProjection;
+
+    OcclusionCuller();
+
+    /* Find the triangles sharing each edge of an occluder */
+    Result FindOpposites(Occluder* O);
+
+    /* Project every occluder vertex to the screen */
+    Result ProjectOccluders();
+
+    /* *
+     * Rasterize every occluder triangle into rows [FirstRow, EndRow),
+     * writing only pixels the occluder covers entirely
+     * */
+    void RasterizeRows(int FirstRow, int EndRow);
+
+    void BuildPyramid();
+
+    static int RasterEntry(void* Data);
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief OcclusionCuller destructor.
+     *
+     * OcclusionCuller destructor.
+     */
+    ~OcclusionCuller();
+
+    /*! @brief Create an OcclusionCuller with a depth buffer of a given size.
+     *
+     * Create an OcclusionCuller with a depth buffer of a given size. Low
+     * resolutions such as 256x128 are plenty for culling. The width is
+     * rounded up to a multiple of 4.
+     *
+     * @param[in] BufferWidth Width of the depth buffer in pixels.
+     * @param[in] BufferHeight Height of the depth buffer in pixels.
+     *
+     * @return Pointer to allocated OcclusionCuller; NULL if any errors
+     * occurred.
+     */
+    BGE_FACTORY OcclusionCuller* Create(int BufferWidth, int BufferHeight);
+
+    /*! @brief Remove every occluder.
+     *
+     * Remove every occluder, typically at the start of a frame.
+     *
+     * @return BGE_SUCCESS.
+     */
+    Result ClearOccluders();
+
+    /*! @brief Add an occluder mesh.
+     *
+     * Add a Mesh as an occluder, at a model transform. Large, simple,
+     * closed meshes such as walls and buildings make the best occluders.
+     * The Mesh must stay alive until Render.
+     *
+     * @param[in] Geometry Mesh to rasterize.
+     * @param[in] Model Model transform of the Mesh.
+     *
+     * @return BGE_SUCCESS if the occluder was added; BGE_FAILURE if the
+     * Mesh has no position or index data or any other errors occurred.
+     */
+    Result AddOccluder(const Mesh* Geometry, Affine BGE_NCP Model);
+
+    /*! @brief Add occluder triangles.
+     *
+     * Add indexed triangles as an occluder, at a model transform. The data
+     * is not copied and must stay alive until Render.
+     *
+     * @param[in] NumVertices Number of vertices.
+     * @param[in] Positions Packed xyz vertex positions, 3 * NumVertices
+     * scalars.
+     * @param[in] NumTriangles Number of triangles.
+     * @param[in] Indices Vertex indices, 3 * NumTriangles ints.
+     * @param[in] Model Model transform of the triangles.
+     *
+     * @return BGE_SUCCESS if the occluder was added; BGE_FAILURE if any
+     * arguments are invalid or any other errors occurred.
+     */
+    Result AddOccluder(int NumVertices, const Scalar* Positions,
+                    int NumTriangles, const int* Indices,
+                                        Affine BGE_NCP Model);
+
+    /*! @brief Rasterize the occluders and build the depth pyramid.
+     *
+     * Rasterize every occluder as seen through a view-projection
+     * transform, then build the depth pyramid boxes are tested against.
+     *
+     * @param[in] ViewProj View-projection transform to render with, such as
+     * Camera3D::GetViewProjection.
+     * @param[in] NumThreads Number of threads to rasterize with; 1 to
+     * rasterize on the calling thread only.
+     *
+     * @return BGE_SUCCESS if the occluders were rendered; BGE_FAILURE if
+     * any errors occurred.
+     */
+    Result Render(Matrix BGE_NCP ViewProj, int NumThreads);
+
+    /*! @brief Check if a box may be visible past the occluders.
+     *
+     * Check if a world-space box may be visible past the occluders drawn
+     * by the last Render.
+     *
+     * @param[in] Bounds Box to test.
+     *
+     * @return false if the box is certainly hidden; true otherwise.
+     */
+    bool IsVisible(AABB BGE_NCP Bounds) const;
+
+    /*! @brief Test SoA boxes against the occluders.
+     *
+     * Test SoA boxes, laid out as for CullBoxesSoA, against the occluders.
+     * Only boxes whose bit in Visible is set are tested, and the bits of
+     * hidden boxes are cleared, so the result of frustum culling can be
+     * refined in place.
+     *
+     * @param[in] Boxes Boxes to test.
+     * @param[in] Count Number of boxes.
+     * @param[in,out] Visible Visibility bitmask.
+     *
+     * @return Number of boxes found hidden.
+     */
+    int TestBoxesSoA(const Scalar* Boxes, int Count, uint32* Visible) const;
+
+    /*! @brief Get the width of the depth buffer.
+     *
+     * Get the width of the depth buffer in pixels.
+     *
+     * @return Width of the depth buffer.
+     */
+    int GetWidth() const;
+
+    /*! @brief Get the height of the depth buffer.
+     *
+     * Get the height of the depth buffer in pixels.
+     *
+     * @return Height of the depth buffer.
+     */
+    int GetHeight() const;
+
+    /*! @brief Get the depth buffer.
+     *
+     * Get the depth buffer from the last Render, row by row from the bottom
+     * of the screen. Depths range from 0 at the near plane to 1 at the far
+     * plane, which is also the depth of pixels no occluder covers.
+     *
+     * @return Pointer to Width * Height depths. Do not free this pointer.
+     */
+    const Scalar* GetDepthBuffer() const;
+
+}; /* OcclusionCuller */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_OCCLUSIONCULLER_H */
@@ -73,15 +73,16 @@ public:
      */
     BGE_FACTORY Pawn* Create();
 
-    /*! @brief Set OpenGL state so objects are rendered in this Pawn's
-     * orientation.
+    /*! @brief Get the model transform objects are rendered with.
      *
-     * Set OpenGL state so objects are rendered in this Pawn's orientation.
+     * Get the Pawn's model transform, composed of its scale, rotation and
+     * position. Binding the Pawn renders objects in this transform.
      *
-     * @return BGE_SUCCESS if the Pawn was successfully bound; BGE_FAILURE if
-     * any errors occurred.
+     * @param[out] Model Model transform of the Pawn.
+     *
+     * @return BGE_SUCCESS.
      */
-    virtual Result Bind() const;
+    virtual Result GetModelTransform(Affine* Model) const;
 
     /*! @brief Set OpenGL state to arbitrary defaults, preventing this Pawn's
      * orientation from being used to render objects.
@@ -125,10 +126,8 @@ public:
      * @param[in] Rotation Quaternion representing new rotation for the Pawn.
      *
      * @return constref to Pawn's rotation, after assignment.
-     *
-     * @todo Pass Rotation as a constref to prevent copy.
      */
-    Quaternion BGE_NCP SetRotation(Quaternion Rotation);
+    Quaternion BGE_NCP SetRotation(Quaternion BGE_NCP Rotation);
 
     /*! @brief Get the Pawns' Quaternion rotation.
      *
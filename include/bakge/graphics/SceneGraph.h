@@ -0,0 +1,259 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file SceneGraph.h
+ * @brief SceneGraph class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_SCENEGRAPH_H
+#define BAKGE_GRAPHICS_SCENEGRAPH_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Hierarchy of transforms with world transforms kept up to date.
+ *
+ * A SceneGraph holds a forest of nodes, each with a local transform
+ * relative to its parent. Nodes are stored in depth-first order in
+ * contiguous arrays with parent indices, so a parent always precedes its
+ * children and every subtree occupies a contiguous range. Update computes
+ * world transforms in a single linear pass, skipping subtrees in which
+ * nothing changed, so static hierarchies cost next to nothing per frame.
+ * Separate roots don't depend on each other and can be updated in
+ * parallel.
+ *
+ * Nodes are referred to by handles, which stay valid while nodes are
+ * added and removed around them. Adding a node to the end of the last
+ * subtree is cheap; inserting anywhere else moves the nodes after it.
+ */
+class BGE_API SceneGraph
+{
+    /* Work for one thread of a parallel update */
+    struct UpdateJob
+    {
+        SceneGraph* Graph;
+        int First;
+        int End;
+    };
+
+    int NumNodes;
+    int Capacity;
+
+    /* Indexed by slot, in depth-first order */
+    int* Parents;
+    int* SubtreeSizes;
+    int* SlotHandles;
+    bool* Dirty;
+    bool* DescendantDirty;
+    Affine* Locals;
+    Affine* Worlds;
+
+    /* Indexed by handle; -1 for free handles */
+    int* HandleSlots;
+    int* FreeHandles;
+    int NumFreeHandles;
+
+    SceneGraph();
+
+    Result Reserve(int NewCapacity);
+
+    /* Flag a slot and let its ancestors know to descend to it */
+    void MarkDirty(int Slot);
+
+    /* Update world transforms of the subtrees in [First, End) */
+    void UpdateRange(int First, int End);
+
+    static int UpdateEntry(void* Data);
+
+    int GetSlot(int Handle) const;
+
+
+public:
+
+    /*! @brief SceneGraph destructor.
+     *
+     * SceneGraph destructor.
+     */
+    ~SceneGraph();
+
+    /*! @brief Create an empty SceneGraph.
+     *
+     * Create an empty SceneGraph with room for a number of nodes. The
+     * SceneGraph grows as needed.
+     *
+     * @param[in] ReserveNodes Number of nodes to make room for.
+     *
+     * @return Pointer to allocated SceneGraph; NULL if any errors occurred.
+     */
+    BGE_FACTORY SceneGraph* Create(int ReserveNodes);
+
+    /*! @brief Add a node to the SceneGraph.
+     *
+     * Add a node as the last child of a parent node, or as the last root
+     * if Parent is -1.
+     *
+     * @param[in] Parent Handle of the parent node; -1 to add a root.
+     * @param[in] Local Transform of the node relative to its parent.
+     *
+     * @return Handle of the new node; -1 if any errors occurred.
+     */
+    int AddNode(int Parent, Affine BGE_NCP Local);
+
+    /*! @brief Remove a node and all of its descendants.
+     *
+     * Remove a node and all of its descendants. Their handles become free
+     * for reuse.
+     *
+     * @param[in] Handle Node to remove.
+     *
+     * @return BGE_SUCCESS if the nodes were removed; BGE_FAILURE if the
+     * handle is invalid.
+     */
+    Result RemoveNode(int Handle);
+
+    /*! @brief Set the transform of a node relative to its parent.
+     *
+     * Set the transform of a node relative to its parent. The world
+     * transforms of the node and its descendants are recomputed on the
+     * next Update.
+     *
+     * @param[in] Handle Node to modify.
+     * @param[in] Local New local transform.
+     *
+     * @return BGE_SUCCESS if the transform was set; BGE_FAILURE if the
+     * handle is invalid.
+     */
+    Result SetLocal(int Handle, Affine BGE_NCP Local);
+
+    /*! @brief Set the transform of a node relative to its parent.
+     *
+     * Set the transform of a node relative to its parent from a position,
+     * rotation and scale, as used by Pawns.
+     *
+     * @param[in] Handle Node to modify.
+     * @param[in] Position Position relative to the parent.
+     * @param[in] Rotation Rotation relative to the parent.
+     * @param[in] Scale Scale along each local axis.
+     *
+     * @return BGE_SUCCESS if the transform was set; BGE_FAILURE if the
+     * handle is invalid.
+     */
+    Result SetLocal(int Handle, Vector4 BGE_NCP Position,
+                Quaternion BGE_NCP Rotation, Vector4 BGE_NCP Scale);
+
+    /*! @brief Get the transform of a node relative to its parent.
+     *
+     * Get the transform of a node relative to its parent.
+     *
+     * @param[in] Handle Node to query.
+     *
+     * @return const reference to the local transform; the identity
+     * transform if the handle is invalid.
+     */
+    Affine BGE_NCP GetLocal(int Handle) const;
+
+    /*! @brief Get the world transform of a node.
+     *
+     * Get the world transform of a node, as of the last Update.
+     *
+     * @param[in] Handle Node to query.
+     *
+     * @return const reference to the world transform; the identity
+     * transform if the handle is invalid.
+     */
+    Affine BGE_NCP GetWorld(int Handle) const;
+
+    /*! @brief Check if a handle refers to a node in the SceneGraph.
+     *
+     * Check if a handle refers to a node in the SceneGraph. Handles of
+     * removed nodes are invalid until they are reused.
+     *
+     * @param[in] Handle Handle to check.
+     *
+     * @return true if the handle is valid; false otherwise.
+     */
+    bool IsValid(int Handle) const;
+
+    /*! @brief Get the parent of a node.
+     *
+     * Get the parent of a node.
+     *
+     * @param[in] Handle Node to query.
+     *
+     * @return Handle of the parent; -1 if the node is a root or the handle
+     * is invalid.
+     */
+    int GetParent(int Handle) const;
+
+    /*! @brief Get the number of nodes in the SceneGraph.
+     *
+     * Get the number of nodes in the SceneGraph.
+     *
+     * @return Number of nodes.
+     */
+    int GetNumNodes() const;
+
+    /*! @brief Recompute world transforms of changed nodes.
+     *
+     * Recompute the world transforms of nodes whose local transform, or
+     * that of an ancestor, changed since the last Update.
+     *
+     * @return BGE_SUCCESS if the world transforms were updated.
+     */
+    Result Update();
+
+    /*! @brief Recompute world transforms of changed nodes in parallel.
+     *
+     * Recompute world transforms like Update, spreading the roots over a
+     * number of threads. Worth it only for large hierarchies; the threads
+     * are created for each call.
+     *
+     * @param[in] NumThreads Number of threads to use.
+     *
+     * @return BGE_SUCCESS if the world transforms were updated; BGE_FAILURE
+     * if any threads couldn't be created. The update is then finished on
+     * the calling thread.
+     */
+    Result Update(int NumThreads);
+
+    /*! @brief Bind the world transform of a node for drawing.
+     *
+     * Write the world transform of a node to the InstanceBuffer and bind
+     * it to bge_Model, like binding a Pawn.
+     *
+     * @param[in] Handle Node to bind.
+     *
+     * @return BGE_SUCCESS if the transform was bound; BGE_FAILURE if the
+     * handle is invalid or any errors occurred.
+     */
+    Result Bind(int Handle) const;
+
+}; /* SceneGraph */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_SCENEGRAPH_H */
@@ -36,15 +36,56 @@
 #define BGE_PROJECTION_UNIFORM "bge_Projection"
 #define BGE_DIFFUSE_UNIFORM "bge_Diffuse"
 #define BGE_CROWD_UNIFORM "bge_Crowd"
+#define BGE_VIEWPROJECTION_UNIFORM "bge_ViewProjection"
+#define BGE_CAMERA_POSITION_UNIFORM "bge_CameraPosition"
+#define BGE_TIME_UNIFORM "bge_Time"
+
+#define BGE_FRAME_BLOCK "bge_FrameData"
 
 #define BGE_MODEL_ATTRIBUTE "bge_Model"
 #define BGE_VERTEX_ATTRIBUTE "bge_Vertex"
 #define BGE_NORMAL_ATTRIBUTE "bge_Normal"
 #define BGE_TEXCOORD_ATTRIBUTE "bge_TexCoord"
 
+/* Directory in the PhysFS write directory holding cached program binaries */
+#define BGE_SHADER_CACHE_DIR "shadercache"
+
 namespace bakge
 {
 
+class ShaderHandle;
+
+/*! @brief Attribute variables every Shader is linked with.
+ *
+ * Attribute variables every Shader is linked with. Their locations are
+ * resolved once when the Shader is linked.
+ */
+enum SHADER_ATTRIBUTE
+{
+    SHADER_ATTRIBUTE_MODEL = 0,
+    SHADER_ATTRIBUTE_VERTEX,
+    SHADER_ATTRIBUTE_NORMAL,
+    SHADER_ATTRIBUTE_TEXCOORD,
+    NUM_SHADER_ATTRIBUTES
+};
+
+/*! @brief Uniform variables every Shader is linked with.
+ *
+ * Uniform variables every Shader is linked with. Their locations are
+ * resolved once when the Shader is linked.
+ */
+enum SHADER_UNIFORM
+{
+    SHADER_UNIFORM_VIEW = 0,
+    SHADER_UNIFORM_PROJECTION,
+    SHADER_UNIFORM_DIFFUSE,
+    SHADER_UNIFORM_CROWD,
+    SHADER_UNIFORM_VIEWPROJECTION,
+    SHADER_UNIFORM_CAMERA_POSITION,
+    SHADER_UNIFORM_TIME,
+    NUM_SHADER_UNIFORMS
+};
+
 /*! @brief GLSL shader wrapper class.
  *
  * Bakge uses shaders for all rendering. When binding and drawing with any
@@ -59,29 +100,111 @@ namespace bakge
 class BGE_API Shader : public Bindable
 {
     static Shader* GenericShader;
+    static const Shader* Current;
     static GLuint VertexLib;
     static GLuint FragmentLib;
     friend Window* Window::Create(int, int, int);
 
+    static bool LibraryCompiled;
+
     static Result InitShaderLibrary();
     static Result DeinitShaderLibrary();
+
+    /* *
+     * Compile the library shaders. Deferred until a program actually has
+     * to be built from source, so a warm binary cache skips it entirely
+     * */
+    static Result CompileShaderLibrary();
     friend BGE_API Result Init(int, char*[]);
     friend BGE_API Result Deinit();
+    friend class ShaderHandle;
+    friend class FrameUniforms;
 
     GLuint Vertex;
     GLuint Fragment;
     GLuint Program;
 
+    /* Hash of the sources; key of the program binary cache */
+    uint64 SourceKey;
+
+    /* *
+     * An active attribute or uniform of the linked program. Uniforms keep
+     * a shadow copy of the last value uploaded through SetUniform so
+     * redundant glUniform* calls can be skipped
+     * */
+    struct ShaderVariable
+    {
+        char* Name;
+        GLint Location;
+        GLenum Type;
+        GLint Size;
+        int ShadowBytes;
+        GLubyte* Shadow;
+        bool ShadowValid;
+    };
+
+    int NumAttributes;
+    ShaderVariable* Attributes;
+    int NumUniforms;
+    ShaderVariable* Uniforms;
+
+    GLint AttributeLocations[NUM_SHADER_ATTRIBUTES];
+    GLint UniformLocations[NUM_SHADER_UNIFORMS];
+
+    /* Whether the program reads frame data from the shared uniform block */
+    bool FrameBlock;
+
+    /* *
+     * Building a program is split in two. Submit creates the program and
+     * either loads it from the binary cache or issues the compiles and
+     * the link. Finish waits for and checks the results. Returns NULL if
+     * any GL objects couldn't be created
+     * */
+    static Shader* Submit(int NumVertex, int NumFragment,
+                                const char** VertexShaders,
+                                const char** FragmentShaders,
+                                const char* Keywords);
+    Result Finish();
+
     Result Link();
+    Result CheckLink();
     Result Unlink();
     Result DeleteShaders();
     Result DeleteProgram();
 
+    /* *
+     * Build the attribute and uniform tables from the linked program.
+     * Called once after a successful link
+     * */
+    Result ResolveVariables();
+    Result ClearVariables();
+
+    /* *
+     * Compare a value about to be uploaded with the shadow copy of the
+     * uniform at Location and update it. Type is the GL type the upload
+     * is made as. Returns false if the upload is redundant and can be
+     * skipped
+     * */
+    bool UpdateShadow(GLint Location, GLenum Type, const void* Data) const;
+
+    /* *
+     * Program binary cache. Linked programs are stored in the PhysFS write
+     * directory, keyed by a hash of every source string that goes into
+     * them and the GL vendor, renderer and version strings
+     * */
+    static uint64 HashSources(int NumVertex, int NumFragment,
+                                    const char** VertexShaders,
+                                    const char** FragmentShaders,
+                                    const char* Defines);
+    static Result LoadBinary(uint64 Key, GLuint Handle);
+    static Result SaveBinary(uint64 Key, GLuint Handle);
+
     /* *
      * Compile a shader and report any errors or warnings
      * Returns BGE_FAILURE if compilation failed
      * */
     static Result Compile(GLuint Handle);
+    static Result CheckCompile(GLuint Handle);
 
 
 public:
@@ -119,6 +242,76 @@ public:
                                             const char** VertexShaders,
                                             const char** FragmentShaders);
 
+    /*! @brief Create a shader variant using a variable number of
+     * null-terminated source strings and a list of keywords.
+     *
+     * Same as the other LoadFromStrings, but each keyword is defined with
+     * a #define line placed after the Bakge "header files" and before the
+     * given sources. Keywords are separated by whitespace or commas; a
+     * keyword of the form NAME=VALUE defines NAME as VALUE. Use
+     * ShaderVariants to share and cache variants of the same sources.
+     *
+     * @param[in] NumVertex Number of vertex shader source strings.
+     * @param[in] NumFragment Number of fragment shader source strings.
+     * @param[in] VertexShaders Array of null-terminated vertex shader source
+     *            strings.
+     * @param[in] FragmentShaders Array of null-terminated fragment shader
+     *            source strings.
+     * @param[in] Keywords Null-terminated list of keywords to define; may
+     *            be NULL.
+     *
+     * @return Pointer to allocated Shader; NULL if any errors occurred.
+     */
+    BGE_FACTORY Shader* LoadFromStrings(int NumVertex, int NumFragment,
+                                            const char** VertexShaders,
+                                            const char** FragmentShaders,
+                                            const char* Keywords);
+
+    /*! @brief Queue a shader to be built on a background thread.
+     *
+     * Queue a shader to be built on a background thread that owns a GL
+     * context shared with every Window. The returned handle binds the
+     * generic Shader until the real one is ready. The source strings are
+     * copied, so they needn't outlive this call.
+     *
+     * @param[in] NumVertex Number of vertex shader source strings.
+     * @param[in] NumFragment Number of fragment shader source strings.
+     * @param[in] VertexShaders Array of null-terminated vertex shader source
+     *            strings.
+     * @param[in] FragmentShaders Array of null-terminated fragment shader
+     *            source strings.
+     *
+     * @return Pointer to allocated ShaderHandle; NULL if the background
+     * compiler couldn't be started.
+     */
+    BGE_FACTORY ShaderHandle* LoadFromStringsAsync(int NumVertex,
+                                                int NumFragment,
+                                        const char** VertexShaders,
+                                        const char** FragmentShaders);
+
+    /*! @brief Queue a shader variant to be built on a background thread.
+     *
+     * Same as the other LoadFromStringsAsync, with a list of keywords to
+     * define as in LoadFromStrings.
+     *
+     * @param[in] NumVertex Number of vertex shader source strings.
+     * @param[in] NumFragment Number of fragment shader source strings.
+     * @param[in] VertexShaders Array of null-terminated vertex shader source
+     *            strings.
+     * @param[in] FragmentShaders Array of null-terminated fragment shader
+     *            source strings.
+     * @param[in] Keywords Null-terminated list of keywords to define; may
+     *            be NULL.
+     *
+     * @return Pointer to allocated ShaderHandle; NULL if the background
+     * compiler couldn't be started.
+     */
+    BGE_FACTORY ShaderHandle* LoadFromStringsAsync(int NumVertex,
+                                                int NumFragment,
+                                        const char** VertexShaders,
+                                        const char** FragmentShaders,
+                                        const char* Keywords);
+
     /*! @brief Bind the GLSL shader as the current shader program.
      *
      * Bind the GLSL shader as the current shader program. Sets various
@@ -140,6 +333,136 @@ public:
      */
     Result Unbind() const;
 
+    /*! @brief Get the Shader that was most recently bound.
+     *
+     * Get the Shader that was most recently bound. Classes which set
+     * attributes or uniforms during their own Bind use this instead of
+     * querying the current program from OpenGL.
+     *
+     * @return Pointer to the current Shader; NULL if no Shader is bound.
+     */
+    static const Shader* GetCurrent();
+
+    /*! @brief Get the location of one of the Bakge attribute variables.
+     *
+     * Get the location of one of the Bakge attribute variables. The
+     * location was resolved when the Shader was linked.
+     *
+     * @param[in] Attribute Attribute variable to look up.
+     *
+     * @return Location of the attribute; -1 if it is not active.
+     */
+    GLint GetAttributeLocation(SHADER_ATTRIBUTE Attribute) const;
+
+    /*! @brief Get the location of an attribute variable by name.
+     *
+     * Get the location of an attribute variable by name. Searches the
+     * table of active attributes built when the Shader was linked.
+     *
+     * @param[in] Name Null-terminated name of the attribute.
+     *
+     * @return Location of the attribute; -1 if it is not active.
+     */
+    GLint GetAttributeLocation(const char* Name) const;
+
+    /*! @brief Get the location of one of the Bakge uniform variables.
+     *
+     * Get the location of one of the Bakge uniform variables. The
+     * location was resolved when the Shader was linked.
+     *
+     * @param[in] Uniform Uniform variable to look up.
+     *
+     * @return Location of the uniform; -1 if it is not active.
+     */
+    GLint GetUniformLocation(SHADER_UNIFORM Uniform) const;
+
+    /*! @brief Get the location of a uniform variable by name.
+     *
+     * Get the location of a uniform variable by name. Searches the table
+     * of active uniforms built when the Shader was linked. Array uniforms
+     * may be looked up with or without the trailing "[0]".
+     *
+     * @param[in] Name Null-terminated name of the uniform.
+     *
+     * @return Location of the uniform; -1 if it is not active.
+     */
+    GLint GetUniformLocation(const char* Name) const;
+
+    /*! @brief Set an int or sampler uniform of this Shader.
+     *
+     * Set an int or sampler uniform of this Shader. The Shader must be
+     * the current Shader. The upload is skipped if the uniform already
+     * holds this value.
+     *
+     * @param[in] Location Location of the uniform.
+     * @param[in] Value New value of the uniform.
+     *
+     * @return BGE_SUCCESS if the uniform holds the value; BGE_FAILURE if
+     * the Shader is not current or the location is invalid.
+     */
+    Result SetUniform(GLint Location, int Value) const;
+
+    /*! @brief Set a float uniform of this Shader.
+     *
+     * Set a float uniform of this Shader. The Shader must be the current
+     * Shader. The upload is skipped if the uniform already holds this value.
+     *
+     * @param[in] Location Location of the uniform.
+     * @param[in] Value New value of the uniform.
+     *
+     * @return BGE_SUCCESS if the uniform holds the value; BGE_FAILURE if
+     * the Shader is not current or the location is invalid.
+     */
+    Result SetUniform(GLint Location, Scalar Value) const;
+
+    /*! @brief Set a vec4 uniform of this Shader.
+     *
+     * Set a vec4 uniform of this Shader. The Shader must be the current
+     * Shader. The upload is skipped if the uniform already holds this value.
+     *
+     * @param[in] Location Location of the uniform.
+     * @param[in] Value New value of the uniform.
+     *
+     * @return BGE_SUCCESS if the uniform holds the value; BGE_FAILURE if
+     * the Shader is not current or the location is invalid.
+     */
+    Result SetUniform(GLint Location, Vector4 BGE_NCP Value) const;
+
+    /*! @brief Set a mat4 uniform of this Shader.
+     *
+     * Set a mat4 uniform of this Shader. The Shader must be the current
+     * Shader. The upload is skipped if the uniform already holds this value.
+     *
+     * @param[in] Location Location of the uniform.
+     * @param[in] Value New value of the uniform.
+     *
+     * @return BGE_SUCCESS if the uniform holds the value; BGE_FAILURE if
+     * the Shader is not current or the location is invalid.
+     */
+    Result SetUniform(GLint Location, Matrix BGE_NCP Value) const;
+
+    /*! @brief Forget the shadowed values of all uniforms.
+     *
+     * Forget the shadowed values of all uniforms, so the next SetUniform
+     * call for each of them is uploaded. Call this after setting uniforms
+     * of this Shader directly through OpenGL.
+     *
+     * @return BGE_SUCCESS if the shadow copies were discarded; BGE_FAILURE
+     * if the Shader has no linked program.
+     */
+    Result InvalidateUniforms() const;
+
+    /*! @brief Check if the Shader reads frame data from a uniform buffer.
+     *
+     * Check if the Shader reads the per-frame camera and time data from the
+     * buffer shared by every program. If not, the data is set as plain
+     * uniforms whenever the Shader is bound.
+     *
+     * @return true if the Shader uses the frame uniform block; false if it
+     * uses plain uniforms.
+     */
+    bool UsesFrameBlock() const;
+
 }; /* Shader */
 
 } /* bakge */
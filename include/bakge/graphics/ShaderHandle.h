@@ -0,0 +1,159 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file ShaderHandle.h
+ * @brief ShaderHandle class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_SHADERHANDLE_H
+#define BAKGE_GRAPHICS_SHADERHANDLE_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Handle to a Shader being built on a background thread.
+ *
+ * Returned by Shader::LoadFromStringsAsync. Compiling and linking runs on
+ * a background thread owning a GL context shared with every Window, so
+ * level loads don't stall on shader compiles. Where the driver supports
+ * GL_KHR_parallel_shader_compile the thread issues every queued program
+ * before waiting on any of them, letting the driver build them in
+ * parallel.
+ *
+ * Until the Shader is ready, binding the handle binds the generic Shader
+ * instead so objects still render.
+ */
+class BGE_API ShaderHandle : public Bindable
+{
+    friend class Shader;
+
+    /* Background compiler shared by every handle */
+    static Mutex* QueueLock;
+    static Thread* Worker;
+    static GLFWwindow* WorkerContext;
+    static ShaderHandle* QueueHead;
+    static ShaderHandle* QueueTail;
+    static bool WorkerRunning;
+    static bool ParallelCompile;
+
+    /* Create the queue and context; the thread runs only while needed */
+    static Result StartCompiler();
+    static Result WakeCompiler();
+    static Result StopCompiler();
+    static int CompilerEntry(void* Data);
+
+    /* Whether the driver is done building a submitted program */
+    static bool IsBuilt(Shader* Program);
+
+    static ShaderHandle* Enqueue(int NumVertex, int NumFragment,
+                                    const char** VertexShaders,
+                                    const char** FragmentShaders,
+                                    const char* Keywords);
+
+    ShaderHandle* Next;
+
+    int NumVertex;
+    int NumFragment;
+    char** VertexSources;
+    char** FragmentSources;
+    char* Keywords;
+
+    /* Written by the compiler thread, guarded by QueueLock */
+    Shader* Program;
+    bool Done;
+
+    ShaderHandle();
+
+
+public:
+
+    /*! @brief ShaderHandle destructor.
+     *
+     * ShaderHandle destructor. Waits for the Shader to finish building,
+     * then deletes it.
+     */
+    ~ShaderHandle();
+
+    /*! @brief Check if the Shader has finished building.
+     *
+     * Check if the Shader has finished building, successfully or not.
+     *
+     * @return true if building is over; false if it is still queued or
+     * being built.
+     */
+    bool IsReady() const;
+
+    /*! @brief Check if the Shader failed to build.
+     *
+     * Check if the Shader failed to build.
+     *
+     * @return true if building is over and failed; false otherwise.
+     */
+    bool IsFailed() const;
+
+    /*! @brief Get the built Shader.
+     *
+     * Get the built Shader. It remains owned by the handle.
+     *
+     * @return Pointer to the Shader; NULL if it isn't ready or failed to
+     * build.
+     */
+    Shader* GetShader() const;
+
+    /*! @brief Block until the Shader has finished building.
+     *
+     * Block until the Shader has finished building.
+     *
+     * @return BGE_SUCCESS if the Shader was built; BGE_FAILURE if it failed
+     * to build.
+     */
+    Result Wait() const;
+
+    /*! @brief Bind the Shader, or the generic Shader if it isn't ready.
+     *
+     * Bind the Shader, or the generic Shader if it isn't ready or failed
+     * to build.
+     *
+     * @return BGE_SUCCESS if a Shader was successfully bound; BGE_FAILURE
+     * if any errors occurred.
+     */
+    Result Bind() const;
+
+    /*! @brief Unbind the Shader and bind the generic Shader in its place.
+     *
+     * Unbind the Shader and bind the generic Shader in its place.
+     *
+     * @return BGE_SUCCESS if the generic Shader was successfully bound;
+     * BGE_FAILURE if any errors occurred.
+     */
+    Result Unbind() const;
+
+}; /* ShaderHandle */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_SHADERHANDLE_H */
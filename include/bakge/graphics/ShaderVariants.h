@@ -0,0 +1,153 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file ShaderVariants.h
+ * @brief ShaderVariants class declaration.
+ */
+
+#ifndef BAKGE_GRAPHICS_SHADERVARIANTS_H
+#define BAKGE_GRAPHICS_SHADERVARIANTS_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Set of Shader variants built from one pair of base sources.
+ *
+ * Instead of keeping near-identical copies of a shader for every feature
+ * combination (instanced or not, textured or not, skinned...), write the
+ * sources once with #ifdef blocks and ask a ShaderVariants for the Shader
+ * matching a set of keywords. Each keyword is defined with a #define line
+ * placed right after the Bakge "header files".
+ *
+ * Keyword sets are normalized (sorted, duplicates removed) and hashed, so
+ * "TEXTURED SKINNED" and "SKINNED,TEXTURED" share one program. Variants
+ * are compiled lazily the first time they are requested, or up front from
+ * a manifest listing one keyword set per line.
+ */
+class BGE_API ShaderVariants
+{
+    struct Variant
+    {
+        uint64 Key;
+        char* Keywords;
+        Shader* Program;
+    };
+
+    char* VertexSource;
+    char* FragmentSource;
+
+    int NumVariants;
+    int Capacity;
+    Variant* Variants;
+
+    ShaderVariants();
+
+    /* *
+     * Find the variant with the given key and normalized keywords.
+     * Returns NULL if it hasn't been requested yet
+     * */
+    Variant* FindVariant(uint64 Key, const char* Keywords) const;
+
+
+public:
+
+    /*! @brief ShaderVariants destructor.
+     *
+     * ShaderVariants destructor. Deletes every compiled variant.
+     */
+    ~ShaderVariants();
+
+    /*! @brief Create a set of variants of a vertex and fragment source.
+     *
+     * Create a set of variants of a vertex and fragment source. The sources
+     * are copied. Nothing is compiled until a variant is requested.
+     *
+     * @param[in] VertexSource Null-terminated vertex shader source.
+     * @param[in] FragmentSource Null-terminated fragment shader source.
+     *
+     * @return Pointer to allocated ShaderVariants; NULL if any errors
+     * occurred.
+     */
+    BGE_FACTORY ShaderVariants* Create(const char* VertexSource,
+                                        const char* FragmentSource);
+
+    /*! @brief Get the Shader for a set of keywords.
+     *
+     * Get the Shader for a set of keywords, compiling it the first time
+     * the set is requested. Keywords are separated by whitespace or commas;
+     * a keyword of the form NAME=VALUE defines NAME as VALUE. A name may
+     * only be given one value per set. A variant that failed to compile is
+     * not retried.
+     *
+     * @param[in] Keywords Null-terminated list of keywords; NULL or empty
+     *            for the base variant.
+     *
+     * @return Pointer to the variant, owned by this ShaderVariants; NULL
+     * if it failed to compile or the keywords define a name twice with
+     * different values.
+     */
+    Shader* GetVariant(const char* Keywords);
+
+    /*! @brief Compile every variant listed in a manifest.
+     *
+     * Compile every variant listed in a manifest string. Each line holds
+     * one keyword set. Text from a '#' to the end of the line is ignored,
+     * as are empty lines. Variants already compiled are skipped.
+     *
+     * @param[in] Manifest Null-terminated manifest text.
+     *
+     * @return BGE_SUCCESS if every listed variant compiled; BGE_FAILURE
+     * if one or more failed.
+     */
+    Result Precompile(const char* Manifest);
+
+    /*! @brief Compile every variant listed in a manifest file.
+     *
+     * Compile every variant listed in a manifest file in the PhysFS search
+     * path. See Precompile for the manifest format.
+     *
+     * @param[in] FileName Path of the manifest file.
+     *
+     * @return BGE_SUCCESS if the file was read and every listed variant
+     * compiled; BGE_FAILURE if any errors occurred.
+     */
+    Result LoadManifest(const char* FileName);
+
+    /*! @brief Get the number of variants requested so far.
+     *
+     * Get the number of distinct variants requested so far, including any
+     * that failed to compile.
+     *
+     * @return Number of variants.
+     */
+    int GetNumVariants() const;
+
+}; /* ShaderVariants */
+
+} /* bakge */
+
+#endif /* BAKGE_GRAPHICS_SHADERVARIANTS_H */
@@ -0,0 +1,263 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file MathKernels.h
+ * @brief Internal math kernel tables, not exposed as end-user API.
+ */
+
+#ifndef BAKGE_INTERNAL_MATHKERNELS_H
+#define BAKGE_INTERNAL_MATHKERNELS_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Table of math kernels for one instruction set.
+ *
+ * All pointers are to 16-byte aligned arrays of Scalars laid out the same
+ * way as Matrix and Vector4. Outputs may alias inputs.
+ */
+struct MathKernels
+{
+    /*! @brief Out = Left * Right, for 4x4 matrices.
+     */
+    void (*MultiplyMatrices)(const Scalar* Left, const Scalar* Right,
+                                                        Scalar* Out);
+
+    /*! @brief Out = M * V, for a 4x4 matrix and a 4-component vector.
+     */
+    void (*TransformVector)(const Scalar* M, const Scalar* V, Scalar* Out);
+
+    /*! @brief Normalize a 4-component vector in place.
+     */
+    void (*NormalizeVector)(Scalar* V);
+
+    /*! @brief Normalize Count 4-component vectors in place.
+     */
+    void (*NormalizeVectors)(Scalar* V, int Count);
+
+    /*! @brief NormalizeVector with a reciprocal square root estimate.
+     *
+     * Relative error is below 5e-7. Swapped in for NormalizeVector in
+     * MATH_PRECISION_FAST mode.
+     */
+    void (*NormalizeVectorFast)(Scalar* V);
+
+    /*! @brief NormalizeVectors with a reciprocal square root estimate.
+     */
+    void (*NormalizeVectorsFast)(Scalar* V, int Count);
+
+    /*! @brief Out[i] = M * In[i], for Count 4-component vectors.
+     */
+    void (*TransformVectors)(const Scalar* M, const Scalar* In, Scalar* Out,
+                                                                int Count);
+
+    /*! @brief Out[i] = M * (In[i], W) for Count packed xyz triplets.
+     *
+     * In and Out need not be aligned. W is 1 for points, 0 for directions.
+     */
+    void (*TransformPacked)(const Scalar* M, const Scalar* In, Scalar* Out,
+                                                    int Count, Scalar W);
+
+    /*! @brief Out[i] = Left[i] * Right, for Count 4x4 matrices.
+     */
+    void (*MultiplyMatrixArray)(const Scalar* Left, const Scalar* Right,
+                                                Scalar* Out, int Count);
+
+    /*! @brief Out[i] = Left[i] * Right[i], for Count 4x4 matrices.
+     */
+    void (*MultiplyMatrixPairs)(const Scalar* Left, const Scalar* Right,
+                                                Scalar* Out, int Count);
+
+    /*! @brief (X, Y, Z)[i] = M * (X, Y, Z, W)[i], in place.
+     *
+     * Streams need not be aligned.
+     */
+    void (*TransformSoA)(const Scalar* M, Scalar* X, Scalar* Y, Scalar* Z,
+                                                    int Count, Scalar W);
+
+    /*! @brief Out[i] = Left[i] * Right, with Left and Out in SoA layout.
+     *
+     * Element e of matrix i is at [e * Count + i]. Streams need not be
+     * aligned.
+     */
+    void (*MultiplyMatricesSoA)(const Scalar* Left, const Scalar* Right,
+                                                Scalar* Out, int Count);
+
+    /*! @brief Out[i] = Left[i] * Right[i], all in SoA layout.
+     */
+    void (*MultiplyMatrixPairsSoA)(const Scalar* Left, const Scalar* Right,
+                                                    Scalar* Out, int Count);
+
+    /*! @brief Out[i] = Left[i] * Right[i], for SoA quaternions.
+     *
+     * Component c (x, y, z, w) of quaternion i is at [c * Count + i].
+     * Streams need not be aligned.
+     */
+    void (*MultiplyQuaternionsSoA)(const Scalar* Left, const Scalar* Right,
+                                                    Scalar* Out, int Count);
+
+    /*! @brief Normalize Count SoA quaternions in place.
+     */
+    void (*NormalizeQuaternionsSoA)(Scalar* Q, int Count);
+
+    /*! @brief Out[i] = normalized lerp of From[i] to To[i] by T[i].
+     *
+     * Takes the shortest path. T is a plain array of Count factors.
+     */
+    void (*NlerpQuaternionsSoA)(const Scalar* From, const Scalar* To,
+                            const Scalar* T, Scalar* Out, int Count);
+
+    /*! @brief Out[i] = spherical lerp of From[i] to To[i] by T[i].
+     *
+     * Takes the shortest path. T is a plain array of Count factors.
+     */
+    void (*SlerpQuaternionsSoA)(const Scalar* From, const Scalar* To,
+                            const Scalar* T, Scalar* Out, int Count);
+
+    /*! @brief Rotation matrices of Count SoA unit quaternions.
+     *
+     * Out is an aligned array of Count 4x4 matrices, laid out like Matrix.
+     */
+    void (*QuaternionsToMatricesSoA)(const Scalar* Q, Scalar* Out,
+                                                        int Count);
+
+    /*! @brief 3x3 rotation matrices of Count SoA unit quaternions.
+     *
+     * Out is SoA too: element c * 3 + r (column c, row r) of matrix i is
+     * at [(c * 3 + r) * Count + i].
+     */
+    void (*QuaternionsToRotationsSoA)(const Scalar* Q, Scalar* Out,
+                                                        int Count);
+
+    /*! @brief Set bit i of Visible if SoA sphere i touches the frustum.
+     *
+     * Planes holds the 6 normalized frustum planes, 4 Scalars each.
+     * Spheres holds x, y, z and radius streams. Bit i of Visible is bit
+     * i % 32 of word i / 32; every word is written, padding bits cleared.
+     */
+    void (*CullSpheresSoA)(const Scalar* Planes, const Scalar* Spheres,
+                                            int Count, uint32* Visible);
+
+    /*! @brief Set bit i of Visible if SoA box i touches the frustum.
+     *
+     * Boxes holds center x, y, z and extent x, y, z streams.
+     */
+    void (*CullBoxesSoA)(const Scalar* Planes, const Scalar* Boxes,
+                                            int Count, uint32* Visible);
+
+    /*! @brief Set bit i of Hits if SoA ray i hits SoA box i.
+     *
+     * Rays holds origin x, y, z and direction x, y, z streams; Boxes is
+     * laid out as for CullBoxesSoA.
+     */
+    void (*IntersectRaysBoxesSoA)(const Scalar* Rays, const Scalar* Boxes,
+                                                int Count, uint32* Hits);
+};
+
+/*! @brief Get the table of math kernels in use.
+ *
+ * Get the table of math kernels in use. Never NULL. Tables are never
+ * written once filled in, so the pointer stays valid after SetMathISA or
+ * SetMathPrecision switch to another table. The first call before Init
+ * fills in the baseline table and isn't thread safe.
+ *
+ * @return Table of math kernels in use.
+ */
+const MathKernels* GetMathKernels();
+
+/*! @brief Select math kernels for the running CPU.
+ *
+ * Detect the running CPU's features and select the best math kernels,
+ * honouring the BGE_MATH_ISA and BGE_MATH_PRECISION environment variables.
+ * Fills in the table for every supported instruction set and precision
+ * up front. Called by Init.
+ *
+ * @return BGE_SUCCESS if kernels were selected; BGE_FAILURE if any errors
+ * occurred.
+ */
+Result InitMathKernels();
+
+/* *
+ * Each instruction set overrides the kernels it can improve on, on top of
+ * the table filled in by the instruction set below it
+ * */
+void FillScalarMathKernels(MathKernels* Kernels);
+void FillSSE2MathKernels(MathKernels* Kernels);
+void FillSSE41MathKernels(MathKernels* Kernels);
+void FillAVX2MathKernels(MathKernels* Kernels);
+
+/* *
+ * Scalar fallbacks for SoA lanes from First to Count, used by the
+ * SIMD kernels for lanes left over after their last full register
+ * */
+void MultiplyMatricesSoARange(const Scalar* Left, const Scalar* Right,
+                                    Scalar* Out, int Count, int First);
+void MultiplyMatrixPairsSoARange(const Scalar* Left, const Scalar* Right,
+                                        Scalar* Out, int Count, int First);
+void MultiplyQuaternionsSoARange(const Scalar* Left, const Scalar* Right,
+                                        Scalar* Out, int Count, int First);
+void NormalizeQuaternionsSoARange(Scalar* Q, int Count, int First);
+void NlerpQuaternionsSoARange(const Scalar* From, const Scalar* To,
+                const Scalar* T, Scalar* Out, int Count, int First);
+void SlerpQuaternionsSoARange(const Scalar* From, const Scalar* To,
+                const Scalar* T, Scalar* Out, int Count, int First);
+void QuaternionsToMatricesSoARange(const Scalar* Q, Scalar* Out,
+                                            int Count, int First);
+void QuaternionsToRotationsSoARange(const Scalar* Q, Scalar* Out,
+                                            int Count, int First);
+
+/* *
+ * Bitmask fallbacks only set bits, in words cleared with ClearBitmask so
+ * bits past Count read as 0
+ * */
+void ClearBitmask(uint32* Bits, int Count);
+void CullSpheresSoARange(const Scalar* Planes, const Scalar* Spheres,
+                            int Count, int First, uint32* Visible);
+void CullBoxesSoARange(const Scalar* Planes, const Scalar* Boxes,
+                            int Count, int First, uint32* Visible);
+void IntersectRaysBoxesSoARange(const Scalar* Rays, const Scalar* Boxes,
+                                int Count, int First, uint32* Hits);
+
+/* *
+ * sin(t * Theta) / sin(Theta) for Cos = cos(Theta) in [0, 1], with the
+ * polynomial from Eberly's "A Fast and Accurate Algorithm for Computing
+ * SLERP": no acos, sin or divide, and within 2e-5 of the exact weights
+ * */
+static const Scalar SlerpU[8] = {
+    1.0f / (1 * 3), 1.0f / (2 * 5), 1.0f / (3 * 7), 1.0f / (4 * 9),
+    1.0f / (5 * 11), 1.0f / (6 * 13), 1.0f / (7 * 15),
+    1.85298109240830f / (8 * 17)
+};
+
+static const Scalar SlerpV[8] = {
+    1.0f / 3, 2.0f / 5, 3.0f / 7, 4.0f / 9, 5.0f / 11, 6.0f / 13, 7.0f / 15,
+    1.85298109240830f * 8 / 17
+};
+
+} /* bakge */
+
+#endif /* BAKGE_INTERNAL_MATHKERNELS_H */
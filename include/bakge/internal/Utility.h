@@ -65,6 +65,36 @@ Result PlatformInit(int, char*[]);
  */
 Result PlatformDeinit();
 
+/*! @brief Initial value for HashString.
+ *
+ * Initial value for HashString; the 64-bit FNV-1a offset basis.
+ */
+#define BGE_HASH_SEED (((bakge::uint64)0xcbf29ce4 << 32) | 0x84222325)
+
+/*! @brief Fold a null-terminated string into a 64-bit FNV-1a hash.
+ *
+ * Fold a null-terminated string into a 64-bit FNV-1a hash. The terminator
+ * is hashed too, so consecutive strings can't alias one another. NULL is
+ * hashed as an empty string.
+ *
+ * @param[in] Hash Hash so far; BGE_HASH_SEED for the first string.
+ * @param[in] String Null-terminated string to hash.
+ *
+ * @return Updated hash.
+ */
+uint64 HashString(uint64 Hash, const char* String);
+
+/*! @brief Check if a character separates shader keywords.
+ *
+ * Check if a character separates shader keywords. Keywords are separated
+ * by whitespace or commas.
+ *
+ * @param[in] C Character to check.
+ *
+ * @return true if the character is a separator; false otherwise.
+ */
+bool IsKeywordSeparator(char C);
+
 } // bakge
 
 #endif // BAKGE_INTERNAL_UTILITY_H
@@ -0,0 +1,197 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file AABB.h
+ * @brief AABB class declaration.
+ */
+
+#ifndef BAKGE_MATH_AABB_H
+#define BAKGE_MATH_AABB_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Axis-aligned bounding box.
+ *
+ * An axis-aligned bounding box, stored as its minimum and maximum corners.
+ * A default constructed AABB is empty: Expand it by points or other boxes
+ * to grow it.
+ */
+class BGE_API BGE_ALIGN(16) AABB
+{
+    Vector4 Min;
+    Vector4 Max;
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief Default AABB constructor.
+     *
+     * Default AABB constructor. Creates an empty box.
+     */
+    AABB();
+
+    /*! @brief Construct a box from its minimum and maximum corners.
+     *
+     * Construct a box from its minimum and maximum corners.
+     *
+     * @param[in] MinCorner Corner with the smallest coordinates.
+     * @param[in] MaxCorner Corner with the largest coordinates.
+     */
+    AABB(Vector4 BGE_NCP MinCorner, Vector4 BGE_NCP MaxCorner);
+
+    /*! @brief AABB copy-constructor.
+     *
+     * AABB copy-constructor.
+     */
+    AABB(AABB BGE_NCP Other);
+
+    /*! @brief AABB destructor.
+     *
+     * AABB destructor.
+     */
+    ~AABB();
+
+    /*! @brief AABB assignment operator.
+     *
+     * AABB assignment operator.
+     *
+     * @return const reference to the AABB after assignment.
+     */
+    AABB BGE_NCP operator=(AABB BGE_NCP Other);
+
+    /*! @brief Get the corner with the smallest coordinates.
+     *
+     * Get the corner with the smallest coordinates.
+     *
+     * @return const reference to the minimum corner.
+     */
+    Vector4 BGE_NCP GetMin() const;
+
+    /*! @brief Get the corner with the largest coordinates.
+     *
+     * Get the corner with the largest coordinates.
+     *
+     * @return const reference to the maximum corner.
+     */
+    Vector4 BGE_NCP GetMax() const;
+
+    /*! @brief Get the center of the box.
+     *
+     * Get the center of the box.
+     *
+     * @return Point at the center of the box.
+     */
+    Vector4 GetCenter() const;
+
+    /*! @brief Get the half-size of the box along each axis.
+     *
+     * Get the half-size of the box along each axis.
+     *
+     * @return Vector from the center of the box to its maximum corner.
+     */
+    Vector4 GetExtents() const;
+
+    /*! @brief Check if the box is empty.
+     *
+     * Check if the box is empty, i.e. its minimum corner is greater than
+     * its maximum corner on some axis.
+     *
+     * @return true if the box is empty; false otherwise.
+     */
+    bool IsEmpty() const;
+
+    /*! @brief Grow the box to contain a point.
+     *
+     * Grow the box to contain a point.
+     *
+     * @param[in] Point Point the box must contain.
+     *
+     * @return const reference to the AABB after expansion.
+     */
+    AABB BGE_NCP Expand(Vector4 BGE_NCP Point);
+
+    /*! @brief Grow the box to contain another box.
+     *
+     * Grow the box to contain another box.
+     *
+     * @param[in] Other Box this box must contain.
+     *
+     * @return const reference to the AABB after expansion.
+     */
+    AABB BGE_NCP Expand(AABB BGE_NCP Other);
+
+    /*! @brief Check if the box contains a point.
+     *
+     * Check if the box contains a point. Points on the surface count.
+     *
+     * @param[in] Point Point to check.
+     *
+     * @return true if the point is inside the box; false otherwise.
+     */
+    bool Contains(Vector4 BGE_NCP Point) const;
+
+    /*! @brief Check if the box overlaps another box.
+     *
+     * Check if the box overlaps another box. Touching boxes overlap.
+     *
+     * @param[in] Other Box to check.
+     *
+     * @return true if the boxes overlap; false otherwise.
+     */
+    bool Intersects(AABB BGE_NCP Other) const;
+
+    /*! @brief Get the box bounding this box after a transformation.
+     *
+     * Get the box bounding this box after a transformation, using Arvo's
+     * method. The result is never smaller than the transformed box.
+     *
+     * @param[in] Transformation Transformation to apply.
+     *
+     * @return Axis-aligned box bounding the transformed box.
+     */
+    AABB Transformed(Matrix BGE_NCP Transformation) const;
+
+    /*! @brief Build a box from its center and half-sizes.
+     *
+     * Build a box from its center and half-size along each axis.
+     *
+     * @param[in] Center Center of the box.
+     * @param[in] Extents Half-size of the box along each axis.
+     *
+     * @return Box centered on Center.
+     */
+    static AABB FromCenterAndExtents(Vector4 BGE_NCP Center,
+                                    Vector4 BGE_NCP Extents);
+
+}; /* AABB */
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_AABB_H */
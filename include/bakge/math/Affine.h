@@ -0,0 +1,304 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Affine.h
+ * @brief Affine class declaration.
+ */
+
+#ifndef BAKGE_MATH_AFFINE_H
+#define BAKGE_MATH_AFFINE_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Compact 3x4 affine transformation.
+ *
+ * An affine transformation (rotation, scale, shear and translation) stored
+ * as the top three rows of a 4x4 matrix; the bottom row is always
+ * (0, 0, 0, 1) and isn't stored. Each row is 16-byte aligned and holds the
+ * translation in its last component, so an Affine is 48 bytes instead of a
+ * Matrix's 64 and composing two of them costs 36 multiplies instead of 64.
+ *
+ * This is also the layout of the bge_Model shader attribute (a mat3x4),
+ * so an Affine can be uploaded as-is for Pawn and Crowd model data.
+ *
+ * Like Matrix, Left * Right applies Left first, then Right.
+ */
+class BGE_API BGE_ALIGN(16) Affine
+{
+    union
+    {
+        struct
+        {
+            Scalar Val[12];
+        };
+
+        struct
+        {
+            Scalar M00, M01, M02, M03;
+            Scalar M10, M11, M12, M13;
+            Scalar M20, M21, M22, M23;
+        };
+    };
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief Identity transformation.
+     *
+     * Use whenever you need an identity transformation instead of
+     * allocating a new one.
+     */
+    static const Affine Identity;
+
+    /*! @brief Default Affine constructor.
+     *
+     * Default Affine constructor. Creates an identity transformation.
+     */
+    Affine();
+
+    /*! @brief Affine copy-constructor.
+     *
+     * Affine copy-constructor.
+     */
+    Affine(Affine BGE_NCP Other);
+
+    /*! @brief Affine row constructor.
+     *
+     * Construct an affine transformation from its three rows. The fourth
+     * component of each row is the translation along that row's axis.
+     */
+    Affine(Vector4 BGE_NCP Row0, Vector4 BGE_NCP Row1, Vector4 BGE_NCP Row2);
+
+    /*! @brief Affine destructor.
+     *
+     * Affine destructor.
+     */
+    ~Affine();
+
+    /*! @brief Affine field accessor.
+     *
+     * Affine field accessor. Fields are stored row by row.
+     *
+     * @param[in] At 0-base field index.
+     *
+     * @return const reference to field at specified index.
+     */
+    BGE_INL Scalar BGE_NCP operator[](int BGE_NCP At) const
+    {
+        return Val[At];
+    }
+
+    /*! @brief Affine field accessor.
+     *
+     * Affine field accessor. Fields are stored row by row.
+     *
+     * @param[in] At 0-base field index.
+     *
+     * @return Reference to field at specified index.
+     */
+    BGE_INL Scalar& operator[](int BGE_NCP At)
+    {
+        return Val[At];
+    }
+
+    /*! @brief Assignment operator.
+     *
+     * Assignment operator.
+     *
+     * @param[in] Other Affine to copy.
+     *
+     * @return constref to the Affine after assignment.
+     */
+    Affine BGE_NCP operator=(Affine BGE_NCP Other);
+
+    /*! @brief Compose two affine transformations.
+     *
+     * Compose two affine transformations. The result applies this
+     * transformation, then Other.
+     *
+     * @param[in] Other Transformation to apply after this one.
+     *
+     * @return Composed transformation.
+     */
+    Affine operator*(Affine BGE_NCP Other) const;
+
+    /*! @brief Compose with another affine transformation in place.
+     *
+     * Compose with another affine transformation in place, so this
+     * transformation is applied first, then Other.
+     *
+     * @param[in] Other Transformation to apply after this one.
+     *
+     * @return constref to the Affine after composition.
+     */
+    Affine BGE_NCP operator*=(Affine BGE_NCP Other);
+
+    /*! @brief Reset to the identity transformation.
+     *
+     * Reset to the identity transformation.
+     *
+     * @return constref to the Affine.
+     */
+    Affine BGE_NCP SetIdentity();
+
+    /*! @brief Transform a point.
+     *
+     * Transform a point, including translation. The w-coordinate of P is
+     * ignored and treated as 1.
+     *
+     * @param[in] P Point to transform.
+     *
+     * @return Transformed point, with a w-coordinate of 1.
+     */
+    Vector4 TransformPoint(Vector4 BGE_NCP P) const;
+
+    /*! @brief Transform a vector.
+     *
+     * Transform a vector, ignoring translation. The w-coordinate of V is
+     * ignored and treated as 0.
+     *
+     * @param[in] V Vector to transform.
+     *
+     * @return Transformed vector, with a w-coordinate of 0.
+     */
+    Vector4 TransformVector(Vector4 BGE_NCP V) const;
+
+    /*! @brief Invert the affine transformation.
+     *
+     * Invert the affine transformation. Works for any invertible affine
+     * transformation, including non-uniform scale and shear.
+     *
+     * @return constref to the Affine after inversion. A singular
+     * transformation is left unchanged.
+     */
+    Affine BGE_NCP Invert();
+
+    /*! @brief Get the inverse of the affine transformation.
+     *
+     * Get the inverse of the affine transformation.
+     *
+     * @return Inverse of the transformation. A singular transformation
+     * is returned unchanged.
+     */
+    Affine Inverted() const;
+
+    /*! @brief Invert a rigid transformation.
+     *
+     * Invert a rigid transformation: rotation and translation only. This
+     * is a transpose and a transformed translation, much cheaper than
+     * Invert.
+     *
+     * @return constref to the Affine after inversion.
+     *
+     * @warning Results are wrong if the transformation has any scale or
+     * shear.
+     */
+    Affine BGE_NCP InvertRigid();
+
+    /*! @brief Get the inverse of a rigid transformation.
+     *
+     * Get the inverse of a rigid transformation.
+     *
+     * @return Inverse of the transformation.
+     *
+     * @warning Results are wrong if the transformation has any scale or
+     * shear.
+     */
+    Affine RigidInverted() const;
+
+    /*! @brief Get the translation of the transformation.
+     *
+     * Get the translation of the transformation.
+     *
+     * @return Translation as a point.
+     */
+    Vector4 GetTranslation() const;
+
+    /*! @brief Get the scale of the transformation.
+     *
+     * Get the scale along each local axis of the transformation. Negative
+     * scales can't be told apart from rotations and come back positive.
+     *
+     * @return Scale along each local axis, with a w-coordinate of 0.
+     */
+    Vector4 GetScale() const;
+
+    /*! @brief Get the rotation of the transformation.
+     *
+     * Get the rotation of the transformation, with scale removed.
+     *
+     * @return Rotation of the transformation.
+     *
+     * @warning Results are meaningless if the transformation has shear.
+     */
+    Quaternion GetRotation() const;
+
+    /*! @brief Expand into a 4x4 matrix.
+     *
+     * Expand into a 4x4 matrix.
+     *
+     * @return Matrix with the same transformation.
+     */
+    Matrix ToMatrix() const;
+
+    /*! @brief Create an affine transformation from a matrix.
+     *
+     * Create an affine transformation from a matrix. The matrix's bottom
+     * row (projection) is dropped.
+     *
+     * @param[in] M Matrix to convert.
+     *
+     * @return Affine transformation of M.
+     */
+    static Affine FromMatrix(Matrix BGE_NCP M);
+
+    /*! @brief Create an affine transformation from its components.
+     *
+     * Create an affine transformation that scales, then rotates, then
+     * translates.
+     *
+     * @param[in] Translation Translation of the transformation.
+     * @param[in] Rotation Rotation of the transformation.
+     * @param[in] Scale Scale along each local axis.
+     *
+     * @return Affine transformation.
+     */
+    static Affine FromTransform(Vector4 BGE_NCP Translation,
+                    Quaternion BGE_NCP Rotation, Vector4 BGE_NCP Scale);
+
+}; /* Affine */
+
+} /* bakge */
+
+#ifdef BGE_MATH_INLINE
+#include <bakge/math/Affine.inl>
+#endif /* BGE_MATH_INLINE */
+
+#endif /* BAKGE_MATH_AFFINE_H */
@@ -0,0 +1,213 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Affine.inl
+ * @brief Affine inline member definitions.
+ */
+
+#ifndef BAKGE_MATH_AFFINE_INL
+#define BAKGE_MATH_AFFINE_INL
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+BGE_MATH_INL Affine::Affine()
+{
+    SetIdentity();
+}
+
+
+BGE_MATH_INL Affine::Affine(Affine BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+BGE_MATH_INL Affine::Affine(Vector4 BGE_NCP Row0, Vector4 BGE_NCP Row1,
+                                                Vector4 BGE_NCP Row2)
+{
+    for(int i = 0; i < 4; ++i) {
+        Val[i] = Row0[i];
+        Val[4 + i] = Row1[i];
+        Val[8 + i] = Row2[i];
+    }
+}
+
+
+BGE_MATH_INL Affine::~Affine()
+{
+}
+
+
+BGE_MATH_INL Affine BGE_NCP Affine::operator=(Affine BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(&Val[0], _mm_load_ps(&Other.Val[0]));
+    _mm_store_ps(&Val[4], _mm_load_ps(&Other.Val[4]));
+    _mm_store_ps(&Val[8], _mm_load_ps(&Other.Val[8]));
+#else
+    for(int i = 0; i < 12; ++i)
+        Val[i] = Other.Val[i];
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Affine BGE_NCP Affine::operator*=(Affine BGE_NCP Other)
+{
+    /* *
+     * Row r of Other * this (applying this first) is a combination of our
+     * rows weighted by row r of Other, plus Other's translation
+     * */
+#ifdef BGE_USE_SIMD
+    __m128 A0 = _mm_load_ps(&Val[0]);
+    __m128 A1 = _mm_load_ps(&Val[4]);
+    __m128 A2 = _mm_load_ps(&Val[8]);
+    __m128 W = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+
+    for(int r = 0; r < 12; r += 4) {
+        __m128 B = _mm_load_ps(&Other.Val[r]);
+        __m128 T = _mm_and_ps(B, W);
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(B, B, 0x00), A0));
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(B, B, 0x55), A1));
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(B, B, 0xAA), A2));
+        _mm_store_ps(&Val[r], T);
+    }
+#else
+    Scalar A[12];
+
+    for(int i = 0; i < 12; ++i)
+        A[i] = Val[i];
+
+    for(int r = 0; r < 12; r += 4) {
+        for(int c = 0; c < 4; ++c) {
+            Val[r + c] = Other.Val[r] * A[c] + Other.Val[r + 1] * A[4 + c]
+                                            + Other.Val[r + 2] * A[8 + c];
+        }
+
+        Val[r + 3] += Other.Val[r + 3];
+    }
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Affine Affine::operator*(Affine BGE_NCP Other) const
+{
+    return Affine(*this) *= Other;
+}
+
+
+BGE_MATH_INL Affine BGE_NCP Affine::SetIdentity()
+{
+    for(int i = 0; i < 12; ++i)
+        Val[i] = 0;
+
+    Val[0] = 1;
+    Val[5] = 1;
+    Val[10] = 1;
+
+    return *this;
+}
+
+
+BGE_MATH_INL Vector4 Affine::TransformPoint(Vector4 BGE_NCP P) const
+{
+#ifdef BGE_USE_SIMD
+    __m128 X = _mm_load_ps(&P[0]);
+
+    /* (x, y, z, 1) dotted with each row */
+    X = _mm_or_ps(_mm_and_ps(X, _mm_castsi128_ps(_mm_setr_epi32(-1, -1,
+                                -1, 0))), _mm_setr_ps(0, 0, 0, 1));
+
+    __m128 R0 = _mm_mul_ps(_mm_load_ps(&Val[0]), X);
+    __m128 R1 = _mm_mul_ps(_mm_load_ps(&Val[4]), X);
+    __m128 R2 = _mm_mul_ps(_mm_load_ps(&Val[8]), X);
+    __m128 R3 = _mm_setzero_ps();
+
+    _MM_TRANSPOSE4_PS(R0, R1, R2, R3);
+
+    Vector4 Res;
+    _mm_store_ps(&Res[0], _mm_add_ps(_mm_add_ps(R0, R1),
+                _mm_add_ps(_mm_add_ps(R2, R3), _mm_setr_ps(0, 0, 0, 1))));
+
+    return Res;
+#else
+    return Vector4(
+        Val[0] * P[0] + Val[1] * P[1] + Val[2] * P[2] + Val[3],
+        Val[4] * P[0] + Val[5] * P[1] + Val[6] * P[2] + Val[7],
+        Val[8] * P[0] + Val[9] * P[1] + Val[10] * P[2] + Val[11],
+        1
+    );
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL Vector4 Affine::TransformVector(Vector4 BGE_NCP V) const
+{
+#ifdef BGE_USE_SIMD
+    /* (x, y, z, 0) dotted with each row */
+    __m128 X = _mm_and_ps(_mm_load_ps(&V[0]),
+                _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+
+    __m128 R0 = _mm_mul_ps(_mm_load_ps(&Val[0]), X);
+    __m128 R1 = _mm_mul_ps(_mm_load_ps(&Val[4]), X);
+    __m128 R2 = _mm_mul_ps(_mm_load_ps(&Val[8]), X);
+    __m128 R3 = _mm_setzero_ps();
+
+    _MM_TRANSPOSE4_PS(R0, R1, R2, R3);
+
+    Vector4 Res;
+    _mm_store_ps(&Res[0], _mm_add_ps(_mm_add_ps(R0, R1),
+                                        _mm_add_ps(R2, R3)));
+
+    return Res;
+#else
+    return Vector4(
+        Val[0] * V[0] + Val[1] * V[1] + Val[2] * V[2],
+        Val[4] * V[0] + Val[5] * V[1] + Val[6] * V[2],
+        Val[8] * V[0] + Val[9] * V[1] + Val[10] * V[2],
+        0
+    );
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL Vector4 Affine::GetTranslation() const
+{
+    return Vector4(Val[3], Val[7], Val[11], 1);
+}
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_AFFINE_INL */
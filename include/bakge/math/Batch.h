@@ -0,0 +1,300 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+/*!
+ * @file Batch.h
+ * @brief Batched vector and matrix operations.
+ */
+
+#ifndef BAKGE_MATH_BATCH_H
+#define BAKGE_MATH_BATCH_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/* *
+ * Batched operations run the math kernels selected at Init over whole
+ * arrays, so per-call overhead and matrix loads are paid once per batch.
+ * Functions suffixed SoA take structure-of-arrays data: one stream per
+ * component instead of one struct per element. SoA streams need not be
+ * aligned, but Vector4 and Matrix arrays must be (they always are when
+ * allocated with new or on the stack).
+ * */
+
+/*! @brief Transform an array of vectors by a matrix.
+ *
+ * Transform an array of vectors by a matrix. Out[i] = M * In[i].
+ * In and Out may be the same array.
+ *
+ * @param[in] M Transformation matrix.
+ * @param[in] In Vectors to transform.
+ * @param[out] Out Transformed vectors.
+ * @param[in] Count Number of vectors.
+ */
+BGE_FUNC void TransformVectors(Matrix BGE_NCP M, const Vector4* In,
+                                            Vector4* Out, int Count);
+
+/*! @brief Transform an array of packed xyz points by a matrix.
+ *
+ * Transform an array of packed xyz points by a matrix, including its
+ * translation. In and Out hold 3 * Count scalars and may be the same
+ * array.
+ *
+ * @param[in] M Transformation matrix.
+ * @param[in] In Points to transform.
+ * @param[out] Out Transformed points.
+ * @param[in] Count Number of points.
+ */
+BGE_FUNC void TransformPoints(Matrix BGE_NCP M, const Scalar* In,
+                                            Scalar* Out, int Count);
+
+/*! @brief Transform an array of packed xyz directions by a matrix.
+ *
+ * Transform an array of packed xyz directions by a matrix, ignoring its
+ * translation. In and Out hold 3 * Count scalars and may be the same
+ * array.
+ *
+ * @param[in] M Transformation matrix.
+ * @param[in] In Directions to transform.
+ * @param[out] Out Transformed directions.
+ * @param[in] Count Number of directions.
+ */
+BGE_FUNC void TransformDirections(Matrix BGE_NCP M, const Scalar* In,
+                                                Scalar* Out, int Count);
+
+/*! @brief Transform SoA points by a matrix in place.
+ *
+ * Transform SoA points by a matrix in place, including its translation.
+ *
+ * @param[in] M Transformation matrix.
+ * @param[in,out] X X components of the points.
+ * @param[in,out] Y Y components of the points.
+ * @param[in,out] Z Z components of the points.
+ * @param[in] Count Number of points.
+ */
+BGE_FUNC void TransformPointsSoA(Matrix BGE_NCP M, Scalar* X, Scalar* Y,
+                                                    Scalar* Z, int Count);
+
+/*! @brief Transform SoA directions by a matrix in place.
+ *
+ * Transform SoA directions by a matrix in place, ignoring its
+ * translation.
+ *
+ * @param[in] M Transformation matrix.
+ * @param[in,out] X X components of the directions.
+ * @param[in,out] Y Y components of the directions.
+ * @param[in,out] Z Z components of the directions.
+ * @param[in] Count Number of directions.
+ */
+BGE_FUNC void TransformDirectionsSoA(Matrix BGE_NCP M, Scalar* X,
+                                    Scalar* Y, Scalar* Z, int Count);
+
+/*! @brief Multiply an array of matrices by one matrix.
+ *
+ * Multiply an array of matrices by one matrix. Out[i] = Left[i] * Right.
+ * Left and Out may be the same array.
+ *
+ * @param[in] Left Matrices to multiply.
+ * @param[in] Right Matrix each of Left is multiplied by.
+ * @param[out] Out Products.
+ * @param[in] Count Number of matrices.
+ */
+BGE_FUNC void MultiplyMatrices(const Matrix* Left, Matrix BGE_NCP Right,
+                                                Matrix* Out, int Count);
+
+/*! @brief Multiply two arrays of matrices pairwise.
+ *
+ * Multiply two arrays of matrices pairwise. Out[i] = Left[i] * Right[i].
+ * Out may be the same array as Left or Right.
+ *
+ * @param[in] Left Left hand matrices.
+ * @param[in] Right Right hand matrices.
+ * @param[out] Out Products.
+ * @param[in] Count Number of matrices.
+ */
+BGE_FUNC void MultiplyMatrixPairs(const Matrix* Left, const Matrix* Right,
+                                                Matrix* Out, int Count);
+
+/*! @brief Multiply SoA matrices by one matrix.
+ *
+ * Multiply SoA matrices by one matrix. Element e of matrix i is stored at
+ * [e * Count + i] of Left and Out, which hold 16 * Count scalars each
+ * and may be the same array.
+ *
+ * @param[in] Left Matrices to multiply.
+ * @param[in] Right Matrix each of Left is multiplied by.
+ * @param[out] Out Products.
+ * @param[in] Count Number of matrices.
+ */
+BGE_FUNC void MultiplyMatricesSoA(const Scalar* Left, Matrix BGE_NCP Right,
+                                                Scalar* Out, int Count);
+
+/*! @brief Multiply two arrays of SoA matrices pairwise.
+ *
+ * Multiply two arrays of SoA matrices pairwise. Element e of matrix i is
+ * stored at [e * Count + i]. Out may be the same array as Left or Right.
+ *
+ * @param[in] Left Left hand matrices.
+ * @param[in] Right Right hand matrices.
+ * @param[out] Out Products.
+ * @param[in] Count Number of matrices.
+ */
+BGE_FUNC void MultiplyMatrixPairsSoA(const Scalar* Left,
+                    const Scalar* Right, Scalar* Out, int Count);
+
+/*! @brief Normalize an array of vectors in place.
+ *
+ * Normalize an array of vectors in place. All four components are used,
+ * like Vector4::Normalize.
+ *
+ * @param[in,out] Vectors Vectors to normalize.
+ * @param[in] Count Number of vectors.
+ */
+BGE_FUNC void NormalizeVectors(Vector4* Vectors, int Count);
+
+/*! @brief Multiply two arrays of SoA quaternions pairwise.
+ *
+ * Multiply two arrays of SoA quaternions pairwise, like
+ * Quaternion::operator*. Component c (x, y, z, w) of quaternion i is
+ * stored at [c * Count + i]. Out may be the same array as Left or Right.
+ *
+ * @param[in] Left Left hand quaternions.
+ * @param[in] Right Right hand quaternions.
+ * @param[out] Out Products.
+ * @param[in] Count Number of quaternions.
+ */
+BGE_FUNC void MultiplyQuaternionsSoA(const Scalar* Left,
+                    const Scalar* Right, Scalar* Out, int Count);
+
+/*! @brief Normalize an array of SoA quaternions in place.
+ *
+ * Normalize an array of SoA quaternions in place.
+ *
+ * @param[in,out] Q Quaternions to normalize.
+ * @param[in] Count Number of quaternions.
+ */
+BGE_FUNC void NormalizeQuaternionsSoA(Scalar* Q, int Count);
+
+/*! @brief Normalized linear interpolation of SoA quaternions.
+ *
+ * Normalized linear interpolation of SoA quaternions, along the shortest
+ * path. Cheaper than slerp and close to it for the small steps between
+ * animation frames. Out may be the same array as From or To.
+ *
+ * @param[in] From Quaternions at T = 0.
+ * @param[in] To Quaternions at T = 1.
+ * @param[in] T Interpolation factor of each pair.
+ * @param[out] Out Interpolated quaternions.
+ * @param[in] Count Number of quaternions.
+ */
+BGE_FUNC void NlerpQuaternionsSoA(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count);
+
+/*! @brief Spherical linear interpolation of SoA quaternions.
+ *
+ * Spherical linear interpolation of SoA quaternions, along the shortest
+ * path. SIMD kernels use a polynomial approximation of the slerp weights
+ * that is within 2e-5 of exact. Out may be the same array as From or To.
+ *
+ * @param[in] From Unit quaternions at T = 0.
+ * @param[in] To Unit quaternions at T = 1.
+ * @param[in] T Interpolation factor of each pair.
+ * @param[out] Out Interpolated quaternions.
+ * @param[in] Count Number of quaternions.
+ */
+BGE_FUNC void SlerpQuaternionsSoA(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count);
+
+/*! @brief Build rotation matrices from SoA quaternions.
+ *
+ * Build rotation matrices from SoA unit quaternions, like
+ * Quaternion::ToMatrix.
+ *
+ * @param[in] Q Unit quaternions.
+ * @param[out] Out Rotation matrices.
+ * @param[in] Count Number of quaternions.
+ */
+BGE_FUNC void QuaternionsToMatricesSoA(const Scalar* Q, Matrix* Out,
+                                                            int Count);
+
+/*! @brief Build SoA 3x3 rotation matrices from SoA quaternions.
+ *
+ * Build SoA 3x3 rotation matrices from SoA unit quaternions. Element
+ * c * 3 + r (column c, row r) of matrix i is stored at
+ * [(c * 3 + r) * Count + i], so Out holds 9 * Count scalars.
+ *
+ * @param[in] Q Unit quaternions.
+ * @param[out] Out Rotation matrices.
+ * @param[in] Count Number of quaternions.
+ */
+BGE_FUNC void QuaternionsToRotationsSoA(const Scalar* Q, Scalar* Out,
+                                                            int Count);
+
+/*! @brief Cull SoA spheres against a frustum.
+ *
+ * Cull SoA spheres against a frustum. Spheres holds center x, y, z and
+ * radius streams, 4 * Count scalars. Bit i % 32 of Visible[i / 32] is set
+ * if sphere i may be visible and cleared otherwise, so Visible must hold
+ * (Count + 31) / 32 words.
+ *
+ * @param[in] View Frustum to cull against.
+ * @param[in] Spheres Spheres to cull.
+ * @param[in] Count Number of spheres.
+ * @param[out] Visible Visibility bitmask.
+ */
+BGE_FUNC void CullSpheresSoA(Frustum BGE_NCP View, const Scalar* Spheres,
+                                            int Count, uint32* Visible);
+
+/*! @brief Cull SoA boxes against a frustum.
+ *
+ * Cull SoA boxes against a frustum. Boxes holds center x, y, z and extent
+ * (half-size) x, y, z streams, 6 * Count scalars. Visible is written as
+ * for CullSpheresSoA.
+ *
+ * @param[in] View Frustum to cull against.
+ * @param[in] Boxes Boxes to cull.
+ * @param[in] Count Number of boxes.
+ * @param[out] Visible Visibility bitmask.
+ */
+BGE_FUNC void CullBoxesSoA(Frustum BGE_NCP View, const Scalar* Boxes,
+                                        int Count, uint32* Visible);
+
+/*! @brief Intersect SoA rays with SoA boxes pairwise.
+ *
+ * Intersect SoA rays with SoA boxes pairwise. Rays holds origin x, y, z
+ * and direction x, y, z streams; Boxes is laid out as for CullBoxesSoA.
+ * Bit i % 32 of Hits[i / 32] is set if ray i hits box i at some T >= 0.
+ *
+ * @param[in] Rays Rays to cast.
+ * @param[in] Boxes Box each ray is tested against.
+ * @param[in] Count Number of rays and boxes.
+ * @param[out] Hits Hit bitmask.
+ */
+BGE_FUNC void IntersectRaysBoxesSoA(const Scalar* Rays, const Scalar* Boxes,
+                                                    int Count, uint32* Hits);
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_BATCH_H */
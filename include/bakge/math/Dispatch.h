@@ -0,0 +1,174 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Dispatch.h
+ * @brief Math kernel instruction set selection API.
+ */
+
+#ifndef BAKGE_MATH_DISPATCH_H
+#define BAKGE_MATH_DISPATCH_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Instruction sets math kernels can be compiled for.
+ *
+ * Hot math kernels such as matrix multiplication, vector transformation
+ * and normalization are compiled once for each of these instruction sets.
+ * The best one supported by the running CPU is picked when Bakge is
+ * initialized. Set the BGE_MATH_ISA environment variable to "scalar",
+ * "sse2", "sse41" or "avx2" to force a variant, e.g. for benchmarking.
+ */
+enum MATH_ISA
+{
+    /*! @brief Portable C++ kernels. Always available.
+     */
+    MATH_ISA_SCALAR = 0,
+
+    /*! @brief SSE2 kernels.
+     */
+    MATH_ISA_SSE2,
+
+    /*! @brief SSE4.1 kernels.
+     */
+    MATH_ISA_SSE41,
+
+    /*! @brief AVX2 and FMA3 kernels.
+     */
+    MATH_ISA_AVX2,
+
+    /*! @brief Total number of math instruction sets.
+     */
+    NUM_MATH_ISAS
+};
+
+/*! @brief Precision modes for math that has a fast approximation.
+ *
+ * In fast mode Vector4::Normalize, Vector4::UnitVector, batched
+ * NormalizeVectors and the Quaternion angle functions use the FastMath
+ * approximations instead of libm. Set the BGE_MATH_PRECISION environment
+ * variable to "exact" or "fast" to pick a mode at Init.
+ */
+enum MATH_PRECISION
+{
+    /*! @brief Full precision libm functions. The default.
+     */
+    MATH_PRECISION_EXACT = 0,
+
+    /*! @brief FastMath approximations, see FastMath.h for their errors.
+     */
+    MATH_PRECISION_FAST,
+
+    /*! @brief Total number of math precision modes.
+     */
+    NUM_MATH_PRECISIONS
+};
+
+/*! @brief Check if math kernels for an instruction set can be used.
+ *
+ * Check if math kernels for an instruction set were compiled into Bakge
+ * and are supported by the running CPU and operating system.
+ *
+ * @param[in] ISA Instruction set to check.
+ *
+ * @return true if the instruction set can be used; false otherwise.
+ */
+BGE_FUNC bool IsMathISASupported(MATH_ISA ISA);
+
+/*! @brief Use math kernels for a given instruction set.
+ *
+ * Use math kernels for a given instruction set. Switching is not thread
+ * safe; do it before any threads start using math classes, or while no
+ * other thread is running math (e.g. between SceneGraph updates).
+ *
+ * @param[in] ISA Instruction set to use.
+ *
+ * @return BGE_SUCCESS if the kernels were switched; BGE_FAILURE if the
+ * instruction set isn't supported.
+ */
+BGE_FUNC Result SetMathISA(MATH_ISA ISA);
+
+/*! @brief Get the instruction set of the math kernels in use.
+ *
+ * Get the instruction set of the math kernels in use. Before Init is
+ * called this is the baseline Bakge was compiled for.
+ *
+ * @return Instruction set of the math kernels in use.
+ */
+BGE_FUNC MATH_ISA GetMathISA();
+
+/*! @brief Get the best instruction set supported on this machine.
+ *
+ * Get the best instruction set supported on this machine.
+ *
+ * @return Best instruction set supported on this machine.
+ */
+BGE_FUNC MATH_ISA GetBestMathISA();
+
+/*! @brief Get the name of an instruction set.
+ *
+ * Get the name of an instruction set, as accepted by the BGE_MATH_ISA
+ * environment variable.
+ *
+ * @param[in] ISA Instruction set.
+ *
+ * @return Name of the instruction set; "unknown" if ISA is invalid.
+ */
+BGE_FUNC const char* GetMathISAName(MATH_ISA ISA);
+
+/*! @brief Set the precision of math that has a fast approximation.
+ *
+ * Set the precision of math that has a fast approximation. Like SetMathISA
+ * this isn't thread safe; don't call it while other threads run math. Code can always call the FastMath functions
+ * directly, whatever the global precision.
+ *
+ * @param[in] Precision Precision mode to use.
+ *
+ * @return BGE_SUCCESS if the precision was set; BGE_FAILURE if it is
+ * invalid.
+ */
+BGE_FUNC Result SetMathPrecision(MATH_PRECISION Precision);
+
+/*! @brief Get the precision of math that has a fast approximation.
+ *
+ * Get the precision of math that has a fast approximation.
+ *
+ * @return Precision mode in use.
+ */
+BGE_FUNC MATH_PRECISION GetMathPrecision();
+
+/*! @brief Precision of math that has a fast approximation.
+ *
+ * Precision of math that has a fast approximation, as returned by
+ * GetMathPrecision. Inline math (see BGE_MATH_INLINE) reads it directly
+ * instead of calling out of line. Change it only with SetMathPrecision.
+ */
+BGE_FUNC MATH_PRECISION CurrentMathPrecision;
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_DISPATCH_H */
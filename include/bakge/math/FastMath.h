@@ -0,0 +1,85 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file FastMath.h
+ * @brief Fast approximate math function declarations.
+ */
+
+#ifndef BAKGE_MATH_FASTMATH_H
+#define BAKGE_MATH_FASTMATH_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/* *
+ * Approximations of libm functions for hot paths that can trade a little
+ * accuracy for speed. Call them directly, or call SetMathPrecision with
+ * MATH_PRECISION_FAST to have Vector4 and Quaternion use them too. Errors
+ * are checked by test/fastmath.
+ * */
+
+/*! @brief Get an approximate reciprocal square root.
+ *
+ * Get an approximate reciprocal square root, from a hardware estimate
+ * refined with one Newton-Raphson step. Relative error is below 5e-7.
+ *
+ * @param[in] X Value to get the reciprocal square root of. Must be > 0.
+ *
+ * @return Approximately 1 / sqrt(X).
+ */
+BGE_FUNC Scalar FastInvSqrt(Scalar X);
+
+/*! @brief Get the approximate sine and cosine of an angle at once.
+ *
+ * Get the approximate sine and cosine of an angle at once. Both share one
+ * range reduction, so this is much cheaper than sinf plus cosf. Absolute
+ * error is below 1e-6 for angles within +/- 8192 radians.
+ *
+ * @param[in] Angle Angle in radians.
+ * @param[out] Sin Sine of the angle.
+ * @param[out] Cos Cosine of the angle.
+ */
+BGE_FUNC void FastSinCos(Radians Angle, Scalar* Sin, Scalar* Cos);
+
+/*! @brief Get the approximate arc cosine of a value.
+ *
+ * Get the approximate arc cosine of a value, using a polynomial from
+ * Abramowitz and Stegun. Absolute error is below 1e-6 radians.
+ *
+ * @param[in] X Value in [-1, 1].
+ *
+ * @return Arc cosine of X in [0, pi].
+ */
+BGE_FUNC Radians FastAcos(Scalar X);
+
+} /* bakge */
+
+#ifdef BGE_MATH_INLINE
+#include <bakge/math/FastMath.inl>
+#endif /* BGE_MATH_INLINE */
+
+#endif /* BAKGE_MATH_FASTMATH_H */
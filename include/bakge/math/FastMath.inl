@@ -0,0 +1,127 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file FastMath.inl
+ * @brief Fast approximate math inline function definitions.
+ */
+
+#ifndef BAKGE_MATH_FASTMATH_INL
+#define BAKGE_MATH_FASTMATH_INL
+
+#ifdef BGE_USE_SIMD
+/* SSE instructions header */
+#include <xmmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+BGE_MATH_INL Scalar FastInvSqrt(Scalar X)
+{
+#ifdef BGE_USE_SIMD
+    Scalar Y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(X)));
+
+    return Y * (1.5f - 0.5f * X * Y * Y);
+#else
+    /* Bit-level first guess needs two more steps to match rsqrtss */
+    union
+    {
+        Scalar F;
+        uint32 I;
+    } Bits;
+
+    Bits.F = X;
+    Bits.I = 0x5F375A86 - (Bits.I >> 1);
+
+    Scalar Y = Bits.F;
+    Y = Y * (1.5f - 0.5f * X * Y * Y);
+    Y = Y * (1.5f - 0.5f * X * Y * Y);
+
+    return Y * (1.5f - 0.5f * X * Y * Y);
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL void FastSinCos(Radians Angle, Scalar* Sin, Scalar* Cos)
+{
+    /* Reduce to [-pi/4, pi/4] around the nearest multiple of pi/2 */
+    Scalar Q = Angle * 0.63661977236758134f;
+    int Quadrant = (int)(Q < 0 ? Q - 0.5f : Q + 0.5f);
+    Scalar F = (Scalar)Quadrant;
+
+    /* pi/2 split in three so the reduction loses no bits */
+    Scalar X = Angle - F * 1.5703125f;
+    X = X - F * 4.837512969970703125e-4f;
+    X = X - F * 7.54978995489188216e-8f;
+
+    /* Cephes minimax polynomials for sinf and cosf */
+    Scalar X2 = X * X;
+    Scalar S = X + X * X2 * (-1.6666654611e-1f + X2 * (8.3321608736e-3f
+                                            + X2 * -1.9515295891e-4f));
+    Scalar C = 1.0f - 0.5f * X2 + X2 * X2 * (4.166664568298827e-2f
+                + X2 * (-1.388731625493765e-3f + X2 * 2.443315711809948e-5f));
+
+    switch(Quadrant & 3) {
+    case 0:
+        *Sin = S;
+        *Cos = C;
+        break;
+    case 1:
+        *Sin = C;
+        *Cos = -S;
+        break;
+    case 2:
+        *Sin = -S;
+        *Cos = -C;
+        break;
+    default:
+        *Sin = -C;
+        *Cos = S;
+        break;
+    }
+}
+
+
+BGE_MATH_INL Radians FastAcos(Scalar X)
+{
+    Scalar A = X < 0 ? -X : X;
+
+    /* Abramowitz and Stegun 4.4.46 */
+    Scalar P = -0.0012624911f;
+    P = P * A + 0.0066700901f;
+    P = P * A - 0.0170881256f;
+    P = P * A + 0.0308918810f;
+    P = P * A - 0.0501743046f;
+    P = P * A + 0.0889789874f;
+    P = P * A - 0.2145988016f;
+    P = P * A + 1.5707963050f;
+    P *= sqrtf(1.0f - A);
+
+    return X < 0 ? 3.14159265358979f - P : P;
+}
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_FASTMATH_INL */
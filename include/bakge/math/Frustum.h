@@ -0,0 +1,151 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Frustum.h
+ * @brief Frustum class declaration.
+ */
+
+#ifndef BAKGE_MATH_FRUSTUM_H
+#define BAKGE_MATH_FRUSTUM_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Planes of a view frustum.
+ */
+enum FRUSTUM_PLANE
+{
+    FRUSTUM_LEFT = 0,
+    FRUSTUM_RIGHT,
+    FRUSTUM_BOTTOM,
+    FRUSTUM_TOP,
+    FRUSTUM_NEAR,
+    FRUSTUM_FAR,
+    NUM_FRUSTUM_PLANES
+};
+
+/*! @brief View frustum for culling.
+ *
+ * A view frustum stored as six normalized planes facing inwards. Anything
+ * on the positive side of all six is visible. Tests are conservative: a
+ * box or sphere near a frustum corner may be reported visible when it
+ * isn't, but never the other way around.
+ */
+class BGE_API BGE_ALIGN(16) Frustum
+{
+    Plane Planes[NUM_FRUSTUM_PLANES];
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief Default Frustum constructor.
+     *
+     * Default Frustum constructor. Creates a frustum that contains
+     * everything.
+     */
+    Frustum();
+
+    /*! @brief Frustum copy-constructor.
+     *
+     * Frustum copy-constructor.
+     */
+    Frustum(Frustum BGE_NCP Other);
+
+    /*! @brief Frustum destructor.
+     *
+     * Frustum destructor.
+     */
+    ~Frustum();
+
+    /*! @brief Frustum assignment operator.
+     *
+     * Frustum assignment operator.
+     *
+     * @return const reference to the Frustum after assignment.
+     */
+    Frustum BGE_NCP operator=(Frustum BGE_NCP Other);
+
+    /*! @brief Get one of the frustum's planes.
+     *
+     * Get one of the frustum's planes. Planes face into the frustum.
+     *
+     * @param[in] Which Plane to get.
+     *
+     * @return const reference to the plane.
+     */
+    Plane BGE_NCP GetPlane(FRUSTUM_PLANE Which) const;
+
+    /*! @brief Check if the frustum contains a point.
+     *
+     * Check if the frustum contains a point.
+     *
+     * @param[in] Point Point to check.
+     *
+     * @return true if the point is inside the frustum; false otherwise.
+     */
+    bool Contains(Vector4 BGE_NCP Point) const;
+
+    /*! @brief Check if a sphere is at least partly inside the frustum.
+     *
+     * Check if a sphere is at least partly inside the frustum.
+     *
+     * @param[in] Target Sphere to check.
+     *
+     * @return true if the sphere may be visible; false if it is outside.
+     */
+    bool Intersects(Sphere BGE_NCP Target) const;
+
+    /*! @brief Check if a box is at least partly inside the frustum.
+     *
+     * Check if a box is at least partly inside the frustum.
+     *
+     * @param[in] Box Box to check.
+     *
+     * @return true if the box may be visible; false if it is outside.
+     */
+    bool Intersects(AABB BGE_NCP Box) const;
+
+    /*! @brief Extract the frustum of a view and projection transformation.
+     *
+     * Extract the frustum of a view and projection transformation, using
+     * the Gribb-Hartmann method. Pass View * Projection (view applied
+     * first) to get the frustum in world space, as Camera3D::GetFrustum
+     * does, or just the projection to get it in view space.
+     *
+     * @param[in] ViewProjection Transformation to clip space.
+     *
+     * @return Frustum of the transformation.
+     */
+    static Frustum FromMatrix(Matrix BGE_NCP ViewProjection);
+
+}; /* Frustum */
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_FRUSTUM_H */
@@ -32,6 +32,21 @@
 
 #include <bakge/Bakge.h>
 
+/* *
+ * Small Vector3, Vector4, Matrix and Quaternion members and the FastMath
+ * functions are defined in .inl
+ * files. Define BGE_MATH_INLINE before including Bakge.h to have them
+ * inlined into your code; otherwise each is a call into the library. The
+ * library itself is always built without BGE_MATH_INLINE, so every one of
+ * its translation units sees the same out-of-line definitions, which it
+ * exports. Both modes link against the same binary.
+ * */
+#ifdef BGE_MATH_INLINE
+#define BGE_MATH_INL inline
+#else
+#define BGE_MATH_INL
+#endif /* BGE_MATH_INLINE */
+
 namespace bakge
 {
 
@@ -39,9 +39,10 @@ namespace bakge
  *
  * Matrices are widely used in graphics to represent position, rotation and
  * scale of objects in space, as well as for perspective, viewing
- * transforms or model transforms.
+ * transforms or model transforms. Each column is 16-byte aligned for SIMD
+ * loads and stores.
  */
-class BGE_API Matrix
+class BGE_API BGE_ALIGN(16) Matrix
 {
     union
     {
@@ -62,6 +63,8 @@ class BGE_API Matrix
 
 public:
 
+    BGE_ALIGNED_NEW(16)
+
     /*! @brief Identity matrix.
      *
      * Use whenever you need an identity matrix instead of allocating a
@@ -162,7 +165,10 @@ public:
 
     /*! @brief Invert the Matrix.
      *
-     * Invert the Matrix.
+     * Invert the Matrix. Works on any invertible 4x4 matrix, including
+     * projections. Singular matrices are left unchanged. Use InvertAffine
+     * or InvertRigid when the Matrix is known to be a model or view
+     * transform, as they are considerably cheaper.
      *
      * @return const reference to the Matrix after it has been inverted.
      */
@@ -170,12 +176,50 @@ public:
 
     /*! @brief Get the inverse of the Matrix.
      *
-     * Get the inverse of the Matrix.
+     * Get the inverse of the Matrix. Singular matrices are returned
+     * unchanged.
      *
      * @return Inverse of the Matrix.
      */
     Matrix Inverted() const;
 
+    /*! @brief Invert the Matrix, assuming it is an affine transform.
+     *
+     * Invert the Matrix, assuming its last row is (0, 0, 0, 1) i.e. it is
+     * made of any combination of translation, rotation, scale and shear.
+     * Singular matrices are left unchanged.
+     *
+     * @return const reference to the Matrix after it has been inverted.
+     */
+    Matrix BGE_NCP InvertAffine();
+
+    /*! @brief Get the inverse of the Matrix, assuming it is affine.
+     *
+     * Get the inverse of the Matrix, assuming its last row is (0, 0, 0, 1).
+     *
+     * @return Inverse of the Matrix.
+     */
+    Matrix AffineInverted() const;
+
+    /*! @brief Invert the Matrix, assuming it is a rigid transform.
+     *
+     * Invert the Matrix, assuming it is made only of rotation and
+     * translation, such as a view matrix. The upper 3x3 is transposed and
+     * the translation negated. Results are wrong if the Matrix has scale.
+     *
+     * @return const reference to the Matrix after it has been inverted.
+     */
+    Matrix BGE_NCP InvertRigid();
+
+    /*! @brief Get the inverse of the Matrix, assuming it is rigid.
+     *
+     * Get the inverse of the Matrix, assuming it is made only of rotation
+     * and translation.
+     *
+     * @return Inverse of the Matrix.
+     */
+    Matrix RigidInverted() const;
+
     /*! @brief Get the transpose of the Matrix.
      *
      * Get the transpose of the Matrix.
@@ -366,4 +410,8 @@ public:
 
 } /* bakge */
 
+#ifdef BGE_MATH_INLINE
+#include <bakge/math/Matrix.inl>
+#endif /* BGE_MATH_INLINE */
+
 #endif /* BAKGE_MATH_MATRIX_H */
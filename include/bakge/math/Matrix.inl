@@ -0,0 +1,229 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Matrix.inl
+ * @brief Matrix inline member definitions.
+ */
+
+#ifndef BAKGE_MATH_MATRIX_INL
+#define BAKGE_MATH_MATRIX_INL
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <mmintrin.h>
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+BGE_MATH_INL Matrix::Matrix()
+{
+    SetIdentity();
+}
+
+
+BGE_MATH_INL Matrix::~Matrix()
+{
+}
+
+
+BGE_MATH_INL Matrix::Matrix(Scalar A, Scalar B, Scalar C, Scalar D,
+           Scalar E, Scalar F, Scalar G, Scalar H,
+           Scalar I, Scalar J, Scalar K, Scalar L,
+           Scalar M, Scalar N, Scalar O, Scalar P)
+{
+    Val[0] = A;
+    Val[1] = B;
+    Val[2] = C;
+    Val[3] = D;
+    Val[4] = E;
+    Val[5] = F;
+    Val[6] = G;
+    Val[7] = H;
+    Val[8] = I;
+    Val[9] = J;
+    Val[10] = K;
+    Val[11] = L;
+    Val[12] = M;
+    Val[13] = N;
+    Val[14] = O;
+    Val[15] = P;
+}
+
+
+BGE_MATH_INL Matrix::Matrix(Vector4 BGE_NCP A, Vector4 BGE_NCP B,
+                            Vector4 BGE_NCP C, Vector4 BGE_NCP D)
+{
+    Val[0] = A[0];
+    Val[1] = A[1];
+    Val[2] = A[2];
+    Val[3] = A[3];
+    Val[4] = B[0];
+    Val[5] = B[1];
+    Val[6] = B[2];
+    Val[7] = B[3];
+    Val[8] = C[0];
+    Val[9] = C[1];
+    Val[10] = C[2];
+    Val[11] = C[3];
+    Val[12] = D[0];
+    Val[13] = D[1];
+    Val[14] = D[2];
+    Val[15] = D[3];
+}
+
+
+BGE_MATH_INL Matrix::Matrix(Matrix BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+BGE_MATH_INL Matrix BGE_NCP Matrix::operator=(Matrix BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(&Val[0], _mm_load_ps(&Other.Val[0]));
+    _mm_store_ps(&Val[4], _mm_load_ps(&Other.Val[4]));
+    _mm_store_ps(&Val[8], _mm_load_ps(&Other.Val[8]));
+    _mm_store_ps(&Val[12], _mm_load_ps(&Other.Val[12]));
+#else
+    for(int i=0;i<16;++i)
+        Val[i] = Other.Val[i];
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Matrix BGE_NCP Matrix::SetIdentity()
+{
+    memset((void*)Val, 0, sizeof(Scalar) * 16);
+    Val[0] = 1.0f;
+    Val[5] = 1.0f;
+    Val[10] = 1.0f;
+    Val[15] = 1.0f;
+
+    return *this;
+}
+
+
+BGE_MATH_INL Matrix Matrix::Scaling(Scalar X, Scalar Y, Scalar Z)
+{
+    return Matrix(
+        X, 0, 0, 0,
+        0, Y, 0, 0,
+        0, 0, Z, 0,
+        0, 0, 0, 1
+    );
+}
+
+
+BGE_MATH_INL Matrix Matrix::Translation(Scalar X, Scalar Y, Scalar Z)
+{
+    return Matrix(
+        1, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        X, Y, Z, 1
+    );
+}
+
+
+BGE_MATH_INL Matrix BGE_NCP Matrix::Translate(Scalar X, Scalar Y, Scalar Z)
+{
+    Val[12] += X;
+    Val[13] += Y;
+    Val[14] += Z;
+
+    return *this;
+}
+
+
+BGE_MATH_INL Scalar Matrix::Determinant() const
+{
+    /* Laplace expansion over 2x2 sub-determinants of column pairs */
+    Scalar S0 = Val[0] * Val[5] - Val[4] * Val[1];
+    Scalar S1 = Val[0] * Val[6] - Val[4] * Val[2];
+    Scalar S2 = Val[0] * Val[7] - Val[4] * Val[3];
+    Scalar S3 = Val[1] * Val[6] - Val[5] * Val[2];
+    Scalar S4 = Val[1] * Val[7] - Val[5] * Val[3];
+    Scalar S5 = Val[2] * Val[7] - Val[6] * Val[3];
+
+    Scalar C5 = Val[10] * Val[15] - Val[14] * Val[11];
+    Scalar C4 = Val[9] * Val[15] - Val[13] * Val[11];
+    Scalar C3 = Val[9] * Val[14] - Val[13] * Val[10];
+    Scalar C2 = Val[8] * Val[15] - Val[12] * Val[11];
+    Scalar C1 = Val[8] * Val[14] - Val[12] * Val[10];
+    Scalar C0 = Val[8] * Val[13] - Val[12] * Val[9];
+
+    return S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+}
+
+
+BGE_MATH_INL Matrix Matrix::Transposed() const
+{
+    return Matrix(
+        Val[0], Val[4], Val[8], Val[12],
+        Val[1], Val[5], Val[9], Val[13],
+        Val[2], Val[6], Val[10], Val[14],
+        Val[3], Val[7], Val[11], Val[15]
+    );
+}
+
+
+BGE_MATH_INL Matrix BGE_NCP Matrix::Transpose()
+{
+    Scalar Temp = Val[4];
+    Val[4] = Val[1];
+    Val[1] = Temp;
+
+    Temp = Val[8];
+    Val[8] = Val[2];
+    Val[2] = Temp;
+
+    Temp = Val[12];
+    Val[12] = Val[3];
+    Val[3] = Temp;
+
+    Temp = Val[9];
+    Val[9] = Val[6];
+    Val[6] = Temp;
+
+    Temp = Val[13];
+    Val[13] = Val[7];
+    Val[7] = Temp;
+
+    Temp = Val[14];
+    Val[14] = Val[11];
+    Val[11] = Temp;
+
+    return *this;
+}
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_MATRIX_INL */
@@ -0,0 +1,167 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Plane.h
+ * @brief Plane class declaration.
+ */
+
+#ifndef BAKGE_MATH_PLANE_H
+#define BAKGE_MATH_PLANE_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Plane in 3D space.
+ *
+ * A plane stored as the coefficients (A, B, C, D) of its equation
+ * Ax + By + Cz + D = 0. (A, B, C) is the plane's normal; when it is unit
+ * length, Distance gives true signed distances, positive on the side the
+ * normal points to.
+ */
+class BGE_API BGE_ALIGN(16) Plane
+{
+    Scalar Val[4];
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief Default Plane constructor.
+     *
+     * Default Plane constructor. Creates the XZ plane, facing +Y.
+     */
+    Plane();
+
+    /*! @brief Construct a plane from the coefficients of its equation.
+     *
+     * Construct a plane from the coefficients of its equation,
+     * Ax + By + Cz + D = 0.
+     *
+     * @param[in] A X component of the normal.
+     * @param[in] B Y component of the normal.
+     * @param[in] C Z component of the normal.
+     * @param[in] D Offset along the normal, negated.
+     */
+    Plane(Scalar A, Scalar B, Scalar C, Scalar D);
+
+    /*! @brief Plane copy-constructor.
+     *
+     * Plane copy-constructor.
+     */
+    Plane(Plane BGE_NCP Other);
+
+    /*! @brief Plane destructor.
+     *
+     * Plane destructor.
+     */
+    ~Plane();
+
+    /*! @brief Plane assignment operator.
+     *
+     * Plane assignment operator.
+     *
+     * @return const reference to the Plane after assignment.
+     */
+    Plane BGE_NCP operator=(Plane BGE_NCP Other);
+
+    /*! @brief Retrieve a coefficient of the plane's equation.
+     *
+     * Retrieve a coefficient (A, B, C or D) of the plane's equation.
+     *
+     * @return Reference to the coefficient.
+     */
+    Scalar& operator[](int At);
+
+    /*! @brief Retrieve a coefficient of the plane's equation.
+     *
+     * Retrieve a coefficient (A, B, C or D) of the plane's equation.
+     *
+     * @return const reference to the coefficient.
+     */
+    Scalar BGE_NCP operator[](int At) const;
+
+    /*! @brief Scale the plane's equation so its normal is unit length.
+     *
+     * Scale the plane's equation so its normal is unit length. The plane
+     * itself doesn't move.
+     *
+     * @return const reference to the Plane after normalization.
+     */
+    Plane BGE_NCP Normalize();
+
+    /*! @brief Get the plane's normal.
+     *
+     * Get the plane's normal, (A, B, C).
+     *
+     * @return Vector4 representing the plane's normal.
+     */
+    Vector4 GetNormal() const;
+
+    /*! @brief Get the signed distance of a point from the plane.
+     *
+     * Get the signed distance of a point from the plane. Positive on the
+     * side the normal points to. Scaled by the length of the normal if it
+     * isn't unit length.
+     *
+     * @param[in] Point Point to measure. Its W component is ignored.
+     *
+     * @return Signed distance of the point from the plane.
+     */
+    Scalar Distance(Vector4 BGE_NCP Point) const;
+
+    /*! @brief Build a plane through a point with a given normal.
+     *
+     * Build a plane through a point with a given normal.
+     *
+     * @param[in] Point Any point on the plane.
+     * @param[in] Normal Unit normal of the plane.
+     *
+     * @return Plane through Point, facing Normal.
+     */
+    static Plane FromPointAndNormal(Vector4 BGE_NCP Point,
+                                    Vector4 BGE_NCP Normal);
+
+    /*! @brief Build a plane through three points.
+     *
+     * Build a plane through three points. The plane faces the side from
+     * which A, B and C wind counter-clockwise.
+     *
+     * @param[in] A First point.
+     * @param[in] B Second point.
+     * @param[in] C Third point.
+     *
+     * @return Normalized plane through the three points.
+     */
+    static Plane FromPoints(Vector4 BGE_NCP A, Vector4 BGE_NCP B,
+                                            Vector4 BGE_NCP C);
+
+}; /* Plane */
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_PLANE_H */
@@ -56,7 +56,7 @@ namespace bakge
  * is useful for compounding rotations upon each other without building
  * rotation matrices and multiplying them instead.
  */
-class BGE_API Quaternion
+class BGE_API BGE_ALIGN(16) Quaternion
 {
     union
     {
@@ -74,6 +74,8 @@ class BGE_API Quaternion
 
 public:
 
+    BGE_ALIGNED_NEW(16)
+
     const static Quaternion Identity;
 
     /*! @brief Default Quaternion constructor.
@@ -151,7 +153,8 @@ public:
     /*! @brief Extract the angle about the quaternion's arbitrary axis
      *
      * Quaternions describe rotations about an arbitrary axis in space.
-     * This method extracts that rotation, described in radians.
+     * This method extracts that rotation, described in radians. Uses
+     * FastAcos in MATH_PRECISION_FAST mode.
      *
      * @return Scalar representing rotation in radians.
      */
@@ -171,7 +174,7 @@ public:
      *
      * Quaternions can be constructed from Euler angles. This method creates
      * a quaternion from which you can extract axis and angle data from
-     * Euler angle data.
+     * Euler angle data. Uses FastSinCos in MATH_PRECISION_FAST mode.
      *
      * @param[in] X Radian angle about the X axis.
      * @param[in] Y Radian angle about the Y axis.
@@ -183,7 +186,8 @@ public:
 
     /*! @brief Construct a quaternion from an axis and an angle.
      *
-     * Construct a quaternion from an axis and an angle.
+     * Construct a quaternion from an axis and an angle. Uses FastSinCos in
+     * MATH_PRECISION_FAST mode.
      *
      * @param[in] Axis Axis about which the rotation is described.
      * @param[in] Angle Radian angle about Axis.
@@ -395,4 +399,8 @@ public:
 
 } /* bakge */
 
+#ifdef BGE_MATH_INLINE
+#include <bakge/math/Quaternion.inl>
+#endif /* BGE_MATH_INLINE */
+
 #endif /* BAKGE_MATH_QUATERNION_H */
@@ -0,0 +1,218 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Quaternion.inl
+ * @brief Quaternion inline member definitions.
+ */
+
+#ifndef BAKGE_MATH_QUATERNION_INL
+#define BAKGE_MATH_QUATERNION_INL
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+BGE_MATH_INL Quaternion::Quaternion()
+{
+    Val[0] = 0.0f;
+    Val[1] = 0.0f;
+    Val[2] = 0.0f;
+    Val[3] = 1.0f;
+}
+
+
+BGE_MATH_INL Quaternion::Quaternion(Vector4 BGE_NCP V, Scalar R)
+{
+    Val[0] = V[0];
+    Val[1] = V[1];
+    Val[2] = V[2];
+    Val[3] = R;
+}
+
+
+BGE_MATH_INL Quaternion::Quaternion(Vector4 BGE_NCP Components)
+{
+    Val[0] = Components[0];
+    Val[1] = Components[1];
+    Val[2] = Components[2];
+    Val[3] = Components[3];
+}
+
+
+BGE_MATH_INL Quaternion::Quaternion(Scalar X, Scalar Y, Scalar Z, Scalar W)
+{
+    Val[0] = X;
+    Val[1] = Y;
+    Val[2] = Z;
+    Val[3] = W;
+}
+
+
+BGE_MATH_INL Quaternion::Quaternion(Quaternion BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_load_ps(Other.Val));
+#else
+    Val[0] = Other.Val[0];
+    Val[1] = Other.Val[1];
+    Val[2] = Other.Val[2];
+    Val[3] = Other.Val[3];
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL Quaternion::~Quaternion()
+{
+}
+
+
+BGE_MATH_INL Quaternion BGE_NCP Quaternion::operator=(Quaternion BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_load_ps(Other.Val));
+#else
+    Q0 = Other.Q0;
+    Q1 = Other.Q1;
+    Q2 = Other.Q2;
+    Q3 = Other.Q3;
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Radians Quaternion::GetAngle() const
+{
+    if(CurrentMathPrecision == MATH_PRECISION_FAST)
+        return FastAcos(Val[3]) * 2.0f;
+
+    return acosf(Val[3]) * 2.0f;
+}
+
+
+BGE_MATH_INL Quaternion BGE_NCP Quaternion::operator+=(Quaternion BGE_NCP Other)
+{
+    Val[0] += Other.Val[0];
+    Val[1] += Other.Val[1];
+    Val[2] += Other.Val[2];
+    Val[3] += Other.Val[3];
+
+    return *this;
+}
+
+
+BGE_MATH_INL Quaternion BGE_NCP Quaternion::operator-=(Quaternion BGE_NCP Other)
+{
+    Val[0] -= Other.Val[0];
+    Val[1] -= Other.Val[1];
+    Val[2] -= Other.Val[2];
+    Val[3] -= Other.Val[3];
+
+    return *this;
+}
+
+
+BGE_MATH_INL Quaternion BGE_NCP Quaternion::operator*=(Scalar BGE_NCP Value)
+{
+    Val[0] *= Value;
+    Val[1] *= Value;
+    Val[2] *= Value;
+    Val[3] *= Value;
+
+    return *this;
+}
+
+
+BGE_MATH_INL Quaternion BGE_NCP Quaternion::operator/=(Scalar BGE_NCP Value)
+{
+    Val[0] /= Value;
+    Val[1] /= Value;
+    Val[2] /= Value;
+    Val[3] /= Value;
+
+    return *this;
+}
+
+
+BGE_MATH_INL Quaternion Quaternion::operator+(Quaternion BGE_NCP Other) const
+{
+    return Quaternion(Val[0] + Other.Val[0], Val[1] + Other.Val[1],
+                        Val[2] + Other.Val[2], Val[3] + Other.Val[3]);
+}
+
+
+BGE_MATH_INL Quaternion Quaternion::operator-(Quaternion BGE_NCP Other) const
+{
+    return Quaternion(Val[0] - Other.Val[0], Val[1] - Other.Val[1],
+                        Val[2] - Other.Val[2], Val[3] - Other.Val[3]);
+}
+
+
+BGE_MATH_INL Quaternion Quaternion::operator*(Scalar BGE_NCP Value) const
+{
+    return Quaternion(Val[0] * Value, Val[1] * Value,
+                        Val[2] * Value, Val[3] * Value);
+}
+
+
+BGE_MATH_INL Quaternion Quaternion::operator/(Scalar BGE_NCP Value) const
+{
+    return Quaternion(Val[0] / Value, Val[1] / Value,
+                        Val[2] / Value, Val[3] / Value);
+}
+
+
+BGE_MATH_INL Quaternion Quaternion::operator-() const
+{
+    return Quaternion(-Val[0], -Val[1], -Val[2], -Val[3]);
+}
+
+
+BGE_MATH_INL Quaternion Quaternion::Normalized() const
+{
+    return Quaternion(*this).Normalize();
+}
+
+
+BGE_MATH_INL Scalar Quaternion::Length() const
+{
+    return sqrtf(LengthSq());
+}
+
+
+BGE_MATH_INL Scalar Quaternion::LengthSq() const
+{
+    return Val[0] * Val[0] + Val[1] * Val[1] + Val[2] * Val[2]
+                                                + Val[3] * Val[3];
+}
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_QUATERNION_INL */
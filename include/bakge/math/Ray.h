@@ -0,0 +1,155 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Ray.h
+ * @brief Ray class declaration.
+ */
+
+#ifndef BAKGE_MATH_RAY_H
+#define BAKGE_MATH_RAY_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Half-line in 3D space.
+ *
+ * A ray stored as an origin point and a direction. Intersection tests
+ * report the first hit at distance T >= 0 along the ray, in units of the
+ * direction's length, so pass a unit direction to get true distances.
+ */
+class BGE_API BGE_ALIGN(16) Ray
+{
+    Vector4 Origin;
+    Vector4 Direction;
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief Default Ray constructor.
+     *
+     * Default Ray constructor. Creates a ray from the origin along -Z.
+     */
+    Ray();
+
+    /*! @brief Construct a ray from its origin and direction.
+     *
+     * Construct a ray from its origin and direction.
+     *
+     * @param[in] O Origin of the ray.
+     * @param[in] D Direction of the ray.
+     */
+    Ray(Vector4 BGE_NCP O, Vector4 BGE_NCP D);
+
+    /*! @brief Ray copy-constructor.
+     *
+     * Ray copy-constructor.
+     */
+    Ray(Ray BGE_NCP Other);
+
+    /*! @brief Ray destructor.
+     *
+     * Ray destructor.
+     */
+    ~Ray();
+
+    /*! @brief Ray assignment operator.
+     *
+     * Ray assignment operator.
+     *
+     * @return const reference to the Ray after assignment.
+     */
+    Ray BGE_NCP operator=(Ray BGE_NCP Other);
+
+    /*! @brief Get the origin of the ray.
+     *
+     * Get the origin of the ray.
+     *
+     * @return const reference to the origin of the ray.
+     */
+    Vector4 BGE_NCP GetOrigin() const;
+
+    /*! @brief Get the direction of the ray.
+     *
+     * Get the direction of the ray.
+     *
+     * @return const reference to the direction of the ray.
+     */
+    Vector4 BGE_NCP GetDirection() const;
+
+    /*! @brief Get the point at a distance along the ray.
+     *
+     * Get the point at a distance along the ray.
+     *
+     * @param[in] T Distance along the ray.
+     *
+     * @return Origin + Direction * T.
+     */
+    Vector4 GetPoint(Scalar T) const;
+
+    /*! @brief Intersect the ray with a box.
+     *
+     * Intersect the ray with a box using the slab method. A ray starting
+     * inside the box hits it at T = 0.
+     *
+     * @param[in] Box Box to intersect.
+     * @param[out] T Distance of the first hit. May be NULL.
+     *
+     * @return true if the ray hits the box; false otherwise.
+     */
+    bool Intersects(AABB BGE_NCP Box, Scalar* T) const;
+
+    /*! @brief Intersect the ray with a sphere.
+     *
+     * Intersect the ray with a sphere. A ray starting inside the sphere
+     * hits it at T = 0.
+     *
+     * @param[in] Target Sphere to intersect.
+     * @param[out] T Distance of the first hit. May be NULL.
+     *
+     * @return true if the ray hits the sphere; false otherwise.
+     */
+    bool Intersects(Sphere BGE_NCP Target, Scalar* T) const;
+
+    /*! @brief Intersect the ray with a plane.
+     *
+     * Intersect the ray with a plane, from either side.
+     *
+     * @param[in] Target Plane to intersect.
+     * @param[out] T Distance of the hit. May be NULL.
+     *
+     * @return true if the ray hits the plane; false if it is parallel to
+     * the plane or points away from it.
+     */
+    bool Intersects(Plane BGE_NCP Target, Scalar* T) const;
+
+}; /* Ray */
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_RAY_H */
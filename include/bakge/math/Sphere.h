@@ -0,0 +1,147 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Sphere.h
+ * @brief Sphere class declaration.
+ */
+
+#ifndef BAKGE_MATH_SPHERE_H
+#define BAKGE_MATH_SPHERE_H
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/*! @brief Bounding sphere.
+ *
+ * A sphere stored as its center point and radius.
+ */
+class BGE_API BGE_ALIGN(16) Sphere
+{
+    Vector4 Center;
+    Scalar Radius;
+
+
+public:
+
+    BGE_ALIGNED_NEW(16)
+
+    /*! @brief Default Sphere constructor.
+     *
+     * Default Sphere constructor. Creates a unit sphere at the origin.
+     */
+    Sphere();
+
+    /*! @brief Construct a sphere from its center and radius.
+     *
+     * Construct a sphere from its center and radius.
+     *
+     * @param[in] C Center of the sphere.
+     * @param[in] R Radius of the sphere.
+     */
+    Sphere(Vector4 BGE_NCP C, Scalar R);
+
+    /*! @brief Sphere copy-constructor.
+     *
+     * Sphere copy-constructor.
+     */
+    Sphere(Sphere BGE_NCP Other);
+
+    /*! @brief Sphere destructor.
+     *
+     * Sphere destructor.
+     */
+    ~Sphere();
+
+    /*! @brief Sphere assignment operator.
+     *
+     * Sphere assignment operator.
+     *
+     * @return const reference to the Sphere after assignment.
+     */
+    Sphere BGE_NCP operator=(Sphere BGE_NCP Other);
+
+    /*! @brief Get the center of the sphere.
+     *
+     * Get the center of the sphere.
+     *
+     * @return const reference to the center of the sphere.
+     */
+    Vector4 BGE_NCP GetCenter() const;
+
+    /*! @brief Get the radius of the sphere.
+     *
+     * Get the radius of the sphere.
+     *
+     * @return Radius of the sphere.
+     */
+    Scalar GetRadius() const;
+
+    /*! @brief Check if the sphere contains a point.
+     *
+     * Check if the sphere contains a point. Points on the surface count.
+     *
+     * @param[in] Point Point to check.
+     *
+     * @return true if the point is inside the sphere; false otherwise.
+     */
+    bool Contains(Vector4 BGE_NCP Point) const;
+
+    /*! @brief Check if the sphere overlaps another sphere.
+     *
+     * Check if the sphere overlaps another sphere.
+     *
+     * @param[in] Other Sphere to check.
+     *
+     * @return true if the spheres overlap; false otherwise.
+     */
+    bool Intersects(Sphere BGE_NCP Other) const;
+
+    /*! @brief Check if the sphere overlaps a box.
+     *
+     * Check if the sphere overlaps a box.
+     *
+     * @param[in] Box Box to check.
+     *
+     * @return true if the sphere and box overlap; false otherwise.
+     */
+    bool Intersects(AABB BGE_NCP Box) const;
+
+    /*! @brief Get the sphere bounding a box.
+     *
+     * Get the smallest sphere bounding a box.
+     *
+     * @param[in] Box Box to bound.
+     *
+     * @return Sphere through the corners of the box.
+     */
+    static Sphere FromAABB(AABB BGE_NCP Box);
+
+}; /* Sphere */
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_SPHERE_H */
@@ -235,7 +235,7 @@ public:
      *
      * @warning Do not get the length of a point.
      */
-    Scalar Length() const;
+    Scalar LengthSquared() const;
 
     /*! @brief Get the length of a vector.
      *
@@ -245,7 +245,7 @@ public:
      *
      * @warning Do not get the length of a point.
      */
-    Scalar LengthSquared() const;
+    Scalar Length() const;
 
     /*! @brief Dot product of two vectors.
      *
@@ -273,4 +273,8 @@ public:
 
 } /* bakge */
 
+#ifdef BGE_MATH_INLINE
+#include <bakge/math/Vector3.inl>
+#endif /* BGE_MATH_INLINE */
+
 #endif /* BAKGE_MATH_VECTOR3_H */
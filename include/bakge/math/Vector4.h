@@ -39,8 +39,9 @@ namespace bakge
  *
  * Commonly used for representing points or directions in 3D Cartesian space.
  * The homogeneous fourth coordinate is often called the w-coordinate.
+ * Vector4 is 16-byte aligned so SSE builds can load it in one instruction.
  */
-class BGE_API Vector4
+class BGE_API BGE_ALIGN(16) Vector4
 {
     union
     {
@@ -58,6 +59,8 @@ class BGE_API Vector4
 
 public:
 
+    BGE_ALIGNED_NEW(16)
+
     static const Vector4 Origin;
     static const Vector4 ZeroVector;
 
@@ -236,6 +239,15 @@ public:
      */
     Vector4 BGE_NCP Normalize();
 
+    /*! @brief Normalize a vector with a fast approximation.
+     *
+     * Normalize a vector with a fast approximation, whatever the global
+     * math precision. Length is 1 to within 5e-7.
+     *
+     * @warning Do not normalize a point.
+     */
+    Vector4 BGE_NCP FastNormalize();
+
     /*! @brief Get a normalized copy of the Vector4.
      *
      * Get a normalized copy of the Vector4.
@@ -310,7 +322,8 @@ public:
 
     /*! @brief Get a unit vector (length of 1) in 3D Cartesian space.
      *
-     * Get a unit vector (length of 1) in 3D Cartesian space.
+     * Get a unit vector (length of 1) in 3D Cartesian space. Uses
+     * FastInvSqrt in MATH_PRECISION_FAST mode.
      *
      * @param[in] X X component of the vector.
      * @param[in] Y Y component of the vector.
@@ -324,4 +337,8 @@ public:
 
 } /* bakge */
 
+#ifdef BGE_MATH_INLINE
+#include <bakge/math/Vector4.inl>
+#endif /* BGE_MATH_INLINE */
+
 #endif /* BAKGE_MATH_VECTOR4_H */
@@ -0,0 +1,293 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/*!
+ * @file Vector4.inl
+ * @brief Vector4 inline member definitions.
+ */
+
+#ifndef BAKGE_MATH_VECTOR4_INL
+#define BAKGE_MATH_VECTOR4_INL
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+BGE_MATH_INL Vector4::Vector4()
+{
+    Val[0] = 0;
+    Val[1] = 0;
+    Val[2] = 0;
+    Val[3] = 1.0;
+}
+
+
+BGE_MATH_INL Vector4::Vector4(Scalar X, Scalar Y, Scalar Z, Scalar W)
+{
+    Val[0] = X;
+    Val[1] = Y;
+    Val[2] = Z;
+    Val[3] = W;
+}
+
+
+BGE_MATH_INL Vector4::Vector4(Vector4 BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_load_ps(Other.Val));
+#else
+    Val[0] = Other[0];
+    Val[1] = Other[1];
+    Val[2] = Other[2];
+    Val[3] = Other[3];
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL Vector4::~Vector4()
+{
+}
+
+
+BGE_MATH_INL Vector4 Vector4::operator-() const
+{
+    return Vector4(-Val[0], -Val[1], -Val[2], -Val[3]);
+}
+
+
+BGE_MATH_INL Vector4 Vector4::Point(Scalar X, Scalar Y, Scalar Z)
+{
+    return Vector4(X, Y, Z, 1.0);
+}
+
+
+BGE_MATH_INL Vector4 Vector4::Vector(Scalar X, Scalar Y, Scalar Z)
+{
+    return Vector4(X, Y, Z, 0);
+}
+
+
+BGE_MATH_INL Vector4 Vector4::UnitVector(Scalar X, Scalar Y, Scalar Z)
+{
+    Scalar LenSq = X * X + Y * Y + Z * Z;
+    Scalar Inv;
+
+    if(CurrentMathPrecision == MATH_PRECISION_FAST)
+        Inv = FastInvSqrt(LenSq);
+    else
+        Inv = 1.0f / sqrtf(LenSq);
+
+    return Vector4(X * Inv, Y * Inv, Z * Inv, 0);
+}
+
+
+BGE_MATH_INL Scalar& Vector4::operator[](int At)
+{
+    return Val[At];
+}
+
+
+BGE_MATH_INL Scalar BGE_NCP Vector4::operator[](int At) const
+{
+    return Val[At];
+}
+
+
+BGE_MATH_INL Vector4 BGE_NCP Vector4::operator=(Vector4 BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_load_ps(Other.Val));
+#else
+    Val[0] = Other[0];
+    Val[1] = Other[1];
+    Val[2] = Other[2];
+    Val[3] = Other[3];
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Vector4 BGE_NCP Vector4::operator+=(Vector4 BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_add_ps(_mm_load_ps(Val), _mm_load_ps(Other.Val)));
+#else
+    Val[0] += Other[0];
+    Val[1] += Other[1];
+    Val[2] += Other[2];
+    Val[3] += Other[3];
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Vector4 BGE_NCP Vector4::operator-=(Vector4 BGE_NCP Other)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_sub_ps(_mm_load_ps(Val), _mm_load_ps(Other.Val)));
+#else
+    Val[0] -= Other[0];
+    Val[1] -= Other[1];
+    Val[2] -= Other[2];
+    Val[3] -= Other[3];
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Vector4 BGE_NCP Vector4::operator*=(Scalar Value)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_mul_ps(_mm_load_ps(Val), _mm_set1_ps(Value)));
+#else
+    Val[0] *= Value;
+    Val[1] *= Value;
+    Val[2] *= Value;
+    Val[3] *= Value;
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL Vector4 BGE_NCP Vector4::operator/=(Scalar Value)
+{
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, _mm_div_ps(_mm_load_ps(Val), _mm_set1_ps(Value)));
+#else
+    Val[0] /= Value;
+    Val[1] /= Value;
+    Val[2] /= Value;
+    Val[3] /= Value;
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+BGE_MATH_INL bool Vector4::operator==(Vector4 BGE_NCP Other) const
+{
+    return ScalarCompare(Val[0], Other.Val[0])
+        && ScalarCompare(Val[1], Other.Val[1])
+        && ScalarCompare(Val[2], Other.Val[2])
+        && ScalarCompare(Val[3], Other.Val[3]);
+}
+
+
+BGE_MATH_INL Vector4 Vector4::Normalized() const
+{
+    return Vector4(*this).Normalize();
+}
+
+
+BGE_MATH_INL Scalar Vector4::LengthSquared() const
+{
+    return Dot(*this, *this);
+}
+
+
+BGE_MATH_INL Scalar Vector4::Length() const
+{
+    return sqrtf(LengthSquared());
+}
+
+
+BGE_MATH_INL Scalar Vector4::Dot(Vector4 BGE_NCP Left, Vector4 BGE_NCP Right)
+{
+#ifdef BGE_USE_SIMD
+    __m128 D = _mm_mul_ps(_mm_load_ps(Left.Val), _mm_load_ps(Right.Val));
+    D = _mm_add_ps(D, _mm_shuffle_ps(D, D, 0x4E));
+    D = _mm_add_ss(D, _mm_shuffle_ps(D, D, 0xB1));
+
+    return _mm_cvtss_f32(D);
+#else
+    return Left[0] * Right[0] + Left[1] * Right[1] + Left[2] * Right[2]
+                                                    + Left[3] * Right[3];
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL Vector4 Vector4::Cross(Vector4 BGE_NCP Left, Vector4 BGE_NCP Right)
+{
+#ifdef BGE_USE_SIMD
+    __m128 L = _mm_load_ps(Left.Val);
+    __m128 R = _mm_load_ps(Right.Val);
+
+    /* L.yzx * R.zxy - L.zxy * R.yzx; w is always 0 */
+    __m128 C = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(L, L, _MM_SHUFFLE(3, 0, 2, 1)),
+                    _mm_shuffle_ps(R, R, _MM_SHUFFLE(3, 1, 0, 2))),
+        _mm_mul_ps(_mm_shuffle_ps(L, L, _MM_SHUFFLE(3, 1, 0, 2)),
+                    _mm_shuffle_ps(R, R, _MM_SHUFFLE(3, 0, 2, 1))));
+
+    Vector4 Res;
+    _mm_store_ps(Res.Val, C);
+    Res.Val[3] = 0;
+
+    return Res;
+#else
+    return Vector4(
+        Left[1] * Right[2] - Left[2] * Right[1],
+        Left[2] * Right[0] - Left[0] * Right[2],
+        Left[0] * Right[1] - Left[1] * Right[0],
+        0
+    );
+#endif /* BGE_USE_SIMD */
+}
+
+
+BGE_MATH_INL Vector4 Vector4::operator+(Vector4 BGE_NCP Other) const
+{
+    return Vector4(*this) += Other;
+}
+
+
+BGE_MATH_INL Vector4 Vector4::operator-(Vector4 BGE_NCP Other) const
+{
+    return Vector4(*this) -= Other;
+}
+
+
+BGE_MATH_INL Vector4 Vector4::operator*(Scalar Value) const
+{
+    return Vector4(*this) *= Value;
+}
+
+
+BGE_MATH_INL Vector4 Vector4::operator/(Scalar Value) const
+{
+    return Vector4(*this) /= Value;
+}
+
+} /* bakge */
+
+#endif /* BAKGE_MATH_VECTOR4_INL */
@@ -81,7 +81,16 @@ public:
      */
     Vector4 BGE_NCP SetAnchor(Scalar X, Scalar Y, Scalar Z);
 
-    virtual Result Bind() const;
+    /*! @brief Get the model transform objects are rendered with.
+     *
+     * Get the Anchor's model transform. Scale and rotation are applied
+     * about the anchor point rather than the origin.
+     *
+     * @param[out] Model Model transform of the Anchor.
+     *
+     * @return BGE_SUCCESS.
+     */
+    virtual Result GetModelTransform(Affine* Model) const;
 
 }; /* Anchor */
 
@@ -0,0 +1,370 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <string.h>
+
+namespace bakge
+{
+
+CommandList::CommandList()
+{
+    Data = NULL;
+    Size = 0;
+    Capacity = 0;
+    NumCommands = 0;
+}
+
+
+CommandList::~CommandList()
+{
+    AlignedFree(Data);
+}
+
+
+CommandList* CommandList::Create(int ReserveBytes)
+{
+    CommandList* L = new CommandList;
+    if(L == NULL) {
+        Log("ERROR: CommandList - Couldn't allocate memory\n");
+        return NULL;
+    }
+
+    if(L->Reserve(ReserveBytes > 0 ? ReserveBytes : 4096) == BGE_FAILURE) {
+        delete L;
+        return NULL;
+    }
+
+    return L;
+}
+
+
+Result CommandList::Reserve(int NewCapacity)
+{
+    if(NewCapacity <= Capacity)
+        return BGE_SUCCESS;
+
+    char* NewData = (char*)AlignedAlloc(NewCapacity, 16);
+    if(NewData == NULL) {
+        Log("ERROR: CommandList - Couldn't allocate command data\n");
+        return BGE_FAILURE;
+    }
+
+    if(Size > 0)
+        memcpy(NewData, Data, Size);
+
+    AlignedFree(Data);
+    Data = NewData;
+    Capacity = NewCapacity;
+
+    return BGE_SUCCESS;
+}
+
+
+int CommandList::GetHeaderSize()
+{
+    return (sizeof(Command) + 15) & ~15;
+}
+
+
+int CommandList::GetDataSize(Command BGE_NCP Cmd)
+{
+    switch(Cmd.Type) {
+
+    case COMMAND_SET_MODELS:
+        return Cmd.Count * sizeof(Affine);
+
+    case COMMAND_SET_CAMERA:
+        return sizeof(CameraData);
+
+    default:
+        return 0;
+    }
+}
+
+
+CommandList::Command* CommandList::Append(COMMAND_TYPE Type, int Count,
+                                    const void* Object, int DataSize)
+{
+    int Needed = Size + GetHeaderSize() + DataSize;
+
+    if(Needed > Capacity) {
+        int NewCapacity = Capacity * 2;
+        if(NewCapacity < Needed)
+            NewCapacity = Needed;
+
+        if(Reserve(NewCapacity) == BGE_FAILURE)
+            return NULL;
+    }
+
+    Command* Cmd = (Command*)(Data + Size);
+    Cmd->Type = Type;
+    Cmd->Count = Count;
+    Cmd->Object = Object;
+
+    Size = Needed;
+    ++NumCommands;
+
+    return Cmd;
+}
+
+
+Result CommandList::BindProgram(const Shader* Program)
+{
+    if(Append(COMMAND_BIND_PROGRAM, 0, Program, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::UnbindProgram(const Shader* Program)
+{
+    if(Append(COMMAND_UNBIND_PROGRAM, 0, Program, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::BindTexture(const Texture* Tex)
+{
+    if(Append(COMMAND_BIND_TEXTURE, 0, Tex, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::UnbindTexture(const Texture* Tex)
+{
+    if(Append(COMMAND_UNBIND_TEXTURE, 0, Tex, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::BindMesh(const Mesh* Geometry)
+{
+    if(Append(COMMAND_BIND_MESH, 0, Geometry, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::UnbindMesh(const Mesh* Geometry)
+{
+    if(Append(COMMAND_UNBIND_MESH, 0, Geometry, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::BindModel(const Node* Model)
+{
+    if(Append(COMMAND_BIND_MODEL, 0, Model, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::UnbindModel(const Node* Model)
+{
+    if(Append(COMMAND_UNBIND_MODEL, 0, Model, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::SetModels(int Count, const Affine* Models)
+{
+    if(Count < 1 || Count > BGE_INSTANCE_RING_SIZE) {
+        Log("ERROR: CommandList - Invalid number of model transforms\n");
+        return BGE_FAILURE;
+    }
+
+    int Bytes = Count * sizeof(Affine);
+    Command* Cmd = Append(COMMAND_SET_MODELS, Count, NULL, Bytes);
+    if(Cmd == NULL)
+        return BGE_FAILURE;
+
+    memcpy((char*)Cmd + GetHeaderSize(), Models, Bytes);
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::SetCamera(Matrix BGE_NCP Projection,
+                    Matrix BGE_NCP View, Vector4 BGE_NCP Position)
+{
+    Command* Cmd = Append(COMMAND_SET_CAMERA, 0, NULL, sizeof(CameraData));
+    if(Cmd == NULL)
+        return BGE_FAILURE;
+
+    CameraData* Camera = (CameraData*)((char*)Cmd + GetHeaderSize());
+    Camera->Projection = Projection;
+    Camera->View = View;
+    Camera->Position = Position;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::Draw(const Mesh* Geometry)
+{
+    if(Append(COMMAND_DRAW, 0, Geometry, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::DrawInstanced(const Mesh* Geometry, int Count)
+{
+    if(Append(COMMAND_DRAW_INSTANCED, Count, Geometry, 0) == NULL)
+        return BGE_FAILURE;
+
+    return BGE_SUCCESS;
+}
+
+
+Result CommandList::Execute() const
+{
+    Result Res = BGE_SUCCESS;
+    const char* At = Data;
+    const char* End = Data + Size;
+    int HeaderSize = GetHeaderSize();
+
+    while(At < End) {
+        const Command* Cmd = (const Command*)At;
+        const char* CmdData = At + HeaderSize;
+        Result CmdRes = BGE_SUCCESS;
+
+        switch(Cmd->Type) {
+
+        case COMMAND_BIND_PROGRAM:
+            CmdRes = ((const Shader*)Cmd->Object)->Bind();
+            break;
+
+        case COMMAND_UNBIND_PROGRAM:
+            CmdRes = ((const Shader*)Cmd->Object)->Unbind();
+            break;
+
+        case COMMAND_BIND_TEXTURE:
+            CmdRes = ((const Texture*)Cmd->Object)->Bind();
+            break;
+
+        case COMMAND_UNBIND_TEXTURE:
+            CmdRes = ((const Texture*)Cmd->Object)->Unbind();
+            break;
+
+        case COMMAND_BIND_MESH:
+            CmdRes = ((const Mesh*)Cmd->Object)->Bind();
+            break;
+
+        case COMMAND_UNBIND_MESH:
+            CmdRes = ((const Mesh*)Cmd->Object)->Unbind();
+            break;
+
+        case COMMAND_BIND_MODEL:
+            CmdRes = ((const Node*)Cmd->Object)->Bind();
+            break;
+
+        case COMMAND_UNBIND_MODEL:
+            CmdRes = ((const Node*)Cmd->Object)->Unbind();
+            break;
+
+        case COMMAND_SET_MODELS:
+            CmdRes = InstanceBuffer::BindModels(Cmd->Count,
+                                                (const Affine*)CmdData);
+            break;
+
+        case COMMAND_SET_CAMERA: {
+            const CameraData* Camera = (const CameraData*)CmdData;
+            CmdRes = FrameUniforms::SetCamera(Camera->Projection,
+                                        Camera->View, Camera->Position);
+            break;
+        }
+
+        case COMMAND_DRAW:
+            CmdRes = ((const Mesh*)Cmd->Object)->Draw();
+            break;
+
+        case COMMAND_DRAW_INSTANCED:
+            CmdRes = ((const Mesh*)Cmd->Object)->DrawInstanced(Cmd->Count);
+            break;
+
+        default:
+            break;
+        }
+
+        if(CmdRes == BGE_FAILURE)
+            Res = BGE_FAILURE;
+
+        At = CmdData + GetDataSize(*Cmd);
+    }
+
+    return Res;
+}
+
+
+Result CommandList::Execute(int NumLists, const CommandList* const* Lists)
+{
+    Result Res = BGE_SUCCESS;
+
+    for(int i=0;i<NumLists;++i) {
+        if(Lists[i] != NULL && Lists[i]->Execute() == BGE_FAILURE)
+            Res = BGE_FAILURE;
+    }
+
+    return Res;
+}
+
+
+Result CommandList::Clear()
+{
+    Size = 0;
+    NumCommands = 0;
+
+    return BGE_SUCCESS;
+}
+
+
+int CommandList::GetNumCommands() const
+{
+    return NumCommands;
+}
+
+
+int CommandList::GetSize() const
+{
+    return Size;
+}
+
+} /* bakge */
@@ -24,16 +24,601 @@
 
 #include <bakge/Bakge.h>
 
+/* *
+ * Sort key layout, most significant bits first:
+ *   layer (8) | program (12) | texture (12) | mesh (12) | depth (20)
+ * Back-to-front layers instead use:
+ *   layer (8) | inverted depth (31) | program (12) | texture (12)
+ * */
+#define BGE_KEY_LAYER_SHIFT 56
+#define BGE_KEY_PROGRAM_SHIFT 44
+#define BGE_KEY_TEXTURE_SHIFT 32
+#define BGE_KEY_MESH_SHIFT 20
+#define BGE_KEY_ID_MASK 0xFFF
+#define BGE_KEY_DEPTH_MASK 0xFFFFF
+
 namespace bakge
 {
 
+/* *
+ * Objects don't carry IDs, so key fields hold a 12-bit hash of their
+ * address. A collision only interleaves two states, costing extra binds;
+ * binds themselves compare the actual objects
+ * */
+static uint64 GetStateID(const void* State)
+{
+    if(State == NULL)
+        return 0;
+
+    uint32 Bits = (uint32)((size_t)State >> 4);
+
+    return (uint64)((Bits * 2654435761u) >> 20) & BGE_KEY_ID_MASK;
+}
+
+
+/* *
+ * Non-negative floats order the same as their bit patterns, so the top
+ * bits make a quantized depth with constant relative precision
+ * */
+static uint32 GetDepthBits(Scalar Depth)
+{
+    if(!(Depth > 0))
+        return 0;
+
+    float F = (float)Depth;
+    uint32 Bits;
+    memcpy((void*)&Bits, (const void*)&F, sizeof(Bits));
+
+    return Bits;
+}
+
+
 Renderer::Renderer()
 {
+    Items = NULL;
+    NumItems = 0;
+    Capacity = 0;
+    Keys = NULL;
+    KeysScratch = NULL;
+    Order = NULL;
+    OrderScratch = NULL;
+    Models = NULL;
+    Transforms = NULL;
+    Boxes = NULL;
+    Visible = NULL;
+    Culling = true;
+    Occlusion = NULL;
+    Commands = NULL;
+    NumDraws = 0;
+    NumBinds = 0;
+    NumInstanced = 0;
+    NumVisible = 0;
+    NumCulled = 0;
+    NumOccluded = 0;
+
+    for(int i=0;i<BGE_RENDER_LAYERS;++i)
+        BackToFront[i] = false;
 }
 
 
 Renderer::~Renderer()
 {
+    delete[] Items;
+    delete[] Keys;
+    delete[] KeysScratch;
+    delete[] Order;
+    delete[] OrderScratch;
+    delete[] Models;
+    delete[] Transforms;
+    delete[] Boxes;
+    delete[] Visible;
+    delete Commands;
+}
+
+
+Renderer* Renderer::Create(int ReserveItems)
+{
+    Renderer* R = new Renderer;
+    if(R == NULL) {
+        Log("ERROR: Renderer - Couldn't allocate memory\n");
+        return NULL;
+    }
+
+    if(R->Reserve(ReserveItems > 0 ? ReserveItems : 64) == BGE_FAILURE) {
+        delete R;
+        return NULL;
+    }
+
+    R->Commands = CommandList::Create(0);
+    if(R->Commands == NULL) {
+        delete R;
+        return NULL;
+    }
+
+    return R;
+}
+
+
+Result Renderer::Reserve(int NewCapacity)
+{
+    if(NewCapacity <= Capacity)
+        return BGE_SUCCESS;
+
+    DrawItem* NewItems = new DrawItem[NewCapacity];
+    uint64* NewKeys = new uint64[NewCapacity];
+    uint64* NewKeysScratch = new uint64[NewCapacity];
+    int* NewOrder = new int[NewCapacity];
+    int* NewOrderScratch = new int[NewCapacity];
+    Affine* NewModels = new Affine[NewCapacity];
+    Affine* NewTransforms = new Affine[NewCapacity];
+    Scalar* NewBoxes = new Scalar[NewCapacity * 6];
+    uint32* NewVisible = new uint32[(NewCapacity + 31) / 32];
+
+    if(NewItems == NULL || NewKeys == NULL || NewKeysScratch == NULL
+                        || NewOrder == NULL || NewOrderScratch == NULL
+                        || NewModels == NULL || NewTransforms == NULL
+                            || NewBoxes == NULL || NewVisible == NULL) {
+        Log("ERROR: Renderer - Couldn't allocate draw items\n");
+        delete[] NewItems;
+        delete[] NewKeys;
+        delete[] NewKeysScratch;
+        delete[] NewOrder;
+        delete[] NewOrderScratch;
+        delete[] NewModels;
+        delete[] NewTransforms;
+        delete[] NewBoxes;
+        delete[] NewVisible;
+        return BGE_FAILURE;
+    }
+
+    for(int i=0;i<NumItems;++i)
+        NewItems[i] = Items[i];
+
+    delete[] Items;
+    delete[] Keys;
+    delete[] KeysScratch;
+    delete[] Order;
+    delete[] OrderScratch;
+    delete[] Models;
+    delete[] Transforms;
+    delete[] Boxes;
+    delete[] Visible;
+
+    Items = NewItems;
+    Keys = NewKeys;
+    KeysScratch = NewKeysScratch;
+    Order = NewOrder;
+    OrderScratch = NewOrderScratch;
+    Models = NewModels;
+    Transforms = NewTransforms;
+    Boxes = NewBoxes;
+    Visible = NewVisible;
+    Capacity = NewCapacity;
+
+    return BGE_SUCCESS;
+}
+
+
+Result Renderer::Submit(int Layer, const Shader* Program, const Texture* Tex,
+                                    const Mesh* Geometry, const Node* Model)
+{
+    if(Layer < 0 || Layer >= BGE_RENDER_LAYERS) {
+        Log("ERROR: Renderer - Layer %d out of range\n", Layer);
+        return BGE_FAILURE;
+    }
+
+    if(Program == NULL || Geometry == NULL) {
+        Log("ERROR: Renderer - Draw items need a Shader and a Mesh\n");
+        return BGE_FAILURE;
+    }
+
+    if(NumItems == Capacity && Reserve(Capacity * 2) == BGE_FAILURE)
+        return BGE_FAILURE;
+
+    DrawItem& Item = Items[NumItems++];
+    Item.Layer = Layer;
+    Item.Program = Program;
+    Item.Tex = Tex;
+    Item.Geometry = Geometry;
+    Item.Model = Model;
+    Item.HasTransform = false;
+
+    return BGE_SUCCESS;
+}
+
+
+void Renderer::Cull()
+{
+    /* Streams of center x, y, z and extent x, y, z, NumItems apart */
+    Scalar* CX = Boxes;
+    Scalar* CY = Boxes + NumItems;
+    Scalar* CZ = Boxes + NumItems * 2;
+    Scalar* EX = Boxes + NumItems * 3;
+    Scalar* EY = Boxes + NumItems * 4;
+    Scalar* EZ = Boxes + NumItems * 5;
+
+    for(int i=0;i<NumItems;++i) {
+        DrawItem& Item = Items[i];
+
+        Item.HasTransform = Item.Model != NULL
+            && Item.Model->GetModelTransform(&Transforms[i]) == BGE_SUCCESS;
+
+        AABB BGE_NCP Bounds = Item.Geometry->GetBounds();
+        if(!Item.HasTransform || Bounds.IsEmpty()) {
+            /* Culled regardless; visibility is forced below */
+            CX[i] = CY[i] = CZ[i] = 0;
+            EX[i] = EY[i] = EZ[i] = 0;
+            continue;
+        }
+
+        /* Arvo's method, straight from the rows of the Affine */
+        Affine BGE_NCP M = Transforms[i];
+        Vector4 Center = M.TransformPoint(Bounds.GetCenter());
+        Vector4 Extents = Bounds.GetExtents();
+
+        CX[i] = Center[0];
+        CY[i] = Center[1];
+        CZ[i] = Center[2];
+        EX[i] = fabs(M[0]) * Extents[0] + fabs(M[1]) * Extents[1]
+                                        + fabs(M[2]) * Extents[2];
+        EY[i] = fabs(M[4]) * Extents[0] + fabs(M[5]) * Extents[1]
+                                        + fabs(M[6]) * Extents[2];
+        EZ[i] = fabs(M[8]) * Extents[0] + fabs(M[9]) * Extents[1]
+                                        + fabs(M[10]) * Extents[2];
+    }
+
+    if(Culling) {
+        CullBoxesSoA(Frustum::FromMatrix(FrameUniforms::GetViewProjection()),
+                                                Boxes, NumItems, Visible);
+    } else {
+        memset((void*)Visible, 0xFF, sizeof(uint32) * ((NumItems + 31) / 32));
+    }
+
+    if(Occlusion != NULL) {
+        /* Keep draws that can't be culled out of the occlusion test */
+        for(int i=0;i<NumItems;++i) {
+            if(!Items[i].HasTransform
+                        || Items[i].Geometry->GetBounds().IsEmpty())
+                Visible[i >> 5] &= ~(1u << (i & 31));
+        }
+
+        NumOccluded = Occlusion->TestBoxesSoA(Boxes, NumItems, Visible);
+    }
+
+    /* Draws without a transform or bounds can't be culled */
+    for(int i=0;i<NumItems;++i) {
+        if(!Items[i].HasTransform || Items[i].Geometry->GetBounds().IsEmpty())
+            Visible[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+
+int Renderer::BuildKeys()
+{
+    Matrix BGE_NCP View = FrameUniforms::GetView();
+    int Count = 0;
+
+    for(int i=0;i<NumItems;++i) {
+        if(!((Visible[i >> 5] >> (i & 31)) & 1))
+            continue;
+
+        const DrawItem& Item = Items[i];
+
+        /* Distance in front of the camera; view space looks down -Z */
+        uint32 Depth = 0;
+        if(Item.Model != NULL)
+            Depth = GetDepthBits(-(View * Item.Model->GetPosition())[2]);
+
+        uint64 Key = (uint64)Item.Layer << BGE_KEY_LAYER_SHIFT;
+
+        if(BackToFront[Item.Layer]) {
+            Key |= (uint64)(0x7FFFFFFF - (Depth & 0x7FFFFFFF)) << 24;
+            Key |= GetStateID(Item.Program) << 12;
+            Key |= GetStateID(Item.Tex);
+        } else {
+            Key |= GetStateID(Item.Program) << BGE_KEY_PROGRAM_SHIFT;
+            Key |= GetStateID(Item.Tex) << BGE_KEY_TEXTURE_SHIFT;
+            Key |= GetStateID(Item.Geometry) << BGE_KEY_MESH_SHIFT;
+            Key |= (uint64)((Depth >> 11) & BGE_KEY_DEPTH_MASK);
+        }
+
+        Keys[Count] = Key;
+        Order[Count] = i;
+        ++Count;
+    }
+
+    return Count;
+}
+
+
+void Renderer::SortKeys(int Count)
+{
+    if(Count == 0)
+        return;
+
+    int Counts[8][256];
+
+    memset((void*)Counts, 0, sizeof(Counts));
+
+    /* Histogram every byte in one pass over the keys */
+    for(int i=0;i<Count;++i) {
+        uint64 Key = Keys[i];
+        for(int b=0;b<8;++b)
+            ++Counts[b][(Key >> (b * 8)) & 0xFF];
+    }
+
+    for(int b=0;b<8;++b) {
+        /* Every key has the same byte here; the pass wouldn't move them */
+        if(Counts[b][(Keys[0] >> (b * 8)) & 0xFF] == Count)
+            continue;
+
+        int Offsets[256];
+        int Sum = 0;
+        for(int d=0;d<256;++d) {
+            Offsets[d] = Sum;
+            Sum += Counts[b][d];
+        }
+
+        /* Stable scatter, so earlier bytes' order is kept */
+        for(int i=0;i<Count;++i) {
+            int To = Offsets[(Keys[i] >> (b * 8)) & 0xFF]++;
+            KeysScratch[To] = Keys[i];
+            OrderScratch[To] = Order[i];
+        }
+
+        uint64* SwapKeys = Keys;
+        Keys = KeysScratch;
+        KeysScratch = SwapKeys;
+
+        int* SwapOrder = Order;
+        Order = OrderScratch;
+        OrderScratch = SwapOrder;
+    }
+}
+
+
+Result Renderer::Flush()
+{
+    Result Res = Record(Commands);
+
+    if(Commands->Execute() == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    Commands->Clear();
+
+    return Res;
+}
+
+
+Result Renderer::Record(CommandList* Target)
+{
+    NumDraws = 0;
+    NumBinds = 0;
+    NumInstanced = 0;
+    NumVisible = 0;
+    NumCulled = 0;
+    NumOccluded = 0;
+
+    if(NumItems == 0)
+        return BGE_SUCCESS;
+
+    Cull();
+    NumVisible = BuildKeys();
+    NumCulled = NumItems - NumVisible;
+    SortKeys(NumVisible);
+
+    Result Res = BGE_SUCCESS;
+    const Shader* CurrentProgram = NULL;
+    const Texture* CurrentTexture = NULL;
+    const Mesh* CurrentMesh = NULL;
+    const Node* LastModel = NULL;
+
+    int i = 0;
+    while(i < NumVisible) {
+        const DrawItem& Item = Items[Order[i]];
+
+        if(Item.Program != CurrentProgram) {
+            /* Attribute locations belong to the previous program */
+            if(LastModel != NULL && Target->UnbindModel(LastModel)
+                                                        == BGE_FAILURE)
+                Res = BGE_FAILURE;
+            if(CurrentMesh != NULL && Target->UnbindMesh(CurrentMesh)
+                                                        == BGE_FAILURE)
+                Res = BGE_FAILURE;
+
+            if(Target->BindProgram(Item.Program) == BGE_FAILURE)
+                Res = BGE_FAILURE;
+
+            ++NumBinds;
+            CurrentProgram = Item.Program;
+            CurrentMesh = NULL;
+            LastModel = NULL;
+        }
+
+        if(Item.Tex != CurrentTexture) {
+            if(Item.Tex != NULL) {
+                if(Target->BindTexture(Item.Tex) == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+            } else {
+                if(Target->UnbindTexture(CurrentTexture) == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+            }
+
+            ++NumBinds;
+            CurrentTexture = Item.Tex;
+        }
+
+        if(Item.Geometry != CurrentMesh) {
+            if(CurrentMesh != NULL && Target->UnbindMesh(CurrentMesh)
+                                                        == BGE_FAILURE)
+                Res = BGE_FAILURE;
+
+            if(Target->BindMesh(Item.Geometry) == BGE_FAILURE)
+                Res = BGE_FAILURE;
+
+            ++NumBinds;
+            CurrentMesh = Item.Geometry;
+        }
+
+        /* Gather the model transforms of following draws of this state */
+        int Count = 0;
+        if(Item.HasTransform) {
+            while(i + Count < NumVisible && Count < BGE_INSTANCE_RING_SIZE) {
+                int Next = Order[i + Count];
+                if(Items[Next].Program != Item.Program
+                            || Items[Next].Tex != Item.Tex
+                            || Items[Next].Geometry != Item.Geometry
+                            || !Items[Next].HasTransform)
+                    break;
+
+                Models[Count++] = Transforms[Next];
+            }
+        }
+
+        if(Count > 0) {
+            if(Target->SetModels(Count, Models) == BGE_FAILURE)
+                Res = BGE_FAILURE;
+
+            LastModel = Item.Model;
+
+            if(Count == 1) {
+                if(Target->Draw(Item.Geometry) == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+            } else {
+                if(Target->DrawInstanced(Item.Geometry, Count)
+                                                        == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+
+                NumInstanced += Count;
+            }
+
+            i += Count;
+        } else {
+            /* No model, or one that must bind itself like a Crowd */
+            int Instances = 1;
+            if(Item.Model != NULL) {
+                if(Target->BindModel(Item.Model) == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+                LastModel = Item.Model;
+                Instances = Item.Model->GetNumInstances();
+            }
+
+            if(Instances == 1) {
+                if(Target->Draw(Item.Geometry) == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+            } else if(Instances > 1) {
+                if(Target->DrawInstanced(Item.Geometry, Instances)
+                                                        == BGE_FAILURE)
+                    Res = BGE_FAILURE;
+            }
+
+            ++i;
+
+            /* An empty Crowd has nothing to draw */
+            if(Instances < 1)
+                continue;
+        }
+
+        ++NumDraws;
+    }
+
+    if(LastModel != NULL && Target->UnbindModel(LastModel) == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    if(CurrentMesh != NULL && Target->UnbindMesh(CurrentMesh)
+                                                    == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    if(CurrentTexture != NULL && Target->UnbindTexture(CurrentTexture)
+                                                    == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    if(CurrentProgram != NULL && Target->UnbindProgram(CurrentProgram)
+                                                    == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    NumItems = 0;
+
+    return Res;
+}
+
+
+Result Renderer::Clear()
+{
+    NumItems = 0;
+
+    return BGE_SUCCESS;
+}
+
+
+Result Renderer::SetBackToFront(int Layer, bool Enabled)
+{
+    if(Layer < 0 || Layer >= BGE_RENDER_LAYERS) {
+        Log("ERROR: Renderer - Layer %d out of range\n", Layer);
+        return BGE_FAILURE;
+    }
+
+    BackToFront[Layer] = Enabled;
+
+    return BGE_SUCCESS;
+}
+
+
+Result Renderer::SetCulling(bool Enabled)
+{
+    Culling = Enabled;
+
+    return BGE_SUCCESS;
+}
+
+
+Result Renderer::SetOcclusionCuller(const OcclusionCuller* Culler)
+{
+    Occlusion = Culler;
+
+    return BGE_SUCCESS;
+}
+
+
+int Renderer::GetNumItems() const
+{
+    return NumItems;
+}
+
+
+int Renderer::GetNumVisible() const
+{
+    return NumVisible;
+}
+
+
+int Renderer::GetNumCulled() const
+{
+    return NumCulled;
+}
+
+
+int Renderer::GetNumOccluded() const
+{
+    return NumOccluded;
+}
+
+
+int Renderer::GetNumDraws() const
+{
+    return NumDraws;
+}
+
+
+int Renderer::GetNumInstanced() const
+{
+    return NumInstanced;
+}
+
+
+int Renderer::GetNumBinds() const
+{
+    return NumBinds;
 }
 
 } /* bakge */
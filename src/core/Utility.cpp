@@ -24,6 +24,7 @@
 
 #include <bakge/Bakge.h>
 #include <bakge/internal/Utility.h>
+#include <bakge/internal/MathKernels.h>
 #ifdef _DEBUG
 #include <bakge/internal/Debug.h>
 #endif // _DEBUG
@@ -105,6 +106,10 @@ Result Init(int argc, char* argv[])
     if(PlatformInit(argc, argv) != BGE_SUCCESS)
         return Deinit();
 
+    /* Pick the best math kernels for this CPU */
+    if(InitMathKernels() != BGE_SUCCESS)
+        return Deinit();
+
     /* Initialize our Bakge shader library */
     if(Shader::InitShaderLibrary() != BGE_SUCCESS) {
         Log("Failed to initialize shader library\n");
@@ -128,6 +133,9 @@ Result Init(int argc, char* argv[])
 
 Result Deinit()
 {
+    /* Pending compiles may still log and write binaries; finish them first */
+    Shader::DeinitShaderLibrary();
+
     if(LogFile != NULL && PHYSFS_close(LogFile) == 0) {
         fprintf(stderr, "Error closing log file\n");
     }
@@ -141,8 +149,6 @@ Result Deinit()
     /* Run platform-specific deinitialization protocol */
     PlatformDeinit();
 
-    Shader::DeinitShaderLibrary();
-
     /* Destroy our shared context window */
     if(Window::SharedContext != NULL)
         glfwDestroyWindow(Window::SharedContext);
@@ -239,4 +245,37 @@ int Log(const char* Format, ...)
     return Len;
 }
 
+
+
+void* AlignedAlloc(size_t Size, size_t Alignment)
+{
+    /* Alignment must be a power of two at least as large as a pointer */
+    if(Alignment < sizeof(void*) || (Alignment & (Alignment - 1)) != 0)
+        return NULL;
+
+    /* *
+     * Over-allocate so the block can be aligned, and stash the pointer
+     * malloc returned just before the aligned block so it can be freed
+     * */
+    Byte* Block = (Byte*)malloc(Size + Alignment + sizeof(void*));
+    if(Block == NULL)
+        return NULL;
+
+    size_t Address = (size_t)(Block + sizeof(void*));
+    Address = (Address + Alignment - 1) & ~(Alignment - 1);
+
+    ((void**)Address)[-1] = (void*)Block;
+
+    return (void*)Address;
+}
+
+
+void AlignedFree(void* Memory)
+{
+    if(Memory == NULL)
+        return;
+
+    free(((void**)Memory)[-1]);
+}
+
 } /* bakge */
@@ -0,0 +1,732 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+/* Half the surface area of a box; proportional to the odds of a hit */
+static Scalar GetArea(const Scalar* Min, const Scalar* Max)
+{
+    Scalar X = Max[0] - Min[0];
+    Scalar Y = Max[1] - Min[1];
+    Scalar Z = Max[2] - Min[2];
+
+    return X * Y + Y * Z + Z * X;
+}
+
+
+static Scalar GetUnionArea(const Scalar* MinA, const Scalar* MaxA,
+                                const Scalar* MinB, const Scalar* MaxB)
+{
+    Scalar Min[3];
+    Scalar Max[3];
+
+    for(int i=0;i<3;++i) {
+        Min[i] = MinA[i] < MinB[i] ? MinA[i] : MinB[i];
+        Max[i] = MaxA[i] > MaxB[i] ? MaxA[i] : MaxB[i];
+    }
+
+    return GetArea(Min, Max);
+}
+
+
+AABBTree::AABBTree()
+{
+    Nodes = NULL;
+    Capacity = 0;
+    Root = -1;
+    FreeList = -1;
+    NumProxies = 0;
+    Margin = 0;
+}
+
+
+AABBTree::~AABBTree()
+{
+    delete[] Nodes;
+}
+
+
+AABBTree* AABBTree::Create(Scalar FatMargin)
+{
+    AABBTree* T = new AABBTree;
+    if(T == NULL) {
+        Log("ERROR: AABBTree - Couldn't allocate memory\n");
+        return NULL;
+    }
+
+    if(T->Reserve(32) == BGE_FAILURE) {
+        delete T;
+        return NULL;
+    }
+
+    T->Margin = FatMargin > 0 ? FatMargin : 0;
+
+    return T;
+}
+
+
+Result AABBTree::Reserve(int NewCapacity)
+{
+    if(NewCapacity <= Capacity)
+        return BGE_SUCCESS;
+
+    TreeNode* NewNodes = new TreeNode[NewCapacity];
+    if(NewNodes == NULL) {
+        Log("ERROR: AABBTree - Couldn't allocate tree nodes\n");
+        return BGE_FAILURE;
+    }
+
+    for(int i=0;i<Capacity;++i)
+        NewNodes[i] = Nodes[i];
+
+    /* Chain the new nodes so the lowest are handed out first */
+    for(int i=NewCapacity-1;i>=Capacity;--i) {
+        NewNodes[i].Height = -1;
+        NewNodes[i].Parent = FreeList;
+        FreeList = i;
+    }
+
+    delete[] Nodes;
+    Nodes = NewNodes;
+    Capacity = NewCapacity;
+
+    return BGE_SUCCESS;
+}
+
+
+int AABBTree::AllocateNode()
+{
+    /* Callers reserve enough nodes beforehand */
+    int Node = FreeList;
+    FreeList = Nodes[Node].Parent;
+
+    Nodes[Node].Data = NULL;
+    Nodes[Node].Parent = -1;
+    Nodes[Node].Left = -1;
+    Nodes[Node].Right = -1;
+    Nodes[Node].Height = 0;
+
+    return Node;
+}
+
+
+void AABBTree::FreeNode(int Node)
+{
+    Nodes[Node].Data = NULL;
+    Nodes[Node].Height = -1;
+    Nodes[Node].Parent = FreeList;
+    FreeList = Node;
+}
+
+
+void AABBTree::SetFatBounds(int Leaf, AABB BGE_NCP Bounds)
+{
+    Vector4 BGE_NCP Min = Bounds.GetMin();
+    Vector4 BGE_NCP Max = Bounds.GetMax();
+
+    for(int i=0;i<3;++i) {
+        Nodes[Leaf].Min[i] = Min[i] - Margin;
+        Nodes[Leaf].Max[i] = Max[i] + Margin;
+    }
+}
+
+
+void AABBTree::Refit(int Node)
+{
+    TreeNode& N = Nodes[Node];
+    TreeNode BGE_NCP L = Nodes[N.Left];
+    TreeNode BGE_NCP R = Nodes[N.Right];
+
+    for(int i=0;i<3;++i) {
+        N.Min[i] = L.Min[i] < R.Min[i] ? L.Min[i] : R.Min[i];
+        N.Max[i] = L.Max[i] > R.Max[i] ? L.Max[i] : R.Max[i];
+    }
+
+    N.Height = 1 + (L.Height > R.Height ? L.Height : R.Height);
+}
+
+
+int AABBTree::Rotate(int Node, int Up)
+{
+    int High = Nodes[Up].Left;
+    int Low = Nodes[Up].Right;
+
+    if(Nodes[High].Height < Nodes[Low].Height) {
+        High = Nodes[Up].Right;
+        Low = Nodes[Up].Left;
+    }
+
+    /* Up takes the place of Node */
+    int Parent = Nodes[Node].Parent;
+    Nodes[Up].Parent = Parent;
+    if(Parent < 0)
+        Root = Up;
+    else if(Nodes[Parent].Left == Node)
+        Nodes[Parent].Left = Up;
+    else
+        Nodes[Parent].Right = Up;
+
+    /* Node moves down, trading Up for its shorter child */
+    if(Nodes[Node].Left == Up)
+        Nodes[Node].Left = Low;
+    else
+        Nodes[Node].Right = Low;
+
+    Nodes[Low].Parent = Node;
+    Nodes[Node].Parent = Up;
+    Nodes[Up].Left = Node;
+    Nodes[Up].Right = High;
+
+    Refit(Node);
+    Refit(Up);
+
+    return Up;
+}
+
+
+int AABBTree::Balance(int Node)
+{
+    if(Nodes[Node].Left < 0 || Nodes[Node].Height < 2)
+        return Node;
+
+    int Left = Nodes[Node].Left;
+    int Right = Nodes[Node].Right;
+    int Difference = Nodes[Right].Height - Nodes[Left].Height;
+
+    if(Difference > 1)
+        return Rotate(Node, Right);
+
+    if(Difference < -1)
+        return Rotate(Node, Left);
+
+    return Node;
+}
+
+
+void AABBTree::FixUpwards(int Node)
+{
+    while(Node >= 0) {
+        Refit(Node);
+        Node = Balance(Node);
+        Node = Nodes[Node].Parent;
+    }
+}
+
+
+void AABBTree::InsertLeaf(int Leaf)
+{
+    if(Root < 0) {
+        Root = Leaf;
+        Nodes[Leaf].Parent = -1;
+        return;
+    }
+
+    TreeNode BGE_NCP L = Nodes[Leaf];
+
+    /* *
+     * Descend towards the sibling that grows the tree's total area the
+     * least. Pairing with a node costs the area of the new parent plus
+     * the growth of every ancestor; descending further adds the growth
+     * of the node itself
+     * */
+    int Index = Root;
+    while(Nodes[Index].Left >= 0) {
+        TreeNode BGE_NCP N = Nodes[Index];
+        Scalar Area = GetArea(N.Min, N.Max);
+        Scalar Combined = GetUnionArea(N.Min, N.Max, L.Min, L.Max);
+        Scalar Cost = 2 * Combined;
+        Scalar Inherited = 2 * (Combined - Area);
+
+        Scalar ChildCosts[2];
+        int Children[2] = { N.Left, N.Right };
+        for(int i=0;i<2;++i) {
+            TreeNode BGE_NCP C = Nodes[Children[i]];
+            ChildCosts[i] = GetUnionArea(C.Min, C.Max, L.Min, L.Max)
+                                                            + Inherited;
+            if(C.Left >= 0)
+                ChildCosts[i] -= GetArea(C.Min, C.Max);
+        }
+
+        if(Cost < ChildCosts[0] && Cost < ChildCosts[1])
+            break;
+
+        Index = ChildCosts[0] < ChildCosts[1] ? Children[0] : Children[1];
+    }
+
+    int Sibling = Index;
+    int OldParent = Nodes[Sibling].Parent;
+    int NewParent = AllocateNode();
+
+    Nodes[NewParent].Parent = OldParent;
+    Nodes[NewParent].Left = Sibling;
+    Nodes[NewParent].Right = Leaf;
+    Nodes[Sibling].Parent = NewParent;
+    Nodes[Leaf].Parent = NewParent;
+
+    if(OldParent < 0)
+        Root = NewParent;
+    else if(Nodes[OldParent].Left == Sibling)
+        Nodes[OldParent].Left = NewParent;
+    else
+        Nodes[OldParent].Right = NewParent;
+
+    FixUpwards(NewParent);
+}
+
+
+void AABBTree::RemoveLeaf(int Leaf)
+{
+    if(Leaf == Root) {
+        Root = -1;
+        return;
+    }
+
+    int Parent = Nodes[Leaf].Parent;
+    int GrandParent = Nodes[Parent].Parent;
+    int Sibling = Nodes[Parent].Left == Leaf ? Nodes[Parent].Right
+                                                : Nodes[Parent].Left;
+
+    /* The sibling takes the place of the parent */
+    Nodes[Sibling].Parent = GrandParent;
+    if(GrandParent < 0)
+        Root = Sibling;
+    else if(Nodes[GrandParent].Left == Parent)
+        Nodes[GrandParent].Left = Sibling;
+    else
+        Nodes[GrandParent].Right = Sibling;
+
+    FreeNode(Parent);
+    Nodes[Leaf].Parent = -1;
+
+    FixUpwards(GrandParent);
+}
+
+
+int AABBTree::Insert(AABB BGE_NCP Bounds, void* Data)
+{
+    /* N leaves need N - 1 internal nodes */
+    if(2 * (NumProxies + 1) - 1 > Capacity
+                    && Reserve(Capacity * 2) == BGE_FAILURE)
+        return -1;
+
+    int Leaf = AllocateNode();
+    Nodes[Leaf].Data = Data;
+    SetFatBounds(Leaf, Bounds);
+
+    InsertLeaf(Leaf);
+    ++NumProxies;
+
+    return Leaf;
+}
+
+
+Result AABBTree::Remove(int Proxy)
+{
+    if(!IsValid(Proxy)) {
+        Log("ERROR: AABBTree - Invalid proxy\n");
+        return BGE_FAILURE;
+    }
+
+    RemoveLeaf(Proxy);
+    FreeNode(Proxy);
+    --NumProxies;
+
+    return BGE_SUCCESS;
+}
+
+
+Result AABBTree::Move(int Proxy, AABB BGE_NCP Bounds)
+{
+    if(!IsValid(Proxy)) {
+        Log("ERROR: AABBTree - Invalid proxy\n");
+        return BGE_FAILURE;
+    }
+
+    TreeNode BGE_NCP N = Nodes[Proxy];
+    Vector4 BGE_NCP Min = Bounds.GetMin();
+    Vector4 BGE_NCP Max = Bounds.GetMax();
+
+    /* Still inside its enlarged box; the tree is fine as it is */
+    if(Min[0] >= N.Min[0] && Min[1] >= N.Min[1] && Min[2] >= N.Min[2]
+        && Max[0] <= N.Max[0] && Max[1] <= N.Max[1] && Max[2] <= N.Max[2])
+        return BGE_SUCCESS;
+
+    RemoveLeaf(Proxy);
+    SetFatBounds(Proxy, Bounds);
+    InsertLeaf(Proxy);
+
+    return BGE_SUCCESS;
+}
+
+
+void AABBTree::SelectLeaves(int* Leaves, int Count, int K, int Axis) const
+{
+    int Lo = 0;
+    int Hi = Count - 1;
+
+    /* Quickselect on box centers (doubled, which orders the same) */
+    while(Lo < Hi) {
+        int P = Leaves[(Lo + Hi) / 2];
+        Scalar Pivot = Nodes[P].Min[Axis] + Nodes[P].Max[Axis];
+        int i = Lo;
+        int j = Hi;
+
+        while(i <= j) {
+            while(Nodes[Leaves[i]].Min[Axis]
+                            + Nodes[Leaves[i]].Max[Axis] < Pivot)
+                ++i;
+
+            while(Nodes[Leaves[j]].Min[Axis]
+                            + Nodes[Leaves[j]].Max[Axis] > Pivot)
+                --j;
+
+            if(i <= j) {
+                int Swap = Leaves[i];
+                Leaves[i] = Leaves[j];
+                Leaves[j] = Swap;
+                ++i;
+                --j;
+            }
+        }
+
+        if(K <= j)
+            Hi = j;
+        else if(K >= i)
+            Lo = i;
+        else
+            break;
+    }
+}
+
+
+int AABBTree::BuildRange(int* Leaves, int Count)
+{
+    if(Count == 1)
+        return Leaves[0];
+
+    /* Split along the axis where the centers spread the most */
+    Scalar Min[3];
+    Scalar Max[3];
+
+    for(int i=0;i<3;++i) {
+        Min[i] = Nodes[Leaves[0]].Min[i] + Nodes[Leaves[0]].Max[i];
+        Max[i] = Min[i];
+    }
+
+    for(int i=1;i<Count;++i) {
+        for(int j=0;j<3;++j) {
+            Scalar C = Nodes[Leaves[i]].Min[j] + Nodes[Leaves[i]].Max[j];
+            if(C < Min[j])
+                Min[j] = C;
+            if(C > Max[j])
+                Max[j] = C;
+        }
+    }
+
+    int Axis = 0;
+    for(int i=1;i<3;++i) {
+        if(Max[i] - Min[i] > Max[Axis] - Min[Axis])
+            Axis = i;
+    }
+
+    int Half = Count / 2;
+    SelectLeaves(Leaves, Count, Half, Axis);
+
+    int Node = AllocateNode();
+    int Left = BuildRange(Leaves, Half);
+    int Right = BuildRange(Leaves + Half, Count - Half);
+
+    Nodes[Node].Left = Left;
+    Nodes[Node].Right = Right;
+    Nodes[Left].Parent = Node;
+    Nodes[Right].Parent = Node;
+    Refit(Node);
+
+    return Node;
+}
+
+
+Result AABBTree::Rebuild()
+{
+    if(NumProxies == 0)
+        return BGE_SUCCESS;
+
+    int* Leaves = new int[NumProxies];
+    if(Leaves == NULL) {
+        Log("ERROR: AABBTree - Couldn't allocate rebuild data\n");
+        return BGE_FAILURE;
+    }
+
+    /* Keep the leaves, so proxy IDs survive; rebuild the rest */
+    int Count = 0;
+    for(int i=0;i<Capacity;++i) {
+        if(Nodes[i].Height == 0)
+            Leaves[Count++] = i;
+        else if(Nodes[i].Height > 0)
+            FreeNode(i);
+    }
+
+    Root = BuildRange(Leaves, Count);
+    Nodes[Root].Parent = -1;
+
+    delete[] Leaves;
+
+    return BGE_SUCCESS;
+}
+
+
+AABB AABBTree::GetNodeBox(int Node) const
+{
+    TreeNode BGE_NCP N = Nodes[Node];
+
+    return AABB(Vector4::Point(N.Min[0], N.Min[1], N.Min[2]),
+                        Vector4::Point(N.Max[0], N.Max[1], N.Max[2]));
+}
+
+
+int AABBTree::QueryBox(AABB BGE_NCP Box, int* Proxies,
+                                            int MaxProxies) const
+{
+    if(Root < 0)
+        return 0;
+
+    Vector4 BGE_NCP Min = Box.GetMin();
+    Vector4 BGE_NCP Max = Box.GetMax();
+
+    int Stack[BGE_AABBTREE_STACK_SIZE];
+    int Top = 0;
+    int Found = 0;
+
+    Stack[Top++] = Root;
+
+    while(Top > 0) {
+        int Node = Stack[--Top];
+        TreeNode BGE_NCP N = Nodes[Node];
+
+        if(N.Max[0] < Min[0] || N.Min[0] > Max[0] || N.Max[1] < Min[1]
+            || N.Min[1] > Max[1] || N.Max[2] < Min[2] || N.Min[2] > Max[2])
+            continue;
+
+        if(N.Left < 0) {
+            if(Found < MaxProxies)
+                Proxies[Found] = Node;
+            ++Found;
+        } else {
+            Stack[Top++] = N.Left;
+            Stack[Top++] = N.Right;
+        }
+    }
+
+    return Found;
+}
+
+
+int AABBTree::QuerySphere(Sphere BGE_NCP Target, int* Proxies,
+                                                int MaxProxies) const
+{
+    if(Root < 0)
+        return 0;
+
+    int Stack[BGE_AABBTREE_STACK_SIZE];
+    int Top = 0;
+    int Found = 0;
+
+    Stack[Top++] = Root;
+
+    while(Top > 0) {
+        int Node = Stack[--Top];
+
+        if(!Target.Intersects(GetNodeBox(Node)))
+            continue;
+
+        if(Nodes[Node].Left < 0) {
+            if(Found < MaxProxies)
+                Proxies[Found] = Node;
+            ++Found;
+        } else {
+            Stack[Top++] = Nodes[Node].Left;
+            Stack[Top++] = Nodes[Node].Right;
+        }
+    }
+
+    return Found;
+}
+
+
+int AABBTree::QueryFrustum(Frustum BGE_NCP View, int* Proxies,
+                                                int MaxProxies) const
+{
+    if(Root < 0)
+        return 0;
+
+    Scalar Planes[NUM_FRUSTUM_PLANES][4];
+    for(int i=0;i<NUM_FRUSTUM_PLANES;++i) {
+        Plane BGE_NCP P = View.GetPlane((FRUSTUM_PLANE)i);
+        for(int j=0;j<4;++j)
+            Planes[i][j] = P[j];
+    }
+
+    /* *
+     * Each entry carries the planes its box may still cross. A box
+     * inside a plane takes it off the list for its whole branch; once
+     * the list is empty, the branch is accepted without further tests
+     * */
+    int Stack[BGE_AABBTREE_STACK_SIZE];
+    int Masks[BGE_AABBTREE_STACK_SIZE];
+    int Top = 0;
+    int Found = 0;
+
+    Stack[Top] = Root;
+    Masks[Top] = (1 << NUM_FRUSTUM_PLANES) - 1;
+    ++Top;
+
+    while(Top > 0) {
+        --Top;
+        int Node = Stack[Top];
+        TreeNode BGE_NCP N = Nodes[Node];
+        int Mask = Masks[Top];
+        bool Outside = false;
+
+        if(Mask != 0) {
+            Scalar Center[3];
+            Scalar Extents[3];
+            for(int i=0;i<3;++i) {
+                Center[i] = (N.Min[i] + N.Max[i]) * 0.5f;
+                Extents[i] = (N.Max[i] - N.Min[i]) * 0.5f;
+            }
+
+            for(int i=0;i<NUM_FRUSTUM_PLANES;++i) {
+                if((Mask & (1 << i)) == 0)
+                    continue;
+
+                const Scalar* P = Planes[i];
+                Scalar Radius = fabsf(P[0]) * Extents[0]
+                                + fabsf(P[1]) * Extents[1]
+                                + fabsf(P[2]) * Extents[2];
+                Scalar Distance = P[0] * Center[0] + P[1] * Center[1]
+                                            + P[2] * Center[2] + P[3];
+
+                if(Distance < -Radius) {
+                    Outside = true;
+                    break;
+                }
+
+                if(Distance >= Radius)
+                    Mask &= ~(1 << i);
+            }
+        }
+
+        if(Outside)
+            continue;
+
+        if(N.Left < 0) {
+            if(Found < MaxProxies)
+                Proxies[Found] = Node;
+            ++Found;
+        } else {
+            Stack[Top] = N.Left;
+            Masks[Top] = Mask;
+            ++Top;
+            Stack[Top] = N.Right;
+            Masks[Top] = Mask;
+            ++Top;
+        }
+    }
+
+    return Found;
+}
+
+
+int AABBTree::QueryRay(Ray BGE_NCP Target, Scalar MaxDistance,
+                                    int* Proxies, int MaxProxies) const
+{
+    if(Root < 0)
+        return 0;
+
+    int Stack[BGE_AABBTREE_STACK_SIZE];
+    int Top = 0;
+    int Found = 0;
+
+    Stack[Top++] = Root;
+
+    while(Top > 0) {
+        int Node = Stack[--Top];
+        Scalar T;
+
+        if(!Target.Intersects(GetNodeBox(Node), &T) || T > MaxDistance)
+            continue;
+
+        if(Nodes[Node].Left < 0) {
+            if(Found < MaxProxies)
+                Proxies[Found] = Node;
+            ++Found;
+        } else {
+            Stack[Top++] = Nodes[Node].Left;
+            Stack[Top++] = Nodes[Node].Right;
+        }
+    }
+
+    return Found;
+}
+
+
+bool AABBTree::IsValid(int Proxy) const
+{
+    return Proxy >= 0 && Proxy < Capacity && Nodes[Proxy].Height == 0;
+}
+
+
+void* AABBTree::GetData(int Proxy) const
+{
+    if(!IsValid(Proxy))
+        return NULL;
+
+    return Nodes[Proxy].Data;
+}
+
+
+AABB AABBTree::GetFatBounds(int Proxy) const
+{
+    return GetNodeBox(Proxy);
+}
+
+
+int AABBTree::GetNumProxies() const
+{
+    return NumProxies;
+}
+
+
+int AABBTree::GetHeight() const
+{
+    if(Root < 0)
+        return -1;
+
+    return Nodes[Root].Height;
+}
+
+} /* bakge */
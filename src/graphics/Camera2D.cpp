@@ -23,15 +23,13 @@
  * */
 
 #include <bakge/Bakge.h>
-#ifdef _DEBUG
-#include <bakge/internal/Debug.h>
-#endif // _DEBUG
 
 namespace bakge
 {
 
 Camera2D::Camera2D()
 {
+    Dirty = true;
 }
 
 
@@ -40,156 +38,74 @@ Camera2D::~Camera2D()
 }
 
 
-Result Camera2D::Bind() const
+void Camera2D::UpdateTransforms() const
 {
-    GLint Location, Program = 0;
-    Matrix Mat;
-    Result Res = BGE_SUCCESS;
+    if(Position[0] != CachedPosition[0] || Position[1] != CachedPosition[1]
+                                    || Position[2] != CachedPosition[2])
+        Dirty = true;
 
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
+    if(!Dirty)
+        return;
 
-    /* First we'll set the perspective */
-    Location = glGetUniformLocation(Program, BGE_PROJECTION_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
-    }
+    Matrix Mat;
 
     Mat.SetOrthographic(Position[0], Position[0] + Span[0], Position[1],
                                     Position[1] + Span[1], Position[2],
                                                 Position[2] + Span[2]);
 
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
-
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Mat[0]);
-
-#ifdef _DEBUG
-    GLenum Error;
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
-
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera2D::Bind\n",
-                                                GetGLErrorName(Error),
-                                                BGE_PROJECTION_UNIFORM);
-    }
-#endif // _DEBUG
-
-    /* Now the view transform */
-    Location = glGetUniformLocation(Program, BGE_VIEW_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
-    }
-
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
-
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
-
-#ifdef _DEBUG
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
-
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera2D::Bind\n",
-                                                GetGLErrorName(Error),
-                                                    BGE_VIEW_UNIFORM);
-    }
-#endif // _DEBUG
-
-    return Res;
+    CachedProjection = Mat;
+    CachedInverseProjection = Mat.Inverted();
+    CachedFrustum = Frustum::FromMatrix(Mat);
+    CachedPosition = Position;
+
+    Dirty = false;
+}
+
+
+Matrix BGE_NCP Camera2D::GetProjection() const
+{
+    UpdateTransforms();
+
+    return CachedProjection;
+}
+
+
+Matrix BGE_NCP Camera2D::GetViewProjection() const
+{
+    UpdateTransforms();
+
+    return CachedProjection;
+}
+
+
+Matrix BGE_NCP Camera2D::GetInverseViewProjection() const
+{
+    UpdateTransforms();
+
+    return CachedInverseProjection;
+}
+
+
+Frustum BGE_NCP Camera2D::GetFrustum() const
+{
+    UpdateTransforms();
+
+    return CachedFrustum;
+}
+
+
+Result Camera2D::Bind() const
+{
+    /* Shared by every program through the frame uniforms */
+    return FrameUniforms::SetCamera(GetProjection(), Matrix::Identity,
+                                                            Position);
 }
 
 
 Result Camera2D::Unbind() const
 {
-    GLint Location, Program = 0;
-    Result Res = BGE_SUCCESS;
-
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
-
-    /* First we'll set the perspective */
-    Location = glGetUniformLocation(Program, BGE_PROJECTION_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
-    }
-
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
-
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
-
-#ifdef _DEBUG
-    GLenum Error;
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
-
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera2D::Unbind\n",
-                                                GetGLErrorName(Error),
-                                                BGE_PROJECTION_UNIFORM);
-    }
-#endif // _DEBUG
-
-    /* Now the view transform */
-    Location = glGetUniformLocation(Program, BGE_VIEW_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
-    }
-
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
-
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
-
-#ifdef _DEBUG
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
-
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera2D::Unbind\n",
-                                                GetGLErrorName(Error),
-                                                    BGE_VIEW_UNIFORM);
-    }
-#endif // _DEBUG
-
-    return Res;
+    return FrameUniforms::SetCamera(Matrix::Identity, Matrix::Identity,
+                                            Vector4::Point(0, 0, 0));
 }
 
 } /* bakge */
@@ -23,9 +23,6 @@
  * */
 
 #include <bakge/Bakge.h>
-#ifdef _DEBUG
-#include <bakge/internal/Debug.h>
-#endif // _DEBUG
 
 namespace bakge
 {
@@ -36,6 +33,9 @@ Camera3D::Camera3D()
     Far = 500.0f;
     Aspect = 1.5f;
     FOV = 80.0f;
+
+    ProjectionDirty = true;
+    ViewDirty = true;
 }
 
 
@@ -49,6 +49,7 @@ Vector4 BGE_NCP Camera3D::SetTarget(Scalar X, Scalar Y, Scalar Z)
     Target[0] = X;
     Target[1] = Y;
     Target[2] = Z;
+    ViewDirty = true;
 
     return Target;
 }
@@ -62,154 +63,86 @@ Vector4 BGE_NCP Camera3D::GetTarget() const
 
 Result Camera3D::Bind() const
 {
-    GLint Location, Program = 0;
+    /* Shared by every program through the frame uniforms */
+    return FrameUniforms::SetCamera(GetProjection(), GetView(), Position);
+}
 
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
 
-    Matrix Proj, View;
-    Result Res = BGE_SUCCESS;
+void Camera3D::UpdateTransforms() const
+{
+    if(Position[0] != CachedEye[0] || Position[1] != CachedEye[1]
+                                    || Position[2] != CachedEye[2])
+        ViewDirty = true;
 
-    Proj.SetPerspective(FOV, Aspect, Near, Far);
-    View.SetLookAt(Position, Target, Vector4(0, 1, 0, 0));
+    if(!ProjectionDirty && !ViewDirty)
+        return;
 
-    /* First we'll set the perspective */
-    Location = glGetUniformLocation(Program, BGE_PROJECTION_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
+    if(ProjectionDirty) {
+        Matrix Proj;
+        Proj.SetPerspective(FOV, Aspect, Near, Far);
+        CachedProjection = Proj;
     }
 
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
-
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Proj[0]);
-
-#ifdef _DEBUG
-    GLenum Error;
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
-
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera3D::Bind\n",
-                                                GetGLErrorName(Error),
-                                                BGE_PROJECTION_UNIFORM);
-    }
-#endif // _DEBUG
-
-    /* Now the view transform */
-    Location = glGetUniformLocation(Program, BGE_VIEW_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
+    if(ViewDirty) {
+        Matrix View;
+        View.SetLookAt(Position, Target, Vector4(0, 1, 0, 0));
+        CachedView = View;
+        CachedEye = Position;
     }
 
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
+    CachedViewProjection = CachedView * CachedProjection;
+    CachedInverseViewProjection = CachedViewProjection.Inverted();
+    CachedFrustum = Frustum::FromMatrix(CachedViewProjection);
 
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &View[0]);
+    ProjectionDirty = false;
+    ViewDirty = false;
+}
 
-#ifdef _DEBUG
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
 
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera3D::Bind\n",
-                                                GetGLErrorName(Error),
-                                                    BGE_VIEW_UNIFORM);
-    }
-#endif // _DEBUG
+Matrix BGE_NCP Camera3D::GetProjection() const
+{
+    UpdateTransforms();
 
-    return Res;
+    return CachedProjection;
 }
 
 
-Result Camera3D::Unbind() const
+Matrix BGE_NCP Camera3D::GetView() const
 {
-    GLint Location, Program = 0;
-    Result Res = BGE_SUCCESS;
-
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
-
-    /* First we'll set the perspective */
-    Location = glGetUniformLocation(Program, BGE_PROJECTION_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
-    }
+    UpdateTransforms();
 
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
-
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
-
-#ifdef _DEBUG
-    GLenum Error;
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
-
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera3D::Unbind\n",
-                                                GetGLErrorName(Error),
-                                                BGE_PROJECTION_UNIFORM);
-    }
-#endif // _DEBUG
-
-    /* Now the view transform */
-    Location = glGetUniformLocation(Program, BGE_VIEW_UNIFORM);
-    if(Location < 0) {
-        Res = BGE_FAILURE;
-#ifdef _DEBUG
-        WarnMissingUniform(BGE_PROJECTION_UNIFORM);
-#endif // _DEBUG
-    }
+    return CachedView;
+}
 
-#ifdef _DEBUG
-    while(glGetError() != GL_NO_ERROR)
-        ;
-#endif // _DEBUG
 
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
+Matrix BGE_NCP Camera3D::GetViewProjection() const
+{
+    UpdateTransforms();
 
-#ifdef _DEBUG
-    while(1) {
-        Error = glGetError();
-        if(Error == GL_NO_ERROR)
-            break;
+    return CachedViewProjection;
+}
 
-        Res = BGE_FAILURE;
-        Log("WARNING: Unexpected GL error %s while setting uniform "
-                                            "%s in Camera3D::Unbind\n",
-                                                GetGLErrorName(Error),
-                                                    BGE_VIEW_UNIFORM);
-    }
-#endif // _DEBUG
 
-    return Res;
+Matrix BGE_NCP Camera3D::GetInverseViewProjection() const
+{
+    UpdateTransforms();
+
+    return CachedInverseViewProjection;
+}
+
+
+Frustum BGE_NCP Camera3D::GetFrustum() const
+{
+    UpdateTransforms();
+
+    return CachedFrustum;
+}
+
+
+Result Camera3D::Unbind() const
+{
+    return FrameUniforms::SetCamera(Matrix::Identity, Matrix::Identity,
+                                            Vector4::Point(0, 0, 0));
 }
 
 } /* bakge */
@@ -47,13 +47,6 @@ Crowd* Crowd::Create(int ReserveMembers)
 {
     Crowd* C = new Crowd;
 
-    glGenBuffers(1, &C->ModelMatrixBuffer);
-    if(C->ModelMatrixBuffer == 0) {
-        Log("Crowd: Error creating model matrix buffer\n");
-        delete C;
-        return NULL;
-    }
-
     C->Reserve(ReserveMembers);
 
     return C;
@@ -62,34 +55,37 @@ Crowd* Crowd::Create(int ReserveMembers)
 
 Result Crowd::Bind() const
 {
-    GLint Program, Location;
+    GLint Location;
 
-    /* Retrieve current shader program */
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
+    /* Retrieve current shader */
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
         return BGE_FAILURE;
 
     /* Retrieve location of the bge_Translation vec4 */
-    Location = glGetAttribLocation(Program, BGE_MODEL_ATTRIBUTE);
+    Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_MODEL);
     if(Location < 0)
         return BGE_FAILURE;
 
     glBindBuffer(GL_ARRAY_BUFFER, CrowdBuffer);
 
+    /* Members are read from the start of the Crowd's own buffer */
+    InstanceBuffer::ResetBaseInstance();
+
     /* *
-     * Each attribute pointer has a stride of 4. Since mat4x4 are composed
-     * of 4 vec4 components, set each of these individually
+     * bge_Model is a mat3x4 holding the rows of an Affine. Matrix
+     * attributes take one location per column, so set each row individually
      * */
-    for(int i=0;i<4;++i) {
+    for(int i=0;i<3;++i) {
         glEnableVertexAttribArray(Location);
-        glVertexAttribPointer(Location, 4, GL_FLOAT, GL_FALSE, sizeof(Matrix),
+        glVertexAttribPointer(Location, 4, GL_FLOAT, GL_FALSE, sizeof(Affine),
                                     (const GLvoid*)(sizeof(Scalar) * 4 * i));
         /* So the attribute is updated per instance, not per vertex */
         glVertexAttribDivisor(Location, 1);
         ++Location;
     }
 
-    Location = glGetUniformLocation(Program, BGE_CROWD_UNIFORM);
+    Location = Current->GetUniformLocation(SHADER_UNIFORM_CROWD);
     if(Location < 0)
         return BGE_FAILURE;
 
@@ -97,26 +93,38 @@ Result Crowd::Bind() const
     CrowdTransform *= Facing.ToMatrix();
     CrowdTransform.Translate(Position[0], Position[1], Position[2]);
 
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &CrowdTransform[0]);
+    Current->SetUniform(Location, CrowdTransform);
 
     return BGE_SUCCESS;
 }
 
 
+Result Crowd::GetModelTransform(Affine* Model) const
+{
+    return BGE_FAILURE;
+}
+
+
+int Crowd::GetNumInstances() const
+{
+    return Population;
+}
+
+
 Result Crowd::Unbind() const
 {
-    GLint Program, Location;
+    GLint Location;
 
-    /* Retrieve current shader program */
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
+    /* Retrieve current shader */
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
         return BGE_FAILURE;
 
-    Location = glGetUniformLocation(Program, BGE_CROWD_UNIFORM);
+    Location = Current->GetUniformLocation(SHADER_UNIFORM_CROWD);
     if(Location < 0)
         return BGE_FAILURE;
 
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
+    Current->SetUniform(Location, Matrix::Identity);
 
     return BGE_SUCCESS;
 }
@@ -124,9 +132,9 @@ Result Crowd::Unbind() const
 
 Result Crowd::Clear()
 {
-    delete[] Positions;
+    AlignedFree(Positions);
     delete[] Rotations;
-    delete[] Scales;
+    AlignedFree(Scales);
     Positions = NULL;
     Rotations = NULL;
     Scales = NULL;
@@ -144,9 +152,17 @@ Result Crowd::Reserve(int NumMembers)
     Capacity = NumMembers;
     Population = NumMembers;
 
-    Positions = new Scalar[NumMembers * 3];
+    /* Keep member data SIMD-friendly. Quaternion aligns its own arrays */
+    Positions = (Scalar*)AlignedAlloc(sizeof(Scalar) * 3 * NumMembers, 16);
     Rotations = new Quaternion[NumMembers];
-    Scales = new Scalar[NumMembers * 3];
+    Scales = (Scalar*)AlignedAlloc(sizeof(Scalar) * 3 * NumMembers, 16);
+
+    if(Positions == NULL || Rotations == NULL || Scales == NULL) {
+        Log("ERROR: Crowd - Couldn't allocate member data\n");
+        Clear();
+        Capacity = 0;
+        return BGE_FAILURE;
+    }
 
     for(int i=0;i<NumMembers;++i) {
         Positions[i * 3 + 0] = 0;
@@ -161,14 +177,14 @@ Result Crowd::Reserve(int NumMembers)
 
     /* Allocates the buffer */
     glBindBuffer(GL_ARRAY_BUFFER, CrowdBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Scalar) * 16 * NumMembers,
-                                            NULL, GL_DYNAMIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Affine) * NumMembers,
+                                        NULL, GL_DYNAMIC_DRAW);
 
-    /* Now set each matrix in the buffer to identity */
-    GLint Stride = sizeof(Scalar) * 16;
+    /* Now set each transformation in the buffer to identity */
+    GLint Stride = sizeof(Affine);
     for(int i=0;i<NumMembers;++i) {
         glBufferSubData(GL_ARRAY_BUFFER, Stride * i, Stride,
-                        (const GLvoid*)&Matrix::Identity[0]);
+                        (const GLvoid*)&Affine::Identity[0]);
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -272,18 +288,17 @@ Quaternion BGE_NCP Crowd::GetMemberRotation(int Index) const
 
 Result Crowd::SetDataStore(int Index)
 {
-    /* Create a new model matrix to copy into the buffer */
-    Matrix Transformation;
-    Transformation.Scale(Scales[Index * 3 + 0],
-                        Scales[Index * 3 + 1],
-                        Scales[Index * 3 + 2]);
-    Transformation *= Rotations[Index].ToMatrix();
-    Transformation.Translate(Positions[Index * 3 + 0],
-                            Positions[Index * 3 + 1],
-                            Positions[Index * 3 + 2]);
+    /* Create a new model transformation to copy into the buffer */
+    Affine Transformation = Affine::FromTransform(
+        Vector4::Point(Positions[Index * 3 + 0], Positions[Index * 3 + 1],
+                                                Positions[Index * 3 + 2]),
+        Rotations[Index],
+        Vector4::Vector(Scales[Index * 3 + 0], Scales[Index * 3 + 1],
+                                                Scales[Index * 3 + 2]));
 
     glBindBuffer(GL_ARRAY_BUFFER, CrowdBuffer);
-    glBufferSubData(GL_ARRAY_BUFFER, 64 * Index, 64, &Transformation[0]);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(Affine) * Index, sizeof(Affine),
+                                                    &Transformation[0]);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     return BGE_SUCCESS;
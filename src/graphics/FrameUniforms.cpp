@@ -0,0 +1,222 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#ifdef _DEBUG
+#include <bakge/internal/Debug.h>
+#endif // _DEBUG
+
+namespace bakge
+{
+
+FrameUniforms::Block FrameUniforms::Data;
+GLuint FrameUniforms::Buffer = 0;
+bool FrameUniforms::Dirty = true;
+Microseconds FrameUniforms::LastFrame = 0;
+int FrameUniforms::FrameNumber = 0;
+
+
+Result FrameUniforms::Init()
+{
+    Data.Projection = Matrix::Identity;
+    Data.View = Matrix::Identity;
+    Data.ViewProjection = Matrix::Identity;
+    Data.CameraPosition = Vector4::Point(0, 0, 0);
+    Data.Time = Vector4(0, 0, 0, 0);
+
+    Dirty = true;
+    LastFrame = GetRunningTime();
+    FrameNumber = 0;
+
+    /* Without uniform buffers the data is set as plain uniforms */
+    if(!GLEW_ARB_uniform_buffer_object)
+        return BGE_SUCCESS;
+
+    /* std140: three mat4 and two vec4, tightly packed */
+    if(sizeof(Block) != sizeof(Scalar) * 56) {
+        Log("WARNING: FrameUniforms - Unexpected block layout; using plain "
+                                                            "uniforms\n");
+        return BGE_SUCCESS;
+    }
+
+    glGenBuffers(1, &Buffer);
+    if(Buffer == 0) {
+        Log("ERROR: FrameUniforms - Error creating uniform buffer\n");
+        return BGE_FAILURE;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &Data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    Dirty = false;
+
+    return Upload();
+}
+
+
+Result FrameUniforms::Deinit()
+{
+    if(Buffer == 0)
+        return BGE_FAILURE;
+
+    glDeleteBuffers(1, &Buffer);
+    Buffer = 0;
+
+    return BGE_SUCCESS;
+}
+
+
+Result FrameUniforms::Upload()
+{
+    if(Buffer == 0)
+        return BGE_FAILURE;
+
+    if(Dirty) {
+        glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &Data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        Dirty = false;
+    }
+
+    /* Buffer contents are shared between contexts, bindings aren't */
+    glBindBufferBase(GL_UNIFORM_BUFFER, BGE_FRAME_BINDING, Buffer);
+
+    return BGE_SUCCESS;
+}
+
+
+Result FrameUniforms::Apply(const Shader* Target)
+{
+    if(Target == NULL)
+        return BGE_FAILURE;
+
+    Result Res = BGE_SUCCESS;
+
+    /* Projection and view are required; the rest are optional */
+    if(Target->SetUniform(Target->GetUniformLocation(
+            SHADER_UNIFORM_PROJECTION), Data.Projection) == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    if(Target->SetUniform(Target->GetUniformLocation(
+                    SHADER_UNIFORM_VIEW), Data.View) == BGE_FAILURE)
+        Res = BGE_FAILURE;
+
+    GLint Location;
+
+    Location = Target->GetUniformLocation(SHADER_UNIFORM_VIEWPROJECTION);
+    if(Location >= 0)
+        Target->SetUniform(Location, Data.ViewProjection);
+
+    Location = Target->GetUniformLocation(SHADER_UNIFORM_CAMERA_POSITION);
+    if(Location >= 0)
+        Target->SetUniform(Location, Data.CameraPosition);
+
+    Location = Target->GetUniformLocation(SHADER_UNIFORM_TIME);
+    if(Location >= 0)
+        Target->SetUniform(Location, Data.Time);
+
+    return Res;
+}
+
+
+bool FrameUniforms::IsBufferAvailable()
+{
+    return Buffer != 0;
+}
+
+
+Result FrameUniforms::BeginFrame()
+{
+    Microseconds Now = GetRunningTime();
+
+    Data.Time[0] = (Scalar)((Seconds)Now / 1000000);
+    Data.Time[1] = (Scalar)((Seconds)(Now - LastFrame) / 1000000);
+    Data.Time[2] = (Scalar)FrameNumber++;
+    LastFrame = Now;
+    Dirty = true;
+
+    const Shader* Current = Shader::GetCurrent();
+    if(Current != NULL && !Current->UsesFrameBlock())
+        Apply(Current);
+
+    if(Buffer == 0)
+        return BGE_SUCCESS;
+
+    return Upload();
+}
+
+
+Result FrameUniforms::SetCamera(Matrix BGE_NCP Projection,
+                                Matrix BGE_NCP View,
+                                Vector4 BGE_NCP Position)
+{
+    Data.Projection = Projection;
+    Data.View = View;
+    Data.ViewProjection = View * Projection;
+    Data.CameraPosition = Position;
+    Dirty = true;
+
+    Result Res = BGE_SUCCESS;
+
+    if(Buffer != 0)
+        Res = Upload();
+
+    /* The current program may still want plain uniforms */
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
+        return Res;
+
+    if(!Current->UsesFrameBlock() && Apply(Current) == BGE_FAILURE) {
+#ifdef _DEBUG
+        if(Current->GetUniformLocation(SHADER_UNIFORM_PROJECTION) < 0)
+            WarnMissingUniform(BGE_PROJECTION_UNIFORM);
+        if(Current->GetUniformLocation(SHADER_UNIFORM_VIEW) < 0)
+            WarnMissingUniform(BGE_VIEW_UNIFORM);
+#endif // _DEBUG
+        Res = BGE_FAILURE;
+    }
+
+    return Res;
+}
+
+
+Matrix BGE_NCP FrameUniforms::GetProjection()
+{
+    return Data.Projection;
+}
+
+
+Matrix BGE_NCP FrameUniforms::GetView()
+{
+    return Data.View;
+}
+
+
+Matrix BGE_NCP FrameUniforms::GetViewProjection()
+{
+    return Data.ViewProjection;
+}
+
+} /* bakge */
@@ -0,0 +1,202 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#ifdef _DEBUG
+#include <bakge/internal/Debug.h>
+#endif // _DEBUG
+
+namespace bakge
+{
+
+GLuint InstanceBuffer::Buffer = 0;
+int InstanceBuffer::Head = 0;
+GLuint InstanceBuffer::BaseInstance = 0;
+
+
+Result InstanceBuffer::Init()
+{
+    Head = 0;
+    BaseInstance = 0;
+
+    glGenBuffers(1, &Buffer);
+    if(Buffer == 0) {
+        Log("ERROR: InstanceBuffer - Error creating ring buffer\n");
+        return BGE_FAILURE;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Affine) * BGE_INSTANCE_RING_SIZE,
+                                                    NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return BGE_SUCCESS;
+}
+
+
+Result InstanceBuffer::Deinit()
+{
+    if(Buffer == 0)
+        return BGE_FAILURE;
+
+    glDeleteBuffers(1, &Buffer);
+    Buffer = 0;
+
+    return BGE_SUCCESS;
+}
+
+
+int InstanceBuffer::Allocate(int Count)
+{
+    if(Count < 1 || Count > BGE_INSTANCE_RING_SIZE)
+        return -1;
+
+    /* *
+     * Orphan the storage when the ring is full. The driver hands us fresh
+     * memory while draws still in flight keep reading the old storage
+     * */
+    if(Head + Count > BGE_INSTANCE_RING_SIZE) {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(Affine) * BGE_INSTANCE_RING_SIZE,
+                                                        NULL, GL_STREAM_DRAW);
+        Head = 0;
+    }
+
+    int First = Head;
+    Head += Count;
+
+    return First;
+}
+
+
+bool InstanceBuffer::IsBaseInstanceAvailable()
+{
+    return GLEW_ARB_base_instance ? true : false;
+}
+
+
+Result InstanceBuffer::BindModel(Affine BGE_NCP Model)
+{
+    return BindModels(1, &Model);
+}
+
+
+Result InstanceBuffer::BindModels(int Count, const Affine* Models)
+{
+    if(Buffer == 0)
+        return BGE_FAILURE;
+
+    /* Retrieve current shader */
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
+        return BGE_FAILURE;
+
+    GLint Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_MODEL);
+    if(Location < 0) {
+#ifdef _DEBUG
+        WarnMissingAttribute(BGE_MODEL_ATTRIBUTE);
+#endif // _DEBUG
+        return BGE_FAILURE;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+
+    int First = Allocate(Count);
+    if(First < 0)
+        return BGE_FAILURE;
+
+    /* Slots past Head are never read by pending draws; don't synchronize */
+    GLintptr Offset = sizeof(Affine) * First;
+    GLsizeiptr Size = sizeof(Affine) * Count;
+    void* Slots = glMapBufferRange(GL_ARRAY_BUFFER, Offset, Size,
+                                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT
+                                                | GL_MAP_UNSYNCHRONIZED_BIT);
+    if(Slots != NULL) {
+        memcpy(Slots, (const void*)Models, Size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, Offset, Size, (const void*)Models);
+    }
+
+    /* Select the slot by base instance, or by offsetting the pointer */
+    if(IsBaseInstanceAvailable()) {
+        BaseInstance = (GLuint)First;
+        Offset = 0;
+    } else {
+        BaseInstance = 0;
+    }
+
+    /* *
+     * bge_Model is a mat3x4 holding the rows of an Affine. Matrix
+     * attributes take one location per column, so set each row individually
+     * */
+    for(int i=0;i<3;++i) {
+        glEnableVertexAttribArray(Location + i);
+        glVertexAttribPointer(Location + i, 4, GL_FLOAT, GL_FALSE,
+                                sizeof(Affine), (const GLvoid*)(Offset
+                                            + sizeof(Scalar) * 4 * i));
+        /* So the attribute is updated per instance, not per vertex */
+        glVertexAttribDivisor(Location + i, 1);
+    }
+
+    return BGE_SUCCESS;
+}
+
+
+Result InstanceBuffer::UnbindModel()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    BaseInstance = 0;
+
+    /* Retrieve current shader */
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
+        return BGE_FAILURE;
+
+    GLint Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_MODEL);
+    if(Location < 0) {
+#ifdef _DEBUG
+        WarnMissingAttribute(BGE_MODEL_ATTRIBUTE);
+#endif // _DEBUG
+        return BGE_FAILURE;
+    }
+
+    for(int i=0;i<3;++i)
+        glDisableVertexAttribArray(Location + i);
+
+    return BGE_SUCCESS;
+}
+
+
+void InstanceBuffer::ResetBaseInstance()
+{
+    BaseInstance = 0;
+}
+
+
+GLuint InstanceBuffer::GetBaseInstance()
+{
+    return BaseInstance;
+}
+
+} /* bakge */
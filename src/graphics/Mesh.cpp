@@ -35,6 +35,13 @@ Mesh::Mesh()
     NumVertices = 0;
     NumTriangles = 0;
     memset((void*)MeshBuffers, 0, sizeof(GLuint) * NUM_MESH_BUFFERS);
+    memset((void*)BufferCopies, 0, sizeof(BufferCopies));
+    memset((void*)CurrentCopy, 0, sizeof(CurrentCopy));
+    memset((void*)StaleFirst, 0, sizeof(StaleFirst));
+    memset((void*)StaleLast, 0, sizeof(StaleLast));
+
+    Usage = GL_STATIC_DRAW;
+    NumCopies = 1;
 
     Positions = NULL;
     Normals = NULL;
@@ -48,13 +55,13 @@ Mesh::~Mesh()
     ClearBuffers();
 
     if(Positions != NULL)
-        free(Positions);
+        AlignedFree(Positions);
 
     if(Normals != NULL)
-        free(Normals);
+        AlignedFree(Normals);
 
     if(TexCoords != NULL)
-        free(TexCoords);
+        AlignedFree(TexCoords);
 
     if(Indices != NULL)
         free(Indices);
@@ -63,16 +70,15 @@ Mesh::~Mesh()
 
 Result Mesh::Bind() const
 {
-    GLint Program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0) {
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
         return BGE_FAILURE;
-    }
 
     /* Check each of our attributes' locations to ensure they exist */
-    GLint Location = glGetAttribLocation(Program, BGE_VERTEX_ATTRIBUTE);
+    GLint Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_VERTEX);
     if(Location >= 0) {
-        glBindBuffer(GL_ARRAY_BUFFER, MeshBuffers[MESH_BUFFER_POSITIONS]);
+        glBindBuffer(GL_ARRAY_BUFFER, GetBufferCopy(MESH_BUFFER_POSITIONS,
+                                    CurrentCopy[MESH_BUFFER_POSITIONS]));
         glEnableVertexAttribArray(Location);
         glVertexAttribPointer(Location, 3, GL_FLOAT, GL_FALSE, 0, 0);
 #ifdef _DEBUG
@@ -81,9 +87,10 @@ Result Mesh::Bind() const
 #endif // _DEBUG
     }
 
-    Location = glGetAttribLocation(Program, BGE_NORMAL_ATTRIBUTE);
+    Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_NORMAL);
     if(Location >= 0) {
-        glBindBuffer(GL_ARRAY_BUFFER, MeshBuffers[MESH_BUFFER_NORMALS]);
+        glBindBuffer(GL_ARRAY_BUFFER, GetBufferCopy(MESH_BUFFER_NORMALS,
+                                    CurrentCopy[MESH_BUFFER_NORMALS]));
         glEnableVertexAttribArray(Location);
         glVertexAttribPointer(Location, 3, GL_FLOAT, GL_FALSE, 0, 0);
 #ifdef _DEBUG
@@ -92,9 +99,10 @@ Result Mesh::Bind() const
 #endif // _DEBUG
     }
 
-    Location = glGetAttribLocation(Program, BGE_TEXCOORD_ATTRIBUTE);
+    Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_TEXCOORD);
     if(Location >= 0) {
-        glBindBuffer(GL_ARRAY_BUFFER, MeshBuffers[MESH_BUFFER_TEXCOORDS]);
+        glBindBuffer(GL_ARRAY_BUFFER, GetBufferCopy(MESH_BUFFER_TEXCOORDS,
+                                    CurrentCopy[MESH_BUFFER_TEXCOORDS]));
         glEnableVertexAttribArray(Location);
         glVertexAttribPointer(Location, 2, GL_FLOAT, GL_FALSE, 0, 0);
 #ifdef _DEBUG
@@ -111,13 +119,11 @@ Result Mesh::Bind() const
 
 Result Mesh::Unbind() const
 {
-    GLint Program;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0) {
+    const Shader* Current = Shader::GetCurrent();
+    if(Current == NULL)
         return BGE_FAILURE;
-    }
 
-    GLint Location = glGetAttribLocation(Program, BGE_VERTEX_ATTRIBUTE);
+    GLint Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_VERTEX);
     if(Location >= 0) {
         glDisableVertexAttribArray(Location);
 #ifdef _DEBUG
@@ -126,7 +132,7 @@ Result Mesh::Unbind() const
 #endif // _DEBUG
     }
 
-    Location = glGetAttribLocation(Program, BGE_NORMAL_ATTRIBUTE);
+    Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_NORMAL);
     if(Location >= 0) {
         glDisableVertexAttribArray(Location);
 #ifdef _DEBUG
@@ -135,7 +141,7 @@ Result Mesh::Unbind() const
 #endif // _DEBUG
     }
 
-    Location = glGetAttribLocation(Program, BGE_TEXCOORD_ATTRIBUTE);
+    Location = Current->GetAttributeLocation(SHADER_ATTRIBUTE_TEXCOORD);
     if(Location >= 0) {
         glDisableVertexAttribArray(Location);
 #ifdef _DEBUG
@@ -192,14 +198,219 @@ Result Mesh::ClearBuffers()
         memset((void*)MeshBuffers, 0, sizeof(GLuint) * NUM_MESH_BUFFERS);
     }
 
+    for(int i=0;i<BGE_MESH_MAX_COPIES - 1;++i) {
+        if(BufferCopies[i][0] != 0) {
+            glDeleteBuffers(NUM_MESH_BUFFERS, BufferCopies[i]);
+            memset((void*)BufferCopies[i], 0,
+                        sizeof(GLuint) * NUM_MESH_BUFFERS);
+        }
+    }
+
+    memset((void*)CurrentCopy, 0, sizeof(CurrentCopy));
+    memset((void*)StaleFirst, 0, sizeof(StaleFirst));
+    memset((void*)StaleLast, 0, sizeof(StaleLast));
+    NumCopies = 1;
+    Usage = GL_STATIC_DRAW;
+
+    return BGE_SUCCESS;
+}
+
+
+GLuint Mesh::GetBufferCopy(MESH_BUFFERS Buffer, int Copy) const
+{
+    if(Copy == 0)
+        return MeshBuffers[Buffer];
+
+    return BufferCopies[Copy - 1][Buffer];
+}
+
+
+Result Mesh::AllocateBuffer(MESH_BUFFERS Buffer, int Components)
+{
+    const Scalar* Store;
+
+    switch(Buffer) {
+
+    case MESH_BUFFER_POSITIONS:
+        Store = Positions;
+        break;
+
+    case MESH_BUFFER_NORMALS:
+        Store = Normals;
+        break;
+
+    case MESH_BUFFER_TEXCOORDS:
+        Store = TexCoords;
+        break;
+
+    default:
+        return BGE_FAILURE;
+    }
+
+    if(Store == NULL)
+        return BGE_SUCCESS;
+
+    GLsizeiptr Size = sizeof(Scalar) * Components * NumVertices;
+
+    for(int i=0;i<NumCopies;++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, GetBufferCopy(Buffer, i));
+        glBufferData(GL_ARRAY_BUFFER, Size, (const GLvoid*)Store, Usage);
+        StaleFirst[i][Buffer] = 0;
+        StaleLast[i][Buffer] = 0;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CurrentCopy[Buffer] = 0;
+
+    return BGE_SUCCESS;
+}
+
+
+Result Mesh::UploadRange(MESH_BUFFERS Buffer, int Components, int First,
+                                                                int Count)
+{
+    const Scalar* Store;
+
+    switch(Buffer) {
+
+    case MESH_BUFFER_POSITIONS:
+        Store = Positions;
+        break;
+
+    case MESH_BUFFER_NORMALS:
+        Store = Normals;
+        break;
+
+    case MESH_BUFFER_TEXCOORDS:
+        Store = TexCoords;
+        break;
+
+    default:
+        return BGE_FAILURE;
+    }
+
+    /* *
+     * Every copy is now missing this range. Grow each copy's stale range
+     * to cover it; the copy we upload to next is brought fully up to date
+     * */
+    int Last = First + Count;
+    for(int i=0;i<NumCopies;++i) {
+        if(StaleFirst[i][Buffer] >= StaleLast[i][Buffer]) {
+            StaleFirst[i][Buffer] = First;
+            StaleLast[i][Buffer] = Last;
+        } else {
+            if(First < StaleFirst[i][Buffer])
+                StaleFirst[i][Buffer] = First;
+
+            if(Last > StaleLast[i][Buffer])
+                StaleLast[i][Buffer] = Last;
+        }
+    }
+
+    /* Write into the least recently used copy so pending draws don't stall */
+    int Copy = (CurrentCopy[Buffer] + 1) % NumCopies;
+    int UploadFirst = StaleFirst[Copy][Buffer];
+    int UploadCount = StaleLast[Copy][Buffer] - UploadFirst;
+    size_t Stride = sizeof(Scalar) * Components;
+
+    glBindBuffer(GL_ARRAY_BUFFER, GetBufferCopy(Buffer, Copy));
+
+    if(UploadCount == NumVertices) {
+        /* Whole buffer is rewritten; orphan it so the driver needn't sync */
+        glBufferData(GL_ARRAY_BUFFER, Stride * NumVertices,
+                                (const GLvoid*)Store, Usage);
+    } else {
+        glBufferSubData(GL_ARRAY_BUFFER, Stride * UploadFirst,
+                                            Stride * UploadCount,
+                    (const GLvoid*)(Store + Components * UploadFirst));
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    StaleFirst[Copy][Buffer] = 0;
+    StaleLast[Copy][Buffer] = 0;
+    CurrentCopy[Buffer] = Copy;
+
+#ifdef _DEBUG
+    while(1) {
+        GLenum Error = glGetError();
+        if(Error == GL_NO_ERROR)
+            break;
+
+        Log("ERROR: Mesh - Unexpected error %s while updating buffer\n",
+                                                GetGLErrorName(Error));
+        return BGE_FAILURE;
+    }
+#endif // _DEBUG
+
+    return BGE_SUCCESS;
+}
+
+
+Result Mesh::SetUsage(MESH_USAGE Hint, int Copies)
+{
+    if(MeshBuffers[0] == 0) {
+        Log("ERROR: Mesh - Buffers must be created before setting usage\n");
+        return BGE_FAILURE;
+    }
+
+    if(Copies < 1 || Copies > BGE_MESH_MAX_COPIES) {
+        Log("ERROR: Mesh - Invalid number of buffer copies %d\n", Copies);
+        return BGE_FAILURE;
+    }
+
+    switch(Hint) {
+
+    case MESH_USAGE_STATIC:
+        Usage = GL_STATIC_DRAW;
+        break;
+
+    case MESH_USAGE_DYNAMIC:
+        Usage = GL_DYNAMIC_DRAW;
+        break;
+
+    case MESH_USAGE_STREAM:
+        Usage = GL_STREAM_DRAW;
+        break;
+
+    default:
+        return BGE_FAILURE;
+    }
+
+    /* Release any copies we no longer need and create the missing ones */
+    for(int i=0;i<BGE_MESH_MAX_COPIES - 1;++i) {
+        if(i < Copies - 1) {
+            if(BufferCopies[i][0] == 0)
+                glGenBuffers(NUM_MESH_BUFFERS, BufferCopies[i]);
+        } else if(BufferCopies[i][0] != 0) {
+            glDeleteBuffers(NUM_MESH_BUFFERS, BufferCopies[i]);
+            memset((void*)BufferCopies[i], 0,
+                        sizeof(GLuint) * NUM_MESH_BUFFERS);
+        }
+    }
+
+    NumCopies = Copies;
+
+    /* Respecify existing data with the new hint in every copy */
+    AllocateBuffer(MESH_BUFFER_POSITIONS, 3);
+    AllocateBuffer(MESH_BUFFER_NORMALS, 3);
+    AllocateBuffer(MESH_BUFFER_TEXCOORDS, 2);
+
     return BGE_SUCCESS;
 }
 
 
 Result Mesh::DrawInstanced(int Count) const
 {
-    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, NumTriangles * 3,
-                            GL_UNSIGNED_INT, (void*)0, Count, 0);
+    if(InstanceBuffer::IsBaseInstanceAvailable()) {
+        glDrawElementsInstancedBaseVertexBaseInstance(DrawStyle,
+                    NumTriangles * 3, GL_UNSIGNED_INT, (void*)0, Count, 0,
+                                        InstanceBuffer::GetBaseInstance());
+    } else {
+        glDrawElementsInstancedBaseVertex(DrawStyle, NumTriangles * 3,
+                                GL_UNSIGNED_INT, (void*)0, Count, 0);
+    }
 
     return BGE_SUCCESS;
 }
@@ -210,23 +421,28 @@ Result Mesh::SetPositionData(int NumPositions, const Scalar* Data)
     if(MeshBuffers[MESH_BUFFER_POSITIONS] == 0)
         return BGE_FAILURE;
 
+    /* Every position is replaced, so the bounds start over */
+    Bounds = AABB();
+
+    /* Same number of vertices; no need to reallocate anything */
+    if(Positions != NULL && NumPositions == NumVertices)
+        return UpdatePositions(0, NumPositions, Data);
+
     NumVertices = NumPositions;
 
     if(Positions != NULL)
-        free(Positions);
+        AlignedFree(Positions);
 
     size_t Size = sizeof(Scalar) * 3 * NumVertices;
 
-    Positions = (Scalar*)malloc(Size);
+    Positions = (Scalar*)AlignedAlloc(Size, 16);
     memcpy((void*)Positions, (const void*)Data, Size);
 
-    glBindBuffer(GL_ARRAY_BUFFER, MeshBuffers[MESH_BUFFER_POSITIONS]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Scalar) * NumPositions * 3,
-                                            (const GLvoid*)Data,
-                                                GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    for(int i=0;i<NumVertices;++i)
+        Bounds.Expand(Vector4::Point(Data[i * 3], Data[i * 3 + 1],
+                                                    Data[i * 3 + 2]));
 
-    return BGE_SUCCESS;
+    return AllocateBuffer(MESH_BUFFER_POSITIONS, 3);
 }
 
 
@@ -235,21 +451,18 @@ Result Mesh::SetNormalData(int NumNormals, const Scalar* Data)
     if(MeshBuffers[MESH_BUFFER_NORMALS] == 0)
         return BGE_FAILURE;
 
+    if(Normals != NULL && NumNormals == NumVertices)
+        return UpdateNormals(0, NumNormals, Data);
+
     if(Normals != NULL)
-        free(Normals);
+        AlignedFree(Normals);
 
     size_t Size = sizeof(Scalar) * 3 * NumVertices;
 
-    Normals = (Scalar*)malloc(Size);
+    Normals = (Scalar*)AlignedAlloc(Size, 16);
     memcpy((void*)Normals, (const void*)Data, Size);
 
-    glBindBuffer(GL_ARRAY_BUFFER, MeshBuffers[MESH_BUFFER_NORMALS]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Scalar) * NumNormals * 3,
-                                            (const GLvoid*)Data,
-                                                GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    return BGE_SUCCESS;
+    return AllocateBuffer(MESH_BUFFER_NORMALS, 3);
 }
 
 
@@ -283,21 +496,77 @@ Result Mesh::SetTexCoordData(int NumTexCoords, const Scalar* Data)
     if(MeshBuffers[MESH_BUFFER_TEXCOORDS] == 0)
         return BGE_FAILURE;
 
+    if(TexCoords != NULL && NumTexCoords == NumVertices)
+        return UpdateTexCoords(0, NumTexCoords, Data);
+
     if(TexCoords != NULL)
-        free(TexCoords);
+        AlignedFree(TexCoords);
 
     size_t Size = sizeof(Scalar) * 2 * NumVertices;
 
-    TexCoords = (Scalar*)malloc(Size);
+    TexCoords = (Scalar*)AlignedAlloc(Size, 16);
     memcpy((void*)TexCoords, (const void*)Data, Size);
 
-    glBindBuffer(GL_ARRAY_BUFFER, MeshBuffers[MESH_BUFFER_TEXCOORDS]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Scalar) * NumTexCoords * 2,
-                                                (const GLvoid*)Data,
-                                                    GL_STATIC_DRAW);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return AllocateBuffer(MESH_BUFFER_TEXCOORDS, 2);
+}
 
-    return BGE_SUCCESS;
+
+Result Mesh::UpdatePositions(int First, int Count, const Scalar* Data)
+{
+    if(Positions == NULL || First < 0 || Count < 0
+                    || First + Count > NumVertices) {
+        Log("ERROR: Mesh - Invalid position update range\n");
+        return BGE_FAILURE;
+    }
+
+    if(Count == 0)
+        return BGE_SUCCESS;
+
+    memcpy((void*)(Positions + First * 3), (const void*)Data,
+                                    sizeof(Scalar) * 3 * Count);
+
+    /* Only grow; shrinking would mean scanning every position */
+    for(int i=0;i<Count;++i)
+        Bounds.Expand(Vector4::Point(Data[i * 3], Data[i * 3 + 1],
+                                                    Data[i * 3 + 2]));
+
+    return UploadRange(MESH_BUFFER_POSITIONS, 3, First, Count);
+}
+
+
+Result Mesh::UpdateNormals(int First, int Count, const Scalar* Data)
+{
+    if(Normals == NULL || First < 0 || Count < 0
+                    || First + Count > NumVertices) {
+        Log("ERROR: Mesh - Invalid normal update range\n");
+        return BGE_FAILURE;
+    }
+
+    if(Count == 0)
+        return BGE_SUCCESS;
+
+    memcpy((void*)(Normals + First * 3), (const void*)Data,
+                                    sizeof(Scalar) * 3 * Count);
+
+    return UploadRange(MESH_BUFFER_NORMALS, 3, First, Count);
+}
+
+
+Result Mesh::UpdateTexCoords(int First, int Count, const Scalar* Data)
+{
+    if(TexCoords == NULL || First < 0 || Count < 0
+                    || First + Count > NumVertices) {
+        Log("ERROR: Mesh - Invalid texture coordinate update range\n");
+        return BGE_FAILURE;
+    }
+
+    if(Count == 0)
+        return BGE_SUCCESS;
+
+    memcpy((void*)(TexCoords + First * 2), (const void*)Data,
+                                    sizeof(Scalar) * 2 * Count);
+
+    return UploadRange(MESH_BUFFER_TEXCOORDS, 2, First, Count);
 }
 
 
@@ -327,7 +596,15 @@ Result Mesh::SetDrawStyle(MESH_DRAW_STYLE Style)
 
 Result Mesh::Draw() const
 {
-    glDrawElements(DrawStyle, NumTriangles * 3, GL_UNSIGNED_INT, (GLvoid*)0);
+    /* The base instance selects the bound model transform's slot */
+    if(InstanceBuffer::IsBaseInstanceAvailable()) {
+        glDrawElementsInstancedBaseInstance(DrawStyle, NumTriangles * 3,
+                                    GL_UNSIGNED_INT, (GLvoid*)0, 1,
+                                    InstanceBuffer::GetBaseInstance());
+    } else {
+        glDrawElements(DrawStyle, NumTriangles * 3, GL_UNSIGNED_INT,
+                                                        (GLvoid*)0);
+    }
 
     return BGE_SUCCESS;
 }
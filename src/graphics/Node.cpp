@@ -23,91 +23,51 @@
  * */
 
 #include <bakge/Bakge.h>
-#ifdef _DEBUG
-#include <bakge/internal/Debug.h>
-#endif // _DEBUG
 
 namespace bakge
 {
 
 Node::Node()
 {
-    ModelMatrixBuffer = 0;
 }
 
 
 Node::~Node()
 {
-    if(ModelMatrixBuffer != 0)
-        glDeleteBuffers(1, &ModelMatrixBuffer);
 }
 
 
-Result Node::Bind() const
+Result Node::GetModelTransform(Affine* Model) const
 {
-    GLint Program, Location;
-
-    /* Retrieve current shader program */
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
-
-    /* Retrieve location of the bge_Translation vec4 */
-    Location = glGetAttribLocation(Program, BGE_MODEL_ATTRIBUTE);
-    if(Location < 0) {
-#ifdef _DEBUG
-        WarnMissingAttribute(BGE_MODEL_ATTRIBUTE);
-#endif // _DEBUG
-        return BGE_FAILURE;
-    }
-
-    Matrix Translation = Matrix::Translation(Position[0], Position[1],
-                                                        Position[2]);
-
-    /* Update the buffer with the new position */
-    glBindBuffer(GL_ARRAY_BUFFER, ModelMatrixBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Translation[0]) * 16, &Translation[0],
-                                                            GL_DYNAMIC_DRAW);
-
-    /* *
-     * Each attribute pointer has a stride of 4. Since mat4x4 are composed
-     * of 4 vec4 components, set each of these individually
-     * */
-    for(int i=0;i<4;++i) {
-        glEnableVertexAttribArray(Location + i);
-        glVertexAttribPointer(Location + i, 4, GL_FLOAT, GL_FALSE, 0,
-                            (const GLvoid*)(sizeof(Scalar) * 4 * i));
-        /* So the attribute is updated per instance, not per vertex */
-        glVertexAttribDivisor(Location + i, 1);
-    }
+    Model->SetIdentity();
+    (*Model)[3] = Position[0];
+    (*Model)[7] = Position[1];
+    (*Model)[11] = Position[2];
 
     return BGE_SUCCESS;
 }
 
 
-Result Node::Unbind() const
+int Node::GetNumInstances() const
 {
-    GLint Program, Location;
+    return 1;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    /* Retrieve current shader program */
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
+Result Node::Bind() const
+{
+    Affine Model;
 
-    Location = glGetAttribLocation(Program, BGE_MODEL_ATTRIBUTE);
-    if(Location < 0) {
-#ifdef _DEBUG
-        WarnMissingAttribute(BGE_MODEL_ATTRIBUTE);
-#endif // _DEBUG
+    if(GetModelTransform(&Model) == BGE_FAILURE)
         return BGE_FAILURE;
-    }
 
-    for(int i=0;i<4;++i)
-        glDisableVertexAttribArray(Location + i);
+    return InstanceBuffer::BindModel(Model);
+}
 
-    return BGE_SUCCESS;
+
+Result Node::Unbind() const
+{
+    return InstanceBuffer::UnbindModel();
 }
 
 
@@ -129,20 +89,12 @@ Vector4 BGE_NCP Node::GetPosition() const
 
 Node* Node::Create(Scalar X, Scalar Y, Scalar Z)
 {
-    GLuint Store;
-    glGenBuffers(1, &Store);
-    if(Store == 0) {
-        Log("ERROR: Node - Couldn't create model matrix buffer\n");
-        return NULL;
-    }
-
     Node* N = new Node;
     if(N == NULL) {
         Log("ERROR: Node - Couldn't allocate memory\n");
         return NULL;
     }
 
-    N->ModelMatrixBuffer = Store;
     N->SetPosition(X, Y, Z);
 
     return N;
@@ -0,0 +1,717 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+/* Vertices closer to the eye than this (in clip w) aren't projected */
+#define BGE_OCCLUSION_MIN_W 1e-5f
+
+namespace bakge
+{
+
+/* An occluder's triangle edge, by its vertices, lowest first */
+struct OccluderEdge
+{
+    int Low;
+    int High;
+    int Corner;
+};
+
+
+static int CompareEdges(const void* A, const void* B)
+{
+    const OccluderEdge* L = (const OccluderEdge*)A;
+    const OccluderEdge* R = (const OccluderEdge*)B;
+
+    if(L->Low != R->Low)
+        return L->Low < R->Low ? -1 : 1;
+
+    if(L->High != R->High)
+        return L->High < R->High ? -1 : 1;
+
+    return L->Corner < R->Corner ? -1 : (L->Corner > R->Corner ? 1 : 0);
+}
+
+
+OcclusionCuller::OcclusionCuller()
+{
+    Width = 0;
+    Height = 0;
+    NumLevels = 0;
+
+    for(int i=0;i<BGE_OCCLUSION_MAX_LEVELS;++i) {
+        LevelWidths[i] = 0;
+        LevelHeights[i] = 0;
+        Levels[i] = NULL;
+    }
+
+    Occluders = NULL;
+    OccluderModels = NULL;
+    NumOccluders = 0;
+    OccluderCapacity = 0;
+
+    Opposites = NULL;
+    NumOpposites = 0;
+    OppositeCapacity = 0;
+
+    ScreenVertices = NULL;
+    ScreenCapacity = 0;
+}
+
+
+OcclusionCuller::~OcclusionCuller()
+{
+    for(int i=0;i<NumLevels;++i)
+        AlignedFree(Levels[i]);
+
+    delete[] Occluders;
+    delete[] OccluderModels;
+    delete[] Opposites;
+    delete[] ScreenVertices;
+}
+
+
+OcclusionCuller* OcclusionCuller::Create(int BufferWidth, int BufferHeight)
+{
+    if(BufferWidth < 1 || BufferHeight < 1) {
+        Log("ERROR: OcclusionCuller - Invalid depth buffer size\n");
+        return NULL;
+    }
+
+    OcclusionCuller* C = new OcclusionCuller;
+    if(C == NULL) {
+        Log("ERROR: OcclusionCuller - Couldn't allocate memory\n");
+        return NULL;
+    }
+
+    /* Rows are filled four pixels at a time */
+    C->Width = (BufferWidth + 3) & ~3;
+    C->Height = BufferHeight;
+
+    int W = C->Width;
+    int H = C->Height;
+
+    while(C->NumLevels < BGE_OCCLUSION_MAX_LEVELS) {
+        Scalar* Level = (Scalar*)AlignedAlloc(sizeof(Scalar) * W * H, 16);
+        if(Level == NULL) {
+            Log("ERROR: OcclusionCuller - Couldn't allocate depth buffer\n");
+            delete C;
+            return NULL;
+        }
+
+        for(int i=0;i<W * H;++i)
+            Level[i] = 1;
+
+        C->Levels[C->NumLevels] = Level;
+        C->LevelWidths[C->NumLevels] = W;
+        C->LevelHeights[C->NumLevels] = H;
+        ++C->NumLevels;
+
+        if(W == 1 && H == 1)
+            break;
+
+        W = (W + 1) / 2;
+        H = (H + 1) / 2;
+    }
+
+    return C;
+}
+
+
+Result OcclusionCuller::ClearOccluders()
+{
+    NumOccluders = 0;
+    NumOpposites = 0;
+
+    return BGE_SUCCESS;
+}
+
+
+Result OcclusionCuller::AddOccluder(const Mesh* Geometry,
+                                    Affine BGE_NCP Model)
+{
+    if(Geometry == NULL)
+        return BGE_FAILURE;
+
+    return AddOccluder(Geometry->GetNumVertices(),
+                        Geometry->GetPositionData(),
+                        Geometry->GetNumTriangles(),
+                        Geometry->GetIndexData(), Model);
+}
+
+
+Result OcclusionCuller::AddOccluder(int NumVertices, const Scalar* Positions,
+                                int NumTriangles, const int* Indices,
+                                                Affine BGE_NCP Model)
+{
+    if(NumVertices < 3 || Positions == NULL || NumTriangles < 1
+                                            || Indices == NULL) {
+        Log("ERROR: OcclusionCuller - Occluders need positions and "
+                                                        "indices\n");
+        return BGE_FAILURE;
+    }
+
+    if(NumOccluders == OccluderCapacity) {
+        int NewCapacity = OccluderCapacity > 0 ? OccluderCapacity * 2 : 16;
+
+        Occluder* NewOccluders = new Occluder[NewCapacity];
+        Affine* NewModels = new Affine[NewCapacity];
+        if(NewOccluders == NULL || NewModels == NULL) {
+            Log("ERROR: OcclusionCuller - Couldn't allocate occluders\n");
+            delete[] NewOccluders;
+            delete[] NewModels;
+            return BGE_FAILURE;
+        }
+
+        for(int i=0;i<NumOccluders;++i) {
+            NewOccluders[i] = Occluders[i];
+            NewModels[i] = OccluderModels[i];
+        }
+
+        delete[] Occluders;
+        delete[] OccluderModels;
+        Occluders = NewOccluders;
+        OccluderModels = NewModels;
+        OccluderCapacity = NewCapacity;
+    }
+
+    Occluder& O = Occluders[NumOccluders];
+    O.NumVertices = NumVertices;
+    O.Positions = Positions;
+    O.NumTriangles = NumTriangles;
+    O.Indices = Indices;
+
+    if(FindOpposites(&O) == BGE_FAILURE)
+        return BGE_FAILURE;
+
+    OccluderModels[NumOccluders] = Model;
+    ++NumOccluders;
+
+    return BGE_SUCCESS;
+}
+
+
+Result OcclusionCuller::FindOpposites(Occluder* O)
+{
+    int NumEdges = O->NumTriangles * 3;
+
+    if(NumOpposites + NumEdges > OppositeCapacity) {
+        int NewCapacity = OppositeCapacity > 0 ? OppositeCapacity * 2 : 256;
+        while(NewCapacity < NumOpposites + NumEdges)
+            NewCapacity *= 2;
+
+        int* NewOpposites = new int[NewCapacity];
+        if(NewOpposites == NULL) {
+            Log("ERROR: OcclusionCuller - Couldn't allocate edges\n");
+            return BGE_FAILURE;
+        }
+
+        for(int i=0;i<NumOpposites;++i)
+            NewOpposites[i] = Opposites[i];
+
+        delete[] Opposites;
+        Opposites = NewOpposites;
+        OppositeCapacity = NewCapacity;
+    }
+
+    OccluderEdge* Edges = new OccluderEdge[NumEdges];
+    if(Edges == NULL) {
+        Log("ERROR: OcclusionCuller - Couldn't allocate edges\n");
+        return BGE_FAILURE;
+    }
+
+    O->FirstEdge = NumOpposites;
+    int* Out = Opposites + NumOpposites;
+
+    /* Edge k of a triangle is the one opposite its corner k */
+    for(int i=0;i<NumEdges;++i) {
+        const int* Tri = O->Indices + (i / 3) * 3;
+        int A = Tri[(i + 1) % 3];
+        int B = Tri[(i + 2) % 3];
+
+        Edges[i].Low = A < B ? A : B;
+        Edges[i].High = A < B ? B : A;
+        Edges[i].Corner = i;
+        Out[i] = -1;
+    }
+
+    qsort((void*)Edges, NumEdges, sizeof(OccluderEdge), CompareEdges);
+
+    /* Only edges shared by exactly two triangles join them */
+    int i = 0;
+    while(i < NumEdges) {
+        int Run = 1;
+        while(i + Run < NumEdges && Edges[i + Run].Low == Edges[i].Low
+                                && Edges[i + Run].High == Edges[i].High)
+            ++Run;
+
+        if(Run == 2 && Edges[i].Low != Edges[i].High) {
+            Out[Edges[i].Corner] = O->Indices[Edges[i + 1].Corner];
+            Out[Edges[i + 1].Corner] = O->Indices[Edges[i].Corner];
+        }
+
+        i += Run;
+    }
+
+    delete[] Edges;
+
+    NumOpposites += NumEdges;
+
+    return BGE_SUCCESS;
+}
+
+
+Result OcclusionCuller::ProjectOccluders()
+{
+    int Total = 0;
+    for(int i=0;i<NumOccluders;++i)
+        Total += Occluders[i].NumVertices;
+
+    if(Total > ScreenCapacity) {
+        Scalar* NewVertices = new Scalar[Total * 4];
+        if(NewVertices == NULL) {
+            Log("ERROR: OcclusionCuller - Couldn't allocate vertices\n");
+            return BGE_FAILURE;
+        }
+
+        delete[] ScreenVertices;
+        ScreenVertices = NewVertices;
+        ScreenCapacity = Total;
+    }
+
+    Scalar* Out = ScreenVertices;
+
+    for(int i=0;i<NumOccluders;++i) {
+        const Occluder& O = Occluders[i];
+        Matrix ModelViewProj = OccluderModels[i].ToMatrix() * ViewProjection;
+
+        for(int v=0;v<O.NumVertices;++v, Out += 4) {
+            const Scalar* P = O.Positions + v * 3;
+            Vector4 Clip = ModelViewProj * Vector4::Point(P[0], P[1], P[2]);
+
+            /* Behind or on the eye; triangles using it are skipped */
+            if(Clip[3] < BGE_OCCLUSION_MIN_W) {
+                Out[3] = 0;
+                continue;
+            }
+
+            Scalar InvW = 1 / Clip[3];
+            Out[0] = (Clip[0] * InvW * 0.5f + 0.5f) * Width;
+            Out[1] = (Clip[1] * InvW * 0.5f + 0.5f) * Height;
+            Out[2] = Clip[2] * InvW * 0.5f + 0.5f;
+            Out[3] = 1;
+        }
+    }
+
+    return BGE_SUCCESS;
+}
+
+
+/* *
+ * An edge joins its triangle to one across it on screen when the other
+ * triangle's far vertex is outside the edge. Otherwise the edge is on the
+ * outline, as where a closed mesh folds from its front to its back
+ * */
+static bool IsInnerEdge(Scalar A, Scalar B, Scalar C,
+                const Scalar* Vertices, int NumVertices, int Opposite)
+{
+    if(Opposite < 0 || Opposite >= NumVertices)
+        return false;
+
+    const Scalar* V = Vertices + Opposite * 4;
+    if(V[3] == 0)
+        return false;
+
+    return A * V[0] + B * V[1] + C < 0;
+}
+
+
+void OcclusionCuller::RasterizeRows(int FirstRow, int EndRow)
+{
+    Scalar* Depths = Levels[0];
+    const Scalar* Vertices = ScreenVertices;
+
+    for(int o=0;o<NumOccluders;++o) {
+        const Occluder& Occ = Occluders[o];
+
+        for(int t=0;t<Occ.NumTriangles;++t) {
+            const int* Tri = Occ.Indices + t * 3;
+            if(Tri[0] < 0 || Tri[0] >= Occ.NumVertices
+                    || Tri[1] < 0 || Tri[1] >= Occ.NumVertices
+                    || Tri[2] < 0 || Tri[2] >= Occ.NumVertices)
+                continue;
+
+            const int* Opp = Opposites + Occ.FirstEdge + t * 3;
+            const Scalar* V0 = Vertices + Tri[0] * 4;
+            const Scalar* V1 = Vertices + Tri[1] * 4;
+            const Scalar* V2 = Vertices + Tri[2] * 4;
+            int O0 = Opp[0], O1 = Opp[1], O2 = Opp[2];
+
+            /* Skipping part of an occluder can only hide less */
+            if(V0[3] == 0 || V1[3] == 0 || V2[3] == 0)
+                continue;
+
+            /* Entirely beyond the far plane */
+            if(V0[2] > 1 && V1[2] > 1 && V2[2] > 1)
+                continue;
+
+            Scalar Area = (V1[0] - V0[0]) * (V2[1] - V0[1])
+                        - (V2[0] - V0[0]) * (V1[1] - V0[1]);
+            if(fabs(Area) < 1e-8f)
+                continue;
+
+            /* Either winding occludes; make it counter-clockwise */
+            if(Area < 0) {
+                const Scalar* Swap = V1;
+                V1 = V2;
+                V2 = Swap;
+                Area = -Area;
+
+                int SwapOpposite = O1;
+                O1 = O2;
+                O2 = SwapOpposite;
+            }
+
+            Scalar MinX = V0[0] < V1[0] ? V0[0] : V1[0];
+            MinX = V2[0] < MinX ? V2[0] : MinX;
+            Scalar MaxX = V0[0] > V1[0] ? V0[0] : V1[0];
+            MaxX = V2[0] > MaxX ? V2[0] : MaxX;
+            Scalar MinY = V0[1] < V1[1] ? V0[1] : V1[1];
+            MinY = V2[1] < MinY ? V2[1] : MinY;
+            Scalar MaxY = V0[1] > V1[1] ? V0[1] : V1[1];
+            MaxY = V2[1] > MaxY ? V2[1] : MaxY;
+
+            if(MaxX < 0 || MinX > Width || MaxY < FirstRow || MinY > EndRow)
+                continue;
+
+            int X0 = MinX < 0 ? 0 : (int)MinX;
+            int X1 = MaxX >= Width ? Width - 1 : (int)MaxX;
+            int Y0 = MinY < FirstRow ? FirstRow : (int)MinY;
+            int Y1 = MaxY >= EndRow ? EndRow - 1 : (int)MaxY;
+
+            /* Edge functions, positive inside, and the depth plane */
+            Scalar EA0 = V1[1] - V2[1], EB0 = V2[0] - V1[0];
+            Scalar EC0 = -(EA0 * V1[0] + EB0 * V1[1]);
+            Scalar EA1 = V2[1] - V0[1], EB1 = V0[0] - V2[0];
+            Scalar EC1 = -(EA1 * V2[0] + EB1 * V2[1]);
+            Scalar EA2 = V0[1] - V1[1], EB2 = V1[0] - V0[0];
+            Scalar EC2 = -(EA2 * V0[0] + EB2 * V0[1]);
+
+            Scalar InvArea = 1 / Area;
+            Scalar ZA = (V0[2] * EA0 + V1[2] * EA1 + V2[2] * EA2) * InvArea;
+            Scalar ZB = (V0[2] * EB0 + V1[2] * EB1 + V2[2] * EB2) * InvArea;
+            Scalar ZC = (V0[2] * EC0 + V1[2] * EC1 + V2[2] * EC2) * InvArea;
+
+            /* *
+             * Only pixels inside every edge at all four corners are covered
+             * entirely, so move outline edges in by half a pixel. An edge
+             * with the neighboring triangle across it on screen is left as
+             * it is; together the two cover the pixels along it. Depth is
+             * taken at the farthest corner
+             * */
+            if(!IsInnerEdge(EA0, EB0, EC0, Vertices,
+                                                Occ.NumVertices, O0))
+                EC0 -= 0.5f * (fabs(EA0) + fabs(EB0));
+            if(!IsInnerEdge(EA1, EB1, EC1, Vertices,
+                                                Occ.NumVertices, O1))
+                EC1 -= 0.5f * (fabs(EA1) + fabs(EB1));
+            if(!IsInnerEdge(EA2, EB2, EC2, Vertices,
+                                                Occ.NumVertices, O2))
+                EC2 -= 0.5f * (fabs(EA2) + fabs(EB2));
+            ZC += 0.5f * (fabs(ZA) + fabs(ZB));
+
+#ifdef BGE_USE_SIMD
+            const __m128 Zero = _mm_setzero_ps();
+            const __m128 Lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            const __m128 A0 = _mm_set1_ps(EA0), A1 = _mm_set1_ps(EA1);
+            const __m128 A2 = _mm_set1_ps(EA2), AZ = _mm_set1_ps(ZA);
+
+            for(int y=Y0;y<=Y1;++y) {
+                Scalar PY = (Scalar)y + 0.5f;
+                __m128 R0 = _mm_set1_ps(EB0 * PY + EC0);
+                __m128 R1 = _mm_set1_ps(EB1 * PY + EC1);
+                __m128 R2 = _mm_set1_ps(EB2 * PY + EC2);
+                __m128 RZ = _mm_set1_ps(ZB * PY + ZC);
+                Scalar* Row = Depths + y * Width;
+
+                for(int x=X0 & ~3;x<=X1;x+=4) {
+                    __m128 PX = _mm_add_ps(_mm_set1_ps((Scalar)x), Lanes);
+
+                    __m128 Inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(A0,
+                                                        PX), R0), Zero);
+                    Inside = _mm_and_ps(Inside, _mm_cmpge_ps(_mm_add_ps(
+                                        _mm_mul_ps(A1, PX), R1), Zero));
+                    Inside = _mm_and_ps(Inside, _mm_cmpge_ps(_mm_add_ps(
+                                        _mm_mul_ps(A2, PX), R2), Zero));
+
+                    if(_mm_movemask_ps(Inside) == 0)
+                        continue;
+
+                    __m128 Z = _mm_max_ps(_mm_add_ps(_mm_mul_ps(AZ, PX), RZ),
+                                                                    Zero);
+                    __m128 Old = _mm_load_ps(Row + x);
+                    __m128 New = _mm_min_ps(Old, Z);
+                    _mm_store_ps(Row + x, _mm_or_ps(_mm_and_ps(Inside, New),
+                                            _mm_andnot_ps(Inside, Old)));
+                }
+            }
+#else
+            for(int y=Y0;y<=Y1;++y) {
+                Scalar PY = (Scalar)y + 0.5f;
+                Scalar* Row = Depths + y * Width;
+
+                for(int x=X0;x<=X1;++x) {
+                    Scalar PX = (Scalar)x + 0.5f;
+
+                    if(EA0 * PX + (EB0 * PY + EC0) < 0
+                            || EA1 * PX + (EB1 * PY + EC1) < 0
+                            || EA2 * PX + (EB2 * PY + EC2) < 0)
+                        continue;
+
+                    Scalar Z = ZA * PX + (ZB * PY + ZC);
+                    if(Z < 0)
+                        Z = 0;
+                    if(Z < Row[x])
+                        Row[x] = Z;
+                }
+            }
+#endif /* BGE_USE_SIMD */
+        }
+
+        Vertices += Occ.NumVertices * 4;
+    }
+}
+
+
+int OcclusionCuller::RasterEntry(void* Data)
+{
+    RasterJob* Job = (RasterJob*)Data;
+
+    Job->Culler->RasterizeRows(Job->FirstRow, Job->EndRow);
+
+    return 0;
+}
+
+
+void OcclusionCuller::BuildPyramid()
+{
+    /* Each texel keeps the farthest depth of the four below it */
+    for(int l=1;l<NumLevels;++l) {
+        const Scalar* Below = Levels[l - 1];
+        int BW = LevelWidths[l - 1];
+        int BH = LevelHeights[l - 1];
+        Scalar* Level = Levels[l];
+
+        for(int y=0;y<LevelHeights[l];++y) {
+            int Y0 = y * 2;
+            int Y1 = Y0 + 1 < BH ? Y0 + 1 : Y0;
+
+            for(int x=0;x<LevelWidths[l];++x) {
+                int X0 = x * 2;
+                int X1 = X0 + 1 < BW ? X0 + 1 : X0;
+
+                Scalar D = Below[Y0 * BW + X0];
+                if(Below[Y0 * BW + X1] > D)
+                    D = Below[Y0 * BW + X1];
+                if(Below[Y1 * BW + X0] > D)
+                    D = Below[Y1 * BW + X0];
+                if(Below[Y1 * BW + X1] > D)
+                    D = Below[Y1 * BW + X1];
+
+                Level[y * LevelWidths[l] + x] = D;
+            }
+        }
+    }
+}
+
+
+Result OcclusionCuller::Render(Matrix BGE_NCP ViewProj, int NumThreads)
+{
+    ViewProjection = ViewProj;
+
+    for(int i=0;i<Width * Height;++i)
+        Levels[0][i] = 1;
+
+    if(ProjectOccluders() == BGE_FAILURE)
+        return BGE_FAILURE;
+
+    if(NumThreads > BGE_OCCLUSION_MAX_THREADS)
+        NumThreads = BGE_OCCLUSION_MAX_THREADS;
+    if(NumThreads > Height)
+        NumThreads = Height;
+
+    Result Res = BGE_SUCCESS;
+
+    if(NumThreads < 2) {
+        RasterizeRows(0, Height);
+    } else {
+        RasterJob Jobs[BGE_OCCLUSION_MAX_THREADS];
+        Thread* Threads[BGE_OCCLUSION_MAX_THREADS];
+
+        for(int i=0;i<NumThreads;++i) {
+            Jobs[i].Culler = this;
+            Jobs[i].FirstRow = Height * i / NumThreads;
+            Jobs[i].EndRow = Height * (i + 1) / NumThreads;
+        }
+
+        /* The calling thread takes the last band itself */
+        for(int i=0;i<NumThreads - 1;++i) {
+            Threads[i] = Thread::Create(RasterEntry, (void*)&Jobs[i]);
+            if(Threads[i] == NULL) {
+                Log("ERROR: OcclusionCuller - Couldn't create raster "
+                                                            "thread\n");
+                RasterizeRows(Jobs[i].FirstRow, Jobs[i].EndRow);
+                Res = BGE_FAILURE;
+            }
+        }
+
+        RasterizeRows(Jobs[NumThreads - 1].FirstRow,
+                        Jobs[NumThreads - 1].EndRow);
+
+        /* Deleting a Thread waits for it to finish */
+        for(int i=0;i<NumThreads - 1;++i) {
+            if(Threads[i] != NULL)
+                delete Threads[i];
+        }
+    }
+
+    BuildPyramid();
+
+    return Res;
+}
+
+
+bool OcclusionCuller::IsVisible(AABB BGE_NCP Bounds) const
+{
+    if(Bounds.IsEmpty())
+        return true;
+
+    Vector4 BGE_NCP Min = Bounds.GetMin();
+    Vector4 BGE_NCP Max = Bounds.GetMax();
+
+    Scalar MinX = (Scalar)Width, MaxX = 0;
+    Scalar MinY = (Scalar)Height, MaxY = 0;
+    Scalar Nearest = 1;
+
+    for(int i=0;i<8;++i) {
+        Vector4 Clip = ViewProjection * Vector4::Point(
+                                        (i & 1) ? Max[0] : Min[0],
+                                        (i & 2) ? Max[1] : Min[1],
+                                        (i & 4) ? Max[2] : Min[2]);
+
+        /* Crosses the near plane; can't be hidden */
+        if(Clip[3] < BGE_OCCLUSION_MIN_W)
+            return true;
+
+        Scalar InvW = 1 / Clip[3];
+        Scalar X = (Clip[0] * InvW * 0.5f + 0.5f) * Width;
+        Scalar Y = (Clip[1] * InvW * 0.5f + 0.5f) * Height;
+        Scalar Z = Clip[2] * InvW * 0.5f + 0.5f;
+
+        MinX = X < MinX ? X : MinX;
+        MaxX = X > MaxX ? X : MaxX;
+        MinY = Y < MinY ? Y : MinY;
+        MaxY = Y > MaxY ? Y : MaxY;
+        Nearest = Z < Nearest ? Z : Nearest;
+    }
+
+    /* Off screen; that's for frustum culling to decide */
+    if(MaxX < 0 || MinX >= Width || MaxY < 0 || MinY >= Height)
+        return true;
+
+    int X0 = MinX < 0 ? 0 : (int)MinX;
+    int X1 = MaxX >= Width ? Width - 1 : (int)MaxX;
+    int Y0 = MinY < 0 ? 0 : (int)MinY;
+    int Y1 = MaxY >= Height ? Height - 1 : (int)MaxY;
+
+    /* Climb until the box covers at most 2x2 texels */
+    int L = 0;
+    while(L < NumLevels - 1 && ((X1 >> L) - (X0 >> L) > 1
+                                || (Y1 >> L) - (Y0 >> L) > 1))
+        ++L;
+
+    const Scalar* Level = Levels[L];
+    int LW = LevelWidths[L];
+
+    for(int y=Y0 >> L;y<=(Y1 >> L);++y) {
+        for(int x=X0 >> L;x<=(X1 >> L);++x) {
+            if(Nearest <= Level[y * LW + x])
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+int OcclusionCuller::TestBoxesSoA(const Scalar* Boxes, int Count,
+                                            uint32* Visible) const
+{
+    int Hidden = 0;
+
+    for(int i=0;i<Count;++i) {
+        if(!((Visible[i >> 5] >> (i & 31)) & 1))
+            continue;
+
+        AABB Bounds = AABB::FromCenterAndExtents(
+                        Vector4::Point(Boxes[i], Boxes[Count + i],
+                                            Boxes[Count * 2 + i]),
+                        Vector4::Vector(Boxes[Count * 3 + i],
+                                            Boxes[Count * 4 + i],
+                                            Boxes[Count * 5 + i]));
+
+        if(!IsVisible(Bounds)) {
+            Visible[i >> 5] &= ~(1u << (i & 31));
+            ++Hidden;
+        }
+    }
+
+    return Hidden;
+}
+
+
+int OcclusionCuller::GetWidth() const
+{
+    return Width;
+}
+
+
+int OcclusionCuller::GetHeight() const
+{
+    return Height;
+}
+
+
+const Scalar* OcclusionCuller::GetDepthBuffer() const
+{
+    return Levels[0];
+}
+
+} /* bakge */
@@ -23,9 +23,6 @@
  * */
 
 #include <bakge/Bakge.h>
-#ifdef _DEBUG
-#include <bakge/internal/Debug.h>
-#endif // _DEBUG
 
 namespace bakge
 {
@@ -44,11 +41,8 @@ Pawn::~Pawn()
 Pawn* Pawn::Create()
 {
     Pawn* P = new Pawn;
-
-    glGenBuffers(1, &P->ModelMatrixBuffer);
-    if(P->ModelMatrixBuffer == 0) {
-        Log("ERROR: Pawn - Couldn't create model matrix buffer\n");
-        delete P;
+    if(P == NULL) {
+        Log("ERROR: Pawn - Couldn't allocate memory\n");
         return NULL;
     }
 
@@ -72,44 +66,9 @@ Vector4 BGE_NCP Pawn::GetScale() const
 }
 
 
-Result Pawn::Bind() const
+Result Pawn::GetModelTransform(Affine* Model) const
 {
-    GLint Program, Location;
-
-    /* Retrieve current shader program */
-    glGetIntegerv(GL_CURRENT_PROGRAM, &Program);
-    if(Program == 0)
-        return BGE_FAILURE;
-
-    // Check if required attribute is present. If not, don't continue
-    Location = glGetAttribLocation(Program, BGE_MODEL_ATTRIBUTE);
-    if(Location < 0) {
-#ifdef _DEBUG
-        WarnMissingAttribute(BGE_MODEL_ATTRIBUTE);
-#endif // _DEBUG
-        return BGE_FAILURE;
-    }
-
-    Matrix Transformation;
-    Transformation.Scale(Scale[0], Scale[1], Scale[2]);
-    Transformation *= Facing.ToMatrix();
-    Transformation.Translate(Position[0], Position[1], Position[2]);
-
-    glBindBuffer(GL_ARRAY_BUFFER, ModelMatrixBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Transformation[0]) * 16,
-                            &Transformation[0], GL_DYNAMIC_DRAW);
-
-    /* *
-     * Each attribute pointer has a stride of 4. Since mat4x4 are composed
-     * of 4 vec4 components, set each of these individually
-     * */
-    for(int i=0;i<4;++i) {
-        glEnableVertexAttribArray(Location + i);
-        glVertexAttribPointer(Location + i, 4, GL_FLOAT, GL_FALSE, 0,
-                            (const GLvoid*)(sizeof(Scalar) * 4 * i));
-        /* So the attribute is updated per instance, not per vertex */
-        glVertexAttribDivisor(Location + i, 1);
-    }
+    *Model = Affine::FromTransform(Position, Facing, Scale);
 
     return BGE_SUCCESS;
 }
@@ -121,7 +80,7 @@ Result Pawn::Unbind() const
 }
 
 
-Quaternion BGE_NCP Pawn::SetRotation(Quaternion Rotation)
+Quaternion BGE_NCP Pawn::SetRotation(Quaternion BGE_NCP Rotation)
 {
     Facing = Rotation;
 
@@ -0,0 +1,453 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+SceneGraph::SceneGraph()
+{
+    NumNodes = 0;
+    Capacity = 0;
+    Parents = NULL;
+    SubtreeSizes = NULL;
+    SlotHandles = NULL;
+    Dirty = NULL;
+    DescendantDirty = NULL;
+    Locals = NULL;
+    Worlds = NULL;
+    HandleSlots = NULL;
+    FreeHandles = NULL;
+    NumFreeHandles = 0;
+}
+
+
+SceneGraph::~SceneGraph()
+{
+    delete[] Parents;
+    delete[] SubtreeSizes;
+    delete[] SlotHandles;
+    delete[] Dirty;
+    delete[] DescendantDirty;
+    delete[] Locals;
+    delete[] Worlds;
+    delete[] HandleSlots;
+    delete[] FreeHandles;
+}
+
+
+SceneGraph* SceneGraph::Create(int ReserveNodes)
+{
+    SceneGraph* G = new SceneGraph;
+    if(G == NULL) {
+        Log("ERROR: SceneGraph - Couldn't allocate memory\n");
+        return NULL;
+    }
+
+    if(G->Reserve(ReserveNodes > 0 ? ReserveNodes : 16) == BGE_FAILURE) {
+        delete G;
+        return NULL;
+    }
+
+    return G;
+}
+
+
+Result SceneGraph::Reserve(int NewCapacity)
+{
+    if(NewCapacity <= Capacity)
+        return BGE_SUCCESS;
+
+    int* NewParents = new int[NewCapacity];
+    int* NewSubtreeSizes = new int[NewCapacity];
+    int* NewSlotHandles = new int[NewCapacity];
+    bool* NewDirty = new bool[NewCapacity];
+    bool* NewDescendantDirty = new bool[NewCapacity];
+    Affine* NewLocals = new Affine[NewCapacity];
+    Affine* NewWorlds = new Affine[NewCapacity];
+    int* NewHandleSlots = new int[NewCapacity];
+    int* NewFreeHandles = new int[NewCapacity];
+
+    if(NewParents == NULL || NewSubtreeSizes == NULL || NewSlotHandles == NULL
+                    || NewDirty == NULL || NewDescendantDirty == NULL
+                            || NewLocals == NULL || NewWorlds == NULL
+                    || NewHandleSlots == NULL || NewFreeHandles == NULL) {
+        Log("ERROR: SceneGraph - Couldn't allocate node data\n");
+        delete[] NewParents;
+        delete[] NewSubtreeSizes;
+        delete[] NewSlotHandles;
+        delete[] NewDirty;
+        delete[] NewDescendantDirty;
+        delete[] NewLocals;
+        delete[] NewWorlds;
+        delete[] NewHandleSlots;
+        delete[] NewFreeHandles;
+        return BGE_FAILURE;
+    }
+
+    for(int i=0;i<NumNodes;++i) {
+        NewParents[i] = Parents[i];
+        NewSubtreeSizes[i] = SubtreeSizes[i];
+        NewSlotHandles[i] = SlotHandles[i];
+        NewDirty[i] = Dirty[i];
+        NewDescendantDirty[i] = DescendantDirty[i];
+        NewLocals[i] = Locals[i];
+        NewWorlds[i] = Worlds[i];
+    }
+
+    /* Handles issued so far: live nodes plus free ones */
+    for(int i=0;i<NumNodes + NumFreeHandles;++i)
+        NewHandleSlots[i] = HandleSlots[i];
+
+    for(int i=0;i<NumFreeHandles;++i)
+        NewFreeHandles[i] = FreeHandles[i];
+
+    delete[] Parents;
+    delete[] SubtreeSizes;
+    delete[] SlotHandles;
+    delete[] Dirty;
+    delete[] DescendantDirty;
+    delete[] Locals;
+    delete[] Worlds;
+    delete[] HandleSlots;
+    delete[] FreeHandles;
+
+    Parents = NewParents;
+    SubtreeSizes = NewSubtreeSizes;
+    SlotHandles = NewSlotHandles;
+    Dirty = NewDirty;
+    DescendantDirty = NewDescendantDirty;
+    Locals = NewLocals;
+    Worlds = NewWorlds;
+    HandleSlots = NewHandleSlots;
+    FreeHandles = NewFreeHandles;
+    Capacity = NewCapacity;
+
+    return BGE_SUCCESS;
+}
+
+
+int SceneGraph::GetSlot(int Handle) const
+{
+    if(Handle < 0 || Handle >= NumNodes + NumFreeHandles)
+        return -1;
+
+    return HandleSlots[Handle];
+}
+
+
+void SceneGraph::MarkDirty(int Slot)
+{
+    Dirty[Slot] = true;
+
+    /* Stop at the first ancestor that already knows */
+    int Parent = Parents[Slot];
+    while(Parent >= 0 && !DescendantDirty[Parent]) {
+        DescendantDirty[Parent] = true;
+        Parent = Parents[Parent];
+    }
+}
+
+
+int SceneGraph::AddNode(int Parent, Affine BGE_NCP Local)
+{
+    /* Local may point into Locals, which moves below */
+    Affine NewLocal = Local;
+    int ParentSlot = -1;
+
+    if(Parent >= 0) {
+        ParentSlot = GetSlot(Parent);
+        if(ParentSlot < 0) {
+            Log("ERROR: SceneGraph - Invalid parent handle\n");
+            return -1;
+        }
+    }
+
+    if(NumNodes == Capacity && Reserve(Capacity * 2) == BGE_FAILURE)
+        return -1;
+
+    /* New nodes go after the last descendant of their parent */
+    int Slot = NumNodes;
+    if(ParentSlot >= 0)
+        Slot = ParentSlot + SubtreeSizes[ParentSlot];
+
+    /* Make room, keeping depth-first order */
+    for(int i=NumNodes;i>Slot;--i) {
+        Parents[i] = Parents[i - 1];
+        if(Parents[i] >= Slot)
+            ++Parents[i];
+        SubtreeSizes[i] = SubtreeSizes[i - 1];
+        SlotHandles[i] = SlotHandles[i - 1];
+        Dirty[i] = Dirty[i - 1];
+        DescendantDirty[i] = DescendantDirty[i - 1];
+        Locals[i] = Locals[i - 1];
+        Worlds[i] = Worlds[i - 1];
+        HandleSlots[SlotHandles[i]] = i;
+    }
+
+    int Handle;
+    if(NumFreeHandles > 0)
+        Handle = FreeHandles[--NumFreeHandles];
+    else
+        Handle = NumNodes;
+
+    Parents[Slot] = ParentSlot;
+    SubtreeSizes[Slot] = 1;
+    SlotHandles[Slot] = Handle;
+    DescendantDirty[Slot] = false;
+    Locals[Slot] = NewLocal;
+    HandleSlots[Handle] = Slot;
+    ++NumNodes;
+
+    for(int i=ParentSlot;i>=0;i=Parents[i])
+        ++SubtreeSizes[i];
+
+    MarkDirty(Slot);
+
+    return Handle;
+}
+
+
+Result SceneGraph::RemoveNode(int Handle)
+{
+    int Slot = GetSlot(Handle);
+    if(Slot < 0) {
+        Log("ERROR: SceneGraph - Invalid node handle\n");
+        return BGE_FAILURE;
+    }
+
+    int Count = SubtreeSizes[Slot];
+
+    for(int i=Parents[Slot];i>=0;i=Parents[i])
+        SubtreeSizes[i] -= Count;
+
+    for(int i=Slot;i<Slot + Count;++i) {
+        HandleSlots[SlotHandles[i]] = -1;
+        FreeHandles[NumFreeHandles++] = SlotHandles[i];
+    }
+
+    /* Close the gap, keeping depth-first order */
+    for(int i=Slot + Count;i<NumNodes;++i) {
+        int To = i - Count;
+        Parents[To] = Parents[i];
+        if(Parents[To] >= Slot)
+            Parents[To] -= Count;
+        SubtreeSizes[To] = SubtreeSizes[i];
+        SlotHandles[To] = SlotHandles[i];
+        Dirty[To] = Dirty[i];
+        DescendantDirty[To] = DescendantDirty[i];
+        Locals[To] = Locals[i];
+        Worlds[To] = Worlds[i];
+        HandleSlots[SlotHandles[To]] = To;
+    }
+
+    NumNodes -= Count;
+
+    return BGE_SUCCESS;
+}
+
+
+Result SceneGraph::SetLocal(int Handle, Affine BGE_NCP Local)
+{
+    int Slot = GetSlot(Handle);
+    if(Slot < 0) {
+        Log("ERROR: SceneGraph - Invalid node handle\n");
+        return BGE_FAILURE;
+    }
+
+    Locals[Slot] = Local;
+    MarkDirty(Slot);
+
+    return BGE_SUCCESS;
+}
+
+
+Result SceneGraph::SetLocal(int Handle, Vector4 BGE_NCP Position,
+                Quaternion BGE_NCP Rotation, Vector4 BGE_NCP Scale)
+{
+    return SetLocal(Handle, Affine::FromTransform(Position, Rotation,
+                                                                Scale));
+}
+
+
+Affine BGE_NCP SceneGraph::GetLocal(int Handle) const
+{
+    int Slot = GetSlot(Handle);
+    if(Slot < 0) {
+        Log("ERROR: SceneGraph - Invalid node handle\n");
+        return Affine::Identity;
+    }
+
+    return Locals[Slot];
+}
+
+
+Affine BGE_NCP SceneGraph::GetWorld(int Handle) const
+{
+    int Slot = GetSlot(Handle);
+    if(Slot < 0) {
+        Log("ERROR: SceneGraph - Invalid node handle\n");
+        return Affine::Identity;
+    }
+
+    return Worlds[Slot];
+}
+
+
+bool SceneGraph::IsValid(int Handle) const
+{
+    return GetSlot(Handle) >= 0;
+}
+
+
+int SceneGraph::GetParent(int Handle) const
+{
+    int Slot = GetSlot(Handle);
+    if(Slot < 0 || Parents[Slot] < 0)
+        return -1;
+
+    return SlotHandles[Parents[Slot]];
+}
+
+
+int SceneGraph::GetNumNodes() const
+{
+    return NumNodes;
+}
+
+
+void SceneGraph::UpdateRange(int First, int End)
+{
+    int i = First;
+
+    while(i < End) {
+        if(Dirty[i]) {
+            /* Parents precede children, so one pass covers the subtree */
+            int Last = i + SubtreeSizes[i];
+            for(int j=i;j<Last;++j) {
+                if(Parents[j] < 0)
+                    Worlds[j] = Locals[j];
+                else
+                    Worlds[j] = Locals[j] * Worlds[Parents[j]];
+
+                Dirty[j] = false;
+                DescendantDirty[j] = false;
+            }
+
+            i = Last;
+        } else if(DescendantDirty[i]) {
+            /* Something below changed; descend */
+            DescendantDirty[i] = false;
+            ++i;
+        } else {
+            /* Nothing changed in this subtree; skip it */
+            i += SubtreeSizes[i];
+        }
+    }
+}
+
+
+int SceneGraph::UpdateEntry(void* Data)
+{
+    UpdateJob* Job = (UpdateJob*)Data;
+
+    Job->Graph->UpdateRange(Job->First, Job->End);
+
+    return 0;
+}
+
+
+Result SceneGraph::Update()
+{
+    UpdateRange(0, NumNodes);
+
+    return BGE_SUCCESS;
+}
+
+
+Result SceneGraph::Update(int NumThreads)
+{
+    if(NumThreads < 2 || NumNodes < NumThreads)
+        return Update();
+
+    UpdateJob* Jobs = new UpdateJob[NumThreads];
+    Thread** Threads = new Thread*[NumThreads];
+
+    /* Split at root boundaries into ranges of roughly equal size */
+    int Target = (NumNodes + NumThreads - 1) / NumThreads;
+    int NumJobs = 0;
+    int First = 0;
+    int i = 0;
+
+    while(i < NumNodes) {
+        i += SubtreeSizes[i];
+        if(i - First >= Target || i == NumNodes) {
+            Jobs[NumJobs].Graph = this;
+            Jobs[NumJobs].First = First;
+            Jobs[NumJobs].End = i;
+            ++NumJobs;
+            First = i;
+        }
+    }
+
+    Result Res = BGE_SUCCESS;
+
+    /* The calling thread takes the last range itself */
+    for(int j=0;j<NumJobs - 1;++j) {
+        Threads[j] = Thread::Create(UpdateEntry, (void*)&Jobs[j]);
+        if(Threads[j] == NULL) {
+            Log("ERROR: SceneGraph - Couldn't create update thread\n");
+            UpdateRange(Jobs[j].First, Jobs[j].End);
+            Res = BGE_FAILURE;
+        }
+    }
+
+    UpdateRange(Jobs[NumJobs - 1].First, Jobs[NumJobs - 1].End);
+
+    /* Deleting a Thread waits for it to finish */
+    for(int j=0;j<NumJobs - 1;++j) {
+        if(Threads[j] != NULL)
+            delete Threads[j];
+    }
+
+    delete[] Threads;
+    delete[] Jobs;
+
+    return Res;
+}
+
+
+Result SceneGraph::Bind(int Handle) const
+{
+    int Slot = GetSlot(Handle);
+    if(Slot < 0) {
+        Log("ERROR: SceneGraph - Invalid node handle\n");
+        return BGE_FAILURE;
+    }
+
+    return InstanceBuffer::BindModel(Worlds[Slot]);
+}
+
+} /* bakge */
@@ -23,6 +23,7 @@
  * */
 
 #include <bakge/Bakge.h>
+#include <bakge/internal/Utility.h>
 #ifdef _DEBUG
 #include <bakge/internal/Debug.h>
 #endif // _DEBUG
@@ -31,16 +32,45 @@ namespace bakge
 {
 
 Shader* Shader::GenericShader = NULL;
+const Shader* Shader::Current = NULL;
 GLuint Shader::VertexLib = 0;
 GLuint Shader::FragmentLib = 0;
+bool Shader::LibraryCompiled = false;
+
+/* Identifies program binary cache files: "BGEP" */
+static const uint32 BinaryMagic = 0x50454742;
+
+/* *
+ * Per-frame camera and time data. Lives in a uniform buffer shared by every
+ * program where uniform blocks are supported; plain uniforms otherwise.
+ * Must be declared right after the #version line
+ * */
+#define BGE_FRAME_DATA_SOURCE \
+    "#extension GL_ARB_uniform_buffer_object : enable\n" \
+    "\n" \
+    "#ifdef GL_ARB_uniform_buffer_object\n" \
+    "layout(std140) uniform " BGE_FRAME_BLOCK "\n" \
+    "{\n" \
+    "    mat4x4 bge_Projection;\n" \
+    "    mat4x4 bge_View;\n" \
+    "    mat4x4 bge_ViewProjection;\n" \
+    "    vec4 bge_CameraPosition;\n" \
+    "    vec4 bge_Time;\n" \
+    "};\n" \
+    "#else\n" \
+    "uniform mat4x4 bge_Projection;\n" \
+    "uniform mat4x4 bge_View;\n" \
+    "uniform mat4x4 bge_ViewProjection;\n" \
+    "uniform vec4 bge_CameraPosition;\n" \
+    "uniform vec4 bge_Time;\n" \
+    "#endif\n" \
+    "\n"
 
 static const char* VertexShaderLibSource =
     "#version 120\n"
     "\n"
-    "attribute mat4x4 bge_Model;\n"
-    "\n"
-    "uniform mat4x4 bge_Projection;\n"
-    "uniform mat4x4 bge_View;\n"
+    BGE_FRAME_DATA_SOURCE
+    "attribute mat3x4 bge_Model;\n"
     "\n"
     "attribute vec4 bge_Vertex;\n"
     "attribute vec4 bge_Normal;\n"
@@ -54,12 +84,13 @@ static const char* GenericVertexShaderSource =
     "\n"
     "void main()\n"
     "{\n"
-    "    vec4 VertexPosition = bge_View * bge_Model * bge_Vertex;\n"
+    "    vec4 VertexPosition = bge_View * vec4(bge_Vertex * bge_Model,\n"
+    "                                                bge_Vertex.w);\n"
     "\n"
     "    mat3x3 NormalMatrix = mat3x3(\n"
-    "        normalize(vec3(bge_Model[0].xyz)),\n"
-    "        normalize(vec3(bge_Model[1].xyz)),\n"
-    "        normalize(vec3(bge_Model[2].xyz))\n"
+    "        normalize(vec3(bge_Model[0].x, bge_Model[1].x, bge_Model[2].x)),\n"
+    "        normalize(vec3(bge_Model[0].y, bge_Model[1].y, bge_Model[2].y)),\n"
+    "        normalize(vec3(bge_Model[0].z, bge_Model[1].z, bge_Model[2].z))\n"
     "    );\n"
     "\n"
     "    TexCoord0 = bge_TexCoord;\n"
@@ -74,6 +105,7 @@ static const char* GenericVertexShaderSource =
 static const char* FragmentShaderLibSource =
     "#version 120\n"
     "\n"
+    BGE_FRAME_DATA_SOURCE
     "varying vec4 bge_TransformedNormal;\n"
     "\n"
     "uniform sampler2D bge_Diffuse;\n"
@@ -96,6 +128,7 @@ static const char* GenericFragmentShaderSource =
 static const char* FragmentShaderLibHeader =
     "#version 120\n"
     "\n"
+    BGE_FRAME_DATA_SOURCE
     "varying vec4 bge_TransformedNormal;\n"
     "\n"
     "uniform sampler2D bge_Diffuse;\n"
@@ -104,10 +137,8 @@ static const char* FragmentShaderLibHeader =
 static const char* VertexShaderLibHeader =
     "#version 120\n"
     "\n"
-    "attribute mat4x4 bge_Model;\n"
-    "\n"
-    "uniform mat4x4 bge_Projection;\n"
-    "uniform mat4x4 bge_View;\n"
+    BGE_FRAME_DATA_SOURCE
+    "attribute mat3x4 bge_Model;\n"
     "\n"
     "uniform mat4x4 bge_Crowd;\n"
     "\n"
@@ -118,6 +149,132 @@ static const char* VertexShaderLibHeader =
     "varying vec2 bge_TexCoord0;\n"
     "\n";
 
+/* Names of the variables whose locations are cached at link time */
+static const char* AttributeNames[NUM_SHADER_ATTRIBUTES] = {
+    BGE_MODEL_ATTRIBUTE,
+    BGE_VERTEX_ATTRIBUTE,
+    BGE_NORMAL_ATTRIBUTE,
+    BGE_TEXCOORD_ATTRIBUTE
+};
+
+static const char* UniformNames[NUM_SHADER_UNIFORMS] = {
+    BGE_VIEW_UNIFORM,
+    BGE_PROJECTION_UNIFORM,
+    BGE_DIFFUSE_UNIFORM,
+    BGE_CROWD_UNIFORM,
+    BGE_VIEWPROJECTION_UNIFORM,
+    BGE_CAMERA_POSITION_UNIFORM,
+    BGE_TIME_UNIFORM
+};
+
+
+/* *
+ * Size in bytes of one element of a uniform of the given type. Returns 0
+ * for types that aren't shadowed
+ * */
+static int GetUniformTypeBytes(GLenum Type)
+{
+    switch(Type) {
+
+    case GL_FLOAT:
+    case GL_INT:
+    case GL_BOOL:
+    case GL_SAMPLER_1D:
+    case GL_SAMPLER_2D:
+    case GL_SAMPLER_3D:
+    case GL_SAMPLER_CUBE:
+    case GL_SAMPLER_1D_SHADOW:
+    case GL_SAMPLER_2D_SHADOW:
+        return sizeof(GLfloat);
+
+    case GL_FLOAT_VEC2:
+    case GL_INT_VEC2:
+    case GL_BOOL_VEC2:
+        return sizeof(GLfloat) * 2;
+
+    case GL_FLOAT_VEC3:
+    case GL_INT_VEC3:
+    case GL_BOOL_VEC3:
+        return sizeof(GLfloat) * 3;
+
+    case GL_FLOAT_VEC4:
+    case GL_INT_VEC4:
+    case GL_BOOL_VEC4:
+    case GL_FLOAT_MAT2:
+        return sizeof(GLfloat) * 4;
+
+    case GL_FLOAT_MAT2x3:
+    case GL_FLOAT_MAT3x2:
+        return sizeof(GLfloat) * 6;
+
+    case GL_FLOAT_MAT2x4:
+    case GL_FLOAT_MAT4x2:
+        return sizeof(GLfloat) * 8;
+
+    case GL_FLOAT_MAT3:
+        return sizeof(GLfloat) * 9;
+
+    case GL_FLOAT_MAT3x4:
+    case GL_FLOAT_MAT4x3:
+        return sizeof(GLfloat) * 12;
+
+    case GL_FLOAT_MAT4:
+        return sizeof(GLfloat) * 16;
+
+    default:
+        return 0;
+    }
+}
+
+
+/* *
+ * Whether a value uploaded as UploadType can be stored in a uniform of
+ * type VariableType. Ints set bools and samplers, floats set bools
+ * */
+static bool IsUploadCompatible(GLenum UploadType, GLenum VariableType)
+{
+    if(UploadType == VariableType)
+        return true;
+
+    if(VariableType == GL_BOOL)
+        return UploadType == GL_INT || UploadType == GL_FLOAT;
+
+    if(UploadType == GL_INT) {
+        switch(VariableType) {
+
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW:
+        case GL_SAMPLER_2D_SHADOW:
+            return true;
+
+        default:
+            break;
+        }
+    }
+
+    return false;
+}
+
+
+/* *
+ * Compare a variable name from the program tables with a requested name.
+ * Array uniforms are stored without their "[0]" suffix but may be
+ * requested with it
+ * */
+static bool MatchVariableName(const char* Stored, const char* Name)
+{
+    size_t Length = strlen(Stored);
+
+    if(strncmp(Stored, Name, Length) != 0)
+        return false;
+
+    return Name[Length] == '\0' || strcmp(Name + Length, "[0]") == 0;
+}
+
+
 Result Shader::InitShaderLibrary()
 {
 #ifdef _DEBUG
@@ -203,13 +360,15 @@ Result Shader::InitShaderLibrary()
     }
 #endif // _DEBUG
 
-    if(Compile(VertexLib) == BGE_FAILURE) {
-        Log("ERROR: Shader Library - Error compiling vertex shader\n");
+    LibraryCompiled = false;
+
+    if(FrameUniforms::Init() == BGE_FAILURE) {
+        Log("ERROR: Shader Library - Error creating frame uniforms\n");
         return BGE_FAILURE;
     }
 
-    if(Compile(FragmentLib) == BGE_FAILURE) {
-        Log("ERROR: Shader Library - Error compiling fragment shader\n");
+    if(InstanceBuffer::Init() == BGE_FAILURE) {
+        Log("ERROR: Shader Library - Error creating instance buffer\n");
         return BGE_FAILURE;
     }
 
@@ -226,6 +385,9 @@ Result Shader::InitShaderLibrary()
 
 Result Shader::DeinitShaderLibrary()
 {
+    /* Finish outstanding background compiles before tearing down */
+    ShaderHandle::StopCompiler();
+
     if(GenericShader == NULL)
         return BGE_FAILURE;
 
@@ -234,6 +396,31 @@ Result Shader::DeinitShaderLibrary()
 
     glDeleteShader(VertexLib);
     glDeleteShader(FragmentLib);
+    LibraryCompiled = false;
+
+    FrameUniforms::Deinit();
+    InstanceBuffer::Deinit();
+
+    return BGE_SUCCESS;
+}
+
+
+Result Shader::CompileShaderLibrary()
+{
+    if(LibraryCompiled)
+        return BGE_SUCCESS;
+
+    if(Compile(VertexLib) == BGE_FAILURE) {
+        Log("ERROR: Shader Library - Error compiling vertex shader\n");
+        return BGE_FAILURE;
+    }
+
+    if(Compile(FragmentLib) == BGE_FAILURE) {
+        Log("ERROR: Shader Library - Error compiling fragment shader\n");
+        return BGE_FAILURE;
+    }
+
+    LibraryCompiled = true;
 
     return BGE_SUCCESS;
 }
@@ -244,11 +431,28 @@ Shader::Shader()
     Program = 0;
     Vertex = 0;
     Fragment = 0;
+    SourceKey = 0;
+    FrameBlock = false;
+
+    NumAttributes = 0;
+    Attributes = NULL;
+    NumUniforms = 0;
+    Uniforms = NULL;
+
+    for(int i=0;i<NUM_SHADER_ATTRIBUTES;++i)
+        AttributeLocations[i] = -1;
+
+    for(int i=0;i<NUM_SHADER_UNIFORMS;++i)
+        UniformLocations[i] = -1;
 }
 
 
 Shader::~Shader()
 {
+    if(Current == this)
+        Current = NULL;
+
+    ClearVariables();
     Unlink();
     DeleteShaders();
     DeleteProgram();
@@ -270,12 +474,161 @@ Result Shader::Link()
     glAttachShader(Program, VertexLib);
     glAttachShader(Program, FragmentLib);
 
+    // Ask the driver to keep the binary around for the program cache
+    if(GLEW_ARB_get_program_binary)
+        glProgramParameteri(Program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                                                                GL_TRUE);
+
     glLinkProgram(Program);
 
     return BGE_SUCCESS;
 }
 
 
+Result Shader::CheckLink()
+{
+    GLint Status, Length;
+
+    glGetProgramiv(Program, GL_LINK_STATUS, &Status);
+    if(Status == GL_FALSE) {
+        glGetProgramiv(Program, GL_INFO_LOG_LENGTH, &Length);
+        if(Length > 1) {
+            char* Info = new char[Length];
+            glGetProgramInfoLog(Program, Length, NULL, Info);
+            Log("ERROR: Shader - Link failed\n%s\n", Info);
+            delete[] Info;
+        }
+
+        return BGE_FAILURE;
+    }
+
+    return ResolveVariables();
+}
+
+
+Result Shader::ResolveVariables()
+{
+    GLint Count, Size, Location, AttributeLength, UniformLength;
+    GLenum Type;
+
+    ClearVariables();
+
+    glGetProgramiv(Program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &AttributeLength);
+    glGetProgramiv(Program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &UniformLength);
+
+    GLint MaxLength = AttributeLength > UniformLength ? AttributeLength
+                                                        : UniformLength;
+    char* Name = new char[MaxLength + 1];
+
+    /* Attributes. Built-in gl_ attributes have no location and are skipped */
+    glGetProgramiv(Program, GL_ACTIVE_ATTRIBUTES, &Count);
+    if(Count > 0)
+        Attributes = new ShaderVariable[Count];
+
+    for(int i=0;i<Count;++i) {
+        glGetActiveAttrib(Program, i, MaxLength + 1, NULL, &Size, &Type,
+                                                                    Name);
+        Location = glGetAttribLocation(Program, Name);
+        if(Location < 0)
+            continue;
+
+        ShaderVariable* Var = &Attributes[NumAttributes++];
+        Var->Name = new char[strlen(Name) + 1];
+        strcpy(Var->Name, Name);
+        Var->Location = Location;
+        Var->Type = Type;
+        Var->Size = Size;
+        Var->ShadowBytes = 0;
+        Var->Shadow = NULL;
+        Var->ShadowValid = false;
+    }
+
+    /* Uniforms. Each gets a shadow copy of its first element */
+    glGetProgramiv(Program, GL_ACTIVE_UNIFORMS, &Count);
+    if(Count > 0)
+        Uniforms = new ShaderVariable[Count];
+
+    for(int i=0;i<Count;++i) {
+        glGetActiveUniform(Program, i, MaxLength + 1, NULL, &Size, &Type,
+                                                                    Name);
+        Location = glGetUniformLocation(Program, Name);
+        if(Location < 0)
+            continue;
+
+        /* Store arrays by their base name */
+        char* Suffix = strstr(Name, "[0]");
+        if(Suffix != NULL && Suffix[3] == '\0')
+            *Suffix = '\0';
+
+        ShaderVariable* Var = &Uniforms[NumUniforms++];
+        Var->Name = new char[strlen(Name) + 1];
+        strcpy(Var->Name, Name);
+        Var->Location = Location;
+        Var->Type = Type;
+        Var->Size = Size;
+        Var->ShadowBytes = GetUniformTypeBytes(Type);
+        Var->Shadow = NULL;
+        if(Var->ShadowBytes > 0)
+            Var->Shadow = new GLubyte[Var->ShadowBytes];
+        Var->ShadowValid = false;
+    }
+
+    delete[] Name;
+
+    for(int i=0;i<NUM_SHADER_ATTRIBUTES;++i)
+        AttributeLocations[i] = GetAttributeLocation(AttributeNames[i]);
+
+    for(int i=0;i<NUM_SHADER_UNIFORMS;++i)
+        UniformLocations[i] = GetUniformLocation(UniformNames[i]);
+
+    /* Point the frame uniform block at the shared buffer's binding */
+    FrameBlock = false;
+    if(GLEW_ARB_uniform_buffer_object) {
+        GLuint Index = glGetUniformBlockIndex(Program, BGE_FRAME_BLOCK);
+        if(Index != GL_INVALID_INDEX) {
+            glUniformBlockBinding(Program, Index, BGE_FRAME_BINDING);
+            FrameBlock = true;
+        }
+    }
+
+    return BGE_SUCCESS;
+}
+
+
+Result Shader::ClearVariables()
+{
+    if(Attributes != NULL) {
+        for(int i=0;i<NumAttributes;++i)
+            delete[] Attributes[i].Name;
+
+        delete[] Attributes;
+        Attributes = NULL;
+    }
+
+    if(Uniforms != NULL) {
+        for(int i=0;i<NumUniforms;++i) {
+            delete[] Uniforms[i].Name;
+            delete[] Uniforms[i].Shadow;
+        }
+
+        delete[] Uniforms;
+        Uniforms = NULL;
+    }
+
+    NumAttributes = 0;
+    NumUniforms = 0;
+    FrameBlock = false;
+
+    for(int i=0;i<NUM_SHADER_ATTRIBUTES;++i)
+        AttributeLocations[i] = -1;
+
+    for(int i=0;i<NUM_SHADER_UNIFORMS;++i)
+        UniformLocations[i] = -1;
+
+    return BGE_SUCCESS;
+}
+
+
 Result Shader::Unlink()
 {
     if(Program == 0)
@@ -329,9 +682,87 @@ Result Shader::DeleteProgram()
 }
 
 
+/* *
+ * Turn a keyword list like "SKINNED LIGHTS=4" into a block of #define
+ * lines. Returns NULL if there are no keywords. Caller frees with delete[]
+ * */
+static char* BuildDefineBlock(const char* Keywords)
+{
+    if(Keywords == NULL)
+        return NULL;
+
+    /* Each keyword grows by "#define " and a newline at most */
+    int NumKeywords = 0;
+    size_t Length = strlen(Keywords);
+    for(size_t i=0;i<Length;++i) {
+        if(!IsKeywordSeparator(Keywords[i]) && (i == 0
+                        || IsKeywordSeparator(Keywords[i-1])))
+            ++NumKeywords;
+    }
+
+    if(NumKeywords == 0)
+        return NULL;
+
+    char* Block = new char[Length + NumKeywords * 9 + 1];
+    char* Out = Block;
+    const char* In = Keywords;
+
+    while(*In != '\0') {
+        if(IsKeywordSeparator(*In)) {
+            ++In;
+            continue;
+        }
+
+        strcpy(Out, "#define ");
+        Out += 8;
+
+        /* NAME=VALUE defines NAME as VALUE */
+        while(*In != '\0' && !IsKeywordSeparator(*In)) {
+            *Out++ = *In == '=' ? ' ' : *In;
+            ++In;
+        }
+
+        *Out++ = '\n';
+    }
+
+    *Out = '\0';
+
+    return Block;
+}
+
+
 Shader* Shader::LoadFromStrings(int NumVertex, int NumFragment,
                                     const char** VertexShaders,
                                     const char** FragmentShaders)
+{
+    return LoadFromStrings(NumVertex, NumFragment, VertexShaders,
+                                            FragmentShaders, NULL);
+}
+
+
+Shader* Shader::LoadFromStrings(int NumVertex, int NumFragment,
+                                    const char** VertexShaders,
+                                    const char** FragmentShaders,
+                                    const char* Keywords)
+{
+    Shader* S = Submit(NumVertex, NumFragment, VertexShaders,
+                                    FragmentShaders, Keywords);
+    if(S == NULL)
+        return NULL;
+
+    if(S->Finish() == BGE_FAILURE) {
+        delete S;
+        return NULL;
+    }
+
+    return S;
+}
+
+
+Shader* Shader::Submit(int NumVertex, int NumFragment,
+                            const char** VertexShaders,
+                            const char** FragmentShaders,
+                            const char* Keywords)
 {
     Shader* S;
 
@@ -349,10 +780,27 @@ Shader* Shader::LoadFromStrings(int NumVertex, int NumFragment,
         return NULL;
     }
 
+    // A cached binary of the same sources skips compiling and linking
+    char* Defines = BuildDefineBlock(Keywords);
+    S->SourceKey = HashSources(NumVertex, NumFragment, VertexShaders,
+                                                FragmentShaders, Defines);
+    if(LoadBinary(S->SourceKey, S->Program) == BGE_SUCCESS) {
+        delete[] Defines;
+        return S;
+    }
+
+    if(CompileShaderLibrary() == BGE_FAILURE) {
+        Log("ERROR: Shader - Shader library unavailable\n");
+        delete[] Defines;
+        delete S;
+        return NULL;
+    }
+
     // Allocate a vertex shader
     S->Vertex = glCreateShader(GL_VERTEX_SHADER);
     if(S->Vertex == 0) {
         Log("ERROR: Shader - Error creating vertex shader\n");
+        delete[] Defines;
         delete S;
         return NULL;
     }
@@ -361,48 +809,249 @@ Shader* Shader::LoadFromStrings(int NumVertex, int NumFragment,
     S->Fragment = glCreateShader(GL_FRAGMENT_SHADER);
     if(S->Fragment == 0) {
         Log("ERROR: Shader - Error creating fragment shader\n");
+        delete[] Defines;
         delete S;
         return NULL;
     }
 
-    // Create new buffers which contain the shader libraries as well
-    const char** VertexShaderBuffer = new const char*[NumVertex + 1];
-    const char** FragmentShaderBuffer = new const char*[NumFragment + 1];
+    /* *
+     * Create new buffers which contain the shader libraries as well. The
+     * library header carries the #version line so it must come first;
+     * variant defines follow it, ahead of the user sources
+     * */
+    int First = Defines != NULL ? 2 : 1;
+    const char** VertexShaderBuffer = new const char*[NumVertex + First];
+    const char** FragmentShaderBuffer = new const char*[NumFragment + First];
 
-    for(int i=1;i<=NumVertex;++i)
-        VertexShaderBuffer[i] = VertexShaders[i-1];
+    for(int i=0;i<NumVertex;++i)
+        VertexShaderBuffer[First + i] = VertexShaders[i];
 
-    for(int i=1;i<=NumFragment;++i)
-        FragmentShaderBuffer[i] = FragmentShaders[i-1];
+    for(int i=0;i<NumFragment;++i)
+        FragmentShaderBuffer[First + i] = FragmentShaders[i];
 
     FragmentShaderBuffer[0] = FragmentShaderLibHeader;
     VertexShaderBuffer[0] = VertexShaderLibHeader;
 
+    if(Defines != NULL) {
+        VertexShaderBuffer[1] = Defines;
+        FragmentShaderBuffer[1] = Defines;
+    }
+
     // Set our shaders' sources
-    glShaderSource(S->Vertex, NumVertex + 1, VertexShaderBuffer, NULL);
-    glShaderSource(S->Fragment, NumFragment + 1, FragmentShaderBuffer, NULL);
+    glShaderSource(S->Vertex, NumVertex + First, VertexShaderBuffer, NULL);
+    glShaderSource(S->Fragment, NumFragment + First, FragmentShaderBuffer,
+                                                                    NULL);
+
+    delete[] VertexShaderBuffer;
+    delete[] FragmentShaderBuffer;
+    delete[] Defines;
+
+    /* *
+     * Only issue the compiles and the link here. Finish checks the
+     * results, which lets drivers that compile in the background overlap
+     * several programs
+     * */
+    glCompileShader(S->Vertex);
+    glCompileShader(S->Fragment);
 
-    // Compile vertex shader and check for errors
-    if(Compile(S->Vertex) == BGE_FAILURE) {
-        Log("ERROR: Shader - Vertex shader compilation failed\n");
+    if(S->Link() == BGE_FAILURE) {
+        Log("ERROR: Shader - Program linking failed\n");
         delete S;
         return NULL;
     }
 
-    // Compile fragment shader and check for errors
-    if(Compile(S->Fragment) == BGE_FAILURE) {
+    return S;
+}
+
+
+Result Shader::Finish()
+{
+    /* Programs loaded from the binary cache are already linked */
+    if(Vertex == 0)
+        return ResolveVariables();
+
+    if(CheckCompile(Vertex) == BGE_FAILURE) {
+        Log("ERROR: Shader - Vertex shader compilation failed\n");
+        return BGE_FAILURE;
+    }
+
+    if(CheckCompile(Fragment) == BGE_FAILURE) {
         Log("ERROR: Shader - Fragment shader compilation failed\n");
-        delete S;
-        return NULL;
+        return BGE_FAILURE;
     }
 
-    if(S->Link() == BGE_FAILURE) {
+    if(CheckLink() == BGE_FAILURE) {
         Log("ERROR: Shader - Program linking failed\n");
-        delete S;
-        return NULL;
+        return BGE_FAILURE;
     }
 
-    return S;
+    SaveBinary(SourceKey, Program);
+
+    return BGE_SUCCESS;
+}
+
+
+ShaderHandle* Shader::LoadFromStringsAsync(int NumVertex, int NumFragment,
+                                            const char** VertexShaders,
+                                            const char** FragmentShaders)
+{
+    return ShaderHandle::Enqueue(NumVertex, NumFragment, VertexShaders,
+                                                FragmentShaders, NULL);
+}
+
+
+ShaderHandle* Shader::LoadFromStringsAsync(int NumVertex, int NumFragment,
+                                            const char** VertexShaders,
+                                            const char** FragmentShaders,
+                                            const char* Keywords)
+{
+    return ShaderHandle::Enqueue(NumVertex, NumFragment, VertexShaders,
+                                            FragmentShaders, Keywords);
+}
+
+
+/* Path of the cache file for a program key. Path holds at least 64 chars */
+static void GetBinaryPath(uint64 Key, char* Path)
+{
+    sprintf(Path, "%s/%08x%08x.bin", BGE_SHADER_CACHE_DIR,
+                                            (unsigned int)(Key >> 32),
+                                    (unsigned int)(Key & 0xffffffff));
+}
+
+
+uint64 Shader::HashSources(int NumVertex, int NumFragment,
+                                const char** VertexShaders,
+                                const char** FragmentShaders,
+                                const char* Defines)
+{
+    uint64 Hash = BGE_HASH_SEED;
+
+    /* A driver update invalidates every binary */
+    Hash = HashString(Hash, (const char*)glGetString(GL_VENDOR));
+    Hash = HashString(Hash, (const char*)glGetString(GL_RENDERER));
+    Hash = HashString(Hash, (const char*)glGetString(GL_VERSION));
+
+    Hash = HashString(Hash, VertexShaderLibSource);
+    Hash = HashString(Hash, FragmentShaderLibSource);
+    Hash = HashString(Hash, VertexShaderLibHeader);
+    Hash = HashString(Hash, FragmentShaderLibHeader);
+    Hash = HashString(Hash, Defines);
+
+    /* The terminators keep vertex and fragment sources from aliasing */
+    for(int i=0;i<NumVertex;++i)
+        Hash = HashString(Hash, VertexShaders[i]);
+
+    Hash = HashString(Hash, "");
+
+    for(int i=0;i<NumFragment;++i)
+        Hash = HashString(Hash, FragmentShaders[i]);
+
+    return Hash;
+}
+
+
+Result Shader::LoadBinary(uint64 Key, GLuint Handle)
+{
+    if(!GLEW_ARB_get_program_binary)
+        return BGE_FAILURE;
+
+    char Path[64];
+    GetBinaryPath(Key, Path);
+
+    if(PHYSFS_exists(Path) == 0)
+        return BGE_FAILURE;
+
+    PHYSFS_File* BinaryFile = PHYSFS_openRead(Path);
+    if(BinaryFile == NULL)
+        return BGE_FAILURE;
+
+    /* Header is magic, binary format and binary length */
+    uint32 Header[3];
+    PHYSFS_sint64 FileLength = PHYSFS_fileLength(BinaryFile);
+    if(PHYSFS_read(BinaryFile, Header, sizeof(uint32), 3) != 3
+                            || Header[0] != BinaryMagic || FileLength
+                    != (PHYSFS_sint64)(sizeof(Header) + Header[2])) {
+        Log("WARNING: Shader - Discarding malformed program binary %s\n",
+                                                                    Path);
+        PHYSFS_close(BinaryFile);
+        PHYSFS_delete(Path);
+        return BGE_FAILURE;
+    }
+
+    Byte* Data = new Byte[Header[2]];
+    PHYSFS_sint64 BytesRead = PHYSFS_read(BinaryFile, Data, 1, Header[2]);
+    PHYSFS_close(BinaryFile);
+
+    if(BytesRead != (PHYSFS_sint64)Header[2]) {
+        delete[] Data;
+        return BGE_FAILURE;
+    }
+
+    glProgramBinary(Handle, (GLenum)Header[1], Data, (GLsizei)Header[2]);
+    delete[] Data;
+
+    /* Drivers may reject binaries from another build; recompile then */
+    GLint Status;
+    glGetProgramiv(Handle, GL_LINK_STATUS, &Status);
+    if(Status == GL_FALSE) {
+        Log("WARNING: Shader - Driver rejected program binary %s\n", Path);
+        PHYSFS_delete(Path);
+        return BGE_FAILURE;
+    }
+
+    return BGE_SUCCESS;
+}
+
+
+Result Shader::SaveBinary(uint64 Key, GLuint Handle)
+{
+    if(!GLEW_ARB_get_program_binary)
+        return BGE_FAILURE;
+
+    GLint Length = 0;
+    glGetProgramiv(Handle, GL_PROGRAM_BINARY_LENGTH, &Length);
+    if(Length <= 0)
+        return BGE_FAILURE;
+
+    Byte* Data = new Byte[Length];
+    GLenum Format;
+    GLsizei Written = 0;
+    glGetProgramBinary(Handle, Length, &Written, &Format, Data);
+    if(Written <= 0) {
+        delete[] Data;
+        return BGE_FAILURE;
+    }
+
+    char Path[64];
+    GetBinaryPath(Key, Path);
+
+    PHYSFS_mkdir(BGE_SHADER_CACHE_DIR);
+    PHYSFS_File* BinaryFile = PHYSFS_openWrite(Path);
+    if(BinaryFile == NULL) {
+        Log("WARNING: Shader - Couldn't write program binary %s: %s\n",
+                                            Path, PHYSFS_getLastError());
+        delete[] Data;
+        return BGE_FAILURE;
+    }
+
+    uint32 Header[3];
+    Header[0] = BinaryMagic;
+    Header[1] = Format;
+    Header[2] = Written;
+
+    Result Res = BGE_SUCCESS;
+    if(PHYSFS_write(BinaryFile, Header, sizeof(uint32), 3) != 3
+            || PHYSFS_write(BinaryFile, Data, 1, Written) != Written)
+        Res = BGE_FAILURE;
+
+    PHYSFS_close(BinaryFile);
+    delete[] Data;
+
+    /* Don't leave a truncated binary behind */
+    if(Res == BGE_FAILURE)
+        PHYSFS_delete(Path);
+
+    return Res;
 }
 
 
@@ -414,8 +1063,6 @@ Result Shader::Compile(GLuint Handle)
         ;
 #endif // _DEBUG
 
-    Result Res = BGE_SUCCESS;
-
     glCompileShader(Handle);
 
 #ifdef _DEBUG
@@ -434,7 +1081,17 @@ Result Shader::Compile(GLuint Handle)
 
         Error = glGetError();
     }
+#endif // _DEBUG
+
+    return CheckCompile(Handle);
+}
 
+
+Result Shader::CheckCompile(GLuint Handle)
+{
+    Result Res = BGE_SUCCESS;
+
+#ifdef _DEBUG
     GLint Status, Length;
 
     glGetShaderiv(Handle, GL_COMPILE_STATUS, &Status);
@@ -445,7 +1102,7 @@ Result Shader::Compile(GLuint Handle)
     if(Length > 1) {
         char* Info = new char[Length];
         glGetShaderInfoLog(Handle, Length, NULL, Info);
-        Log("Shader compile result\n", Info);
+        Log("Shader compile result\n%s\n", Info);
         Log("======================\n");
         delete[] Info;
     }
@@ -487,16 +1144,25 @@ Result Shader::Bind() const
     }
 #endif // _DEBUG
 
-    // Below we bind some sensible defaults to various uniforms
+    Current = this;
+
+    /* *
+     * Below we bind some sensible defaults to various uniforms. These are
+     * only uploaded if the shadowed values differ
+     * */
     GLint Location;
 
-    Location = glGetUniformLocation(Program, BGE_DIFFUSE_UNIFORM);
+    Location = UniformLocations[SHADER_UNIFORM_DIFFUSE];
     if(Location >= 0)
-        glUniform1i(Location, 0);
+        SetUniform(Location, 0);
 
-    Location = glGetUniformLocation(Program, BGE_CROWD_UNIFORM);
+    Location = UniformLocations[SHADER_UNIFORM_CROWD];
     if(Location >= 0)
-        glUniformMatrix4fv(Location, 1, GL_FALSE, &Matrix::Identity[0]);
+        SetUniform(Location, Matrix::Identity);
+
+    /* Programs without the uniform block get frame data per bind */
+    if(!FrameBlock)
+        FrameUniforms::Apply(this);
 
     return BGE_SUCCESS;
 }
@@ -507,4 +1173,174 @@ Result Shader::Unbind() const
     return GenericShader->Bind();
 }
 
+
+const Shader* Shader::GetCurrent()
+{
+    return Current;
+}
+
+
+GLint Shader::GetAttributeLocation(SHADER_ATTRIBUTE Attribute) const
+{
+    if(Attribute < 0 || Attribute >= NUM_SHADER_ATTRIBUTES)
+        return -1;
+
+    return AttributeLocations[Attribute];
+}
+
+
+GLint Shader::GetAttributeLocation(const char* Name) const
+{
+    for(int i=0;i<NumAttributes;++i) {
+        if(MatchVariableName(Attributes[i].Name, Name))
+            return Attributes[i].Location;
+    }
+
+    return -1;
+}
+
+
+GLint Shader::GetUniformLocation(SHADER_UNIFORM Uniform) const
+{
+    if(Uniform < 0 || Uniform >= NUM_SHADER_UNIFORMS)
+        return -1;
+
+    return UniformLocations[Uniform];
+}
+
+
+GLint Shader::GetUniformLocation(const char* Name) const
+{
+    for(int i=0;i<NumUniforms;++i) {
+        if(MatchVariableName(Uniforms[i].Name, Name))
+            return Uniforms[i].Location;
+    }
+
+    return -1;
+}
+
+
+bool Shader::UpdateShadow(GLint Location, GLenum Type,
+                                    const void* Data) const
+{
+    ShaderVariable* Var = NULL;
+
+    for(int i=0;i<NumUniforms;++i) {
+        if(Uniforms[i].Location == Location) {
+            Var = &Uniforms[i];
+            break;
+        }
+    }
+
+    /* Array elements past the first aren't shadowed */
+    if(Var == NULL)
+        return true;
+
+    /* Let OpenGL report mismatched uploads; don't trust the shadow after */
+    if(Var->Shadow == NULL || !IsUploadCompatible(Type, Var->Type)) {
+        Var->ShadowValid = false;
+        return true;
+    }
+
+    if(Var->ShadowValid && memcmp(Var->Shadow, Data, Var->ShadowBytes) == 0)
+        return false;
+
+    memcpy(Var->Shadow, Data, Var->ShadowBytes);
+    Var->ShadowValid = true;
+
+    return true;
+}
+
+
+Result Shader::SetUniform(GLint Location, int Value) const
+{
+    if(Current != this) {
+        Log("ERROR: Shader - Can't set uniform of a Shader that isn't "
+                                                            "bound\n");
+        return BGE_FAILURE;
+    }
+
+    if(Location < 0)
+        return BGE_FAILURE;
+
+    GLint Data = Value;
+    if(UpdateShadow(Location, GL_INT, &Data))
+        glUniform1i(Location, Data);
+
+    return BGE_SUCCESS;
+}
+
+
+Result Shader::SetUniform(GLint Location, Scalar Value) const
+{
+    if(Current != this) {
+        Log("ERROR: Shader - Can't set uniform of a Shader that isn't "
+                                                            "bound\n");
+        return BGE_FAILURE;
+    }
+
+    if(Location < 0)
+        return BGE_FAILURE;
+
+    GLfloat Data = Value;
+    if(UpdateShadow(Location, GL_FLOAT, &Data))
+        glUniform1f(Location, Data);
+
+    return BGE_SUCCESS;
+}
+
+
+Result Shader::SetUniform(GLint Location, Vector4 BGE_NCP Value) const
+{
+    if(Current != this) {
+        Log("ERROR: Shader - Can't set uniform of a Shader that isn't "
+                                                            "bound\n");
+        return BGE_FAILURE;
+    }
+
+    if(Location < 0)
+        return BGE_FAILURE;
+
+    if(UpdateShadow(Location, GL_FLOAT_VEC4, &Value[0]))
+        glUniform4fv(Location, 1, &Value[0]);
+
+    return BGE_SUCCESS;
+}
+
+
+Result Shader::SetUniform(GLint Location, Matrix BGE_NCP Value) const
+{
+    if(Current != this) {
+        Log("ERROR: Shader - Can't set uniform of a Shader that isn't "
+                                                            "bound\n");
+        return BGE_FAILURE;
+    }
+
+    if(Location < 0)
+        return BGE_FAILURE;
+
+    if(UpdateShadow(Location, GL_FLOAT_MAT4, &Value[0]))
+        glUniformMatrix4fv(Location, 1, GL_FALSE, &Value[0]);
+
+    return BGE_SUCCESS;
+}
+
+
+bool Shader::UsesFrameBlock() const
+{
+    return FrameBlock;
+}
+
+
+Result Shader::InvalidateUniforms() const
+{
+    if(Program == 0)
+        return BGE_FAILURE;
+
+    for(int i=0;i<NumUniforms;++i)
+        Uniforms[i].ShadowValid = false;
+
+    return BGE_SUCCESS;
+}
+
 } /* bakge */
@@ -0,0 +1,404 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif // GL_MAX_SHADER_COMPILER_THREADS_KHR
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif // GL_COMPLETION_STATUS_KHR
+
+namespace bakge
+{
+
+/* glMaxShaderCompilerThreadsKHR; not known to our GLEW */
+typedef void (APIENTRY* MaxCompilerThreadsProc)(GLuint Count);
+
+Mutex* ShaderHandle::QueueLock = NULL;
+Thread* ShaderHandle::Worker = NULL;
+GLFWwindow* ShaderHandle::WorkerContext = NULL;
+ShaderHandle* ShaderHandle::QueueHead = NULL;
+ShaderHandle* ShaderHandle::QueueTail = NULL;
+bool ShaderHandle::WorkerRunning = false;
+bool ShaderHandle::ParallelCompile = false;
+
+
+/* Copy an array of null-terminated strings */
+static char** CopySources(int Count, const char** Sources)
+{
+    char** Copy = new char*[Count > 0 ? Count : 1];
+
+    for(int i=0;i<Count;++i) {
+        Copy[i] = new char[strlen(Sources[i]) + 1];
+        strcpy(Copy[i], Sources[i]);
+    }
+
+    return Copy;
+}
+
+
+static void FreeSources(int Count, char** Sources)
+{
+    if(Sources == NULL)
+        return;
+
+    for(int i=0;i<Count;++i)
+        delete[] Sources[i];
+
+    delete[] Sources;
+}
+
+
+ShaderHandle::ShaderHandle()
+{
+    Next = NULL;
+    NumVertex = 0;
+    NumFragment = 0;
+    VertexSources = NULL;
+    FragmentSources = NULL;
+    Keywords = NULL;
+    Program = NULL;
+    Done = false;
+}
+
+
+ShaderHandle::~ShaderHandle()
+{
+    /* The compiler thread may still be using our sources */
+    Wait();
+
+    if(Program != NULL)
+        delete Program;
+
+    FreeSources(NumVertex, VertexSources);
+    FreeSources(NumFragment, FragmentSources);
+    delete[] Keywords;
+}
+
+
+Result ShaderHandle::StartCompiler()
+{
+    if(QueueLock != NULL)
+        return BGE_SUCCESS;
+
+    /* The compiler thread only links against the library shaders */
+    if(Shader::CompileShaderLibrary() == BGE_FAILURE) {
+        Log("ERROR: ShaderHandle - Shader library unavailable\n");
+        return BGE_FAILURE;
+    }
+
+    ParallelCompile = glfwExtensionSupported("GL_KHR_parallel_shader_compile")
+                || glfwExtensionSupported("GL_ARB_parallel_shader_compile");
+
+    QueueLock = Mutex::Create();
+    if(QueueLock == NULL) {
+        Log("ERROR: ShaderHandle - Couldn't create queue lock\n");
+        return BGE_FAILURE;
+    }
+
+    /* A hidden window whose context shares objects with every Window */
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+    WorkerContext = glfwCreateWindow(16, 16, "", NULL, Window::SharedContext);
+    glfwWindowHint(GLFW_VISIBLE, GL_TRUE);
+
+    if(WorkerContext == NULL) {
+        Log("ERROR: ShaderHandle - Couldn't create compiler context\n");
+        delete QueueLock;
+        QueueLock = NULL;
+        return BGE_FAILURE;
+    }
+
+    WorkerRunning = false;
+
+    return BGE_SUCCESS;
+}
+
+
+Result ShaderHandle::WakeCompiler()
+{
+    /* The previous thread found the queue empty; wait for it to exit */
+    if(Worker != NULL)
+        delete Worker;
+
+    Worker = Thread::Create(CompilerEntry, NULL);
+    if(Worker != NULL)
+        return BGE_SUCCESS;
+
+    Log("ERROR: ShaderHandle - Couldn't start compiler thread\n");
+
+    /* Nothing will build the queued programs; fail them */
+    QueueLock->Lock();
+    for(ShaderHandle* H = QueueHead;H != NULL;H = H->Next)
+        H->Done = true;
+    QueueHead = NULL;
+    QueueTail = NULL;
+    WorkerRunning = false;
+    QueueLock->Unlock();
+
+    return BGE_FAILURE;
+}
+
+
+Result ShaderHandle::StopCompiler()
+{
+    if(QueueLock == NULL)
+        return BGE_FAILURE;
+
+    /* The thread drains the queue before it exits; deleting waits for it */
+    if(Worker != NULL) {
+        delete Worker;
+        Worker = NULL;
+    }
+
+    glfwDestroyWindow(WorkerContext);
+    WorkerContext = NULL;
+
+    delete QueueLock;
+    QueueLock = NULL;
+
+    return BGE_SUCCESS;
+}
+
+
+bool ShaderHandle::IsBuilt(Shader* Built)
+{
+    /* Programs from the binary cache have no shader objects to wait on */
+    if(!ParallelCompile || Built->Vertex == 0)
+        return true;
+
+    GLint Status = GL_FALSE;
+    glGetProgramiv(Built->Program, GL_COMPLETION_STATUS_KHR, &Status);
+
+    return Status == GL_TRUE;
+}
+
+
+int ShaderHandle::CompilerEntry(void* Data)
+{
+    glfwMakeContextCurrent(WorkerContext);
+
+    /* Let the driver use as many compiler threads as it likes */
+    if(ParallelCompile) {
+        MaxCompilerThreadsProc MaxCompilerThreads = (MaxCompilerThreadsProc)
+                    glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        if(MaxCompilerThreads == NULL)
+            MaxCompilerThreads = (MaxCompilerThreadsProc)
+                    glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        if(MaxCompilerThreads != NULL)
+            MaxCompilerThreads(0xFFFFFFFF);
+    }
+
+    while(1) {
+        /* Take everything queued so far */
+        QueueLock->Lock();
+        ShaderHandle* Batch = QueueHead;
+        QueueHead = NULL;
+        QueueTail = NULL;
+
+        /* Rather than idle, exit; the next Enqueue starts a new thread */
+        if(Batch == NULL)
+            WorkerRunning = false;
+        QueueLock->Unlock();
+
+        if(Batch == NULL)
+            break;
+
+        int Count = 0;
+        for(ShaderHandle* H = Batch;H != NULL;H = H->Next)
+            ++Count;
+
+        ShaderHandle** Pending = new ShaderHandle*[Count];
+        Shader** Built = new Shader*[Count];
+        bool* Complete = new bool[Count];
+
+        int Index = 0;
+        for(ShaderHandle* H = Batch;H != NULL;H = H->Next)
+            Pending[Index++] = H;
+
+        /* Issue every program before waiting on any of them */
+        for(int i=0;i<Count;++i) {
+            Built[i] = Shader::Submit(Pending[i]->NumVertex,
+                                        Pending[i]->NumFragment,
+                            (const char**)Pending[i]->VertexSources,
+                            (const char**)Pending[i]->FragmentSources,
+                                            Pending[i]->Keywords);
+            Complete[i] = false;
+        }
+
+        int Remaining = Count;
+        while(Remaining > 0) {
+            bool Progress = false;
+
+            for(int i=0;i<Count;++i) {
+                if(Complete[i])
+                    continue;
+
+                if(Built[i] != NULL) {
+                    if(!IsBuilt(Built[i]))
+                        continue;
+
+                    if(Built[i]->Finish() == BGE_FAILURE) {
+                        delete Built[i];
+                        Built[i] = NULL;
+                    }
+                }
+
+                Complete[i] = true;
+                Progress = true;
+            }
+
+            if(!Progress) {
+                Delay(500);
+                continue;
+            }
+
+            /* Other contexts may only use the programs once they're done */
+            glFinish();
+
+            /* Handles may be deleted as soon as they're published */
+            QueueLock->Lock();
+            for(int i=0;i<Count;++i) {
+                if(!Complete[i] || Pending[i] == NULL)
+                    continue;
+
+                Pending[i]->Program = Built[i];
+                Pending[i]->Done = true;
+                Pending[i] = NULL;
+                --Remaining;
+            }
+            QueueLock->Unlock();
+        }
+
+        delete[] Pending;
+        delete[] Built;
+        delete[] Complete;
+    }
+
+    glfwMakeContextCurrent(NULL);
+
+    return 0;
+}
+
+
+ShaderHandle* ShaderHandle::Enqueue(int NumVertex, int NumFragment,
+                                        const char** VertexShaders,
+                                        const char** FragmentShaders,
+                                        const char* Keywords)
+{
+    if(StartCompiler() == BGE_FAILURE) {
+        Log("ERROR: ShaderHandle - Background compiler unavailable\n");
+        return NULL;
+    }
+
+    ShaderHandle* H = new ShaderHandle;
+
+    H->NumVertex = NumVertex;
+    H->NumFragment = NumFragment;
+    H->VertexSources = CopySources(NumVertex, VertexShaders);
+    H->FragmentSources = CopySources(NumFragment, FragmentShaders);
+
+    if(Keywords != NULL) {
+        H->Keywords = new char[strlen(Keywords) + 1];
+        strcpy(H->Keywords, Keywords);
+    }
+
+    QueueLock->Lock();
+    if(QueueTail == NULL)
+        QueueHead = H;
+    else
+        QueueTail->Next = H;
+    QueueTail = H;
+    bool Running = WorkerRunning;
+    WorkerRunning = true;
+    QueueLock->Unlock();
+
+    /* A failed start marks H done, so waiting on it doesn't hang */
+    if(!Running)
+        WakeCompiler();
+
+    return H;
+}
+
+
+bool ShaderHandle::IsReady() const
+{
+    /* The compiler is only ever stopped once the queue is drained */
+    if(QueueLock == NULL)
+        return true;
+
+    QueueLock->Lock();
+    bool Ready = Done;
+    QueueLock->Unlock();
+
+    return Ready;
+}
+
+
+bool ShaderHandle::IsFailed() const
+{
+    return IsReady() && GetShader() == NULL;
+}
+
+
+Shader* ShaderHandle::GetShader() const
+{
+    if(QueueLock == NULL)
+        return Program;
+
+    QueueLock->Lock();
+    Shader* Ready = Done ? Program : NULL;
+    QueueLock->Unlock();
+
+    return Ready;
+}
+
+
+Result ShaderHandle::Wait() const
+{
+    while(!IsReady())
+        Delay(1000);
+
+    return GetShader() != NULL ? BGE_SUCCESS : BGE_FAILURE;
+}
+
+
+Result ShaderHandle::Bind() const
+{
+    Shader* Ready = GetShader();
+    if(Ready != NULL)
+        return Ready->Bind();
+
+    return Shader::GenericShader->Bind();
+}
+
+
+Result ShaderHandle::Unbind() const
+{
+    return Shader::GenericShader->Bind();
+}
+
+} /* bakge */
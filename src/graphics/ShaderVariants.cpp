@@ -0,0 +1,332 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/Utility.h>
+
+namespace bakge
+{
+
+/* *
+ * Compare the names of two keywords, the part before any '='. Names are
+ * ordered like strcmp orders them
+ * */
+static int CompareKeywordNames(const char* A, const char* B)
+{
+    while(*A != '\0' && *A != '=' && *A == *B) {
+        ++A;
+        ++B;
+    }
+
+    bool EndA = *A == '\0' || *A == '=';
+    bool EndB = *B == '\0' || *B == '=';
+
+    if(EndA && EndB)
+        return 0;
+
+    if(EndA)
+        return -1;
+
+    if(EndB)
+        return 1;
+
+    return (unsigned char)*A - (unsigned char)*B;
+}
+
+
+/* Order keywords by name, then by value */
+static int CompareKeywords(const char* A, const char* B)
+{
+    int Order = CompareKeywordNames(A, B);
+    if(Order != 0)
+        return Order;
+
+    return strcmp(A, B);
+}
+
+
+/* *
+ * Normalize a keyword list: keywords sorted by name and joined by single
+ * spaces, duplicates removed. Returns NULL if a name is given different
+ * values. Caller frees with delete[]
+ * */
+static char* NormalizeKeywords(const char* Keywords)
+{
+    if(Keywords == NULL)
+        Keywords = "";
+
+    size_t Length = strlen(Keywords);
+    char* Copy = new char[Length + 1];
+    strcpy(Copy, Keywords);
+
+    for(size_t i=0;i<Length;++i) {
+        if(IsKeywordSeparator(Copy[i]))
+            Copy[i] = '\0';
+    }
+
+    /* Collect keywords in sorted order */
+    const char** Tokens = new const char*[Length / 2 + 1];
+    int NumTokens = 0;
+
+    for(size_t i=0;i<Length;++i) {
+        if(Copy[i] == '\0' || (i > 0 && Copy[i-1] != '\0'))
+            continue;
+
+        int j = NumTokens++;
+        while(j > 0 && CompareKeywords(Tokens[j-1], &Copy[i]) > 0) {
+            Tokens[j] = Tokens[j-1];
+            --j;
+        }
+
+        Tokens[j] = &Copy[i];
+    }
+
+    char* Normalized = new char[Length + 1];
+    char* Out = Normalized;
+
+    for(int i=0;i<NumTokens;++i) {
+        if(i > 0 && CompareKeywordNames(Tokens[i], Tokens[i-1]) == 0) {
+            if(strcmp(Tokens[i], Tokens[i-1]) == 0)
+                continue;
+
+            /* Each would become a #define of the same name */
+            Log("ERROR: ShaderVariants - Conflicting keywords \"%s\" and "
+                                    "\"%s\"\n", Tokens[i-1], Tokens[i]);
+            delete[] Normalized;
+            delete[] Tokens;
+            delete[] Copy;
+            return NULL;
+        }
+
+        if(Out != Normalized)
+            *Out++ = ' ';
+
+        strcpy(Out, Tokens[i]);
+        Out += strlen(Tokens[i]);
+    }
+
+    *Out = '\0';
+
+    delete[] Tokens;
+    delete[] Copy;
+
+    return Normalized;
+}
+
+
+ShaderVariants::ShaderVariants()
+{
+    VertexSource = NULL;
+    FragmentSource = NULL;
+    NumVariants = 0;
+    Capacity = 0;
+    Variants = NULL;
+}
+
+
+ShaderVariants::~ShaderVariants()
+{
+    for(int i=0;i<NumVariants;++i) {
+        delete[] Variants[i].Keywords;
+        if(Variants[i].Program != NULL)
+            delete Variants[i].Program;
+    }
+
+    delete[] Variants;
+    delete[] VertexSource;
+    delete[] FragmentSource;
+}
+
+
+ShaderVariants* ShaderVariants::Create(const char* VertexSource,
+                                        const char* FragmentSource)
+{
+    if(VertexSource == NULL || FragmentSource == NULL) {
+        Log("ERROR: ShaderVariants - Missing base source\n");
+        return NULL;
+    }
+
+    ShaderVariants* V = new ShaderVariants;
+
+    V->VertexSource = new char[strlen(VertexSource) + 1];
+    strcpy(V->VertexSource, VertexSource);
+
+    V->FragmentSource = new char[strlen(FragmentSource) + 1];
+    strcpy(V->FragmentSource, FragmentSource);
+
+    return V;
+}
+
+
+ShaderVariants::Variant* ShaderVariants::FindVariant(uint64 Key,
+                                            const char* Keywords) const
+{
+    /* Compare the keywords as well in case two sets share a hash */
+    for(int i=0;i<NumVariants;++i) {
+        if(Variants[i].Key == Key
+                    && strcmp(Variants[i].Keywords, Keywords) == 0)
+            return &Variants[i];
+    }
+
+    return NULL;
+}
+
+
+Shader* ShaderVariants::GetVariant(const char* Keywords)
+{
+    char* Normalized = NormalizeKeywords(Keywords);
+    if(Normalized == NULL)
+        return NULL;
+
+    uint64 Key = HashString(BGE_HASH_SEED, Normalized);
+
+    Variant* Found = FindVariant(Key, Normalized);
+    if(Found != NULL) {
+        delete[] Normalized;
+        return Found->Program;
+    }
+
+    if(NumVariants == Capacity) {
+        int NewCapacity = Capacity > 0 ? Capacity * 2 : 4;
+        Variant* NewVariants = new Variant[NewCapacity];
+
+        for(int i=0;i<NumVariants;++i)
+            NewVariants[i] = Variants[i];
+
+        delete[] Variants;
+        Variants = NewVariants;
+        Capacity = NewCapacity;
+    }
+
+    const char* Vertex = VertexSource;
+    const char* Fragment = FragmentSource;
+
+    Variant* New = &Variants[NumVariants++];
+    New->Key = Key;
+    New->Keywords = Normalized;
+    New->Program = Shader::LoadFromStrings(1, 1, &Vertex, &Fragment,
+                                                        Normalized);
+
+    /* Failed variants stay in the table so they aren't rebuilt every use */
+    if(New->Program == NULL)
+        Log("ERROR: ShaderVariants - Variant \"%s\" failed to compile\n",
+                                                            Normalized);
+
+    return New->Program;
+}
+
+
+Result ShaderVariants::Precompile(const char* Manifest)
+{
+    if(Manifest == NULL)
+        return BGE_FAILURE;
+
+    Result Res = BGE_SUCCESS;
+    const char* Line = Manifest;
+
+    while(*Line != '\0') {
+        const char* End = Line;
+        while(*End != '\0' && *End != '\n')
+            ++End;
+
+        /* Strip comments */
+        const char* Stop = Line;
+        while(Stop < End && *Stop != '#')
+            ++Stop;
+
+        size_t Length = Stop - Line;
+        char* Keywords = new char[Length + 1];
+        memcpy(Keywords, Line, Length);
+        Keywords[Length] = '\0';
+
+        /* Skip lines without any keywords */
+        bool Empty = true;
+        for(size_t i=0;i<Length;++i) {
+            if(!IsKeywordSeparator(Keywords[i])) {
+                Empty = false;
+                break;
+            }
+        }
+
+        if(!Empty && GetVariant(Keywords) == NULL)
+            Res = BGE_FAILURE;
+
+        delete[] Keywords;
+
+        Line = *End == '\0' ? End : End + 1;
+    }
+
+    return Res;
+}
+
+
+Result ShaderVariants::LoadManifest(const char* FileName)
+{
+    if(PHYSFS_exists(FileName) == 0) {
+        Log("ERROR: ShaderVariants - Unable to locate manifest %s\n",
+                                                            FileName);
+        return BGE_FAILURE;
+    }
+
+    PHYSFS_File* ManifestFile = PHYSFS_openRead(FileName);
+    if(ManifestFile == NULL) {
+        Log("ERROR: ShaderVariants - Unable to open manifest %s\n",
+                                                            FileName);
+        return BGE_FAILURE;
+    }
+
+    PHYSFS_sint64 Size = PHYSFS_fileLength(ManifestFile);
+    if(Size < 0) {
+        Log("ERROR: ShaderVariants - Unable to get manifest length\n");
+        PHYSFS_close(ManifestFile);
+        return BGE_FAILURE;
+    }
+
+    char* Manifest = new char[(size_t)Size + 1];
+    PHYSFS_sint64 BytesRead = PHYSFS_read(ManifestFile, Manifest, 1,
+                                                (PHYSFS_uint32)Size);
+    PHYSFS_close(ManifestFile);
+
+    if(BytesRead != Size) {
+        Log("ERROR: ShaderVariants - Error reading manifest %s\n",
+                                                            FileName);
+        delete[] Manifest;
+        return BGE_FAILURE;
+    }
+
+    Manifest[Size] = '\0';
+
+    Result Res = Precompile(Manifest);
+    delete[] Manifest;
+
+    return Res;
+}
+
+
+int ShaderVariants::GetNumVariants() const
+{
+    return NumVariants;
+}
+
+} /* bakge */
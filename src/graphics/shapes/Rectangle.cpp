@@ -116,9 +116,8 @@ Result Rectangle::SetDimensions(Scalar Width, Scalar Height)
         R, B, 0
     };
 
-    SetPositionData(4, Positions);
-
-    return BGE_SUCCESS;
+    /* Updates the existing buffers in place once they've been allocated */
+    return SetPositionData(4, Positions);
 }
 
 
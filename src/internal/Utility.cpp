@@ -38,4 +38,26 @@ bool CheckRequiredExtensions()
     return true;
 }
 
+
+uint64 HashString(uint64 Hash, const char* String)
+{
+    const uint64 Prime = ((uint64)0x00000100 << 32) | 0x000001b3;
+
+    if(String == NULL)
+        String = "";
+
+    do {
+        Hash ^= (Byte)*String;
+        Hash *= Prime;
+    } while(*String++ != '\0');
+
+    return Hash;
+}
+
+
+bool IsKeywordSeparator(char C)
+{
+    return C == ' ' || C == '\t' || C == '\n' || C == '\r' || C == ',';
+}
+
 } // bakge
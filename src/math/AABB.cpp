@@ -0,0 +1,186 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <float.h>
+
+namespace bakge
+{
+
+AABB::AABB()
+{
+    /* Inverted so the first point or box expanded into becomes the box */
+    Min = Vector4(FLT_MAX, FLT_MAX, FLT_MAX, 1);
+    Max = Vector4(-FLT_MAX, -FLT_MAX, -FLT_MAX, 1);
+}
+
+
+AABB::AABB(Vector4 BGE_NCP MinCorner, Vector4 BGE_NCP MaxCorner)
+{
+    Min = MinCorner;
+    Max = MaxCorner;
+}
+
+
+AABB::AABB(AABB BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+AABB::~AABB()
+{
+}
+
+
+AABB BGE_NCP AABB::operator=(AABB BGE_NCP Other)
+{
+    Min = Other.Min;
+    Max = Other.Max;
+
+    return *this;
+}
+
+
+Vector4 BGE_NCP AABB::GetMin() const
+{
+    return Min;
+}
+
+
+Vector4 BGE_NCP AABB::GetMax() const
+{
+    return Max;
+}
+
+
+Vector4 AABB::GetCenter() const
+{
+    return Vector4::Point((Min[0] + Max[0]) * 0.5f, (Min[1] + Max[1]) * 0.5f,
+                                                (Min[2] + Max[2]) * 0.5f);
+}
+
+
+Vector4 AABB::GetExtents() const
+{
+    return Vector4::Vector((Max[0] - Min[0]) * 0.5f,
+                    (Max[1] - Min[1]) * 0.5f, (Max[2] - Min[2]) * 0.5f);
+}
+
+
+bool AABB::IsEmpty() const
+{
+    return Min[0] > Max[0] || Min[1] > Max[1] || Min[2] > Max[2];
+}
+
+
+AABB BGE_NCP AABB::Expand(Vector4 BGE_NCP Point)
+{
+    for(int i = 0; i < 3; ++i) {
+        if(Point[i] < Min[i])
+            Min[i] = Point[i];
+
+        if(Point[i] > Max[i])
+            Max[i] = Point[i];
+    }
+
+    return *this;
+}
+
+
+AABB BGE_NCP AABB::Expand(AABB BGE_NCP Other)
+{
+    if(Other.IsEmpty())
+        return *this;
+
+    Expand(Other.Min);
+
+    return Expand(Other.Max);
+}
+
+
+bool AABB::Contains(Vector4 BGE_NCP Point) const
+{
+    for(int i = 0; i < 3; ++i) {
+        if(Point[i] < Min[i] || Point[i] > Max[i])
+            return false;
+    }
+
+    return true;
+}
+
+
+bool AABB::Intersects(AABB BGE_NCP Other) const
+{
+    for(int i = 0; i < 3; ++i) {
+        if(Other.Max[i] < Min[i] || Other.Min[i] > Max[i])
+            return false;
+    }
+
+    return true;
+}
+
+
+AABB AABB::Transformed(Matrix BGE_NCP Transformation) const
+{
+    if(IsEmpty())
+        return *this;
+
+    /* *
+     * Arvo's method: each output axis starts at the translation and takes
+     * the smaller and larger of each rotated input extent
+     * */
+    Vector4 NewMin = Vector4::Point(Transformation[12], Transformation[13],
+                                                    Transformation[14]);
+    Vector4 NewMax = NewMin;
+
+    for(int c = 0; c < 3; ++c) {
+        for(int r = 0; r < 3; ++r) {
+            Scalar A = Transformation[c * 4 + r] * Min[c];
+            Scalar B = Transformation[c * 4 + r] * Max[c];
+
+            if(A < B) {
+                NewMin[r] += A;
+                NewMax[r] += B;
+            } else {
+                NewMin[r] += B;
+                NewMax[r] += A;
+            }
+        }
+    }
+
+    return AABB(NewMin, NewMax);
+}
+
+
+AABB AABB::FromCenterAndExtents(Vector4 BGE_NCP Center,
+                                Vector4 BGE_NCP Extents)
+{
+    return AABB(Vector4::Point(Center[0] - Extents[0], Center[1] - Extents[1],
+                                            Center[2] - Extents[2]),
+                Vector4::Point(Center[0] + Extents[0], Center[1] + Extents[1],
+                                            Center[2] + Extents[2]));
+}
+
+} /* bakge */
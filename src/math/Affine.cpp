@@ -0,0 +1,240 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+/* The library exports the out-of-line copies of the inline members */
+#ifdef BGE_MATH_INLINE
+#error "Build the Bakge library without BGE_MATH_INLINE"
+#endif /* BGE_MATH_INLINE */
+
+#include <bakge/Bakge.h>
+#include <bakge/math/Affine.inl>
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+const Affine Affine::Identity;
+
+Affine BGE_NCP Affine::Invert()
+{
+    /* Rows of the upper 3x3 */
+    Scalar A0 = Val[0], A1 = Val[1], A2 = Val[2];
+    Scalar B0 = Val[4], B1 = Val[5], B2 = Val[6];
+    Scalar C0 = Val[8], C1 = Val[9], C2 = Val[10];
+
+    /* Columns of the inverse are B x C, C x A and A x B over the determinant */
+    Scalar BC0 = B1 * C2 - B2 * C1;
+    Scalar BC1 = B2 * C0 - B0 * C2;
+    Scalar BC2 = B0 * C1 - B1 * C0;
+
+    Scalar Det = A0 * BC0 + A1 * BC1 + A2 * BC2;
+
+    /* Singular transformations are left untouched */
+    if(Det == 0)
+        return *this;
+
+    Scalar InvDet = 1.0f / Det;
+
+    BC0 *= InvDet;
+    BC1 *= InvDet;
+    BC2 *= InvDet;
+
+    Scalar CA0 = (C1 * A2 - C2 * A1) * InvDet;
+    Scalar CA1 = (C2 * A0 - C0 * A2) * InvDet;
+    Scalar CA2 = (C0 * A1 - C1 * A0) * InvDet;
+
+    Scalar AB0 = (A1 * B2 - A2 * B1) * InvDet;
+    Scalar AB1 = (A2 * B0 - A0 * B2) * InvDet;
+    Scalar AB2 = (A0 * B1 - A1 * B0) * InvDet;
+
+    Scalar T0 = Val[3], T1 = Val[7], T2 = Val[11];
+
+    Val[0] = BC0;
+    Val[1] = CA0;
+    Val[2] = AB0;
+    Val[3] = -(BC0 * T0 + CA0 * T1 + AB0 * T2);
+
+    Val[4] = BC1;
+    Val[5] = CA1;
+    Val[6] = AB1;
+    Val[7] = -(BC1 * T0 + CA1 * T1 + AB1 * T2);
+
+    Val[8] = BC2;
+    Val[9] = CA2;
+    Val[10] = AB2;
+    Val[11] = -(BC2 * T0 + CA2 * T1 + AB2 * T2);
+
+    return *this;
+}
+
+
+Affine Affine::Inverted() const
+{
+    return Affine(*this).Invert();
+}
+
+
+Affine BGE_NCP Affine::InvertRigid()
+{
+#ifdef BGE_USE_SIMD
+    __m128 Row0 = _mm_load_ps(&Val[0]);
+    __m128 Row1 = _mm_load_ps(&Val[4]);
+    __m128 Row2 = _mm_load_ps(&Val[8]);
+
+    /* -(R^T * t) is a sum of the rows scaled by each translation */
+    __m128 T = _mm_mul_ps(Row0, _mm_shuffle_ps(Row0, Row0, 0xFF));
+    T = _mm_add_ps(T, _mm_mul_ps(Row1, _mm_shuffle_ps(Row1, Row1, 0xFF)));
+    T = _mm_add_ps(T, _mm_mul_ps(Row2, _mm_shuffle_ps(Row2, Row2, 0xFF)));
+    T = _mm_sub_ps(_mm_setzero_ps(), T);
+
+    /* Transposing puts the new translation in the last column */
+    _MM_TRANSPOSE4_PS(Row0, Row1, Row2, T);
+
+    _mm_store_ps(&Val[0], Row0);
+    _mm_store_ps(&Val[4], Row1);
+    _mm_store_ps(&Val[8], Row2);
+#else
+    Scalar T0 = Val[3], T1 = Val[7], T2 = Val[11];
+
+    Scalar Temp = Val[1];
+    Val[1] = Val[4];
+    Val[4] = Temp;
+
+    Temp = Val[2];
+    Val[2] = Val[8];
+    Val[8] = Temp;
+
+    Temp = Val[6];
+    Val[6] = Val[9];
+    Val[9] = Temp;
+
+    Val[3] = -(Val[0] * T0 + Val[1] * T1 + Val[2] * T2);
+    Val[7] = -(Val[4] * T0 + Val[5] * T1 + Val[6] * T2);
+    Val[11] = -(Val[8] * T0 + Val[9] * T1 + Val[10] * T2);
+#endif /* BGE_USE_SIMD */
+
+    return *this;
+}
+
+
+Affine Affine::RigidInverted() const
+{
+    return Affine(*this).InvertRigid();
+}
+
+
+Vector4 Affine::GetScale() const
+{
+    /* Length of each column of the upper 3x3 */
+    return Vector4(
+        sqrtf(Val[0] * Val[0] + Val[4] * Val[4] + Val[8] * Val[8]),
+        sqrtf(Val[1] * Val[1] + Val[5] * Val[5] + Val[9] * Val[9]),
+        sqrtf(Val[2] * Val[2] + Val[6] * Val[6] + Val[10] * Val[10]),
+        0
+    );
+}
+
+
+Quaternion Affine::GetRotation() const
+{
+    Vector4 Scale = GetScale();
+    Scalar M[3][3];
+
+    for(int r = 0; r < 3; ++r) {
+        for(int c = 0; c < 3; ++c) {
+            M[r][c] = Scale[c] == 0 ? 0 : Val[r * 4 + c] / Scale[c];
+        }
+    }
+
+    /* Pick the largest of w, x, y and z to divide by for stability */
+    Scalar Trace = M[0][0] + M[1][1] + M[2][2];
+    Scalar S;
+
+    if(Trace > 0) {
+        S = sqrtf(Trace + 1) * 2;
+        return Quaternion((M[2][1] - M[1][2]) / S, (M[0][2] - M[2][0]) / S,
+                                    (M[1][0] - M[0][1]) / S, S * 0.25f);
+    }
+
+    if(M[0][0] > M[1][1] && M[0][0] > M[2][2]) {
+        S = sqrtf(1 + M[0][0] - M[1][1] - M[2][2]) * 2;
+        return Quaternion(S * 0.25f, (M[0][1] + M[1][0]) / S,
+                (M[0][2] + M[2][0]) / S, (M[2][1] - M[1][2]) / S);
+    }
+
+    if(M[1][1] > M[2][2]) {
+        S = sqrtf(1 + M[1][1] - M[0][0] - M[2][2]) * 2;
+        return Quaternion((M[0][1] + M[1][0]) / S, S * 0.25f,
+                (M[1][2] + M[2][1]) / S, (M[0][2] - M[2][0]) / S);
+    }
+
+    S = sqrtf(1 + M[2][2] - M[0][0] - M[1][1]) * 2;
+    return Quaternion((M[0][2] + M[2][0]) / S, (M[1][2] + M[2][1]) / S,
+                                S * 0.25f, (M[1][0] - M[0][1]) / S);
+}
+
+
+Matrix Affine::ToMatrix() const
+{
+    return Matrix(
+        Val[0], Val[4], Val[8], 0,
+        Val[1], Val[5], Val[9], 0,
+        Val[2], Val[6], Val[10], 0,
+        Val[3], Val[7], Val[11], 1
+    );
+}
+
+
+Affine Affine::FromMatrix(Matrix BGE_NCP M)
+{
+    return Affine(
+        Vector4(M[0], M[4], M[8], M[12]),
+        Vector4(M[1], M[5], M[9], M[13]),
+        Vector4(M[2], M[6], M[10], M[14])
+    );
+}
+
+
+Affine Affine::FromTransform(Vector4 BGE_NCP Translation,
+                Quaternion BGE_NCP Rotation, Vector4 BGE_NCP Scale)
+{
+    Matrix R = Rotation.ToMatrix();
+
+    /* Row r of T * R * S is row r of R scaled per column, then t[r] */
+    return Affine(
+        Vector4(R[0] * Scale[0], R[4] * Scale[1], R[8] * Scale[2],
+                                                    Translation[0]),
+        Vector4(R[1] * Scale[0], R[5] * Scale[1], R[9] * Scale[2],
+                                                    Translation[1]),
+        Vector4(R[2] * Scale[0], R[6] * Scale[1], R[10] * Scale[2],
+                                                    Translation[2])
+    );
+}
+
+} /* bakge */
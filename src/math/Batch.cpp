@@ -0,0 +1,220 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/MathKernels.h>
+
+namespace bakge
+{
+
+void TransformVectors(Matrix BGE_NCP M, const Vector4* In, Vector4* Out,
+                                                                int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->TransformVectors(&M[0], &In[0][0], &Out[0][0], Count);
+}
+
+
+void TransformPoints(Matrix BGE_NCP M, const Scalar* In, Scalar* Out,
+                                                            int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->TransformPacked(&M[0], In, Out, Count, 1);
+}
+
+
+void TransformDirections(Matrix BGE_NCP M, const Scalar* In, Scalar* Out,
+                                                                int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->TransformPacked(&M[0], In, Out, Count, 0);
+}
+
+
+void TransformPointsSoA(Matrix BGE_NCP M, Scalar* X, Scalar* Y, Scalar* Z,
+                                                                int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->TransformSoA(&M[0], X, Y, Z, Count, 1);
+}
+
+
+void TransformDirectionsSoA(Matrix BGE_NCP M, Scalar* X, Scalar* Y,
+                                                Scalar* Z, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->TransformSoA(&M[0], X, Y, Z, Count, 0);
+}
+
+
+void MultiplyMatrices(const Matrix* Left, Matrix BGE_NCP Right,
+                                        Matrix* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->MultiplyMatrixArray(&Left[0][0], &Right[0],
+                                                &Out[0][0], Count);
+}
+
+
+void MultiplyMatrixPairs(const Matrix* Left, const Matrix* Right,
+                                        Matrix* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->MultiplyMatrixPairs(&Left[0][0], &Right[0][0],
+                                                &Out[0][0], Count);
+}
+
+
+void MultiplyMatricesSoA(const Scalar* Left, Matrix BGE_NCP Right,
+                                        Scalar* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->MultiplyMatricesSoA(Left, &Right[0], Out, Count);
+}
+
+
+void MultiplyMatrixPairsSoA(const Scalar* Left, const Scalar* Right,
+                                            Scalar* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->MultiplyMatrixPairsSoA(Left, Right, Out, Count);
+}
+
+
+void NormalizeVectors(Vector4* Vectors, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->NormalizeVectors(&Vectors[0][0], Count);
+}
+
+
+void MultiplyQuaternionsSoA(const Scalar* Left, const Scalar* Right,
+                                            Scalar* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->MultiplyQuaternionsSoA(Left, Right, Out, Count);
+}
+
+
+void NormalizeQuaternionsSoA(Scalar* Q, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->NormalizeQuaternionsSoA(Q, Count);
+}
+
+
+void NlerpQuaternionsSoA(const Scalar* From, const Scalar* To,
+                        const Scalar* T, Scalar* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->NlerpQuaternionsSoA(From, To, T, Out, Count);
+}
+
+
+void SlerpQuaternionsSoA(const Scalar* From, const Scalar* To,
+                        const Scalar* T, Scalar* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->SlerpQuaternionsSoA(From, To, T, Out, Count);
+}
+
+
+void QuaternionsToMatricesSoA(const Scalar* Q, Matrix* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->QuaternionsToMatricesSoA(Q, &Out[0][0], Count);
+}
+
+
+void QuaternionsToRotationsSoA(const Scalar* Q, Scalar* Out, int Count)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->QuaternionsToRotationsSoA(Q, Out, Count);
+}
+
+
+void CullSpheresSoA(Frustum BGE_NCP View, const Scalar* Spheres, int Count,
+                                                        uint32* Visible)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->CullSpheresSoA(&View.GetPlane(FRUSTUM_LEFT)[0],
+                                            Spheres, Count, Visible);
+}
+
+
+void CullBoxesSoA(Frustum BGE_NCP View, const Scalar* Boxes, int Count,
+                                                    uint32* Visible)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->CullBoxesSoA(&View.GetPlane(FRUSTUM_LEFT)[0], Boxes,
+                                                        Count, Visible);
+}
+
+
+void IntersectRaysBoxesSoA(const Scalar* Rays, const Scalar* Boxes,
+                                        int Count, uint32* Hits)
+{
+    if(Count <= 0)
+        return;
+
+    GetMathKernels()->IntersectRaysBoxesSoA(Rays, Boxes, Count, Hits);
+}
+
+} /* bakge */
@@ -0,0 +1,322 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/MathKernels.h>
+
+#ifdef BGE_USE_SIMD
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif /* _MSC_VER */
+#endif /* BGE_USE_SIMD */
+
+namespace bakge
+{
+
+/* *
+ * One table per instruction set and precision. A table is filled in once
+ * and never written again, so threads holding a pointer to it are safe.
+ * Switching only changes which table Kernels points at.
+ * */
+static MathKernels Tables[NUM_MATH_ISAS][NUM_MATH_PRECISIONS];
+static bool Built[NUM_MATH_ISAS][NUM_MATH_PRECISIONS];
+static const MathKernels* volatile Kernels = NULL;
+static MATH_ISA CurrentISA = NUM_MATH_ISAS;
+static MATH_ISA BestISA = NUM_MATH_ISAS;
+MATH_PRECISION CurrentMathPrecision = MATH_PRECISION_EXACT;
+
+static const char* ISANames[NUM_MATH_ISAS] = {
+    "scalar",
+    "sse2",
+    "sse41",
+    "avx2"
+};
+
+static const char* PrecisionNames[NUM_MATH_PRECISIONS] = {
+    "exact",
+    "fast"
+};
+
+#ifdef BGE_USE_SIMD
+static void CPUID(int Leaf, int SubLeaf, unsigned int* Regs)
+{
+#ifdef _MSC_VER
+    __cpuidex((int*)Regs, Leaf, SubLeaf);
+#else
+    __cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif /* _MSC_VER */
+}
+
+
+/* Read XCR0 to check the OS saves AVX registers on context switches */
+static uint64 ReadXCR0()
+{
+#ifdef _MSC_VER
+    return (uint64)_xgetbv(0);
+#else
+    unsigned int Low, High;
+    __asm__ __volatile__ ("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+    return ((uint64)High << 32) | Low;
+#endif /* _MSC_VER */
+}
+#endif /* BGE_USE_SIMD */
+
+
+/* Best instruction set both compiled in and supported by this machine */
+static MATH_ISA DetectISA()
+{
+#ifdef BGE_USE_SIMD
+    unsigned int Regs[4];
+
+    CPUID(0, 0, Regs);
+    int MaxLeaf = (int)Regs[0];
+
+    CPUID(1, 0, Regs);
+    unsigned int ECX = Regs[2];
+    unsigned int EDX = Regs[3];
+
+    /* SSE2 is EDX bit 26; always set on x86-64 */
+    if((EDX & (1 << 26)) == 0)
+        return MATH_ISA_SCALAR;
+
+    /* SSE4.1 is ECX bit 19 */
+    if((ECX & (1 << 19)) == 0)
+        return MATH_ISA_SSE2;
+
+#ifdef BGE_HAVE_AVX2_KERNELS
+    /* Need OSXSAVE (bit 27), AVX (bit 28) and FMA (bit 12) */
+    unsigned int AVXBits = (1 << 27) | (1 << 28) | (1 << 12);
+    if((ECX & AVXBits) == AVXBits && MaxLeaf >= 7) {
+        /* OS must save XMM and YMM state */
+        if((ReadXCR0() & 0x6) == 0x6) {
+            /* AVX2 is leaf 7 EBX bit 5 */
+            CPUID(7, 0, Regs);
+            if(Regs[1] & (1 << 5))
+                return MATH_ISA_AVX2;
+        }
+    }
+#else
+    (void)MaxLeaf;
+#endif /* BGE_HAVE_AVX2_KERNELS */
+
+#ifdef BGE_HAVE_SSE41_KERNELS
+    return MATH_ISA_SSE41;
+#else
+    return MATH_ISA_SSE2;
+#endif /* BGE_HAVE_SSE41_KERNELS */
+#else
+    return MATH_ISA_SCALAR;
+#endif /* BGE_USE_SIMD */
+}
+
+
+static void BuildKernels(MATH_ISA ISA, MATH_PRECISION Precision,
+                                            MathKernels* Table)
+{
+    FillScalarMathKernels(Table);
+
+#ifdef BGE_USE_SIMD
+    if(ISA >= MATH_ISA_SSE2)
+        FillSSE2MathKernels(Table);
+
+#ifdef BGE_HAVE_SSE41_KERNELS
+    if(ISA >= MATH_ISA_SSE41)
+        FillSSE41MathKernels(Table);
+#endif /* BGE_HAVE_SSE41_KERNELS */
+
+#ifdef BGE_HAVE_AVX2_KERNELS
+    if(ISA >= MATH_ISA_AVX2)
+        FillAVX2MathKernels(Table);
+#endif /* BGE_HAVE_AVX2_KERNELS */
+#endif /* BGE_USE_SIMD */
+
+    if(Precision == MATH_PRECISION_FAST) {
+        Table->NormalizeVector = Table->NormalizeVectorFast;
+        Table->NormalizeVectors = Table->NormalizeVectorsFast;
+    }
+}
+
+
+/* Get the table for an instruction set and precision, filling it if needed */
+static const MathKernels* GetTable(MATH_ISA ISA, MATH_PRECISION Precision)
+{
+    if(!Built[ISA][Precision]) {
+        BuildKernels(ISA, Precision, &Tables[ISA][Precision]);
+        Built[ISA][Precision] = true;
+    }
+
+    return &Tables[ISA][Precision];
+}
+
+
+const MathKernels* GetMathKernels()
+{
+    /* *
+     * Math classes work before Init; use the baseline Bakge was built
+     * for until Init picks the best kernels for this machine
+     * */
+    if(Kernels == NULL) {
+#ifdef BGE_USE_SIMD
+        CurrentISA = MATH_ISA_SSE2;
+#else
+        CurrentISA = MATH_ISA_SCALAR;
+#endif /* BGE_USE_SIMD */
+        Kernels = GetTable(CurrentISA, CurrentMathPrecision);
+    }
+
+    return Kernels;
+}
+
+
+Result InitMathKernels()
+{
+    MATH_ISA ISA = GetBestMathISA();
+
+    const char* Forced = getenv("BGE_MATH_ISA");
+    if(Forced != NULL) {
+        int i;
+        for(i = 0; i < NUM_MATH_ISAS; ++i) {
+            if(strcmp(Forced, ISANames[i]) == 0)
+                break;
+        }
+
+        if(i == NUM_MATH_ISAS) {
+            Log("WARNING: Unknown BGE_MATH_ISA \"%s\"; ignoring\n", Forced);
+        } else if(!IsMathISASupported((MATH_ISA)i)) {
+            Log("WARNING: BGE_MATH_ISA \"%s\" isn't supported on this "
+                                                "machine\n", Forced);
+        } else {
+            ISA = (MATH_ISA)i;
+        }
+    }
+
+    const char* Precision = getenv("BGE_MATH_PRECISION");
+    if(Precision != NULL) {
+        if(strcmp(Precision, PrecisionNames[MATH_PRECISION_FAST]) == 0) {
+            CurrentMathPrecision = MATH_PRECISION_FAST;
+        } else if(strcmp(Precision,
+                    PrecisionNames[MATH_PRECISION_EXACT]) == 0) {
+            CurrentMathPrecision = MATH_PRECISION_EXACT;
+        } else {
+            Log("WARNING: Unknown BGE_MATH_PRECISION \"%s\"; ignoring\n",
+                                                            Precision);
+        }
+    }
+
+    /* *
+     * Fill every table this machine can use now, before any threads run,
+     * so switching later never writes to a table another thread may read
+     * */
+    GetMathKernels();
+    for(int i = 0; i <= GetBestMathISA(); ++i) {
+        for(int j = 0; j < NUM_MATH_PRECISIONS; ++j)
+            GetTable((MATH_ISA)i, (MATH_PRECISION)j);
+    }
+
+    if(SetMathISA(ISA) != BGE_SUCCESS)
+        return BGE_FAILURE;
+
+    Log("Using %s math kernels, %s precision\n", GetMathISAName(ISA),
+                                    PrecisionNames[CurrentMathPrecision]);
+
+    return BGE_SUCCESS;
+}
+
+
+bool IsMathISASupported(MATH_ISA ISA)
+{
+    if(ISA < MATH_ISA_SCALAR || ISA >= NUM_MATH_ISAS)
+        return false;
+
+    /* Every instruction set in the enum builds on the one before it */
+    return ISA <= GetBestMathISA();
+}
+
+
+Result SetMathISA(MATH_ISA ISA)
+{
+    if(!IsMathISASupported(ISA)) {
+        Log("ERROR: SetMathISA - Instruction set %s isn't supported\n",
+                                                GetMathISAName(ISA));
+        return BGE_FAILURE;
+    }
+
+    CurrentISA = ISA;
+    Kernels = GetTable(ISA, CurrentMathPrecision);
+
+    return BGE_SUCCESS;
+}
+
+
+MATH_ISA GetMathISA()
+{
+    GetMathKernels();
+
+    return CurrentISA;
+}
+
+
+MATH_ISA GetBestMathISA()
+{
+    if(BestISA == NUM_MATH_ISAS)
+        BestISA = DetectISA();
+
+    return BestISA;
+}
+
+
+const char* GetMathISAName(MATH_ISA ISA)
+{
+    if(ISA < MATH_ISA_SCALAR || ISA >= NUM_MATH_ISAS)
+        return "unknown";
+
+    return ISANames[ISA];
+}
+
+
+Result SetMathPrecision(MATH_PRECISION Precision)
+{
+    if(Precision < MATH_PRECISION_EXACT || Precision >= NUM_MATH_PRECISIONS) {
+        Log("ERROR: SetMathPrecision - Invalid precision %d\n",
+                                                    (int)Precision);
+        return BGE_FAILURE;
+    }
+
+    MATH_ISA ISA = GetMathISA();
+
+    CurrentMathPrecision = Precision;
+    Kernels = GetTable(ISA, Precision);
+
+    return BGE_SUCCESS;
+}
+
+
+MATH_PRECISION GetMathPrecision()
+{
+    return CurrentMathPrecision;
+}
+
+} /* bakge */
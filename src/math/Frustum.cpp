@@ -0,0 +1,130 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+Frustum::Frustum()
+{
+    /* Planes with no normal and a positive offset contain everything */
+    for(int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+        Planes[i] = Plane(0, 0, 0, 1);
+}
+
+
+Frustum::Frustum(Frustum BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+Frustum::~Frustum()
+{
+}
+
+
+Frustum BGE_NCP Frustum::operator=(Frustum BGE_NCP Other)
+{
+    for(int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+        Planes[i] = Other.Planes[i];
+
+    return *this;
+}
+
+
+Plane BGE_NCP Frustum::GetPlane(FRUSTUM_PLANE Which) const
+{
+    return Planes[Which];
+}
+
+
+bool Frustum::Contains(Vector4 BGE_NCP Point) const
+{
+    for(int i = 0; i < NUM_FRUSTUM_PLANES; ++i) {
+        if(Planes[i].Distance(Point) < 0)
+            return false;
+    }
+
+    return true;
+}
+
+
+bool Frustum::Intersects(Sphere BGE_NCP Target) const
+{
+    Scalar Radius = Target.GetRadius();
+
+    for(int i = 0; i < NUM_FRUSTUM_PLANES; ++i) {
+        if(Planes[i].Distance(Target.GetCenter()) < -Radius)
+            return false;
+    }
+
+    return true;
+}
+
+
+bool Frustum::Intersects(AABB BGE_NCP Box) const
+{
+    Vector4 Center = Box.GetCenter();
+    Vector4 Extents = Box.GetExtents();
+
+    for(int i = 0; i < NUM_FRUSTUM_PLANES; ++i) {
+        /* Projected radius of the box onto the plane's normal */
+        Scalar Radius = fabsf(Planes[i][0]) * Extents[0]
+                        + fabsf(Planes[i][1]) * Extents[1]
+                        + fabsf(Planes[i][2]) * Extents[2];
+
+        if(Planes[i].Distance(Center) < -Radius)
+            return false;
+    }
+
+    return true;
+}
+
+
+Frustum Frustum::FromMatrix(Matrix BGE_NCP ViewProjection)
+{
+    Frustum F;
+    const Matrix& M = ViewProjection;
+
+    /* *
+     * Clip space is -w <= x, y, z <= w. Row r of the transformation is
+     * (M[r], M[4 + r], M[8 + r], M[12 + r]); each plane is the last row
+     * plus or minus one of the others
+     * */
+    for(int i = 0; i < 3; ++i) {
+        F.Planes[i * 2] = Plane(M[3] + M[i], M[7] + M[4 + i],
+                                M[11] + M[8 + i], M[15] + M[12 + i]);
+        F.Planes[i * 2 + 1] = Plane(M[3] - M[i], M[7] - M[4 + i],
+                                M[11] - M[8 + i], M[15] - M[12 + i]);
+    }
+
+    for(int i = 0; i < NUM_FRUSTUM_PLANES; ++i)
+        F.Planes[i].Normalize();
+
+    return F;
+}
+
+} /* bakge */
@@ -22,7 +22,14 @@
  * THE SOFTWARE.
  * */
 
+/* The library exports the out-of-line copies of the inline members */
+#ifdef BGE_MATH_INLINE
+#error "Build the Bakge library without BGE_MATH_INLINE"
+#endif /* BGE_MATH_INLINE */
+
 #include <bakge/Bakge.h>
+#include <bakge/math/Matrix.inl>
+#include <bakge/internal/MathKernels.h>
 
 #ifdef BGE_USE_SIMD
 /* SSE and SSE2 instructions headers */
@@ -36,143 +43,11 @@ namespace bakge
 
 const Matrix Matrix::Identity;
 
-Matrix::Matrix()
-{
-    SetIdentity();
-}
-
-
-Matrix::~Matrix()
-{
-}
-
-
-Matrix::Matrix(Scalar A, Scalar B, Scalar C, Scalar D,
-           Scalar E, Scalar F, Scalar G, Scalar H,
-           Scalar I, Scalar J, Scalar K, Scalar L,
-           Scalar M, Scalar N, Scalar O, Scalar P)
-{
-    Val[0] = A;
-    Val[1] = B;
-    Val[2] = C;
-    Val[3] = D;
-    Val[4] = E;
-    Val[5] = F;
-    Val[6] = G;
-    Val[7] = H;
-    Val[8] = I;
-    Val[9] = J;
-    Val[10] = K;
-    Val[11] = L;
-    Val[12] = M;
-    Val[13] = N;
-    Val[14] = O;
-    Val[15] = P;
-}
-
-
-Matrix::Matrix(Vector4 BGE_NCP A, Vector4 BGE_NCP B, Vector4 BGE_NCP C,
-                                                    Vector4 BGE_NCP D)
-{
-    Val[0] = A[0];
-    Val[1] = A[1];
-    Val[2] = A[2];
-    Val[3] = A[3];
-    Val[4] = B[0];
-    Val[5] = B[1];
-    Val[6] = B[2];
-    Val[7] = B[3];
-    Val[8] = C[0];
-    Val[9] = C[1];
-    Val[10] = C[2];
-    Val[11] = C[3];
-    Val[12] = D[0];
-    Val[13] = D[1];
-    Val[14] = D[2];
-    Val[15] = D[3];
-}
-
-
-Matrix::Matrix(Matrix BGE_NCP Other)
-{
-    *this = Other;
-}
-
-
-Matrix BGE_NCP Matrix::operator=(Matrix BGE_NCP Other)
-{
-    for(int i=0;i<16;++i)
-        Val[i] = Other.Val[i];
-
-    return *this;
-}
-
-
 Matrix Matrix::operator*(Matrix BGE_NCP Other) const
 {
     Matrix Res;
 
-#ifdef BGE_USE_SIMD
-    __m128 T1, T2, C;
-
-    C = _mm_setr_ps(Other[0], Other[1], Other[2], Other[3]);
-    T1 = _mm_set1_ps(Val[0]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[1]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[2]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[3]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Res[0], T2);
-
-    C = _mm_setr_ps(Other[4], Other[5], Other[6], Other[7]);
-    T1 = _mm_set1_ps(Val[4]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[5]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[6]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[7]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Res[4], T2);
-
-    C = _mm_setr_ps(Other[8], Other[9], Other[10], Other[11]);
-    T1 = _mm_set1_ps(Val[8]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[9]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[10]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[11]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Res[8], T2);
-
-    C = _mm_setr_ps(Other[12], Other[13], Other[14], Other[15]);
-    T1 = _mm_set1_ps(Val[12]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[13]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[14]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[15]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Res[12], T2);
-#else
-    memset((void*)&Res[0], 0, sizeof(Scalar) * 16);
-
-    for(int i=0;i<4;++i) {
-        for(int j=0;j<4;++j) {
-            for(int k=0;k<4;++k) {
-                Res[i*4+k] += Val[i*4+j] * Other.Val[j*4+k];
-            }
-        }
-    }
-#endif /* BGE_USE_SIMD */
+    GetMathKernels()->MultiplyMatrices(Val, Other.Val, Res.Val);
 
     return Res;
 }
@@ -180,71 +55,7 @@ Matrix Matrix::operator*(Matrix BGE_NCP Other) const
 
 Matrix BGE_NCP Matrix::operator*=(Matrix BGE_NCP Other)
 {
-#ifdef BGE_USE_SIMD
-    __m128 T1, T2, C;
-
-    C = _mm_setr_ps(Other[0], Other[1], Other[2], Other[3]);
-    T1 = _mm_set1_ps(Val[0]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[1]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[2]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[3]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Val[0], T2);
-
-    C = _mm_setr_ps(Other[4], Other[5], Other[6], Other[7]);
-    T1 = _mm_set1_ps(Val[4]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[5]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[6]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[7]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Val[4], T2);
-
-    C = _mm_setr_ps(Other[8], Other[9], Other[10], Other[11]);
-    T1 = _mm_set1_ps(Val[8]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[9]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[10]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[11]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Val[8], T2);
-
-    C = _mm_setr_ps(Other[12], Other[13], Other[14], Other[15]);
-    T1 = _mm_set1_ps(Val[12]);
-    T2 = _mm_mul_ps(C, T1);
-    T1 =_mm_set1_ps(Val[13]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[14]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-    T1 =_mm_set1_ps(Val[15]);
-    T2 = _mm_add_ps(_mm_mul_ps(C, T1), T2);
-
-    _mm_storeu_ps(&Val[12], T2);
-#else
-    Matrix Result;
-    memset((void*)&Result[0], 0, sizeof(Scalar) * 16);
-
-    for(int i=0;i<4;++i) {
-        for(int j=0;j<4;++j) {
-            for(int k=0;k<4;++k) {
-                Result[i*4+k] += Val[i*4+j] * Other.Val[j*4+k];
-            }
-        }
-    }
-
-    for(int i=0;i<16;++i)
-        Val[i] = Result[i];
-#endif /* BGE_USE_SIMD */
+    GetMathKernels()->MultiplyMatrices(Val, Other.Val, Val);
 
     return *this;
 }
@@ -285,18 +96,6 @@ Matrix BGE_NCP Matrix::SetLookAt(Vector4 BGE_NCP Position,
 }
 
 
-Matrix BGE_NCP Matrix::SetIdentity()
-{
-    memset((void*)Val, 0, sizeof(Scalar) * 16);
-    Val[0] = 1.0f;
-    Val[5] = 1.0f;
-    Val[10] = 1.0f;
-    Val[15] = 1.0f;
-
-    return *this;
-}
-
-
 Matrix BGE_NCP Matrix::SetPerspective(Degrees FOV, Scalar Aspect,
                                 Scalar NearClip, Scalar FarClip)
 {
@@ -348,28 +147,6 @@ Matrix BGE_NCP Matrix::SetOrthographic(Scalar Left, Scalar Right,
 }
 
 
-Matrix Matrix::Scaling(Scalar X, Scalar Y, Scalar Z)
-{
-    return Matrix(
-        X, 0, 0, 0,
-        0, Y, 0, 0,
-        0, 0, Z, 0,
-        0, 0, 0, 1
-    );
-}
-
-
-Matrix Matrix::Translation(Scalar X, Scalar Y, Scalar Z)
-{
-    return Matrix(
-        1, 0, 0, 0,
-        0, 1, 0, 0,
-        0, 0, 1, 0,
-        X, Y, Z, 1
-    );
-}
-
-
 Matrix Matrix::Rotation(Radians X, Radians Y, Radians Z)
 {
     return Quaternion::FromEulerAngles(X, Y, Z).ToMatrix();
@@ -399,16 +176,6 @@ Matrix Matrix::Rotation(Radians Angle, Radians X, Radians Y, Radians Z)
 }
 
 
-Matrix BGE_NCP Matrix::Translate(Scalar X, Scalar Y, Scalar Z)
-{
-    Val[12] += X;
-    Val[13] += Y;
-    Val[14] += Z;
-
-    return *this;
-}
-
-
 Matrix BGE_NCP Matrix::Scale(Scalar X, Scalar Y, Scalar Z)
 {
     /* May change in the future */
@@ -436,35 +203,243 @@ Matrix BGE_NCP Matrix::Rotate(Radians Angle, Scalar X, Scalar Y, Scalar Z)
 
 Matrix BGE_NCP Matrix::Invert()
 {
+#ifdef BGE_USE_SIMD
+    /* *
+     * Cramer's rule on 2x2 sub-determinants, after Intel's AP-928. The
+     * inverse of the transpose is the transpose of the inverse, so this
+     * works on the array regardless of row or column-major interpretation
+     * */
+    __m128 Minor0, Minor1, Minor2, Minor3;
+    __m128 Row0, Row1, Row2, Row3;
+    __m128 Det, Tmp;
+
+    __m128 C0 = _mm_load_ps(&Val[0]);
+    __m128 C1 = _mm_load_ps(&Val[4]);
+    __m128 C2 = _mm_load_ps(&Val[8]);
+    __m128 C3 = _mm_load_ps(&Val[12]);
+
+    /* Transpose, with rows 1 and 3 swizzled as the cofactor math expects */
+    Tmp = _mm_movelh_ps(C0, C1);
+    Row1 = _mm_movelh_ps(C2, C3);
+    Row0 = _mm_shuffle_ps(Tmp, Row1, 0x88);
+    Row1 = _mm_shuffle_ps(Row1, Tmp, 0xDD);
+    Tmp = _mm_movehl_ps(C1, C0);
+    Row3 = _mm_movehl_ps(C3, C2);
+    Row2 = _mm_shuffle_ps(Tmp, Row3, 0x88);
+    Row3 = _mm_shuffle_ps(Row3, Tmp, 0xDD);
+
+    Tmp = _mm_mul_ps(Row2, Row3);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0xB1);
+    Minor0 = _mm_mul_ps(Row1, Tmp);
+    Minor1 = _mm_mul_ps(Row0, Tmp);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0x4E);
+    Minor0 = _mm_sub_ps(_mm_mul_ps(Row1, Tmp), Minor0);
+    Minor1 = _mm_sub_ps(_mm_mul_ps(Row0, Tmp), Minor1);
+    Minor1 = _mm_shuffle_ps(Minor1, Minor1, 0x4E);
+
+    Tmp = _mm_mul_ps(Row1, Row2);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0xB1);
+    Minor0 = _mm_add_ps(_mm_mul_ps(Row3, Tmp), Minor0);
+    Minor3 = _mm_mul_ps(Row0, Tmp);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0x4E);
+    Minor0 = _mm_sub_ps(Minor0, _mm_mul_ps(Row3, Tmp));
+    Minor3 = _mm_sub_ps(_mm_mul_ps(Row0, Tmp), Minor3);
+    Minor3 = _mm_shuffle_ps(Minor3, Minor3, 0x4E);
+
+    Tmp = _mm_mul_ps(_mm_shuffle_ps(Row1, Row1, 0x4E), Row3);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0xB1);
+    Row2 = _mm_shuffle_ps(Row2, Row2, 0x4E);
+    Minor0 = _mm_add_ps(_mm_mul_ps(Row2, Tmp), Minor0);
+    Minor2 = _mm_mul_ps(Row0, Tmp);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0x4E);
+    Minor0 = _mm_sub_ps(Minor0, _mm_mul_ps(Row2, Tmp));
+    Minor2 = _mm_sub_ps(_mm_mul_ps(Row0, Tmp), Minor2);
+    Minor2 = _mm_shuffle_ps(Minor2, Minor2, 0x4E);
+
+    Tmp = _mm_mul_ps(Row0, Row1);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0xB1);
+    Minor2 = _mm_add_ps(_mm_mul_ps(Row3, Tmp), Minor2);
+    Minor3 = _mm_sub_ps(_mm_mul_ps(Row2, Tmp), Minor3);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0x4E);
+    Minor2 = _mm_sub_ps(_mm_mul_ps(Row3, Tmp), Minor2);
+    Minor3 = _mm_sub_ps(Minor3, _mm_mul_ps(Row2, Tmp));
+
+    Tmp = _mm_mul_ps(Row0, Row3);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0xB1);
+    Minor1 = _mm_sub_ps(Minor1, _mm_mul_ps(Row2, Tmp));
+    Minor2 = _mm_add_ps(_mm_mul_ps(Row1, Tmp), Minor2);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0x4E);
+    Minor1 = _mm_add_ps(_mm_mul_ps(Row2, Tmp), Minor1);
+    Minor2 = _mm_sub_ps(Minor2, _mm_mul_ps(Row1, Tmp));
+
+    Tmp = _mm_mul_ps(Row0, Row2);
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0xB1);
+    Minor1 = _mm_add_ps(_mm_mul_ps(Row3, Tmp), Minor1);
+    Minor3 = _mm_sub_ps(Minor3, _mm_mul_ps(Row1, Tmp));
+    Tmp = _mm_shuffle_ps(Tmp, Tmp, 0x4E);
+    Minor1 = _mm_sub_ps(Minor1, _mm_mul_ps(Row3, Tmp));
+    Minor3 = _mm_add_ps(_mm_mul_ps(Row1, Tmp), Minor3);
+
+    /* Horizontal sum of first row times its cofactors */
+    Det = _mm_mul_ps(Row0, Minor0);
+    Det = _mm_add_ps(_mm_shuffle_ps(Det, Det, 0x4E), Det);
+    Det = _mm_add_ss(_mm_shuffle_ps(Det, Det, 0xB1), Det);
+
+    /* Singular matrices are left untouched */
+    if(_mm_cvtss_f32(Det) == 0)
+        return *this;
+
+    Det = _mm_div_ss(_mm_set_ss(1.0f), Det);
+    Det = _mm_shuffle_ps(Det, Det, 0x00);
+
+    _mm_store_ps(&Val[0], _mm_mul_ps(Det, Minor0));
+    _mm_store_ps(&Val[4], _mm_mul_ps(Det, Minor1));
+    _mm_store_ps(&Val[8], _mm_mul_ps(Det, Minor2));
+    _mm_store_ps(&Val[12], _mm_mul_ps(Det, Minor3));
+#else
+    /* 2x2 sub-determinants of the first and last two columns */
+    Scalar S0 = Val[0] * Val[5] - Val[4] * Val[1];
+    Scalar S1 = Val[0] * Val[6] - Val[4] * Val[2];
+    Scalar S2 = Val[0] * Val[7] - Val[4] * Val[3];
+    Scalar S3 = Val[1] * Val[6] - Val[5] * Val[2];
+    Scalar S4 = Val[1] * Val[7] - Val[5] * Val[3];
+    Scalar S5 = Val[2] * Val[7] - Val[6] * Val[3];
+
+    Scalar C5 = Val[10] * Val[15] - Val[14] * Val[11];
+    Scalar C4 = Val[9] * Val[15] - Val[13] * Val[11];
+    Scalar C3 = Val[9] * Val[14] - Val[13] * Val[10];
+    Scalar C2 = Val[8] * Val[15] - Val[12] * Val[11];
+    Scalar C1 = Val[8] * Val[14] - Val[12] * Val[10];
+    Scalar C0 = Val[8] * Val[13] - Val[12] * Val[9];
+
+    Scalar Det = S0 * C5 - S1 * C4 + S2 * C3 + S3 * C2 - S4 * C1 + S5 * C0;
+
+    /* Singular matrices are left untouched */
+    if(Det == 0)
+        return *this;
+
+    Scalar InvDet = 1.0f / Det;
+    Scalar In[16];
+    memcpy((void*)In, (const void*)Val, sizeof(Scalar) * 16);
+
+    Val[0] = (In[5] * C5 - In[6] * C4 + In[7] * C3) * InvDet;
+    Val[1] = (-In[1] * C5 + In[2] * C4 - In[3] * C3) * InvDet;
+    Val[2] = (In[13] * S5 - In[14] * S4 + In[15] * S3) * InvDet;
+    Val[3] = (-In[9] * S5 + In[10] * S4 - In[11] * S3) * InvDet;
+
+    Val[4] = (-In[4] * C5 + In[6] * C2 - In[7] * C1) * InvDet;
+    Val[5] = (In[0] * C5 - In[2] * C2 + In[3] * C1) * InvDet;
+    Val[6] = (-In[12] * S5 + In[14] * S2 - In[15] * S1) * InvDet;
+    Val[7] = (In[8] * S5 - In[10] * S2 + In[11] * S1) * InvDet;
+
+    Val[8] = (In[4] * C4 - In[5] * C2 + In[7] * C0) * InvDet;
+    Val[9] = (-In[0] * C4 + In[1] * C2 - In[3] * C0) * InvDet;
+    Val[10] = (In[12] * S4 - In[13] * S2 + In[15] * S0) * InvDet;
+    Val[11] = (-In[8] * S4 + In[9] * S2 - In[11] * S0) * InvDet;
+
+    Val[12] = (-In[4] * C3 + In[5] * C1 - In[6] * C0) * InvDet;
+    Val[13] = (In[0] * C3 - In[1] * C1 + In[2] * C0) * InvDet;
+    Val[14] = (-In[12] * S3 + In[13] * S1 - In[14] * S0) * InvDet;
+    Val[15] = (In[8] * S3 - In[9] * S1 + In[10] * S0) * InvDet;
+#endif /* BGE_USE_SIMD */
+
     return *this;
 }
 
 
 Matrix Matrix::Inverted() const
 {
-    return Matrix();
+    return Matrix(*this).Invert();
 }
 
 
-Scalar Matrix::Determinant() const
+Matrix BGE_NCP Matrix::InvertAffine()
 {
-    return Scalar(0);
+    /* Columns of the upper 3x3 */
+    Scalar A0 = Val[0], A1 = Val[1], A2 = Val[2];
+    Scalar B0 = Val[4], B1 = Val[5], B2 = Val[6];
+    Scalar C0 = Val[8], C1 = Val[9], C2 = Val[10];
+
+    /* Rows of the inverse are B x C, C x A and A x B over the determinant */
+    Scalar R00 = B1 * C2 - B2 * C1;
+    Scalar R01 = B2 * C0 - B0 * C2;
+    Scalar R02 = B0 * C1 - B1 * C0;
+
+    Scalar Det = A0 * R00 + A1 * R01 + A2 * R02;
+
+    /* Singular matrices are left untouched */
+    if(Det == 0)
+        return *this;
+
+    Scalar InvDet = 1.0f / Det;
+
+    R00 *= InvDet;
+    R01 *= InvDet;
+    R02 *= InvDet;
+
+    Scalar R10 = (C1 * A2 - C2 * A1) * InvDet;
+    Scalar R11 = (C2 * A0 - C0 * A2) * InvDet;
+    Scalar R12 = (C0 * A1 - C1 * A0) * InvDet;
+
+    Scalar R20 = (A1 * B2 - A2 * B1) * InvDet;
+    Scalar R21 = (A2 * B0 - A0 * B2) * InvDet;
+    Scalar R22 = (A0 * B1 - A1 * B0) * InvDet;
+
+    Scalar T0 = Val[12], T1 = Val[13], T2 = Val[14];
+
+    Val[0] = R00;
+    Val[1] = R10;
+    Val[2] = R20;
+    Val[3] = 0;
+
+    Val[4] = R01;
+    Val[5] = R11;
+    Val[6] = R21;
+    Val[7] = 0;
+
+    Val[8] = R02;
+    Val[9] = R12;
+    Val[10] = R22;
+    Val[11] = 0;
+
+    Val[12] = -(R00 * T0 + R01 * T1 + R02 * T2);
+    Val[13] = -(R10 * T0 + R11 * T1 + R12 * T2);
+    Val[14] = -(R20 * T0 + R21 * T1 + R22 * T2);
+    Val[15] = 1;
+
+    return *this;
 }
 
 
-Matrix Matrix::Transposed() const
+Matrix Matrix::AffineInverted() const
 {
-    return Matrix(
-        Val[0], Val[4], Val[8], Val[12],
-        Val[1], Val[5], Val[9], Val[13],
-        Val[2], Val[6], Val[10], Val[14],
-        Val[3], Val[7], Val[11], Val[15]
-    );
+    return Matrix(*this).InvertAffine();
 }
 
 
-Matrix BGE_NCP Matrix::Transpose()
+Matrix BGE_NCP Matrix::InvertRigid()
 {
+#ifdef BGE_USE_SIMD
+    __m128 Col0 = _mm_load_ps(&Val[0]);
+    __m128 Col1 = _mm_load_ps(&Val[4]);
+    __m128 Col2 = _mm_load_ps(&Val[8]);
+    __m128 Col3 = _mm_setzero_ps();
+    __m128 Trans = _mm_load_ps(&Val[12]);
+
+    /* Rotation is orthonormal so its inverse is its transpose */
+    _MM_TRANSPOSE4_PS(Col0, Col1, Col2, Col3);
+
+    /* New translation is the old one rotated by the inverse, negated */
+    __m128 T = _mm_mul_ps(Col0, _mm_shuffle_ps(Trans, Trans, 0x00));
+    T = _mm_add_ps(T, _mm_mul_ps(Col1, _mm_shuffle_ps(Trans, Trans, 0x55)));
+    T = _mm_add_ps(T, _mm_mul_ps(Col2, _mm_shuffle_ps(Trans, Trans, 0xAA)));
+    T = _mm_sub_ps(_mm_setr_ps(0, 0, 0, 1), T);
+
+    _mm_store_ps(&Val[0], Col0);
+    _mm_store_ps(&Val[4], Col1);
+    _mm_store_ps(&Val[8], Col2);
+    _mm_store_ps(&Val[12], T);
+#else
     Scalar Temp = Val[4];
     Val[4] = Val[1];
     Val[1] = Temp;
@@ -473,53 +448,37 @@ Matrix BGE_NCP Matrix::Transpose()
     Val[8] = Val[2];
     Val[2] = Temp;
 
-    Temp = Val[12];
-    Val[12] = Val[3];
-    Val[3] = Temp;
-
     Temp = Val[9];
     Val[9] = Val[6];
     Val[6] = Temp;
 
-    Temp = Val[13];
-    Val[13] = Val[7];
-    Val[7] = Temp;
+    Scalar T0 = Val[12], T1 = Val[13], T2 = Val[14];
+
+    Val[12] = -(Val[0] * T0 + Val[4] * T1 + Val[8] * T2);
+    Val[13] = -(Val[1] * T0 + Val[5] * T1 + Val[9] * T2);
+    Val[14] = -(Val[2] * T0 + Val[6] * T1 + Val[10] * T2);
 
-    Temp = Val[14];
-    Val[14] = Val[11];
-    Val[11] = Temp;
+    Val[3] = Val[7] = Val[11] = 0;
+    Val[15] = 1;
+#endif /* BGE_USE_SIMD */
 
     return *this;
 }
 
 
+Matrix Matrix::RigidInverted() const
+{
+    return Matrix(*this).InvertRigid();
+}
+
+
 Vector4 Matrix::operator*(Vector4 BGE_NCP Other) const
 {
-    Scalar A = 0;
-    Scalar B = 0;
-    Scalar C = 0;
-    Scalar D = 0;
-
-    A += M00 * Other[0];
-    B += M01 * Other[0];
-    C += M02 * Other[0];
-    D += M03 * Other[0];
-    A += M10 * Other[1];
-    B += M11 * Other[1];
-    C += M12 * Other[1];
-    D += M13 * Other[1];
-    A += M20 * Other[2];
-    B += M21 * Other[2];
-    C += M22 * Other[2];
-    D += M23 * Other[2];
-    A += M30 * Other[3];
-    B += M31 * Other[3];
-    C += M32 * Other[3];
-    D += M33 * Other[3];
-
-    return Vector4(
-        A, B, C, D
-    );
+    Vector4 Res;
+
+    GetMathKernels()->TransformVector(Val, &Other[0], &Res[0]);
+
+    return Res;
 }
 
 } /* bakge */
@@ -0,0 +1,124 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+Plane::Plane()
+{
+    Val[0] = 0;
+    Val[1] = 1;
+    Val[2] = 0;
+    Val[3] = 0;
+}
+
+
+Plane::Plane(Scalar A, Scalar B, Scalar C, Scalar D)
+{
+    Val[0] = A;
+    Val[1] = B;
+    Val[2] = C;
+    Val[3] = D;
+}
+
+
+Plane::Plane(Plane BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+Plane::~Plane()
+{
+}
+
+
+Plane BGE_NCP Plane::operator=(Plane BGE_NCP Other)
+{
+    Val[0] = Other.Val[0];
+    Val[1] = Other.Val[1];
+    Val[2] = Other.Val[2];
+    Val[3] = Other.Val[3];
+
+    return *this;
+}
+
+
+Scalar& Plane::operator[](int At)
+{
+    return Val[At];
+}
+
+
+Scalar BGE_NCP Plane::operator[](int At) const
+{
+    return Val[At];
+}
+
+
+Plane BGE_NCP Plane::Normalize()
+{
+    Scalar Len = sqrtf(Val[0] * Val[0] + Val[1] * Val[1] + Val[2] * Val[2]);
+
+    Val[0] /= Len;
+    Val[1] /= Len;
+    Val[2] /= Len;
+    Val[3] /= Len;
+
+    return *this;
+}
+
+
+Vector4 Plane::GetNormal() const
+{
+    return Vector4(Val[0], Val[1], Val[2], 0);
+}
+
+
+Scalar Plane::Distance(Vector4 BGE_NCP Point) const
+{
+    return Val[0] * Point[0] + Val[1] * Point[1] + Val[2] * Point[2]
+                                                            + Val[3];
+}
+
+
+Plane Plane::FromPointAndNormal(Vector4 BGE_NCP Point,
+                                Vector4 BGE_NCP Normal)
+{
+    return Plane(Normal[0], Normal[1], Normal[2], -(Normal[0] * Point[0]
+                        + Normal[1] * Point[1] + Normal[2] * Point[2]));
+}
+
+
+Plane Plane::FromPoints(Vector4 BGE_NCP A, Vector4 BGE_NCP B,
+                                        Vector4 BGE_NCP C)
+{
+    Vector4 Normal = Vector4::Cross(B - A, C - A);
+
+    return FromPointAndNormal(A, Normal).Normalize();
+}
+
+} /* bakge */
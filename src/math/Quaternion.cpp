@@ -22,73 +22,52 @@
  * THE SOFTWARE.
  * */
 
-#include <bakge/Bakge.h>
-
-namespace bakge
-{
-
-const Quaternion Quaternion::Identity;
-
-Quaternion::Quaternion()
-{
-    Val[0] = 0.0f;
-    Val[1] = 0.0f;
-    Val[2] = 0.0f;
-    Val[3] = 1.0f;
-}
-
-
-Quaternion::Quaternion(Vector4 BGE_NCP V, Scalar R)
-{
-    Val[0] = V[0];
-    Val[1] = V[1];
-    Val[2] = V[2];
-    Val[3] = R;
-}
-
-
-Quaternion::Quaternion(Vector4 BGE_NCP Components)
-{
-    Val[0] = Components[0];
-    Val[1] = Components[1];
-    Val[2] = Components[2];
-    Val[3] = Components[3];
-}
-
+/* The library exports the out-of-line copies of the inline members */
+#ifdef BGE_MATH_INLINE
+#error "Build the Bakge library without BGE_MATH_INLINE"
+#endif /* BGE_MATH_INLINE */
 
-Quaternion::Quaternion(Scalar X, Scalar Y, Scalar Z, Scalar W)
-{
-    Val[0] = X;
-    Val[1] = Y;
-    Val[2] = Z;
-    Val[3] = W;
-}
+#include <bakge/Bakge.h>
+#include <bakge/math/Quaternion.inl>
 
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+#endif /* BGE_USE_SIMD */
 
-Quaternion::Quaternion(Quaternion BGE_NCP Other)
+namespace bakge
 {
-    Val[0] = Other.Val[0];
-    Val[1] = Other.Val[1];
-    Val[2] = Other.Val[2];
-    Val[3] = Other.Val[3];
-}
-
 
-Quaternion::~Quaternion()
+#ifdef BGE_USE_SIMD
+/* *
+ * Hamilton product of two quaternions held in registers, (x, y, z, w):
+ * A.w * B + A.x * B.wzyx * (+-+-) + A.y * B.zwxy * (++--)
+ *         + A.z * B.yxwz * (-++-)
+ * */
+static __m128 MultiplyQuaternions(__m128 A, __m128 B)
 {
-}
+    const __m128 SignX = _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f);
+    const __m128 SignY = _mm_setr_ps(0.0f, 0.0f, -0.0f, -0.0f);
+    const __m128 SignZ = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
 
+    __m128 R = _mm_mul_ps(_mm_shuffle_ps(A, A, 0xFF), B);
 
-Quaternion BGE_NCP Quaternion::operator=(Quaternion BGE_NCP Other)
-{
-    Q0 = Other.Q0;
-    Q1 = Other.Q1;
-    Q2 = Other.Q2;
-    Q3 = Other.Q3;
+    R = _mm_add_ps(R, _mm_xor_ps(SignX, _mm_mul_ps(
+                    _mm_shuffle_ps(A, A, 0x00),
+                    _mm_shuffle_ps(B, B, _MM_SHUFFLE(0, 1, 2, 3)))));
+    R = _mm_add_ps(R, _mm_xor_ps(SignY, _mm_mul_ps(
+                    _mm_shuffle_ps(A, A, 0x55),
+                    _mm_shuffle_ps(B, B, _MM_SHUFFLE(1, 0, 3, 2)))));
+    R = _mm_add_ps(R, _mm_xor_ps(SignZ, _mm_mul_ps(
+                    _mm_shuffle_ps(A, A, 0xAA),
+                    _mm_shuffle_ps(B, B, _MM_SHUFFLE(2, 3, 0, 1)))));
 
-    return *this;
+    return R;
 }
+#endif /* BGE_USE_SIMD */
 
+const Quaternion Quaternion::Identity;
 
 Matrix Quaternion::ToMatrix() const
 {
@@ -110,12 +89,6 @@ Matrix Quaternion::ToMatrix() const
 }
 
 
-Radians Quaternion::GetAngle() const
-{
-    return acosf(Val[3]) * 2.0f;
-}
-
-
 Vector4 Quaternion::GetAxis() const
 {
     if(ScalarCompare(Val[3], 1.0f)) {
@@ -132,12 +105,20 @@ Vector4 Quaternion::GetAxis() const
 
 Quaternion Quaternion::FromEulerAngles(Radians X, Radians Y, Radians Z)
 {
-    Scalar SinX = sinf(X / 2.0f);
-    Scalar SinY = sinf(Y / 2.0f);
-    Scalar SinZ = sinf(Z / 2.0f);
-    Scalar CosX = cosf(X / 2.0f);
-    Scalar CosY = cosf(Y / 2.0f);
-    Scalar CosZ = cosf(Z / 2.0f);
+    Scalar SinX, SinY, SinZ, CosX, CosY, CosZ;
+
+    if(GetMathPrecision() == MATH_PRECISION_FAST) {
+        FastSinCos(X / 2.0f, &SinX, &CosX);
+        FastSinCos(Y / 2.0f, &SinY, &CosY);
+        FastSinCos(Z / 2.0f, &SinZ, &CosZ);
+    } else {
+        SinX = sinf(X / 2.0f);
+        SinY = sinf(Y / 2.0f);
+        SinZ = sinf(Z / 2.0f);
+        CosX = cosf(X / 2.0f);
+        CosY = cosf(Y / 2.0f);
+        CosZ = cosf(Z / 2.0f);
+    }
 
     return Quaternion(
         Vector4(
@@ -153,33 +134,22 @@ Quaternion Quaternion::FromEulerAngles(Radians X, Radians Y, Radians Z)
 
 Quaternion Quaternion::FromAxisAndAngle(Vector4 BGE_NCP Axis, Radians Angle)
 {
-    return Quaternion(Axis * sinf(Angle / 2.0f), cosf(Angle / 2.0f));
-}
-
-Quaternion BGE_NCP Quaternion::operator+=(Quaternion BGE_NCP Other)
-{
-    Val[0] += Other.Val[0];
-    Val[1] += Other.Val[1];
-    Val[2] += Other.Val[2];
-    Val[3] += Other.Val[3];
-
-    return *this;
-}
+    if(GetMathPrecision() == MATH_PRECISION_FAST) {
+        Scalar Sin, Cos;
+        FastSinCos(Angle / 2.0f, &Sin, &Cos);
 
+        return Quaternion(Axis * Sin, Cos);
+    }
 
-Quaternion BGE_NCP Quaternion::operator-=(Quaternion BGE_NCP Other)
-{
-    Val[0] -= Other.Val[0];
-    Val[1] -= Other.Val[1];
-    Val[2] -= Other.Val[2];
-    Val[3] -= Other.Val[3];
-
-    return *this;
+    return Quaternion(Axis * sinf(Angle / 2.0f), cosf(Angle / 2.0f));
 }
 
-
 Quaternion BGE_NCP Quaternion::operator*=(Quaternion BGE_NCP Other)
 {
+#ifdef BGE_USE_SIMD
+    _mm_store_ps(Val, MultiplyQuaternions(_mm_load_ps(Val),
+                                    _mm_load_ps(Other.Val)));
+#else
     Vector4 Temp(Val[0], Val[1], Val[2], Val[3]);
     Val[3] *= Other.Val[3];
     Val[3] -= Val[0] * Other.Val[0];
@@ -194,6 +164,7 @@ Quaternion BGE_NCP Quaternion::operator*=(Quaternion BGE_NCP Other)
     Val[0] += Temp[1] * Other.Val[2] - Temp[2] * Other.Val[1];
     Val[1] += Temp[2] * Other.Val[0] - Temp[0] * Other.Val[2];
     Val[2] += Temp[0] * Other.Val[1] - Temp[1] * Other.Val[0];
+#endif /* BGE_USE_SIMD */
 
     return *this;
 }
@@ -207,44 +178,15 @@ Quaternion BGE_NCP Quaternion::operator/=(Quaternion BGE_NCP Other)
 }
 
 
-Quaternion BGE_NCP Quaternion::operator*=(Scalar BGE_NCP Value)
-{
-    Val[0] *= Value;
-    Val[1] *= Value;
-    Val[2] *= Value;
-    Val[3] *= Value;
-
-    return *this;
-}
-
-
-Quaternion BGE_NCP Quaternion::operator/=(Scalar BGE_NCP Value)
-{
-    Val[0] /= Value;
-    Val[1] /= Value;
-    Val[2] /= Value;
-    Val[3] /= Value;
-
-    return *this;
-}
-
-
-Quaternion Quaternion::operator+(Quaternion BGE_NCP Other) const
-{
-    return Quaternion(Val[0] + Other.Val[0], Val[1] + Other.Val[1],
-                        Val[2] + Other.Val[2], Val[3] + Other.Val[3]);
-}
-
-
-Quaternion Quaternion::operator-(Quaternion BGE_NCP Other) const
-{
-    return Quaternion(Val[0] - Other.Val[0], Val[1] - Other.Val[1],
-                        Val[2] - Other.Val[2], Val[3] - Other.Val[3]);
-}
-
-
 Quaternion Quaternion::operator*(Quaternion BGE_NCP Other) const
 {
+#ifdef BGE_USE_SIMD
+    Quaternion Res;
+    _mm_store_ps(Res.Val, MultiplyQuaternions(_mm_load_ps(Val),
+                                        _mm_load_ps(Other.Val)));
+
+    return Res;
+#else
     Vector4 Us(Val[0], Val[1], Val[2], 0);
     Vector4 Them(Other.Val[0], Other.Val[1], Other.Val[2], 0);
 
@@ -260,6 +202,7 @@ Quaternion Quaternion::operator*(Quaternion BGE_NCP Other) const
         ),
         Val[3] * Other.Val[3] - Vector4::Dot(Us, Them)
     );
+#endif /* BGE_USE_SIMD */
 }
 
 
@@ -269,26 +212,6 @@ Quaternion Quaternion::operator/(Quaternion BGE_NCP Other) const
 }
 
 
-Quaternion Quaternion::operator*(Scalar BGE_NCP Value) const
-{
-    return Quaternion(Val[0] * Value, Val[1] * Value,
-                        Val[2] * Value, Val[3] * Value);
-}
-
-
-Quaternion Quaternion::operator/(Scalar BGE_NCP Value) const
-{
-    return Quaternion(Val[0] / Value, Val[1] / Value,
-                        Val[2] / Value, Val[3] / Value);
-}
-
-
-Quaternion Quaternion::operator-() const
-{
-    return Quaternion(-Val[0], -Val[1], -Val[2], -Val[3]);
-}
-
-
 Quaternion BGE_NCP Quaternion::Invert()
 {
     Val[0] *= -1;
@@ -325,24 +248,4 @@ Quaternion BGE_NCP Quaternion::Normalize()
     return *this;
 }
 
-
-Quaternion Quaternion::Normalized() const
-{
-    return Quaternion(*this).Normalize();
-}
-
-
-Scalar Quaternion::Length() const
-{
-    return sqrt(LengthSq());
-}
-
-
-Scalar Quaternion::LengthSq() const
-{
-    Vector4 Us(Val[0], Val[1], Val[2], 0);
-
-    return Scalar(Val[3] * Val[3] + pow(Us.Length(), 2));
-}
-
 } /* bakge */
@@ -0,0 +1,167 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <float.h>
+
+namespace bakge
+{
+
+Ray::Ray()
+{
+    Direction = Vector4::Vector(0, 0, -1);
+}
+
+
+Ray::Ray(Vector4 BGE_NCP O, Vector4 BGE_NCP D)
+{
+    Origin = O;
+    Direction = D;
+}
+
+
+Ray::Ray(Ray BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+Ray::~Ray()
+{
+}
+
+
+Ray BGE_NCP Ray::operator=(Ray BGE_NCP Other)
+{
+    Origin = Other.Origin;
+    Direction = Other.Direction;
+
+    return *this;
+}
+
+
+Vector4 BGE_NCP Ray::GetOrigin() const
+{
+    return Origin;
+}
+
+
+Vector4 BGE_NCP Ray::GetDirection() const
+{
+    return Direction;
+}
+
+
+Vector4 Ray::GetPoint(Scalar T) const
+{
+    return Origin + Direction * T;
+}
+
+
+bool Ray::Intersects(AABB BGE_NCP Box, Scalar* T) const
+{
+    Scalar Near = 0;
+    Scalar Far = FLT_MAX;
+
+    for(int i = 0; i < 3; ++i) {
+        /* Zero components divide to infinity, which the slabs handle */
+        Scalar Inv = 1.0f / Direction[i];
+        Scalar T0 = (Box.GetMin()[i] - Origin[i]) * Inv;
+        Scalar T1 = (Box.GetMax()[i] - Origin[i]) * Inv;
+
+        if(T0 > T1) {
+            Scalar Swap = T0;
+            T0 = T1;
+            T1 = Swap;
+        }
+
+        if(T0 > Near)
+            Near = T0;
+
+        if(T1 < Far)
+            Far = T1;
+
+        if(Near > Far)
+            return false;
+    }
+
+    if(T != NULL)
+        *T = Near;
+
+    return true;
+}
+
+
+bool Ray::Intersects(Sphere BGE_NCP Target, Scalar* T) const
+{
+    Vector4 Center = Target.GetCenter();
+    Vector4 L = Vector4::Vector(Origin[0] - Center[0], Origin[1] - Center[1],
+                                                    Origin[2] - Center[2]);
+    Vector4 D = Vector4::Vector(Direction[0], Direction[1], Direction[2]);
+    Scalar R = Target.GetRadius();
+
+    /* Solve |L + D t|^2 = R^2 for t */
+    Scalar A = D.LengthSquared();
+    Scalar B = Vector4::Dot(L, D);
+    Scalar C = L.LengthSquared() - R * R;
+    Scalar Disc = B * B - A * C;
+
+    if(Disc < 0 || A == 0)
+        return false;
+
+    Scalar Root = sqrtf(Disc);
+    Scalar Far = (-B + Root) / A;
+
+    if(Far < 0)
+        return false;
+
+    if(T != NULL) {
+        Scalar Near = (-B - Root) / A;
+        *T = Near > 0 ? Near : 0;
+    }
+
+    return true;
+}
+
+
+bool Ray::Intersects(Plane BGE_NCP Target, Scalar* T) const
+{
+    Scalar Denom = Target[0] * Direction[0] + Target[1] * Direction[1]
+                                            + Target[2] * Direction[2];
+
+    if(Denom == 0)
+        return false;
+
+    Scalar Hit = -Target.Distance(Origin) / Denom;
+
+    if(Hit < 0)
+        return false;
+
+    if(T != NULL)
+        *T = Hit;
+
+    return true;
+}
+
+} /* bakge */
@@ -0,0 +1,119 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+
+namespace bakge
+{
+
+Sphere::Sphere()
+{
+    Radius = 1;
+}
+
+
+Sphere::Sphere(Vector4 BGE_NCP C, Scalar R)
+{
+    Center = C;
+    Radius = R;
+}
+
+
+Sphere::Sphere(Sphere BGE_NCP Other)
+{
+    *this = Other;
+}
+
+
+Sphere::~Sphere()
+{
+}
+
+
+Sphere BGE_NCP Sphere::operator=(Sphere BGE_NCP Other)
+{
+    Center = Other.Center;
+    Radius = Other.Radius;
+
+    return *this;
+}
+
+
+Vector4 BGE_NCP Sphere::GetCenter() const
+{
+    return Center;
+}
+
+
+Scalar Sphere::GetRadius() const
+{
+    return Radius;
+}
+
+
+bool Sphere::Contains(Vector4 BGE_NCP Point) const
+{
+    Vector4 D = Vector4::Vector(Point[0] - Center[0], Point[1] - Center[1],
+                                                    Point[2] - Center[2]);
+
+    return D.LengthSquared() <= Radius * Radius;
+}
+
+
+bool Sphere::Intersects(Sphere BGE_NCP Other) const
+{
+    Vector4 D = Vector4::Vector(Other.Center[0] - Center[0],
+                Other.Center[1] - Center[1], Other.Center[2] - Center[2]);
+    Scalar R = Radius + Other.Radius;
+
+    return D.LengthSquared() <= R * R;
+}
+
+
+bool Sphere::Intersects(AABB BGE_NCP Box) const
+{
+    /* Squared distance from the center to the closest point in the box */
+    Scalar DistSq = 0;
+
+    for(int i = 0; i < 3; ++i) {
+        Scalar D = 0;
+
+        if(Center[i] < Box.GetMin()[i])
+            D = Box.GetMin()[i] - Center[i];
+        else if(Center[i] > Box.GetMax()[i])
+            D = Center[i] - Box.GetMax()[i];
+
+        DistSq += D * D;
+    }
+
+    return DistSq <= Radius * Radius;
+}
+
+
+Sphere Sphere::FromAABB(AABB BGE_NCP Box)
+{
+    return Sphere(Box.GetCenter(), Box.GetExtents().Length());
+}
+
+} /* bakge */
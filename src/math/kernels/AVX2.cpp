@@ -0,0 +1,577 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/MathKernels.h>
+#include <float.h>
+
+#ifdef BGE_HAVE_AVX2_KERNELS
+/* This file alone is compiled with AVX2 and FMA enabled */
+#include <immintrin.h>
+
+namespace bakge
+{
+
+/* *
+ * Two chunks of Out per iteration; each 128-bit lane works like the SSE2
+ * kernel with fused multiply-adds. Matrices are only 16-byte aligned so
+ * 256-bit accesses must be unaligned
+ * */
+static void MultiplyMatricesAVX2(const Scalar* Left, const Scalar* Right,
+                                                            Scalar* Out)
+{
+    __m256 R0 = _mm256_broadcast_ps((const __m128*)Right);
+    __m256 R1 = _mm256_broadcast_ps((const __m128*)(Right + 4));
+    __m256 R2 = _mm256_broadcast_ps((const __m128*)(Right + 8));
+    __m256 R3 = _mm256_broadcast_ps((const __m128*)(Right + 12));
+
+    for(int i = 0; i < 16; i += 8) {
+        __m256 L = _mm256_loadu_ps(Left + i);
+        __m256 T = _mm256_mul_ps(_mm256_shuffle_ps(L, L, 0x00), R0);
+        T = _mm256_fmadd_ps(_mm256_shuffle_ps(L, L, 0x55), R1, T);
+        T = _mm256_fmadd_ps(_mm256_shuffle_ps(L, L, 0xAA), R2, T);
+        T = _mm256_fmadd_ps(_mm256_shuffle_ps(L, L, 0xFF), R3, T);
+        _mm256_storeu_ps(Out + i, T);
+    }
+}
+
+
+static void TransformVectorAVX2(const Scalar* M, const Scalar* V,
+                                                    Scalar* Out)
+{
+    __m128 X = _mm_load_ps(V);
+    __m128 T = _mm_mul_ps(_mm_load_ps(M), _mm_permute_ps(X, 0x00));
+    T = _mm_fmadd_ps(_mm_load_ps(M + 4), _mm_permute_ps(X, 0x55), T);
+    T = _mm_fmadd_ps(_mm_load_ps(M + 8), _mm_permute_ps(X, 0xAA), T);
+    T = _mm_fmadd_ps(_mm_load_ps(M + 12), _mm_permute_ps(X, 0xFF), T);
+    _mm_store_ps(Out, T);
+}
+
+
+static void NormalizeVectorsAVX2(Scalar* V, int Count)
+{
+    int i = 0;
+
+    /* dp_ps works per 128-bit lane, so two vectors per instruction */
+    for(; i + 2 <= Count; i += 2) {
+        __m256 X = _mm256_loadu_ps(V + i * 4);
+        __m256 Sq = _mm256_dp_ps(X, X, 0xFF);
+        _mm256_storeu_ps(V + i * 4, _mm256_div_ps(X, _mm256_sqrt_ps(Sq)));
+    }
+
+    if(i < Count) {
+        __m128 X = _mm_load_ps(V + i * 4);
+        _mm_store_ps(V + i * 4, _mm_div_ps(X, _mm_sqrt_ps(_mm_dp_ps(X, X,
+                                                                0xFF))));
+    }
+}
+
+
+static void TransformVectorsAVX2(const Scalar* M, const Scalar* In,
+                                            Scalar* Out, int Count)
+{
+    __m256 C0 = _mm256_broadcast_ps((const __m128*)M);
+    __m256 C1 = _mm256_broadcast_ps((const __m128*)(M + 4));
+    __m256 C2 = _mm256_broadcast_ps((const __m128*)(M + 8));
+    __m256 C3 = _mm256_broadcast_ps((const __m128*)(M + 12));
+
+    int i = 0;
+
+    for(; i + 2 <= Count; i += 2) {
+        __m256 X = _mm256_loadu_ps(In + i * 4);
+        __m256 T = _mm256_mul_ps(C0, _mm256_permute_ps(X, 0x00));
+        T = _mm256_fmadd_ps(C1, _mm256_permute_ps(X, 0x55), T);
+        T = _mm256_fmadd_ps(C2, _mm256_permute_ps(X, 0xAA), T);
+        T = _mm256_fmadd_ps(C3, _mm256_permute_ps(X, 0xFF), T);
+        _mm256_storeu_ps(Out + i * 4, T);
+    }
+
+    if(i < Count)
+        TransformVectorAVX2(M, In + i * 4, Out + i * 4);
+}
+
+
+static void MultiplyMatrixArrayAVX2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    __m256 R0 = _mm256_broadcast_ps((const __m128*)Right);
+    __m256 R1 = _mm256_broadcast_ps((const __m128*)(Right + 4));
+    __m256 R2 = _mm256_broadcast_ps((const __m128*)(Right + 8));
+    __m256 R3 = _mm256_broadcast_ps((const __m128*)(Right + 12));
+
+    for(int i = 0; i < Count * 16; i += 8) {
+        __m256 L = _mm256_loadu_ps(Left + i);
+        __m256 T = _mm256_mul_ps(_mm256_shuffle_ps(L, L, 0x00), R0);
+        T = _mm256_fmadd_ps(_mm256_shuffle_ps(L, L, 0x55), R1, T);
+        T = _mm256_fmadd_ps(_mm256_shuffle_ps(L, L, 0xAA), R2, T);
+        T = _mm256_fmadd_ps(_mm256_shuffle_ps(L, L, 0xFF), R3, T);
+        _mm256_storeu_ps(Out + i, T);
+    }
+}
+
+
+static void MultiplyMatrixPairsAVX2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    for(int i = 0; i < Count * 16; i += 16)
+        MultiplyMatricesAVX2(Left + i, Right + i, Out + i);
+}
+
+
+static void TransformSoAAVX2(const Scalar* M, Scalar* X, Scalar* Y,
+                                    Scalar* Z, int Count, Scalar W)
+{
+    __m256 M0 = _mm256_set1_ps(M[0]), M1 = _mm256_set1_ps(M[1]);
+    __m256 M2 = _mm256_set1_ps(M[2]), M4 = _mm256_set1_ps(M[4]);
+    __m256 M5 = _mm256_set1_ps(M[5]), M6 = _mm256_set1_ps(M[6]);
+    __m256 M8 = _mm256_set1_ps(M[8]), M9 = _mm256_set1_ps(M[9]);
+    __m256 M10 = _mm256_set1_ps(M[10]);
+    __m256 TX = _mm256_set1_ps(M[12] * W);
+    __m256 TY = _mm256_set1_ps(M[13] * W);
+    __m256 TZ = _mm256_set1_ps(M[14] * W);
+
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 A = _mm256_loadu_ps(X + i);
+        __m256 B = _mm256_loadu_ps(Y + i);
+        __m256 C = _mm256_loadu_ps(Z + i);
+
+        __m256 RX = _mm256_fmadd_ps(M0, A, TX);
+        __m256 RY = _mm256_fmadd_ps(M1, A, TY);
+        __m256 RZ = _mm256_fmadd_ps(M2, A, TZ);
+        RX = _mm256_fmadd_ps(M4, B, RX);
+        RY = _mm256_fmadd_ps(M5, B, RY);
+        RZ = _mm256_fmadd_ps(M6, B, RZ);
+        RX = _mm256_fmadd_ps(M8, C, RX);
+        RY = _mm256_fmadd_ps(M9, C, RY);
+        RZ = _mm256_fmadd_ps(M10, C, RZ);
+
+        _mm256_storeu_ps(X + i, RX);
+        _mm256_storeu_ps(Y + i, RY);
+        _mm256_storeu_ps(Z + i, RZ);
+    }
+
+    for(; i < Count; ++i) {
+        Scalar A = X[i], B = Y[i], C = Z[i];
+
+        X[i] = M[0] * A + M[4] * B + M[8] * C + M[12] * W;
+        Y[i] = M[1] * A + M[5] * B + M[9] * C + M[13] * W;
+        Z[i] = M[2] * A + M[6] * B + M[10] * C + M[14] * W;
+    }
+}
+
+
+static void MultiplyMatricesSoAAVX2(const Scalar* Left,
+            const Scalar* Right, Scalar* Out, int Count)
+{
+    __m256 R[16];
+
+    for(int e = 0; e < 16; ++e)
+        R[e] = _mm256_set1_ps(Right[e]);
+
+    int n = 0;
+
+    for(; n + 8 <= Count; n += 8) {
+        for(int i = 0; i < 16; i += 4) {
+            __m256 L0 = _mm256_loadu_ps(Left + (i + 0) * Count + n);
+            __m256 L1 = _mm256_loadu_ps(Left + (i + 1) * Count + n);
+            __m256 L2 = _mm256_loadu_ps(Left + (i + 2) * Count + n);
+            __m256 L3 = _mm256_loadu_ps(Left + (i + 3) * Count + n);
+
+            for(int k = 0; k < 4; ++k) {
+                __m256 T = _mm256_mul_ps(L0, R[k]);
+                T = _mm256_fmadd_ps(L1, R[4 + k], T);
+                T = _mm256_fmadd_ps(L2, R[8 + k], T);
+                T = _mm256_fmadd_ps(L3, R[12 + k], T);
+                _mm256_storeu_ps(Out + (i + k) * Count + n, T);
+            }
+        }
+    }
+
+    MultiplyMatricesSoARange(Left, Right, Out, Count, n);
+}
+
+
+static void MultiplyMatrixPairsSoAAVX2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    int n = 0;
+
+    for(; n + 8 <= Count; n += 8) {
+        __m256 R[16];
+
+        for(int e = 0; e < 16; ++e)
+            R[e] = _mm256_loadu_ps(Right + e * Count + n);
+
+        for(int i = 0; i < 16; i += 4) {
+            __m256 L0 = _mm256_loadu_ps(Left + (i + 0) * Count + n);
+            __m256 L1 = _mm256_loadu_ps(Left + (i + 1) * Count + n);
+            __m256 L2 = _mm256_loadu_ps(Left + (i + 2) * Count + n);
+            __m256 L3 = _mm256_loadu_ps(Left + (i + 3) * Count + n);
+
+            for(int k = 0; k < 4; ++k) {
+                __m256 T = _mm256_mul_ps(L0, R[k]);
+                T = _mm256_fmadd_ps(L1, R[4 + k], T);
+                T = _mm256_fmadd_ps(L2, R[8 + k], T);
+                T = _mm256_fmadd_ps(L3, R[12 + k], T);
+                _mm256_storeu_ps(Out + (i + k) * Count + n, T);
+            }
+        }
+    }
+
+    MultiplyMatrixPairsSoARange(Left, Right, Out, Count, n);
+}
+
+
+static void MultiplyQuaternionsSoAAVX2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 AX = _mm256_loadu_ps(Left + i);
+        __m256 AY = _mm256_loadu_ps(Left + Count + i);
+        __m256 AZ = _mm256_loadu_ps(Left + Count * 2 + i);
+        __m256 AW = _mm256_loadu_ps(Left + Count * 3 + i);
+        __m256 BX = _mm256_loadu_ps(Right + i);
+        __m256 BY = _mm256_loadu_ps(Right + Count + i);
+        __m256 BZ = _mm256_loadu_ps(Right + Count * 2 + i);
+        __m256 BW = _mm256_loadu_ps(Right + Count * 3 + i);
+
+        __m256 X = _mm256_fmadd_ps(AW, BX, _mm256_mul_ps(AX, BW));
+        X = _mm256_fmadd_ps(AY, BZ, X);
+        X = _mm256_fnmadd_ps(AZ, BY, X);
+        __m256 Y = _mm256_fmadd_ps(AW, BY, _mm256_mul_ps(AY, BW));
+        Y = _mm256_fmadd_ps(AZ, BX, Y);
+        Y = _mm256_fnmadd_ps(AX, BZ, Y);
+        __m256 Z = _mm256_fmadd_ps(AW, BZ, _mm256_mul_ps(AZ, BW));
+        Z = _mm256_fmadd_ps(AX, BY, Z);
+        Z = _mm256_fnmadd_ps(AY, BX, Z);
+        __m256 W = _mm256_fnmadd_ps(AX, BX, _mm256_mul_ps(AW, BW));
+        W = _mm256_fnmadd_ps(AY, BY, W);
+        W = _mm256_fnmadd_ps(AZ, BZ, W);
+
+        _mm256_storeu_ps(Out + i, X);
+        _mm256_storeu_ps(Out + Count + i, Y);
+        _mm256_storeu_ps(Out + Count * 2 + i, Z);
+        _mm256_storeu_ps(Out + Count * 3 + i, W);
+    }
+
+    MultiplyQuaternionsSoARange(Left, Right, Out, Count, i);
+}
+
+
+static void NormalizeQuaternionsSoAAVX2(Scalar* Q, int Count)
+{
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 X = _mm256_loadu_ps(Q + i);
+        __m256 Y = _mm256_loadu_ps(Q + Count + i);
+        __m256 Z = _mm256_loadu_ps(Q + Count * 2 + i);
+        __m256 W = _mm256_loadu_ps(Q + Count * 3 + i);
+
+        __m256 Len = _mm256_mul_ps(X, X);
+        Len = _mm256_fmadd_ps(Y, Y, Len);
+        Len = _mm256_fmadd_ps(Z, Z, Len);
+        Len = _mm256_sqrt_ps(_mm256_fmadd_ps(W, W, Len));
+
+        _mm256_storeu_ps(Q + i, _mm256_div_ps(X, Len));
+        _mm256_storeu_ps(Q + Count + i, _mm256_div_ps(Y, Len));
+        _mm256_storeu_ps(Q + Count * 2 + i, _mm256_div_ps(Z, Len));
+        _mm256_storeu_ps(Q + Count * 3 + i, _mm256_div_ps(W, Len));
+    }
+
+    NormalizeQuaternionsSoARange(Q, Count, i);
+}
+
+
+static void NlerpQuaternionsSoAAVX2(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count)
+{
+    const __m256 SignMask = _mm256_set1_ps(-0.0f);
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 A[4], B[4];
+        __m256 Dot = _mm256_setzero_ps();
+
+        for(int c = 0; c < 4; ++c) {
+            A[c] = _mm256_loadu_ps(From + Count * c + i);
+            B[c] = _mm256_loadu_ps(To + Count * c + i);
+            Dot = _mm256_fmadd_ps(A[c], B[c], Dot);
+        }
+
+        __m256 Sign = _mm256_and_ps(Dot, SignMask);
+        __m256 Factor = _mm256_loadu_ps(T + i);
+        __m256 LenSq = _mm256_setzero_ps();
+
+        for(int c = 0; c < 4; ++c) {
+            B[c] = _mm256_xor_ps(B[c], Sign);
+            A[c] = _mm256_fmadd_ps(Factor, _mm256_sub_ps(B[c], A[c]), A[c]);
+            LenSq = _mm256_fmadd_ps(A[c], A[c], LenSq);
+        }
+
+        __m256 Len = _mm256_sqrt_ps(LenSq);
+
+        for(int c = 0; c < 4; ++c)
+            _mm256_storeu_ps(Out + Count * c + i, _mm256_div_ps(A[c], Len));
+    }
+
+    NlerpQuaternionsSoARange(From, To, T, Out, Count, i);
+}
+
+
+/* Evaluates the SlerpU/SlerpV polynomial for each lane */
+static __m256 SlerpWeightAVX2(__m256 T, __m256 CosMinus1)
+{
+    const __m256 One = _mm256_set1_ps(1.0f);
+    __m256 SqrT = _mm256_mul_ps(T, T);
+    __m256 Acc = One;
+
+    for(int k = 7; k >= 0; --k) {
+        __m256 B = _mm256_fmsub_ps(_mm256_set1_ps(SlerpU[k]), SqrT,
+                                            _mm256_set1_ps(SlerpV[k]));
+        Acc = _mm256_fmadd_ps(_mm256_mul_ps(B, CosMinus1), Acc, One);
+    }
+
+    return _mm256_mul_ps(T, Acc);
+}
+
+
+static void SlerpQuaternionsSoAAVX2(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count)
+{
+    const __m256 SignMask = _mm256_set1_ps(-0.0f);
+    const __m256 One = _mm256_set1_ps(1.0f);
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 A[4], B[4];
+        __m256 Dot = _mm256_setzero_ps();
+
+        for(int c = 0; c < 4; ++c) {
+            A[c] = _mm256_loadu_ps(From + Count * c + i);
+            B[c] = _mm256_loadu_ps(To + Count * c + i);
+            Dot = _mm256_fmadd_ps(A[c], B[c], Dot);
+        }
+
+        __m256 Sign = _mm256_and_ps(Dot, SignMask);
+        __m256 CosMinus1 = _mm256_sub_ps(_mm256_andnot_ps(SignMask, Dot),
+                                                                    One);
+        __m256 Factor = _mm256_loadu_ps(T + i);
+
+        __m256 WA = SlerpWeightAVX2(_mm256_sub_ps(One, Factor), CosMinus1);
+        __m256 WB = _mm256_xor_ps(SlerpWeightAVX2(Factor, CosMinus1), Sign);
+
+        for(int c = 0; c < 4; ++c) {
+            _mm256_storeu_ps(Out + Count * c + i, _mm256_fmadd_ps(WB, B[c],
+                                            _mm256_mul_ps(WA, A[c])));
+        }
+    }
+
+    SlerpQuaternionsSoARange(From, To, T, Out, Count, i);
+}
+
+
+static void QuaternionsToRotationsSoAAVX2(const Scalar* Q, Scalar* Out,
+                                                            int Count)
+{
+    const __m256 One = _mm256_set1_ps(1.0f);
+    const __m256 Two = _mm256_set1_ps(2.0f);
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 X = _mm256_loadu_ps(Q + i);
+        __m256 Y = _mm256_loadu_ps(Q + Count + i);
+        __m256 Z = _mm256_loadu_ps(Q + Count * 2 + i);
+        __m256 W = _mm256_loadu_ps(Q + Count * 3 + i);
+
+        /* Doubled components save a multiply per element */
+        __m256 X2 = _mm256_mul_ps(X, Two), Y2 = _mm256_mul_ps(Y, Two);
+        __m256 Z2 = _mm256_mul_ps(Z, Two);
+
+        __m256 XX = _mm256_mul_ps(X, X2), YY = _mm256_mul_ps(Y, Y2);
+        __m256 ZZ = _mm256_mul_ps(Z, Z2), XY = _mm256_mul_ps(X, Y2);
+        __m256 XZ = _mm256_mul_ps(X, Z2), YZ = _mm256_mul_ps(Y, Z2);
+        __m256 XW = _mm256_mul_ps(W, X2), YW = _mm256_mul_ps(W, Y2);
+        __m256 ZW = _mm256_mul_ps(W, Z2);
+
+        __m256 R[9];
+        R[0] = _mm256_sub_ps(One, _mm256_add_ps(YY, ZZ));
+        R[1] = _mm256_add_ps(XY, ZW);
+        R[2] = _mm256_sub_ps(XZ, YW);
+        R[3] = _mm256_sub_ps(XY, ZW);
+        R[4] = _mm256_sub_ps(One, _mm256_add_ps(XX, ZZ));
+        R[5] = _mm256_add_ps(YZ, XW);
+        R[6] = _mm256_add_ps(XZ, YW);
+        R[7] = _mm256_sub_ps(YZ, XW);
+        R[8] = _mm256_sub_ps(One, _mm256_add_ps(XX, YY));
+
+        for(int e = 0; e < 9; ++e)
+            _mm256_storeu_ps(Out + Count * e + i, R[e]);
+    }
+
+    QuaternionsToRotationsSoARange(Q, Out, Count, i);
+}
+
+
+static void CullSpheresSoAAVX2(const Scalar* Planes,
+            const Scalar* Spheres, int Count, uint32* Visible)
+{
+    const __m256 SignMask = _mm256_set1_ps(-0.0f);
+    __m256 Plane[24];
+
+    for(int p = 0; p < 24; ++p)
+        Plane[p] = _mm256_set1_ps(Planes[p]);
+
+    ClearBitmask(Visible, Count);
+
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 X = _mm256_loadu_ps(Spheres + i);
+        __m256 Y = _mm256_loadu_ps(Spheres + Count + i);
+        __m256 Z = _mm256_loadu_ps(Spheres + Count * 2 + i);
+        __m256 NegR = _mm256_xor_ps(_mm256_loadu_ps(Spheres + Count * 3 + i),
+                                                            SignMask);
+        __m256 Culled = _mm256_setzero_ps();
+
+        for(int p = 0; p < 24; p += 4) {
+            __m256 D = _mm256_fmadd_ps(Plane[p], X, Plane[p + 3]);
+            D = _mm256_fmadd_ps(Plane[p + 1], Y, D);
+            D = _mm256_fmadd_ps(Plane[p + 2], Z, D);
+            Culled = _mm256_or_ps(Culled, _mm256_cmp_ps(D, NegR, _CMP_LT_OQ));
+        }
+
+        uint32 Bits = ~_mm256_movemask_ps(Culled) & 0xFF;
+        Visible[i >> 5] |= Bits << (i & 31);
+    }
+
+    CullSpheresSoARange(Planes, Spheres, Count, i, Visible);
+}
+
+
+static void CullBoxesSoAAVX2(const Scalar* Planes, const Scalar* Boxes,
+                                                int Count, uint32* Visible)
+{
+    const __m256 Zero = _mm256_setzero_ps();
+    __m256 Plane[24], Abs[24];
+
+    for(int p = 0; p < 24; ++p) {
+        Plane[p] = _mm256_set1_ps(Planes[p]);
+        Abs[p] = _mm256_set1_ps(fabsf(Planes[p]));
+    }
+
+    ClearBitmask(Visible, Count);
+
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 X = _mm256_loadu_ps(Boxes + i);
+        __m256 Y = _mm256_loadu_ps(Boxes + Count + i);
+        __m256 Z = _mm256_loadu_ps(Boxes + Count * 2 + i);
+        __m256 EX = _mm256_loadu_ps(Boxes + Count * 3 + i);
+        __m256 EY = _mm256_loadu_ps(Boxes + Count * 4 + i);
+        __m256 EZ = _mm256_loadu_ps(Boxes + Count * 5 + i);
+        __m256 Culled = _mm256_setzero_ps();
+
+        for(int p = 0; p < 24; p += 4) {
+            __m256 D = _mm256_fmadd_ps(Plane[p], X, Plane[p + 3]);
+            D = _mm256_fmadd_ps(Plane[p + 1], Y, D);
+            D = _mm256_fmadd_ps(Plane[p + 2], Z, D);
+            __m256 R = _mm256_mul_ps(Abs[p], EX);
+            R = _mm256_fmadd_ps(Abs[p + 1], EY, R);
+            R = _mm256_fmadd_ps(Abs[p + 2], EZ, R);
+            __m256 Out = _mm256_cmp_ps(_mm256_add_ps(D, R), Zero, _CMP_LT_OQ);
+            Culled = _mm256_or_ps(Culled, Out);
+        }
+
+        uint32 Bits = ~_mm256_movemask_ps(Culled) & 0xFF;
+        Visible[i >> 5] |= Bits << (i & 31);
+    }
+
+    CullBoxesSoARange(Planes, Boxes, Count, i, Visible);
+}
+
+
+static void IntersectRaysBoxesSoAAVX2(const Scalar* Rays,
+                const Scalar* Boxes, int Count, uint32* Hits)
+{
+    const __m256 One = _mm256_set1_ps(1.0f);
+
+    ClearBitmask(Hits, Count);
+
+    int i = 0;
+
+    for(; i + 8 <= Count; i += 8) {
+        __m256 Near = _mm256_setzero_ps();
+        __m256 Far = _mm256_set1_ps(FLT_MAX);
+
+        for(int a = 0; a < 3; ++a) {
+            __m256 Dir = _mm256_loadu_ps(Rays + Count * (3 + a) + i);
+            __m256 Origin = _mm256_loadu_ps(Rays + Count * a + i);
+            __m256 Inv = _mm256_div_ps(One, Dir);
+            __m256 Center = _mm256_loadu_ps(Boxes + Count * a + i);
+            Center = _mm256_sub_ps(Center, Origin);
+            __m256 Extent = _mm256_loadu_ps(Boxes + Count * (3 + a) + i);
+            __m256 T0 = _mm256_mul_ps(_mm256_sub_ps(Center, Extent), Inv);
+            __m256 T1 = _mm256_mul_ps(_mm256_add_ps(Center, Extent), Inv);
+
+            Near = _mm256_max_ps(Near, _mm256_min_ps(T0, T1));
+            Far = _mm256_min_ps(Far, _mm256_max_ps(T0, T1));
+        }
+
+        uint32 Bits = _mm256_movemask_ps(_mm256_cmp_ps(Near, Far, _CMP_LE_OQ));
+        Hits[i >> 5] |= Bits << (i & 31);
+    }
+
+    IntersectRaysBoxesSoARange(Rays, Boxes, Count, i, Hits);
+}
+
+
+void FillAVX2MathKernels(MathKernels* Kernels)
+{
+    Kernels->MultiplyMatrices = MultiplyMatricesAVX2;
+    Kernels->TransformVector = TransformVectorAVX2;
+    Kernels->NormalizeVectors = NormalizeVectorsAVX2;
+    Kernels->TransformVectors = TransformVectorsAVX2;
+    Kernels->MultiplyMatrixArray = MultiplyMatrixArrayAVX2;
+    Kernels->MultiplyMatrixPairs = MultiplyMatrixPairsAVX2;
+    Kernels->TransformSoA = TransformSoAAVX2;
+    Kernels->MultiplyMatricesSoA = MultiplyMatricesSoAAVX2;
+    Kernels->MultiplyMatrixPairsSoA = MultiplyMatrixPairsSoAAVX2;
+    Kernels->MultiplyQuaternionsSoA = MultiplyQuaternionsSoAAVX2;
+    Kernels->NormalizeQuaternionsSoA = NormalizeQuaternionsSoAAVX2;
+    Kernels->NlerpQuaternionsSoA = NlerpQuaternionsSoAAVX2;
+    Kernels->SlerpQuaternionsSoA = SlerpQuaternionsSoAAVX2;
+    Kernels->QuaternionsToRotationsSoA = QuaternionsToRotationsSoAAVX2;
+    Kernels->CullSpheresSoA = CullSpheresSoAAVX2;
+    Kernels->CullBoxesSoA = CullBoxesSoAAVX2;
+    Kernels->IntersectRaysBoxesSoA = IntersectRaysBoxesSoAAVX2;
+}
+
+} /* bakge */
+#endif /* BGE_HAVE_AVX2_KERNELS */
@@ -0,0 +1,716 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/MathKernels.h>
+#include <float.h>
+
+#ifdef BGE_USE_SIMD
+/* SSE and SSE2 instructions headers */
+#include <xmmintrin.h>
+#include <emmintrin.h>
+
+namespace bakge
+{
+
+/* *
+ * Each 4-wide chunk of Out is a linear combination of the chunks of Right,
+ * weighted by the matching chunk of Left. Right is loaded up front so Out
+ * may alias either operand
+ * */
+static void MultiplyMatricesSSE2(const Scalar* Left, const Scalar* Right,
+                                                            Scalar* Out)
+{
+    __m128 R0 = _mm_load_ps(Right);
+    __m128 R1 = _mm_load_ps(Right + 4);
+    __m128 R2 = _mm_load_ps(Right + 8);
+    __m128 R3 = _mm_load_ps(Right + 12);
+
+    for(int i = 0; i < 16; i += 4) {
+        __m128 L = _mm_load_ps(Left + i);
+        __m128 T = _mm_mul_ps(_mm_shuffle_ps(L, L, 0x00), R0);
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(L, L, 0x55), R1));
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(L, L, 0xAA), R2));
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(L, L, 0xFF), R3));
+        _mm_store_ps(Out + i, T);
+    }
+}
+
+
+static void TransformVectorSSE2(const Scalar* M, const Scalar* V,
+                                                    Scalar* Out)
+{
+    __m128 X = _mm_load_ps(V);
+    __m128 T = _mm_mul_ps(_mm_load_ps(M), _mm_shuffle_ps(X, X, 0x00));
+    T = _mm_add_ps(T, _mm_mul_ps(_mm_load_ps(M + 4),
+                                _mm_shuffle_ps(X, X, 0x55)));
+    T = _mm_add_ps(T, _mm_mul_ps(_mm_load_ps(M + 8),
+                                _mm_shuffle_ps(X, X, 0xAA)));
+    T = _mm_add_ps(T, _mm_mul_ps(_mm_load_ps(M + 12),
+                                _mm_shuffle_ps(X, X, 0xFF)));
+    _mm_store_ps(Out, T);
+}
+
+
+static void NormalizeVectorSSE2(Scalar* V)
+{
+    __m128 X = _mm_load_ps(V);
+    __m128 Sq = _mm_mul_ps(X, X);
+
+    /* Horizontal sum leaves the squared length in every lane */
+    Sq = _mm_add_ps(Sq, _mm_shuffle_ps(Sq, Sq, 0x4E));
+    Sq = _mm_add_ps(Sq, _mm_shuffle_ps(Sq, Sq, 0xB1));
+
+    _mm_store_ps(V, _mm_div_ps(X, _mm_sqrt_ps(Sq)));
+}
+
+
+static void NormalizeVectorsSSE2(Scalar* V, int Count)
+{
+    int i = 0;
+
+    /* Two at a time to hide the latency of the square root and divide */
+    for(; i + 2 <= Count; i += 2) {
+        __m128 A = _mm_load_ps(V + i * 4);
+        __m128 B = _mm_load_ps(V + i * 4 + 4);
+        __m128 SA = _mm_mul_ps(A, A);
+        __m128 SB = _mm_mul_ps(B, B);
+
+        SA = _mm_add_ps(SA, _mm_shuffle_ps(SA, SA, 0x4E));
+        SB = _mm_add_ps(SB, _mm_shuffle_ps(SB, SB, 0x4E));
+        SA = _mm_add_ps(SA, _mm_shuffle_ps(SA, SA, 0xB1));
+        SB = _mm_add_ps(SB, _mm_shuffle_ps(SB, SB, 0xB1));
+
+        _mm_store_ps(V + i * 4, _mm_div_ps(A, _mm_sqrt_ps(SA)));
+        _mm_store_ps(V + i * 4 + 4, _mm_div_ps(B, _mm_sqrt_ps(SB)));
+    }
+
+    if(i < Count)
+        NormalizeVectorSSE2(V + i * 4);
+}
+
+
+/* One Newton-Raphson step on the rsqrtps estimate of 1 / sqrt(Sq) */
+static __m128 InvSqrtSSE2(__m128 Sq)
+{
+    __m128 Y = _mm_rsqrt_ps(Sq);
+    __m128 YY = _mm_mul_ps(_mm_mul_ps(Y, Y), _mm_mul_ps(Sq,
+                                        _mm_set1_ps(0.5f)));
+
+    return _mm_mul_ps(Y, _mm_sub_ps(_mm_set1_ps(1.5f), YY));
+}
+
+
+static void NormalizeVectorFastSSE2(Scalar* V)
+{
+    __m128 X = _mm_load_ps(V);
+    __m128 Sq = _mm_mul_ps(X, X);
+
+    Sq = _mm_add_ps(Sq, _mm_shuffle_ps(Sq, Sq, 0x4E));
+    Sq = _mm_add_ps(Sq, _mm_shuffle_ps(Sq, Sq, 0xB1));
+
+    _mm_store_ps(V, _mm_mul_ps(X, InvSqrtSSE2(Sq)));
+}
+
+
+static void NormalizeVectorsFastSSE2(Scalar* V, int Count)
+{
+    int i = 0;
+
+    /* Four at a time so one rsqrtps serves four vectors */
+    for(; i + 4 <= Count; i += 4) {
+        __m128 A = _mm_load_ps(V + i * 4);
+        __m128 B = _mm_load_ps(V + i * 4 + 4);
+        __m128 C = _mm_load_ps(V + i * 4 + 8);
+        __m128 D = _mm_load_ps(V + i * 4 + 12);
+        __m128 SA = _mm_mul_ps(A, A), SB = _mm_mul_ps(B, B);
+        __m128 SC = _mm_mul_ps(C, C), SD = _mm_mul_ps(D, D);
+
+        /* Transposing the squares leaves each length in its own lane */
+        _MM_TRANSPOSE4_PS(SA, SB, SC, SD);
+        __m128 Inv = InvSqrtSSE2(_mm_add_ps(_mm_add_ps(SA, SB),
+                                            _mm_add_ps(SC, SD)));
+
+        _mm_store_ps(V + i * 4, _mm_mul_ps(A,
+                        _mm_shuffle_ps(Inv, Inv, 0x00)));
+        _mm_store_ps(V + i * 4 + 4, _mm_mul_ps(B,
+                        _mm_shuffle_ps(Inv, Inv, 0x55)));
+        _mm_store_ps(V + i * 4 + 8, _mm_mul_ps(C,
+                        _mm_shuffle_ps(Inv, Inv, 0xAA)));
+        _mm_store_ps(V + i * 4 + 12, _mm_mul_ps(D,
+                        _mm_shuffle_ps(Inv, Inv, 0xFF)));
+    }
+
+    for(; i < Count; ++i)
+        NormalizeVectorFastSSE2(V + i * 4);
+}
+
+
+static void TransformVectorsSSE2(const Scalar* M, const Scalar* In,
+                                            Scalar* Out, int Count)
+{
+    __m128 C0 = _mm_load_ps(M);
+    __m128 C1 = _mm_load_ps(M + 4);
+    __m128 C2 = _mm_load_ps(M + 8);
+    __m128 C3 = _mm_load_ps(M + 12);
+
+    for(int i = 0; i < Count * 4; i += 4) {
+        __m128 X = _mm_load_ps(In + i);
+        __m128 T = _mm_mul_ps(C0, _mm_shuffle_ps(X, X, 0x00));
+        T = _mm_add_ps(T, _mm_mul_ps(C1, _mm_shuffle_ps(X, X, 0x55)));
+        T = _mm_add_ps(T, _mm_mul_ps(C2, _mm_shuffle_ps(X, X, 0xAA)));
+        T = _mm_add_ps(T, _mm_mul_ps(C3, _mm_shuffle_ps(X, X, 0xFF)));
+        _mm_store_ps(Out + i, T);
+    }
+}
+
+
+static void TransformPackedSSE2(const Scalar* M, const Scalar* In,
+                                Scalar* Out, int Count, Scalar W)
+{
+    __m128 C0 = _mm_load_ps(M);
+    __m128 C1 = _mm_load_ps(M + 4);
+    __m128 C2 = _mm_load_ps(M + 8);
+    __m128 C3 = _mm_mul_ps(_mm_load_ps(M + 12), _mm_set1_ps(W));
+
+    /* Triplets are unaligned and can't be read 4 wide past the last one */
+    for(int i = 0; i < Count * 3; i += 3) {
+        __m128 T = _mm_add_ps(C3, _mm_mul_ps(C0, _mm_load1_ps(In + i)));
+        T = _mm_add_ps(T, _mm_mul_ps(C1, _mm_load1_ps(In + i + 1)));
+        T = _mm_add_ps(T, _mm_mul_ps(C2, _mm_load1_ps(In + i + 2)));
+
+        _mm_storel_pi((__m64*)(Out + i), T);
+        _mm_store_ss(Out + i + 2, _mm_movehl_ps(T, T));
+    }
+}
+
+
+static void MultiplyMatrixArraySSE2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    __m128 R0 = _mm_load_ps(Right);
+    __m128 R1 = _mm_load_ps(Right + 4);
+    __m128 R2 = _mm_load_ps(Right + 8);
+    __m128 R3 = _mm_load_ps(Right + 12);
+
+    for(int i = 0; i < Count * 16; i += 4) {
+        __m128 L = _mm_load_ps(Left + i);
+        __m128 T = _mm_mul_ps(_mm_shuffle_ps(L, L, 0x00), R0);
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(L, L, 0x55), R1));
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(L, L, 0xAA), R2));
+        T = _mm_add_ps(T, _mm_mul_ps(_mm_shuffle_ps(L, L, 0xFF), R3));
+        _mm_store_ps(Out + i, T);
+    }
+}
+
+
+static void MultiplyMatrixPairsSSE2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    for(int i = 0; i < Count * 16; i += 16)
+        MultiplyMatricesSSE2(Left + i, Right + i, Out + i);
+}
+
+
+static void TransformSoASSE2(const Scalar* M, Scalar* X, Scalar* Y,
+                                    Scalar* Z, int Count, Scalar W)
+{
+    __m128 M0 = _mm_set1_ps(M[0]), M1 = _mm_set1_ps(M[1]);
+    __m128 M2 = _mm_set1_ps(M[2]), M4 = _mm_set1_ps(M[4]);
+    __m128 M5 = _mm_set1_ps(M[5]), M6 = _mm_set1_ps(M[6]);
+    __m128 M8 = _mm_set1_ps(M[8]), M9 = _mm_set1_ps(M[9]);
+    __m128 M10 = _mm_set1_ps(M[10]);
+    __m128 TX = _mm_set1_ps(M[12] * W);
+    __m128 TY = _mm_set1_ps(M[13] * W);
+    __m128 TZ = _mm_set1_ps(M[14] * W);
+
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 A = _mm_loadu_ps(X + i);
+        __m128 B = _mm_loadu_ps(Y + i);
+        __m128 C = _mm_loadu_ps(Z + i);
+
+        __m128 RX = _mm_add_ps(TX, _mm_mul_ps(M0, A));
+        __m128 RY = _mm_add_ps(TY, _mm_mul_ps(M1, A));
+        __m128 RZ = _mm_add_ps(TZ, _mm_mul_ps(M2, A));
+        RX = _mm_add_ps(RX, _mm_mul_ps(M4, B));
+        RY = _mm_add_ps(RY, _mm_mul_ps(M5, B));
+        RZ = _mm_add_ps(RZ, _mm_mul_ps(M6, B));
+        RX = _mm_add_ps(RX, _mm_mul_ps(M8, C));
+        RY = _mm_add_ps(RY, _mm_mul_ps(M9, C));
+        RZ = _mm_add_ps(RZ, _mm_mul_ps(M10, C));
+
+        _mm_storeu_ps(X + i, RX);
+        _mm_storeu_ps(Y + i, RY);
+        _mm_storeu_ps(Z + i, RZ);
+    }
+
+    for(; i < Count; ++i) {
+        Scalar A = X[i], B = Y[i], C = Z[i];
+
+        X[i] = M[0] * A + M[4] * B + M[8] * C + M[12] * W;
+        Y[i] = M[1] * A + M[5] * B + M[9] * C + M[13] * W;
+        Z[i] = M[2] * A + M[6] * B + M[10] * C + M[14] * W;
+    }
+}
+
+
+static void MultiplyMatricesSoASSE2(const Scalar* Left,
+            const Scalar* Right, Scalar* Out, int Count)
+{
+    __m128 R[16];
+
+    for(int e = 0; e < 16; ++e)
+        R[e] = _mm_set1_ps(Right[e]);
+
+    int n = 0;
+
+    for(; n + 4 <= Count; n += 4) {
+        /* Each row of Out only needs the same row of Left */
+        for(int i = 0; i < 16; i += 4) {
+            __m128 L0 = _mm_loadu_ps(Left + (i + 0) * Count + n);
+            __m128 L1 = _mm_loadu_ps(Left + (i + 1) * Count + n);
+            __m128 L2 = _mm_loadu_ps(Left + (i + 2) * Count + n);
+            __m128 L3 = _mm_loadu_ps(Left + (i + 3) * Count + n);
+
+            for(int k = 0; k < 4; ++k) {
+                __m128 T = _mm_mul_ps(L0, R[k]);
+                T = _mm_add_ps(T, _mm_mul_ps(L1, R[4 + k]));
+                T = _mm_add_ps(T, _mm_mul_ps(L2, R[8 + k]));
+                T = _mm_add_ps(T, _mm_mul_ps(L3, R[12 + k]));
+                _mm_storeu_ps(Out + (i + k) * Count + n, T);
+            }
+        }
+    }
+
+    MultiplyMatricesSoARange(Left, Right, Out, Count, n);
+}
+
+
+static void MultiplyMatrixPairsSoASSE2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    int n = 0;
+
+    for(; n + 4 <= Count; n += 4) {
+        __m128 R[16];
+
+        /* Load all of Right first so Out may alias it */
+        for(int e = 0; e < 16; ++e)
+            R[e] = _mm_loadu_ps(Right + e * Count + n);
+
+        for(int i = 0; i < 16; i += 4) {
+            __m128 L0 = _mm_loadu_ps(Left + (i + 0) * Count + n);
+            __m128 L1 = _mm_loadu_ps(Left + (i + 1) * Count + n);
+            __m128 L2 = _mm_loadu_ps(Left + (i + 2) * Count + n);
+            __m128 L3 = _mm_loadu_ps(Left + (i + 3) * Count + n);
+
+            for(int k = 0; k < 4; ++k) {
+                __m128 T = _mm_mul_ps(L0, R[k]);
+                T = _mm_add_ps(T, _mm_mul_ps(L1, R[4 + k]));
+                T = _mm_add_ps(T, _mm_mul_ps(L2, R[8 + k]));
+                T = _mm_add_ps(T, _mm_mul_ps(L3, R[12 + k]));
+                _mm_storeu_ps(Out + (i + k) * Count + n, T);
+            }
+        }
+    }
+
+    MultiplyMatrixPairsSoARange(Left, Right, Out, Count, n);
+}
+
+
+/* *
+ * Quaternion kernels work on 4 SoA quaternions per register: one register
+ * per component, so the math is the same as the scalar code, lane-wise
+ * */
+static void MultiplyQuaternionsSoASSE2(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 AX = _mm_loadu_ps(Left + i);
+        __m128 AY = _mm_loadu_ps(Left + Count + i);
+        __m128 AZ = _mm_loadu_ps(Left + Count * 2 + i);
+        __m128 AW = _mm_loadu_ps(Left + Count * 3 + i);
+        __m128 BX = _mm_loadu_ps(Right + i);
+        __m128 BY = _mm_loadu_ps(Right + Count + i);
+        __m128 BZ = _mm_loadu_ps(Right + Count * 2 + i);
+        __m128 BW = _mm_loadu_ps(Right + Count * 3 + i);
+
+        __m128 X = _mm_add_ps(_mm_mul_ps(AW, BX), _mm_mul_ps(AX, BW));
+        X = _mm_add_ps(X, _mm_sub_ps(_mm_mul_ps(AY, BZ), _mm_mul_ps(AZ, BY)));
+        __m128 Y = _mm_add_ps(_mm_mul_ps(AW, BY), _mm_mul_ps(AY, BW));
+        Y = _mm_add_ps(Y, _mm_sub_ps(_mm_mul_ps(AZ, BX), _mm_mul_ps(AX, BZ)));
+        __m128 Z = _mm_add_ps(_mm_mul_ps(AW, BZ), _mm_mul_ps(AZ, BW));
+        Z = _mm_add_ps(Z, _mm_sub_ps(_mm_mul_ps(AX, BY), _mm_mul_ps(AY, BX)));
+        __m128 W = _mm_sub_ps(_mm_mul_ps(AW, BW), _mm_mul_ps(AX, BX));
+        W = _mm_sub_ps(W, _mm_add_ps(_mm_mul_ps(AY, BY), _mm_mul_ps(AZ, BZ)));
+
+        _mm_storeu_ps(Out + i, X);
+        _mm_storeu_ps(Out + Count + i, Y);
+        _mm_storeu_ps(Out + Count * 2 + i, Z);
+        _mm_storeu_ps(Out + Count * 3 + i, W);
+    }
+
+    MultiplyQuaternionsSoARange(Left, Right, Out, Count, i);
+}
+
+
+static void NormalizeQuaternionsSoASSE2(Scalar* Q, int Count)
+{
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 X = _mm_loadu_ps(Q + i);
+        __m128 Y = _mm_loadu_ps(Q + Count + i);
+        __m128 Z = _mm_loadu_ps(Q + Count * 2 + i);
+        __m128 W = _mm_loadu_ps(Q + Count * 3 + i);
+
+        __m128 Len = _mm_add_ps(_mm_mul_ps(X, X), _mm_mul_ps(Y, Y));
+        Len = _mm_add_ps(Len, _mm_add_ps(_mm_mul_ps(Z, Z), _mm_mul_ps(W, W)));
+        Len = _mm_sqrt_ps(Len);
+
+        _mm_storeu_ps(Q + i, _mm_div_ps(X, Len));
+        _mm_storeu_ps(Q + Count + i, _mm_div_ps(Y, Len));
+        _mm_storeu_ps(Q + Count * 2 + i, _mm_div_ps(Z, Len));
+        _mm_storeu_ps(Q + Count * 3 + i, _mm_div_ps(W, Len));
+    }
+
+    NormalizeQuaternionsSoARange(Q, Count, i);
+}
+
+
+static void NlerpQuaternionsSoASSE2(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count)
+{
+    const __m128 SignMask = _mm_set1_ps(-0.0f);
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 A[4], B[4];
+        __m128 Dot = _mm_setzero_ps();
+
+        for(int c = 0; c < 4; ++c) {
+            A[c] = _mm_loadu_ps(From + Count * c + i);
+            B[c] = _mm_loadu_ps(To + Count * c + i);
+            Dot = _mm_add_ps(Dot, _mm_mul_ps(A[c], B[c]));
+        }
+
+        /* Flip To onto From's hemisphere for the shortest path */
+        __m128 Sign = _mm_and_ps(Dot, SignMask);
+        __m128 Factor = _mm_loadu_ps(T + i);
+        __m128 LenSq = _mm_setzero_ps();
+
+        for(int c = 0; c < 4; ++c) {
+            B[c] = _mm_xor_ps(B[c], Sign);
+            A[c] = _mm_add_ps(A[c], _mm_mul_ps(Factor,
+                                    _mm_sub_ps(B[c], A[c])));
+            LenSq = _mm_add_ps(LenSq, _mm_mul_ps(A[c], A[c]));
+        }
+
+        __m128 Len = _mm_sqrt_ps(LenSq);
+
+        for(int c = 0; c < 4; ++c)
+            _mm_storeu_ps(Out + Count * c + i, _mm_div_ps(A[c], Len));
+    }
+
+    NlerpQuaternionsSoARange(From, To, T, Out, Count, i);
+}
+
+
+/* Evaluates the SlerpU/SlerpV polynomial for each lane */
+static __m128 SlerpWeightSSE2(__m128 T, __m128 CosMinus1)
+{
+    const __m128 One = _mm_set1_ps(1.0f);
+    __m128 SqrT = _mm_mul_ps(T, T);
+    __m128 Acc = One;
+
+    for(int k = 7; k >= 0; --k) {
+        __m128 B = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(_mm_set1_ps(SlerpU[k]),
+                        SqrT), _mm_set1_ps(SlerpV[k])), CosMinus1);
+        Acc = _mm_add_ps(One, _mm_mul_ps(B, Acc));
+    }
+
+    return _mm_mul_ps(T, Acc);
+}
+
+
+static void SlerpQuaternionsSoASSE2(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count)
+{
+    const __m128 SignMask = _mm_set1_ps(-0.0f);
+    const __m128 One = _mm_set1_ps(1.0f);
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 A[4], B[4];
+        __m128 Dot = _mm_setzero_ps();
+
+        for(int c = 0; c < 4; ++c) {
+            A[c] = _mm_loadu_ps(From + Count * c + i);
+            B[c] = _mm_loadu_ps(To + Count * c + i);
+            Dot = _mm_add_ps(Dot, _mm_mul_ps(A[c], B[c]));
+        }
+
+        __m128 Sign = _mm_and_ps(Dot, SignMask);
+        __m128 CosMinus1 = _mm_sub_ps(_mm_andnot_ps(SignMask, Dot), One);
+        __m128 Factor = _mm_loadu_ps(T + i);
+
+        __m128 WA = SlerpWeightSSE2(_mm_sub_ps(One, Factor), CosMinus1);
+        __m128 WB = _mm_xor_ps(SlerpWeightSSE2(Factor, CosMinus1), Sign);
+
+        for(int c = 0; c < 4; ++c) {
+            _mm_storeu_ps(Out + Count * c + i, _mm_add_ps(
+                    _mm_mul_ps(WA, A[c]), _mm_mul_ps(WB, B[c])));
+        }
+    }
+
+    SlerpQuaternionsSoARange(From, To, T, Out, Count, i);
+}
+
+
+/* Column-major 3x3 rotations of 4 quaternions, one element per register */
+static void QuaternionsToRotationsSSE2(const Scalar* Q, int Count, int i,
+                                                            __m128* R)
+{
+    const __m128 One = _mm_set1_ps(1.0f);
+    const __m128 Two = _mm_set1_ps(2.0f);
+
+    __m128 X = _mm_loadu_ps(Q + i);
+    __m128 Y = _mm_loadu_ps(Q + Count + i);
+    __m128 Z = _mm_loadu_ps(Q + Count * 2 + i);
+    __m128 W = _mm_loadu_ps(Q + Count * 3 + i);
+
+    __m128 XX = _mm_mul_ps(X, X), YY = _mm_mul_ps(Y, Y);
+    __m128 ZZ = _mm_mul_ps(Z, Z), XY = _mm_mul_ps(X, Y);
+    __m128 XZ = _mm_mul_ps(X, Z), YZ = _mm_mul_ps(Y, Z);
+    __m128 XW = _mm_mul_ps(X, W), YW = _mm_mul_ps(Y, W);
+    __m128 ZW = _mm_mul_ps(Z, W);
+
+    R[0] = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(YY, ZZ)));
+    R[1] = _mm_mul_ps(Two, _mm_add_ps(XY, ZW));
+    R[2] = _mm_mul_ps(Two, _mm_sub_ps(XZ, YW));
+    R[3] = _mm_mul_ps(Two, _mm_sub_ps(XY, ZW));
+    R[4] = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(XX, ZZ)));
+    R[5] = _mm_mul_ps(Two, _mm_add_ps(YZ, XW));
+    R[6] = _mm_mul_ps(Two, _mm_add_ps(XZ, YW));
+    R[7] = _mm_mul_ps(Two, _mm_sub_ps(YZ, XW));
+    R[8] = _mm_sub_ps(One, _mm_mul_ps(Two, _mm_add_ps(XX, YY)));
+}
+
+
+static void QuaternionsToMatricesSoASSE2(const Scalar* Q, Scalar* Out,
+                                                            int Count)
+{
+    const __m128 Col3 = _mm_setr_ps(0, 0, 0, 1);
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 R[9];
+        QuaternionsToRotationsSSE2(Q, Count, i, R);
+
+        /* Transposing 3 elements and zeros gives a column of each matrix */
+        for(int c = 0; c < 3; ++c) {
+            __m128 C0 = R[c * 3], C1 = R[c * 3 + 1], C2 = R[c * 3 + 2];
+            __m128 C3 = _mm_setzero_ps();
+
+            _MM_TRANSPOSE4_PS(C0, C1, C2, C3);
+
+            _mm_store_ps(Out + (i + 0) * 16 + c * 4, C0);
+            _mm_store_ps(Out + (i + 1) * 16 + c * 4, C1);
+            _mm_store_ps(Out + (i + 2) * 16 + c * 4, C2);
+            _mm_store_ps(Out + (i + 3) * 16 + c * 4, C3);
+        }
+
+        for(int k = 0; k < 4; ++k)
+            _mm_store_ps(Out + (i + k) * 16 + 12, Col3);
+    }
+
+    QuaternionsToMatricesSoARange(Q, Out, Count, i);
+}
+
+
+static void QuaternionsToRotationsSoASSE2(const Scalar* Q, Scalar* Out,
+                                                            int Count)
+{
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 R[9];
+        QuaternionsToRotationsSSE2(Q, Count, i, R);
+
+        for(int e = 0; e < 9; ++e)
+            _mm_storeu_ps(Out + Count * e + i, R[e]);
+    }
+
+    QuaternionsToRotationsSoARange(Q, Out, Count, i);
+}
+
+
+static void CullSpheresSoASSE2(const Scalar* Planes,
+            const Scalar* Spheres, int Count, uint32* Visible)
+{
+    const __m128 SignMask = _mm_set1_ps(-0.0f);
+    __m128 Plane[24];
+
+    for(int p = 0; p < 24; ++p)
+        Plane[p] = _mm_set1_ps(Planes[p]);
+
+    ClearBitmask(Visible, Count);
+
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 X = _mm_loadu_ps(Spheres + i);
+        __m128 Y = _mm_loadu_ps(Spheres + Count + i);
+        __m128 Z = _mm_loadu_ps(Spheres + Count * 2 + i);
+        __m128 NegR = _mm_xor_ps(_mm_loadu_ps(Spheres + Count * 3 + i),
+                                                            SignMask);
+        __m128 Culled = _mm_setzero_ps();
+
+        for(int p = 0; p < 24; p += 4) {
+            __m128 D = _mm_add_ps(_mm_mul_ps(Plane[p], X),
+                                    _mm_mul_ps(Plane[p + 1], Y));
+            D = _mm_add_ps(D, _mm_add_ps(_mm_mul_ps(Plane[p + 2], Z),
+                                                        Plane[p + 3]));
+            Culled = _mm_or_ps(Culled, _mm_cmplt_ps(D, NegR));
+        }
+
+        uint32 Bits = ~_mm_movemask_ps(Culled) & 0xF;
+        Visible[i >> 5] |= Bits << (i & 31);
+    }
+
+    CullSpheresSoARange(Planes, Spheres, Count, i, Visible);
+}
+
+
+static void CullBoxesSoASSE2(const Scalar* Planes, const Scalar* Boxes,
+                                                int Count, uint32* Visible)
+{
+    const __m128 Zero = _mm_setzero_ps();
+    __m128 Plane[24], Abs[24];
+
+    for(int p = 0; p < 24; ++p) {
+        Plane[p] = _mm_set1_ps(Planes[p]);
+        Abs[p] = _mm_set1_ps(fabsf(Planes[p]));
+    }
+
+    ClearBitmask(Visible, Count);
+
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 X = _mm_loadu_ps(Boxes + i);
+        __m128 Y = _mm_loadu_ps(Boxes + Count + i);
+        __m128 Z = _mm_loadu_ps(Boxes + Count * 2 + i);
+        __m128 EX = _mm_loadu_ps(Boxes + Count * 3 + i);
+        __m128 EY = _mm_loadu_ps(Boxes + Count * 4 + i);
+        __m128 EZ = _mm_loadu_ps(Boxes + Count * 5 + i);
+        __m128 Culled = _mm_setzero_ps();
+
+        for(int p = 0; p < 24; p += 4) {
+            __m128 D = _mm_add_ps(_mm_mul_ps(Plane[p], X),
+                                    _mm_mul_ps(Plane[p + 1], Y));
+            D = _mm_add_ps(D, _mm_add_ps(_mm_mul_ps(Plane[p + 2], Z),
+                                                        Plane[p + 3]));
+            __m128 R = _mm_add_ps(_mm_mul_ps(Abs[p], EX),
+                                    _mm_mul_ps(Abs[p + 1], EY));
+            R = _mm_add_ps(R, _mm_mul_ps(Abs[p + 2], EZ));
+            __m128 Out = _mm_cmplt_ps(_mm_add_ps(D, R), Zero);
+            Culled = _mm_or_ps(Culled, Out);
+        }
+
+        uint32 Bits = ~_mm_movemask_ps(Culled) & 0xF;
+        Visible[i >> 5] |= Bits << (i & 31);
+    }
+
+    CullBoxesSoARange(Planes, Boxes, Count, i, Visible);
+}
+
+
+static void IntersectRaysBoxesSoASSE2(const Scalar* Rays,
+                const Scalar* Boxes, int Count, uint32* Hits)
+{
+    const __m128 One = _mm_set1_ps(1.0f);
+
+    ClearBitmask(Hits, Count);
+
+    int i = 0;
+
+    for(; i + 4 <= Count; i += 4) {
+        __m128 Near = _mm_setzero_ps();
+        __m128 Far = _mm_set1_ps(FLT_MAX);
+
+        for(int a = 0; a < 3; ++a) {
+            __m128 Dir = _mm_loadu_ps(Rays + Count * (3 + a) + i);
+            __m128 Origin = _mm_loadu_ps(Rays + Count * a + i);
+            __m128 Inv = _mm_div_ps(One, Dir);
+            __m128 Center = _mm_loadu_ps(Boxes + Count * a + i);
+            Center = _mm_sub_ps(Center, Origin);
+            __m128 Extent = _mm_loadu_ps(Boxes + Count * (3 + a) + i);
+            __m128 T0 = _mm_mul_ps(_mm_sub_ps(Center, Extent), Inv);
+            __m128 T1 = _mm_mul_ps(_mm_add_ps(Center, Extent), Inv);
+
+            Near = _mm_max_ps(Near, _mm_min_ps(T0, T1));
+            Far = _mm_min_ps(Far, _mm_max_ps(T0, T1));
+        }
+
+        uint32 Bits = _mm_movemask_ps(_mm_cmple_ps(Near, Far));
+        Hits[i >> 5] |= Bits << (i & 31);
+    }
+
+    IntersectRaysBoxesSoARange(Rays, Boxes, Count, i, Hits);
+}
+
+
+void FillSSE2MathKernels(MathKernels* Kernels)
+{
+    Kernels->MultiplyMatrices = MultiplyMatricesSSE2;
+    Kernels->TransformVector = TransformVectorSSE2;
+    Kernels->NormalizeVector = NormalizeVectorSSE2;
+    Kernels->NormalizeVectorFast = NormalizeVectorFastSSE2;
+    Kernels->NormalizeVectorsFast = NormalizeVectorsFastSSE2;
+    Kernels->NormalizeVectors = NormalizeVectorsSSE2;
+    Kernels->TransformVectors = TransformVectorsSSE2;
+    Kernels->TransformPacked = TransformPackedSSE2;
+    Kernels->MultiplyMatrixArray = MultiplyMatrixArraySSE2;
+    Kernels->MultiplyMatrixPairs = MultiplyMatrixPairsSSE2;
+    Kernels->TransformSoA = TransformSoASSE2;
+    Kernels->MultiplyMatricesSoA = MultiplyMatricesSoASSE2;
+    Kernels->MultiplyMatrixPairsSoA = MultiplyMatrixPairsSoASSE2;
+    Kernels->MultiplyQuaternionsSoA = MultiplyQuaternionsSoASSE2;
+    Kernels->NormalizeQuaternionsSoA = NormalizeQuaternionsSoASSE2;
+    Kernels->NlerpQuaternionsSoA = NlerpQuaternionsSoASSE2;
+    Kernels->SlerpQuaternionsSoA = SlerpQuaternionsSoASSE2;
+    Kernels->QuaternionsToMatricesSoA = QuaternionsToMatricesSoASSE2;
+    Kernels->QuaternionsToRotationsSoA = QuaternionsToRotationsSoASSE2;
+    Kernels->CullSpheresSoA = CullSpheresSoASSE2;
+    Kernels->CullBoxesSoA = CullBoxesSoASSE2;
+    Kernels->IntersectRaysBoxesSoA = IntersectRaysBoxesSoASSE2;
+}
+
+} /* bakge */
+#endif /* BGE_USE_SIMD */
@@ -0,0 +1,63 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/MathKernels.h>
+
+#ifdef BGE_HAVE_SSE41_KERNELS
+/* This file alone is compiled with SSE4.1 enabled */
+#include <smmintrin.h>
+
+namespace bakge
+{
+
+static void NormalizeVectorSSE41(Scalar* V)
+{
+    __m128 X = _mm_load_ps(V);
+
+    /* Dot product broadcast to all four lanes in one instruction */
+    __m128 Sq = _mm_dp_ps(X, X, 0xFF);
+
+    _mm_store_ps(V, _mm_div_ps(X, _mm_sqrt_ps(Sq)));
+}
+
+
+static void NormalizeVectorsSSE41(Scalar* V, int Count)
+{
+    for(int i = 0; i < Count * 4; i += 4) {
+        __m128 X = _mm_load_ps(V + i);
+        _mm_store_ps(V + i, _mm_div_ps(X, _mm_sqrt_ps(_mm_dp_ps(X, X,
+                                                                0xFF))));
+    }
+}
+
+
+void FillSSE41MathKernels(MathKernels* Kernels)
+{
+    Kernels->NormalizeVector = NormalizeVectorSSE41;
+    Kernels->NormalizeVectors = NormalizeVectorsSSE41;
+}
+
+} /* bakge */
+#endif /* BGE_HAVE_SSE41_KERNELS */
@@ -0,0 +1,548 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <bakge/Bakge.h>
+#include <bakge/internal/MathKernels.h>
+#include <float.h>
+
+namespace bakge
+{
+
+static void MultiplyMatricesScalar(const Scalar* Left, const Scalar* Right,
+                                                            Scalar* Out)
+{
+    Scalar Res[16];
+
+    memset((void*)Res, 0, sizeof(Scalar) * 16);
+
+    for(int i=0;i<4;++i) {
+        for(int j=0;j<4;++j) {
+            for(int k=0;k<4;++k) {
+                Res[i*4+k] += Left[i*4+j] * Right[j*4+k];
+            }
+        }
+    }
+
+    memcpy((void*)Out, (const void*)Res, sizeof(Scalar) * 16);
+}
+
+
+static void TransformVectorScalar(const Scalar* M, const Scalar* V,
+                                                        Scalar* Out)
+{
+    Scalar X = V[0], Y = V[1], Z = V[2], W = V[3];
+
+    Out[0] = M[0] * X + M[4] * Y + M[8] * Z + M[12] * W;
+    Out[1] = M[1] * X + M[5] * Y + M[9] * Z + M[13] * W;
+    Out[2] = M[2] * X + M[6] * Y + M[10] * Z + M[14] * W;
+    Out[3] = M[3] * X + M[7] * Y + M[11] * Z + M[15] * W;
+}
+
+
+static void NormalizeVectorScalar(Scalar* V)
+{
+    Scalar Len = sqrtf(V[0] * V[0] + V[1] * V[1] + V[2] * V[2]
+                                                    + V[3] * V[3]);
+
+    V[0] /= Len;
+    V[1] /= Len;
+    V[2] /= Len;
+    V[3] /= Len;
+}
+
+
+static void NormalizeVectorsScalar(Scalar* V, int Count)
+{
+    for(int i = 0; i < Count; ++i)
+        NormalizeVectorScalar(V + i * 4);
+}
+
+
+static void NormalizeVectorFastScalar(Scalar* V)
+{
+    Scalar Inv = FastInvSqrt(V[0] * V[0] + V[1] * V[1] + V[2] * V[2]
+                                                    + V[3] * V[3]);
+
+    V[0] *= Inv;
+    V[1] *= Inv;
+    V[2] *= Inv;
+    V[3] *= Inv;
+}
+
+
+static void NormalizeVectorsFastScalar(Scalar* V, int Count)
+{
+    for(int i = 0; i < Count; ++i)
+        NormalizeVectorFastScalar(V + i * 4);
+}
+
+
+static void TransformVectorsScalar(const Scalar* M, const Scalar* In,
+                                            Scalar* Out, int Count)
+{
+    for(int i = 0; i < Count; ++i)
+        TransformVectorScalar(M, In + i * 4, Out + i * 4);
+}
+
+
+static void TransformPackedScalar(const Scalar* M, const Scalar* In,
+                                Scalar* Out, int Count, Scalar W)
+{
+    for(int i = 0; i < Count * 3; i += 3) {
+        Scalar X = In[i], Y = In[i + 1], Z = In[i + 2];
+
+        Out[i] = M[0] * X + M[4] * Y + M[8] * Z + M[12] * W;
+        Out[i + 1] = M[1] * X + M[5] * Y + M[9] * Z + M[13] * W;
+        Out[i + 2] = M[2] * X + M[6] * Y + M[10] * Z + M[14] * W;
+    }
+}
+
+
+static void MultiplyMatrixArrayScalar(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    for(int i = 0; i < Count * 16; i += 16)
+        MultiplyMatricesScalar(Left + i, Right, Out + i);
+}
+
+
+static void MultiplyMatrixPairsScalar(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    for(int i = 0; i < Count * 16; i += 16)
+        MultiplyMatricesScalar(Left + i, Right + i, Out + i);
+}
+
+
+static void TransformSoAScalar(const Scalar* M, Scalar* X, Scalar* Y,
+                                        Scalar* Z, int Count, Scalar W)
+{
+    for(int i = 0; i < Count; ++i) {
+        Scalar A = X[i], B = Y[i], C = Z[i];
+
+        X[i] = M[0] * A + M[4] * B + M[8] * C + M[12] * W;
+        Y[i] = M[1] * A + M[5] * B + M[9] * C + M[13] * W;
+        Z[i] = M[2] * A + M[6] * B + M[10] * C + M[14] * W;
+    }
+}
+
+
+/* Gather one matrix out of SoA streams */
+static void GatherSoA(const Scalar* Streams, int Count, int Index,
+                                                    Scalar* Out)
+{
+    for(int e = 0; e < 16; ++e)
+        Out[e] = Streams[e * Count + Index];
+}
+
+
+static void ScatterSoA(const Scalar* In, int Count, int Index,
+                                                Scalar* Streams)
+{
+    for(int e = 0; e < 16; ++e)
+        Streams[e * Count + Index] = In[e];
+}
+
+
+void MultiplyMatricesSoARange(const Scalar* Left, const Scalar* Right,
+                                    Scalar* Out, int Count, int First)
+{
+    Scalar L[16];
+
+    for(int i = First; i < Count; ++i) {
+        GatherSoA(Left, Count, i, L);
+        MultiplyMatricesScalar(L, Right, L);
+        ScatterSoA(L, Count, i, Out);
+    }
+}
+
+
+void MultiplyMatrixPairsSoARange(const Scalar* Left, const Scalar* Right,
+                                        Scalar* Out, int Count, int First)
+{
+    Scalar L[16];
+    Scalar R[16];
+
+    for(int i = First; i < Count; ++i) {
+        GatherSoA(Left, Count, i, L);
+        GatherSoA(Right, Count, i, R);
+        MultiplyMatricesScalar(L, R, L);
+        ScatterSoA(L, Count, i, Out);
+    }
+}
+
+
+static void MultiplyMatricesSoAScalar(const Scalar* Left,
+            const Scalar* Right, Scalar* Out, int Count)
+{
+    MultiplyMatricesSoARange(Left, Right, Out, Count, 0);
+}
+
+
+static void MultiplyMatrixPairsSoAScalar(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    MultiplyMatrixPairsSoARange(Left, Right, Out, Count, 0);
+}
+
+
+void MultiplyQuaternionsSoARange(const Scalar* Left, const Scalar* Right,
+                                        Scalar* Out, int Count, int First)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar AX = Left[i], AY = Left[Count + i];
+        Scalar AZ = Left[Count * 2 + i], AW = Left[Count * 3 + i];
+        Scalar BX = Right[i], BY = Right[Count + i];
+        Scalar BZ = Right[Count * 2 + i], BW = Right[Count * 3 + i];
+
+        Out[i] = AW * BX + AX * BW + AY * BZ - AZ * BY;
+        Out[Count + i] = AW * BY - AX * BZ + AY * BW + AZ * BX;
+        Out[Count * 2 + i] = AW * BZ + AX * BY - AY * BX + AZ * BW;
+        Out[Count * 3 + i] = AW * BW - AX * BX - AY * BY - AZ * BZ;
+    }
+}
+
+
+void NormalizeQuaternionsSoARange(Scalar* Q, int Count, int First)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar Len = sqrtf(Q[i] * Q[i] + Q[Count + i] * Q[Count + i]
+                    + Q[Count * 2 + i] * Q[Count * 2 + i]
+                    + Q[Count * 3 + i] * Q[Count * 3 + i]);
+
+        Q[i] /= Len;
+        Q[Count + i] /= Len;
+        Q[Count * 2 + i] /= Len;
+        Q[Count * 3 + i] /= Len;
+    }
+}
+
+
+void NlerpQuaternionsSoARange(const Scalar* From, const Scalar* To,
+                const Scalar* T, Scalar* Out, int Count, int First)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar Dot = 0;
+
+        for(int c = 0; c < 4; ++c)
+            Dot += From[Count * c + i] * To[Count * c + i];
+
+        /* Flip To onto From's hemisphere for the shortest path */
+        Scalar Sign = Dot < 0 ? -1.0f : 1.0f;
+        Scalar R[4];
+        Scalar LenSq = 0;
+
+        for(int c = 0; c < 4; ++c) {
+            Scalar A = From[Count * c + i];
+            R[c] = A + T[i] * (Sign * To[Count * c + i] - A);
+            LenSq += R[c] * R[c];
+        }
+
+        Scalar Len = sqrtf(LenSq);
+
+        for(int c = 0; c < 4; ++c)
+            Out[Count * c + i] = R[c] / Len;
+    }
+}
+
+
+void SlerpQuaternionsSoARange(const Scalar* From, const Scalar* To,
+                const Scalar* T, Scalar* Out, int Count, int First)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar Dot = 0;
+
+        for(int c = 0; c < 4; ++c)
+            Dot += From[Count * c + i] * To[Count * c + i];
+
+        Scalar Sign = 1;
+        if(Dot < 0) {
+            Sign = -1;
+            Dot = -Dot;
+        }
+
+        /* Nearly parallel; sin(Theta) is too small to divide by */
+        if(Dot > 0.9995f) {
+            Scalar Len = 0;
+
+            for(int c = 0; c < 4; ++c) {
+                Scalar Q = From[Count * c + i] + T[i]
+                        * (Sign * To[Count * c + i] - From[Count * c + i]);
+                Out[Count * c + i] = Q;
+                Len += Q * Q;
+            }
+
+            Len = sqrtf(Len);
+
+            for(int c = 0; c < 4; ++c)
+                Out[Count * c + i] /= Len;
+
+            continue;
+        }
+
+        Scalar Theta = acosf(Dot);
+        Scalar InvSin = 1.0f / sinf(Theta);
+        Scalar WA = sinf((1 - T[i]) * Theta) * InvSin;
+        Scalar WB = Sign * sinf(T[i] * Theta) * InvSin;
+
+        for(int c = 0; c < 4; ++c) {
+            Out[Count * c + i] = WA * From[Count * c + i]
+                                + WB * To[Count * c + i];
+        }
+    }
+}
+
+
+/* Column-major 3x3 rotation of a unit quaternion, Stride apart */
+static void QuaternionToRotation(Scalar X, Scalar Y, Scalar Z, Scalar W,
+                                                Scalar* Out, int Stride)
+{
+    Out[0] = 1 - 2 * (Y * Y + Z * Z);
+    Out[Stride] = 2 * (X * Y + Z * W);
+    Out[Stride * 2] = 2 * (X * Z - Y * W);
+    Out[Stride * 3] = 2 * (X * Y - Z * W);
+    Out[Stride * 4] = 1 - 2 * (X * X + Z * Z);
+    Out[Stride * 5] = 2 * (Y * Z + X * W);
+    Out[Stride * 6] = 2 * (X * Z + Y * W);
+    Out[Stride * 7] = 2 * (Y * Z - X * W);
+    Out[Stride * 8] = 1 - 2 * (X * X + Y * Y);
+}
+
+
+void QuaternionsToMatricesSoARange(const Scalar* Q, Scalar* Out,
+                                            int Count, int First)
+{
+    Scalar R[9];
+
+    for(int i = First; i < Count; ++i) {
+        QuaternionToRotation(Q[i], Q[Count + i], Q[Count * 2 + i],
+                                            Q[Count * 3 + i], R, 1);
+
+        Scalar* M = Out + i * 16;
+        M[0] = R[0];
+        M[1] = R[1];
+        M[2] = R[2];
+        M[3] = 0;
+        M[4] = R[3];
+        M[5] = R[4];
+        M[6] = R[5];
+        M[7] = 0;
+        M[8] = R[6];
+        M[9] = R[7];
+        M[10] = R[8];
+        M[11] = 0;
+        M[12] = 0;
+        M[13] = 0;
+        M[14] = 0;
+        M[15] = 1;
+    }
+}
+
+
+void QuaternionsToRotationsSoARange(const Scalar* Q, Scalar* Out,
+                                            int Count, int First)
+{
+    for(int i = First; i < Count; ++i) {
+        QuaternionToRotation(Q[i], Q[Count + i], Q[Count * 2 + i],
+                                    Q[Count * 3 + i], Out + i, Count);
+    }
+}
+
+
+static void MultiplyQuaternionsSoAScalar(const Scalar* Left,
+                const Scalar* Right, Scalar* Out, int Count)
+{
+    MultiplyQuaternionsSoARange(Left, Right, Out, Count, 0);
+}
+
+
+static void NormalizeQuaternionsSoAScalar(Scalar* Q, int Count)
+{
+    NormalizeQuaternionsSoARange(Q, Count, 0);
+}
+
+
+static void NlerpQuaternionsSoAScalar(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count)
+{
+    NlerpQuaternionsSoARange(From, To, T, Out, Count, 0);
+}
+
+
+static void SlerpQuaternionsSoAScalar(const Scalar* From, const Scalar* To,
+                                const Scalar* T, Scalar* Out, int Count)
+{
+    SlerpQuaternionsSoARange(From, To, T, Out, Count, 0);
+}
+
+
+static void QuaternionsToMatricesSoAScalar(const Scalar* Q, Scalar* Out,
+                                                            int Count)
+{
+    QuaternionsToMatricesSoARange(Q, Out, Count, 0);
+}
+
+
+static void QuaternionsToRotationsSoAScalar(const Scalar* Q, Scalar* Out,
+                                                            int Count)
+{
+    QuaternionsToRotationsSoARange(Q, Out, Count, 0);
+}
+
+
+void CullSpheresSoARange(const Scalar* Planes, const Scalar* Spheres,
+                            int Count, int First, uint32* Visible)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar X = Spheres[i], Y = Spheres[Count + i];
+        Scalar Z = Spheres[Count * 2 + i], R = Spheres[Count * 3 + i];
+        int p;
+
+        for(p = 0; p < 24; p += 4) {
+            Scalar D = Planes[p] * X + Planes[p + 1] * Y + Planes[p + 2] * Z
+                                                            + Planes[p + 3];
+            if(D < -R)
+                break;
+        }
+
+        if(p == 24)
+            Visible[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+
+void CullBoxesSoARange(const Scalar* Planes, const Scalar* Boxes,
+                            int Count, int First, uint32* Visible)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar X = Boxes[i], Y = Boxes[Count + i], Z = Boxes[Count * 2 + i];
+        Scalar EX = Boxes[Count * 3 + i], EY = Boxes[Count * 4 + i];
+        Scalar EZ = Boxes[Count * 5 + i];
+        int p;
+
+        for(p = 0; p < 24; p += 4) {
+            Scalar D = Planes[p] * X + Planes[p + 1] * Y + Planes[p + 2] * Z
+                                                            + Planes[p + 3];
+            Scalar R = fabsf(Planes[p]) * EX + fabsf(Planes[p + 1]) * EY
+                                            + fabsf(Planes[p + 2]) * EZ;
+            if(D < -R)
+                break;
+        }
+
+        if(p == 24)
+            Visible[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+
+void IntersectRaysBoxesSoARange(const Scalar* Rays, const Scalar* Boxes,
+                                int Count, int First, uint32* Hits)
+{
+    for(int i = First; i < Count; ++i) {
+        Scalar Near = 0;
+        Scalar Far = FLT_MAX;
+
+        for(int a = 0; a < 3; ++a) {
+            Scalar Inv = 1.0f / Rays[Count * (3 + a) + i];
+            Scalar Center = Boxes[Count * a + i] - Rays[Count * a + i];
+            Scalar Extent = Boxes[Count * (3 + a) + i];
+            Scalar T0 = (Center - Extent) * Inv;
+            Scalar T1 = (Center + Extent) * Inv;
+
+            if(T0 > T1) {
+                Scalar Swap = T0;
+                T0 = T1;
+                T1 = Swap;
+            }
+
+            if(T0 > Near)
+                Near = T0;
+
+            if(T1 < Far)
+                Far = T1;
+        }
+
+        if(Near <= Far)
+            Hits[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+
+void ClearBitmask(uint32* Bits, int Count)
+{
+    memset((void*)Bits, 0, sizeof(uint32) * ((Count + 31) / 32));
+}
+
+
+static void CullSpheresSoAScalar(const Scalar* Planes, const Scalar* Spheres,
+                                            int Count, uint32* Visible)
+{
+    ClearBitmask(Visible, Count);
+    CullSpheresSoARange(Planes, Spheres, Count, 0, Visible);
+}
+
+
+static void CullBoxesSoAScalar(const Scalar* Planes, const Scalar* Boxes,
+                                            int Count, uint32* Visible)
+{
+    ClearBitmask(Visible, Count);
+    CullBoxesSoARange(Planes, Boxes, Count, 0, Visible);
+}
+
+
+static void IntersectRaysBoxesSoAScalar(const Scalar* Rays,
+                    const Scalar* Boxes, int Count, uint32* Hits)
+{
+    ClearBitmask(Hits, Count);
+    IntersectRaysBoxesSoARange(Rays, Boxes, Count, 0, Hits);
+}
+
+
+void FillScalarMathKernels(MathKernels* Kernels)
+{
+    Kernels->MultiplyMatrices = MultiplyMatricesScalar;
+    Kernels->TransformVector = TransformVectorScalar;
+    Kernels->NormalizeVector = NormalizeVectorScalar;
+    Kernels->NormalizeVectorFast = NormalizeVectorFastScalar;
+    Kernels->NormalizeVectorsFast = NormalizeVectorsFastScalar;
+    Kernels->CullSpheresSoA = CullSpheresSoAScalar;
+    Kernels->CullBoxesSoA = CullBoxesSoAScalar;
+    Kernels->IntersectRaysBoxesSoA = IntersectRaysBoxesSoAScalar;
+    Kernels->NormalizeVectors = NormalizeVectorsScalar;
+    Kernels->TransformVectors = TransformVectorsScalar;
+    Kernels->TransformPacked = TransformPackedScalar;
+    Kernels->MultiplyMatrixArray = MultiplyMatrixArrayScalar;
+    Kernels->MultiplyMatrixPairs = MultiplyMatrixPairsScalar;
+    Kernels->TransformSoA = TransformSoAScalar;
+    Kernels->MultiplyMatricesSoA = MultiplyMatricesSoAScalar;
+    Kernels->MultiplyMatrixPairsSoA = MultiplyMatrixPairsSoAScalar;
+    Kernels->MultiplyQuaternionsSoA = MultiplyQuaternionsSoAScalar;
+    Kernels->NormalizeQuaternionsSoA = NormalizeQuaternionsSoAScalar;
+    Kernels->NlerpQuaternionsSoA = NlerpQuaternionsSoAScalar;
+    Kernels->SlerpQuaternionsSoA = SlerpQuaternionsSoAScalar;
+    Kernels->QuaternionsToMatricesSoA = QuaternionsToMatricesSoAScalar;
+    Kernels->QuaternionsToRotationsSoA = QuaternionsToRotationsSoAScalar;
+}
+
+} /* bakge */
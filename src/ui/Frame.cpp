@@ -65,6 +65,12 @@ Frame* Frame::Create(Scalar Width, Scalar Height)
         return NULL;
     }
 
+    /* Frames are resized often; double buffer their vertex data */
+    if(U->SetUsage(MESH_USAGE_DYNAMIC, 2) != BGE_SUCCESS) {
+        delete U;
+        return NULL;
+    }
+
     if(U->SetDimensions(Width, Height) == BGE_FAILURE) {
         delete U;
         return NULL;
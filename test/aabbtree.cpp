@@ -0,0 +1,283 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bakge/Bakge.h>
+
+#define NUM_OBJECTS 2000
+#define MAX_RESULTS NUM_OBJECTS
+
+int Failures = 0;
+
+bakge::AABB Bounds[NUM_OBJECTS];
+int Proxies[NUM_OBJECTS];
+bool Alive[NUM_OBJECTS];
+
+
+bakge::Scalar RandomValue(double Range)
+{
+    return (bakge::Scalar)(((double)rand() / RAND_MAX) * 2 * Range - Range);
+}
+
+
+bakge::AABB RandomBox()
+{
+    bakge::Vector4 Center = bakge::Vector4::Point(RandomValue(100),
+                                    RandomValue(100), RandomValue(100));
+    bakge::Scalar Size = 0.5f + (bakge::Scalar)((double)rand() / RAND_MAX);
+
+    return bakge::AABB::FromCenterAndExtents(Center,
+                                bakge::Vector4::Vector(Size, Size, Size));
+}
+
+
+int CompareInts(const void* A, const void* B)
+{
+    return *(const int*)A - *(const int*)B;
+}
+
+
+/* Compare a query's results with a linear scan over the fat bounds */
+void CheckResults(const char* Name, int* Found, int NumFound,
+                                        const bool* Expected)
+{
+    int NumExpected = 0;
+    for(int i = 0; i < NUM_OBJECTS; ++i) {
+        if(Alive[i] && Expected[i])
+            ++NumExpected;
+    }
+
+    if(NumFound != NumExpected) {
+        printf("test/aabbtree: %s found %d proxies, expected %d\n", Name,
+                                                NumFound, NumExpected);
+        ++Failures;
+        return;
+    }
+
+    qsort(Found, NumFound, sizeof(int), CompareInts);
+
+    for(int i = 0; i < NUM_OBJECTS; ++i) {
+        if(!Alive[i] || !Expected[i])
+            continue;
+
+        /* Proxy IDs aren't ordered like objects; look it up */
+        int* Match = (int*)bsearch(&Proxies[i], Found, NumFound,
+                                            sizeof(int), CompareInts);
+        if(Match == NULL) {
+            printf("test/aabbtree: %s missed object %d\n", Name, i);
+            ++Failures;
+            return;
+        }
+    }
+}
+
+
+void CheckQueries(const char* Stage, const bakge::AABBTree* T)
+{
+    static int Found[MAX_RESULTS];
+    static bool Expected[NUM_OBJECTS];
+    char Name[128];
+    int N;
+
+    bakge::AABB Box = bakge::AABB::FromCenterAndExtents(
+                            bakge::Vector4::Point(10, -20, 5),
+                            bakge::Vector4::Vector(30, 25, 40));
+    for(int i = 0; i < NUM_OBJECTS; ++i)
+        Expected[i] = Alive[i]
+                    && T->GetFatBounds(Proxies[i]).Intersects(Box);
+    N = T->QueryBox(Box, Found, MAX_RESULTS);
+    sprintf(Name, "QueryBox %s", Stage);
+    CheckResults(Name, Found, N, Expected);
+
+    bakge::Sphere Ball(bakge::Vector4::Point(-30, 10, 20), 35);
+    for(int i = 0; i < NUM_OBJECTS; ++i)
+        Expected[i] = Alive[i]
+                    && Ball.Intersects(T->GetFatBounds(Proxies[i]));
+    N = T->QuerySphere(Ball, Found, MAX_RESULTS);
+    sprintf(Name, "QuerySphere %s", Stage);
+    CheckResults(Name, Found, N, Expected);
+
+    bakge::Matrix Proj;
+    bakge::Matrix View;
+    Proj.SetPerspective(60.0f, 1.5f, 1.0f, 120.0f);
+    View.SetLookAt(bakge::Vector4::Point(0, 20, 150),
+                    bakge::Vector4::Point(20, 0, 0),
+                    bakge::Vector4::Vector(0, 1, 0));
+    bakge::Frustum F = bakge::Frustum::FromMatrix(View * Proj);
+    for(int i = 0; i < NUM_OBJECTS; ++i)
+        Expected[i] = Alive[i]
+                    && F.Intersects(T->GetFatBounds(Proxies[i]));
+    N = T->QueryFrustum(F, Found, MAX_RESULTS);
+    sprintf(Name, "QueryFrustum %s", Stage);
+    CheckResults(Name, Found, N, Expected);
+
+    /* Aim rays at objects so they hit something */
+    for(int r = 0; r < 8; ++r) {
+        bakge::Vector4 Origin = bakge::Vector4::Point(-150, r * 10.0f, 0);
+        bakge::Vector4 Target = Bounds[r * 97 + 1].GetCenter();
+        bakge::Ray R(Origin, (Target - Origin).Normalized());
+
+        for(int i = 0; i < NUM_OBJECTS; ++i) {
+            bakge::Scalar Distance;
+            Expected[i] = Alive[i]
+                && R.Intersects(T->GetFatBounds(Proxies[i]), &Distance)
+                && Distance <= 300;
+        }
+        N = T->QueryRay(R, 300, Found, MAX_RESULTS);
+        sprintf(Name, "QueryRay %d %s", r, Stage);
+        CheckResults(Name, Found, N, Expected);
+    }
+
+    /* Results beyond the output array are counted but not written */
+    int Few[4];
+    int Total = T->QueryBox(Box, Few, 4);
+    if(Total != T->QueryBox(Box, Found, MAX_RESULTS)) {
+        printf("test/aabbtree: QueryBox %s miscounted a short array\n",
+                                                                Stage);
+        ++Failures;
+    }
+
+    for(int i = 0; i < NUM_OBJECTS; ++i) {
+        if(Alive[i] && T->GetData(Proxies[i]) != &Bounds[i]) {
+            printf("test/aabbtree: Proxy of object %d lost its data %s\n",
+                                                                i, Stage);
+            ++Failures;
+            break;
+        }
+    }
+}
+
+
+void CheckHeight(const char* Stage, const bakge::AABBTree* T, int Limit)
+{
+    if(T->GetHeight() > Limit) {
+        printf("test/aabbtree: Height %d %s exceeds %d\n", T->GetHeight(),
+                                                            Stage, Limit);
+        ++Failures;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    srand(4321);
+
+    bakge::AABBTree* T = bakge::AABBTree::Create(0.5f);
+    if(T == NULL) {
+        printf("test/aabbtree: Couldn't create AABBTree\n");
+        return 1;
+    }
+
+    for(int i = 0; i < NUM_OBJECTS; ++i) {
+        Bounds[i] = RandomBox();
+        Proxies[i] = T->Insert(Bounds[i], &Bounds[i]);
+        Alive[i] = Proxies[i] >= 0;
+        if(!Alive[i]) {
+            printf("test/aabbtree: Couldn't insert object %d\n", i);
+            ++Failures;
+        }
+    }
+
+    /* log2(2000) is about 11; balancing keeps it within a small factor */
+    CheckHeight("after insertion", T, 30);
+    CheckQueries("after insertion", T);
+
+    /* Small moves stay inside the fat bounds; large ones reinsert */
+    for(int i = 0; i < NUM_OBJECTS; i += 2) {
+        bakge::Scalar Step = (i % 4 == 0) ? 0.2f : 20.0f;
+        bakge::Vector4 Offset = bakge::Vector4::Vector(Step, -Step, Step);
+        Bounds[i] = bakge::AABB(Bounds[i].GetMin() + Offset,
+                                        Bounds[i].GetMax() + Offset);
+        if(T->Move(Proxies[i], Bounds[i]) == BGE_FAILURE) {
+            printf("test/aabbtree: Couldn't move object %d\n", i);
+            ++Failures;
+        }
+    }
+
+    for(int i = 0; i < NUM_OBJECTS; i += 2) {
+        bakge::AABB Fat = T->GetFatBounds(Proxies[i]);
+        if(!Fat.Contains(Bounds[i].GetMin())
+                            || !Fat.Contains(Bounds[i].GetMax())) {
+            printf("test/aabbtree: Object %d outside its fat bounds\n", i);
+            ++Failures;
+            break;
+        }
+    }
+
+    CheckHeight("after moves", T, 30);
+    CheckQueries("after moves", T);
+
+    for(int i = 0; i < NUM_OBJECTS; i += 3) {
+        if(T->Remove(Proxies[i]) == BGE_FAILURE) {
+            printf("test/aabbtree: Couldn't remove object %d\n", i);
+            ++Failures;
+        }
+        Alive[i] = false;
+    }
+
+    int Count = 0;
+    for(int i = 0; i < NUM_OBJECTS; ++i) {
+        if(Alive[i])
+            ++Count;
+    }
+
+    if(T->GetNumProxies() != Count || T->IsValid(Proxies[0])) {
+        printf("test/aabbtree: Removal left %d proxies, expected %d\n",
+                                            T->GetNumProxies(), Count);
+        ++Failures;
+    }
+
+    CheckQueries("after removal", T);
+
+    /* A rebuilt tree is as shallow as a binary tree can be */
+    if(T->Rebuild() == BGE_FAILURE) {
+        printf("test/aabbtree: Rebuild failed\n");
+        ++Failures;
+    }
+
+    CheckHeight("after rebuild", T,
+                        (int)ceil(log((double)Count) / log(2.0)));
+    CheckQueries("after rebuild", T);
+
+    /* Reinserting after a rebuild reuses the freed proxies */
+    for(int i = 0; i < NUM_OBJECTS; i += 3) {
+        Proxies[i] = T->Insert(Bounds[i], &Bounds[i]);
+        Alive[i] = Proxies[i] >= 0;
+    }
+
+    CheckQueries("after reinsertion", T);
+
+    delete T;
+
+    if(Failures > 0) {
+        printf("test/aabbtree: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/aabbtree: All tests passed\n");
+
+    return 0;
+}
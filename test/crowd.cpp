@@ -33,6 +33,7 @@ int main(int argc, char* argv[])
     bakge::Texture* Tex;
     bakge::Crowd* Group;
     bakge::Camera3D* Cam;
+    bakge::Renderer* Queue;
 
     bakge::Init(argc, argv);
 
@@ -91,6 +92,8 @@ int main(int argc, char* argv[])
     Cam->SetPosition(0, 0.5f, 1.25f);
     Cam->SetTarget(0, 0, 0);
 
+    Queue = bakge::Renderer::Create(16);
+
     float Rot = 0;
     bakge::Microseconds NowTime;
     bakge::Microseconds LastTime = bakge::GetRunningTime();
@@ -114,13 +117,11 @@ int main(int argc, char* argv[])
                                                         DeltaTime, 0));
 
         Cam->Bind();
-        Tex->Bind();
-        Obj->Bind();
-        Group->Bind();
-        Obj->DrawInstanced(Group->GetPopulation()); /* No renderer for now */
-        Group->Unbind();
-        Obj->Unbind();
-        Tex->Unbind();
+
+        /* Draw with the window's shader; the Crowd draws every member */
+        Queue->Submit(0, bakge::Shader::GetCurrent(), Tex, Obj, Group);
+        Queue->Flush();
+
         Cam->Unbind();
 
         Win->SwapBuffers();
@@ -141,6 +142,9 @@ int main(int argc, char* argv[])
     if(Cam != NULL)
         delete Cam;
 
+    if(Queue != NULL)
+        delete Queue;
+
     bakge::Deinit();
 
     delete[] Bitmap;
@@ -99,13 +99,9 @@ int main(int argc, char* argv[])
     bakge::Matrix Perspective;
     bakge::Matrix View;
 
-    GLint ShaderProgram, Location;
     Perspective.SetPerspective(80.0f, 1024.0f / 768.0f, 0.1f, 500.0f);
-    glGetIntegerv(GL_CURRENT_PROGRAM, &ShaderProgram);
-    Location = glGetUniformLocation(ShaderProgram, BGE_PROJECTION_UNIFORM);
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &Perspective[0]);
-    Location = glGetUniformLocation(ShaderProgram, BGE_VIEW_UNIFORM);
-    glUniformMatrix4fv(Location, 1, GL_FALSE, &View[0]);
+    bakge::FrameUniforms::SetCamera(Perspective, View,
+                            bakge::Vector4::Point(0, 0.5f, 1.25f));
 
     float Rot = 0;
     bakge::Microseconds NowTime;
@@ -131,8 +127,9 @@ int main(int argc, char* argv[])
             bakge::Vector4::Point(0.0f, 0, 0.0f),
             bakge::Vector4::UnitVector(0, 1, 0)
         );
-        glGetIntegerv(GL_CURRENT_PROGRAM, &ShaderProgram);
-        glUniformMatrix4fv(glGetUniformLocation(ShaderProgram, "bge_View"), 1, GL_FALSE, &View[0]);
+        bakge::FrameUniforms::BeginFrame();
+        bakge::FrameUniforms::SetCamera(Perspective, View,
+                                bakge::Vector4::Point(0, 0.5f, 1.25f));
 
         for(int i=0;i<CROWD_SIZE;++i)
             Group->RotateMember(i, bakge::Quaternion::FromEulerAngles(0,
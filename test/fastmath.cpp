@@ -0,0 +1,261 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <bakge/Bakge.h>
+
+/* Error contracts documented in bakge/math/FastMath.h */
+#define INV_SQRT_MAX_ERROR 5e-7
+#define SIN_COS_MAX_ERROR 1e-6
+#define ACOS_MAX_ERROR 1e-6
+#define NORMALIZE_MAX_ERROR 5e-7
+
+#define NUM_SAMPLES 1000000
+#define NUM_VECTORS 1024
+
+int Failures = 0;
+
+/* Keeps benchmarked results alive so the loops aren't optimized out */
+volatile bakge::Scalar Sink;
+
+
+void CheckError(const char* Name, double MaxError, double Bound)
+{
+    printf("test/fastmath: %-20s max error %.3g (bound %.3g)\n", Name,
+                                                    MaxError, Bound);
+
+    if(MaxError > Bound) {
+        printf("test/fastmath: %s exceeds its error bound\n", Name);
+        ++Failures;
+    }
+}
+
+
+void Report(const char* Name, clock_t Fast, clock_t Exact, int Ops)
+{
+    double FastNs = (double)Fast / CLOCKS_PER_SEC * 1e9 / Ops;
+    double ExactNs = (double)Exact / CLOCKS_PER_SEC * 1e9 / Ops;
+
+    printf("test/fastmath: %-20s %6.2f ns/op vs %6.2f ns/op libm "
+                    "(%.2fx)\n", Name, FastNs, ExactNs,
+                    FastNs > 0 ? ExactNs / FastNs : 0);
+}
+
+
+void TestAccuracy()
+{
+    double InvSqrtError = 0, SinCosError = 0, AcosError = 0;
+
+    for(int i = 0; i < NUM_SAMPLES; ++i) {
+        double T = (double)i / NUM_SAMPLES;
+
+        /* Reciprocal square root over several octaves, relative error */
+        bakge::Scalar X = (bakge::Scalar)pow(2.0, T * 40 - 20);
+        double Exact = 1 / sqrt((double)X);
+        double Error = fabs(bakge::FastInvSqrt(X) - Exact) / Exact;
+        if(Error > InvSqrtError)
+            InvSqrtError = Error;
+
+        bakge::Scalar Angle = (bakge::Scalar)((T * 2 - 1) * 8192);
+        bakge::Scalar Sin, Cos;
+        bakge::FastSinCos(Angle, &Sin, &Cos);
+        Error = fabs(Sin - sin((double)Angle));
+        if(Error > SinCosError)
+            SinCosError = Error;
+        Error = fabs(Cos - cos((double)Angle));
+        if(Error > SinCosError)
+            SinCosError = Error;
+
+        bakge::Scalar C = (bakge::Scalar)(T * 2 - 1);
+        Error = fabs(bakge::FastAcos(C) - acos((double)C));
+        if(Error > AcosError)
+            AcosError = Error;
+    }
+
+    CheckError("FastInvSqrt", InvSqrtError, INV_SQRT_MAX_ERROR);
+    CheckError("FastSinCos", SinCosError, SIN_COS_MAX_ERROR);
+    CheckError("FastAcos", AcosError, ACOS_MAX_ERROR);
+
+    /* Every kernel set's fast normalize must honour the same contract */
+    for(int i = 0; i < bakge::NUM_MATH_ISAS; ++i) {
+        bakge::MATH_ISA ISA = (bakge::MATH_ISA)i;
+
+        if(!bakge::IsMathISASupported(ISA))
+            continue;
+
+        bakge::SetMathISA(ISA);
+
+        bakge::Vector4* Vectors = new bakge::Vector4[NUM_VECTORS];
+        for(int v = 0; v < NUM_VECTORS; ++v) {
+            Vectors[v] = bakge::Vector4(
+                    (bakge::Scalar)(rand() % 2000 - 1000) / 7,
+                    (bakge::Scalar)(rand() % 2000 - 1000) / 7,
+                    (bakge::Scalar)(rand() % 2000 - 1000) / 7, 1);
+        }
+
+        double NormalizeError = 0;
+
+        bakge::SetMathPrecision(bakge::MATH_PRECISION_FAST);
+        bakge::NormalizeVectors(Vectors, NUM_VECTORS - 1);
+        Vectors[NUM_VECTORS - 1].FastNormalize();
+        bakge::SetMathPrecision(bakge::MATH_PRECISION_EXACT);
+
+        for(int v = 0; v < NUM_VECTORS; ++v) {
+            double Len = 0;
+            for(int c = 0; c < 4; ++c)
+                Len += (double)Vectors[v][c] * Vectors[v][c];
+
+            double Error = fabs(sqrt(Len) - 1);
+            if(Error > NormalizeError)
+                NormalizeError = Error;
+        }
+
+        char Name[32];
+        sprintf(Name, "FastNormalize (%s)", bakge::GetMathISAName(ISA));
+        CheckError(Name, NormalizeError, NORMALIZE_MAX_ERROR);
+
+        delete[] Vectors;
+    }
+
+    bakge::SetMathISA(bakge::GetBestMathISA());
+}
+
+
+void BenchmarkInvSqrt()
+{
+    bakge::Scalar Sum = 0;
+    clock_t Start = clock();
+
+    for(int i = 1; i <= NUM_SAMPLES; ++i)
+        Sum += bakge::FastInvSqrt((bakge::Scalar)i);
+
+    clock_t Fast = clock() - Start;
+    Start = clock();
+
+    for(int i = 1; i <= NUM_SAMPLES; ++i)
+        Sum += 1.0f / sqrtf((bakge::Scalar)i);
+
+    Report("FastInvSqrt", Fast, clock() - Start, NUM_SAMPLES);
+    Sink = Sum;
+}
+
+
+void BenchmarkSinCos()
+{
+    bakge::Scalar Sum = 0;
+    clock_t Start = clock();
+
+    for(int i = 0; i < NUM_SAMPLES; ++i) {
+        bakge::Scalar Sin, Cos;
+        bakge::FastSinCos((bakge::Scalar)i * 0.001f, &Sin, &Cos);
+        Sum += Sin + Cos;
+    }
+
+    clock_t Fast = clock() - Start;
+    Start = clock();
+
+    for(int i = 0; i < NUM_SAMPLES; ++i) {
+        bakge::Scalar Angle = (bakge::Scalar)i * 0.001f;
+        Sum += sinf(Angle) + cosf(Angle);
+    }
+
+    Report("FastSinCos", Fast, clock() - Start, NUM_SAMPLES);
+    Sink = Sum;
+}
+
+
+void BenchmarkAcos()
+{
+    bakge::Scalar Sum = 0;
+    bakge::Scalar Step = 2.0f / NUM_SAMPLES;
+    clock_t Start = clock();
+
+    for(int i = 0; i < NUM_SAMPLES; ++i)
+        Sum += bakge::FastAcos(i * Step - 1);
+
+    clock_t Fast = clock() - Start;
+    Start = clock();
+
+    for(int i = 0; i < NUM_SAMPLES; ++i)
+        Sum += acosf(i * Step - 1);
+
+    Report("FastAcos", Fast, clock() - Start, NUM_SAMPLES);
+    Sink = Sum;
+}
+
+
+void BenchmarkNormalize()
+{
+    bakge::Vector4* Vectors = new bakge::Vector4[NUM_VECTORS];
+    int Rounds = NUM_SAMPLES / NUM_VECTORS;
+
+    for(int v = 0; v < NUM_VECTORS; ++v)
+        Vectors[v] = bakge::Vector4((bakge::Scalar)v, 1, 2, 0);
+
+    /* Normalizing unit vectors again keeps the data stable across rounds */
+    clock_t Start = clock();
+    bakge::SetMathPrecision(bakge::MATH_PRECISION_FAST);
+
+    for(int r = 0; r < Rounds; ++r)
+        bakge::NormalizeVectors(Vectors, NUM_VECTORS);
+
+    clock_t Fast = clock() - Start;
+    Start = clock();
+    bakge::SetMathPrecision(bakge::MATH_PRECISION_EXACT);
+
+    for(int r = 0; r < Rounds; ++r)
+        bakge::NormalizeVectors(Vectors, NUM_VECTORS);
+
+    Report("NormalizeVectors", Fast, clock() - Start, Rounds * NUM_VECTORS);
+    Sink = Vectors[0][0];
+
+    delete[] Vectors;
+}
+
+
+int main(int argc, char* argv[])
+{
+    printf("test/fastmath: Using %s math kernels\n",
+            bakge::GetMathISAName(bakge::GetBestMathISA()));
+
+    srand(1234);
+
+    TestAccuracy();
+    BenchmarkInvSqrt();
+    BenchmarkSinCos();
+    BenchmarkAcos();
+    BenchmarkNormalize();
+
+    if(Failures > 0) {
+        printf("test/fastmath: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/fastmath: All tests passed\n");
+
+    return 0;
+}
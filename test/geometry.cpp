@@ -0,0 +1,253 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bakge/Bakge.h>
+
+/* Odd so every kernel has lanes left over and masks span several words */
+#define BATCH_SIZE 77
+#define MASK_WORDS ((BATCH_SIZE + 31) / 32)
+
+int Failures = 0;
+
+
+void Check(const char* Name, int Sample, bool Result, bool Expected)
+{
+    if(Result != Expected) {
+        printf("test/geometry: %s failed on sample %d: got %s, expected "
+                    "%s\n", Name, Sample, Result ? "true" : "false",
+                                        Expected ? "true" : "false");
+        ++Failures;
+    }
+}
+
+
+bool GetBit(const bakge::uint32* Bits, int i)
+{
+    return (Bits[i >> 5] >> (i & 31)) & 1;
+}
+
+
+bakge::Scalar RandomValue(double Range)
+{
+    return (bakge::Scalar)(((double)rand() / RAND_MAX) * 2 * Range - Range);
+}
+
+
+/* Camera at (0, 0, 10) looking at the origin, as Camera3D sets it up */
+bakge::Frustum TestFrustum()
+{
+    bakge::Matrix Proj, View;
+
+    Proj.SetPerspective(60.0f, 1.5f, 1.0f, 100.0f);
+    View.SetLookAt(bakge::Vector4::Point(0, 0, 10),
+                bakge::Vector4::Point(0, 0, 0),
+                bakge::Vector4::Vector(0, 1, 0));
+
+    return bakge::Frustum::FromMatrix(View * Proj);
+}
+
+
+void TestPrimitives()
+{
+    bakge::Frustum F = TestFrustum();
+
+    Check("Frustum Contains target", 0,
+            F.Contains(bakge::Vector4::Point(0, 0, 0)), true);
+    Check("Frustum Contains behind", 0,
+            F.Contains(bakge::Vector4::Point(0, 0, 20)), false);
+    Check("Frustum Contains too near", 0,
+            F.Contains(bakge::Vector4::Point(0, 0, 9.5f)), false);
+    Check("Frustum Contains too far", 0,
+            F.Contains(bakge::Vector4::Point(0, 0, -95)), false);
+    Check("Frustum Contains left", 0,
+            F.Contains(bakge::Vector4::Point(-20, 0, 0)), false);
+    Check("Frustum Contains above", 0,
+            F.Contains(bakge::Vector4::Point(0, 20, 0)), false);
+
+    /* The near plane is 1 unit in front of the camera */
+    bakge::Scalar Near = F.GetPlane(bakge::FRUSTUM_NEAR).Distance(
+                                    bakge::Vector4::Point(0, 0, 8));
+    Check("Frustum near plane", 0, fabs(Near - 1) < 1e-3, true);
+
+    Check("Frustum Intersects sphere", 0, F.Intersects(bakge::Sphere(
+                        bakge::Vector4::Point(-20, 0, 0), 15)), true);
+    Check("Frustum Intersects box", 0, F.Intersects(
+                bakge::AABB::FromCenterAndExtents(
+                    bakge::Vector4::Point(0, 0, 15),
+                    bakge::Vector4::Vector(1, 1, 6))), true);
+
+    bakge::AABB Box(bakge::Vector4::Point(-1, -1, -1),
+                    bakge::Vector4::Point(1, 1, 1));
+    bakge::Scalar T;
+
+    Check("Ray hits box", 0, bakge::Ray(bakge::Vector4::Point(0, 0, 5),
+        bakge::Vector4::Vector(0, 0, -1)).Intersects(Box, &T), true);
+    Check("Ray box distance", 0, fabs(T - 4) < 1e-5, true);
+    Check("Ray misses box", 0, bakge::Ray(bakge::Vector4::Point(0, 0, 5),
+        bakge::Vector4::Vector(0, 0, 1)).Intersects(Box, &T), false);
+    Check("Ray hits sphere", 0, bakge::Ray(bakge::Vector4::Point(0, 0, 5),
+                bakge::Vector4::Vector(0, 0, -1)).Intersects(
+                    bakge::Sphere(bakge::Vector4::Point(0, 0, 0), 2), &T),
+                                                                    true);
+    Check("Ray sphere distance", 0, fabs(T - 3) < 1e-5, true);
+    Check("Ray hits plane", 0, bakge::Ray(bakge::Vector4::Point(0, 5, 0),
+            bakge::Vector4::Vector(0, -1, 0)).Intersects(bakge::Plane(),
+                                                            &T), true);
+    Check("Ray plane distance", 0, fabs(T - 5) < 1e-5, true);
+
+    Check("Sphere Intersects box", 0, bakge::Sphere(
+            bakge::Vector4::Point(2, 2, 0), 1.5f).Intersects(Box), true);
+    Check("Sphere misses box", 0, bakge::Sphere(
+            bakge::Vector4::Point(2, 2, 2), 1.5f).Intersects(Box), false);
+
+    /* A transformed box must still contain its transformed corners */
+    bakge::Matrix M = bakge::Matrix::Rotation(0.3f, 0.7f, 1.1f)
+                        * bakge::Matrix::Translation(4, -2, 1);
+    bakge::AABB Moved = Box.Transformed(M);
+    for(int c = 0; c < 8; ++c) {
+        bakge::Vector4 P = M * bakge::Vector4::Point(c & 1 ? 1 : -1,
+                                        c & 2 ? 1 : -1, c & 4 ? 1 : -1);
+        bool Inside = true;
+
+        for(int a = 0; a < 3; ++a) {
+            if(P[a] < Moved.GetMin()[a] - 1e-4f
+                    || P[a] > Moved.GetMax()[a] + 1e-4f)
+                Inside = false;
+        }
+
+        Check("AABB Transformed", c, Inside, true);
+    }
+}
+
+
+void TestBatch()
+{
+    bakge::Frustum F = TestFrustum();
+    bakge::Scalar Spheres[BATCH_SIZE * 4];
+    bakge::Scalar Boxes[BATCH_SIZE * 6], Rays[BATCH_SIZE * 6];
+    bakge::uint32 Bits[MASK_WORDS];
+
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        for(int c = 0; c < 3; ++c) {
+            Spheres[c * BATCH_SIZE + i] = RandomValue(60);
+            Boxes[c * BATCH_SIZE + i] = RandomValue(60);
+            Boxes[(c + 3) * BATCH_SIZE + i] = RandomValue(5) + 5.5f;
+            Rays[c * BATCH_SIZE + i] = RandomValue(30);
+            Rays[(c + 3) * BATCH_SIZE + i] = RandomValue(1);
+        }
+
+        Spheres[3 * BATCH_SIZE + i] = RandomValue(5) + 5.5f;
+
+        /* Aim every other ray near its box so both outcomes are covered */
+        if(i % 2 == 1) {
+            for(int c = 0; c < 3; ++c) {
+                Rays[(c + 3) * BATCH_SIZE + i] = Boxes[c * BATCH_SIZE + i]
+                            - Rays[c * BATCH_SIZE + i] + RandomValue(10);
+            }
+        }
+
+        /* Axis-aligned rays divide by zero on two axes */
+        if(i % 5 == 0) {
+            Rays[4 * BATCH_SIZE + i] = 0;
+            Rays[5 * BATCH_SIZE + i] = 0;
+        }
+    }
+
+    bakge::CullSpheresSoA(F, Spheres, BATCH_SIZE, Bits);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Sphere S(bakge::Vector4::Point(Spheres[i],
+                                Spheres[BATCH_SIZE + i],
+                                Spheres[BATCH_SIZE * 2 + i]),
+                                Spheres[BATCH_SIZE * 3 + i]);
+        Check("CullSpheresSoA", i, GetBit(Bits, i), F.Intersects(S));
+    }
+
+    Check("CullSpheresSoA padding", 0,
+            (Bits[MASK_WORDS - 1] >> (BATCH_SIZE & 31)) != 0, false);
+
+    bakge::CullBoxesSoA(F, Boxes, BATCH_SIZE, Bits);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::AABB B = bakge::AABB::FromCenterAndExtents(
+                            bakge::Vector4::Point(Boxes[i],
+                                Boxes[BATCH_SIZE + i],
+                                Boxes[BATCH_SIZE * 2 + i]),
+                            bakge::Vector4::Vector(
+                                Boxes[BATCH_SIZE * 3 + i],
+                                Boxes[BATCH_SIZE * 4 + i],
+                                Boxes[BATCH_SIZE * 5 + i]));
+        Check("CullBoxesSoA", i, GetBit(Bits, i), F.Intersects(B));
+    }
+
+    bakge::IntersectRaysBoxesSoA(Rays, Boxes, BATCH_SIZE, Bits);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::AABB B = bakge::AABB::FromCenterAndExtents(
+                            bakge::Vector4::Point(Boxes[i],
+                                Boxes[BATCH_SIZE + i],
+                                Boxes[BATCH_SIZE * 2 + i]),
+                            bakge::Vector4::Vector(
+                                Boxes[BATCH_SIZE * 3 + i],
+                                Boxes[BATCH_SIZE * 4 + i],
+                                Boxes[BATCH_SIZE * 5 + i]));
+        bakge::Ray R(bakge::Vector4::Point(Rays[i], Rays[BATCH_SIZE + i],
+                                            Rays[BATCH_SIZE * 2 + i]),
+                    bakge::Vector4::Vector(Rays[BATCH_SIZE * 3 + i],
+                                            Rays[BATCH_SIZE * 4 + i],
+                                            Rays[BATCH_SIZE * 5 + i]));
+        Check("IntersectRaysBoxesSoA", i, GetBit(Bits, i),
+                                    R.Intersects(B, NULL));
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Run every test with each set of math kernels this machine supports */
+    for(int i = 0; i < bakge::NUM_MATH_ISAS; ++i) {
+        bakge::MATH_ISA ISA = (bakge::MATH_ISA)i;
+
+        if(!bakge::IsMathISASupported(ISA))
+            continue;
+
+        bakge::SetMathISA(ISA);
+        printf("test/geometry: Testing %s kernels\n",
+                        bakge::GetMathISAName(ISA));
+
+        srand(1234);
+
+        TestPrimitives();
+        TestBatch();
+    }
+
+    if(Failures > 0) {
+        printf("test/geometry: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/geometry: All tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,623 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bakge/Bakge.h>
+
+#define NUM_SAMPLES 1000
+#define TOLERANCE 1e-3
+
+int Failures = 0;
+
+
+/* Reference inverse in double precision using Gauss-Jordan elimination */
+bool ReferenceInverse(const double* In, double* Out)
+{
+    double A[16];
+
+    for(int i = 0; i < 16; ++i) {
+        A[i] = In[i];
+        Out[i] = (i % 5 == 0) ? 1 : 0;
+    }
+
+    for(int c = 0; c < 4; ++c) {
+        /* Partial pivoting on column c */
+        int Pivot = c;
+        for(int r = c + 1; r < 4; ++r) {
+            if(fabs(A[c * 4 + r]) > fabs(A[c * 4 + Pivot]))
+                Pivot = r;
+        }
+
+        if(A[c * 4 + Pivot] == 0)
+            return false;
+
+        for(int k = 0; k < 4; ++k) {
+            double T = A[k * 4 + c];
+            A[k * 4 + c] = A[k * 4 + Pivot];
+            A[k * 4 + Pivot] = T;
+
+            T = Out[k * 4 + c];
+            Out[k * 4 + c] = Out[k * 4 + Pivot];
+            Out[k * 4 + Pivot] = T;
+        }
+
+        double Inv = 1.0 / A[c * 4 + c];
+        for(int k = 0; k < 4; ++k) {
+            A[k * 4 + c] *= Inv;
+            Out[k * 4 + c] *= Inv;
+        }
+
+        for(int r = 0; r < 4; ++r) {
+            if(r == c)
+                continue;
+
+            double F = A[c * 4 + r];
+            for(int k = 0; k < 4; ++k) {
+                A[k * 4 + r] -= F * A[k * 4 + c];
+                Out[k * 4 + r] -= F * Out[k * 4 + c];
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/* Reference determinant in double precision by cofactor expansion */
+double ReferenceDeterminant3(double A, double B, double C, double D,
+                    double E, double F, double G, double H, double I)
+{
+    return A * (E * I - F * H) - B * (D * I - F * G) + C * (D * H - E * G);
+}
+
+
+double ReferenceDeterminant(const double* M)
+{
+    double Det = 0;
+    double Sign = 1;
+
+    for(int c = 0; c < 4; ++c) {
+        double Sub[9];
+        int n = 0;
+        for(int k = 0; k < 4; ++k) {
+            if(k == c)
+                continue;
+
+            for(int r = 1; r < 4; ++r)
+                Sub[n++] = M[k * 4 + r];
+        }
+
+        Det += Sign * M[c * 4] * ReferenceDeterminant3(Sub[0], Sub[1],
+                        Sub[2], Sub[3], Sub[4], Sub[5], Sub[6], Sub[7],
+                                                                Sub[8]);
+        Sign = -Sign;
+    }
+
+    return Det;
+}
+
+
+double RandomValue()
+{
+    return ((double)rand() / RAND_MAX) * 20.0 - 10.0;
+}
+
+
+void Check(const char* Name, int Sample, bakge::Matrix BGE_NCP Result,
+                                                    const double* Expected)
+{
+    for(int i = 0; i < 16; ++i) {
+        double Error = fabs(Result[i] - Expected[i]);
+        double Scale = fabs(Expected[i]) > 1 ? fabs(Expected[i]) : 1;
+
+        if(Error / Scale > TOLERANCE) {
+            printf("test/matrix: %s failed on sample %d, element %d: "
+                            "got %f, expected %f\n", Name, Sample, i,
+                                            Result[i], Expected[i]);
+            ++Failures;
+            return;
+        }
+    }
+}
+
+
+void TestGeneralInverse()
+{
+    for(int s = 0; s < NUM_SAMPLES; ++s) {
+        bakge::Matrix M;
+        double In[16];
+        double Expected[16];
+
+        for(int i = 0; i < 16; ++i) {
+            In[i] = RandomValue();
+            M[i] = (bakge::Scalar)In[i];
+        }
+
+        /* Compare against the rounded single-precision input */
+        for(int i = 0; i < 16; ++i)
+            In[i] = M[i];
+
+        double Det = ReferenceDeterminant(In);
+
+        /* Skip badly conditioned samples; they test float, not us */
+        if(fabs(Det) < 1.0)
+            continue;
+
+        double DetError = fabs(M.Determinant() - Det) / fabs(Det);
+        if(DetError > TOLERANCE) {
+            printf("test/matrix: Determinant failed on sample %d: "
+                    "got %f, expected %f\n", s, M.Determinant(), Det);
+            ++Failures;
+        }
+
+        if(!ReferenceInverse(In, Expected))
+            continue;
+
+        Check("Inverted", s, M.Inverted(), Expected);
+        Check("Invert", s, bakge::Matrix(M).Invert(), Expected);
+    }
+}
+
+
+void TestAffineInverse()
+{
+    for(int s = 0; s < NUM_SAMPLES; ++s) {
+        bakge::Matrix M = bakge::Matrix::Scaling(
+                            (bakge::Scalar)(RandomValue() * 0.1 + 1.5),
+                            (bakge::Scalar)(RandomValue() * 0.1 + 1.5),
+                            (bakge::Scalar)(RandomValue() * 0.1 + 1.5));
+        M *= bakge::Matrix::Rotation((bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue());
+        M.Translate((bakge::Scalar)RandomValue(),
+                    (bakge::Scalar)RandomValue(),
+                    (bakge::Scalar)RandomValue());
+
+        double In[16];
+        double Expected[16];
+
+        for(int i = 0; i < 16; ++i)
+            In[i] = M[i];
+
+        if(!ReferenceInverse(In, Expected))
+            continue;
+
+        Check("AffineInverted", s, M.AffineInverted(), Expected);
+        Check("InvertAffine", s, bakge::Matrix(M).InvertAffine(), Expected);
+    }
+}
+
+
+void TestRigidInverse()
+{
+    for(int s = 0; s < NUM_SAMPLES; ++s) {
+        bakge::Matrix M = bakge::Matrix::Rotation(
+                                    (bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue());
+        M.Translate((bakge::Scalar)RandomValue(),
+                    (bakge::Scalar)RandomValue(),
+                    (bakge::Scalar)RandomValue());
+
+        double In[16];
+        double Expected[16];
+
+        for(int i = 0; i < 16; ++i)
+            In[i] = M[i];
+
+        if(!ReferenceInverse(In, Expected))
+            continue;
+
+        Check("RigidInverted", s, M.RigidInverted(), Expected);
+        Check("InvertRigid", s, bakge::Matrix(M).InvertRigid(), Expected);
+    }
+}
+
+
+void TestSingular()
+{
+    bakge::Matrix M = bakge::Matrix::Scaling(1, 0, 1);
+    double Expected[16];
+
+    for(int i = 0; i < 16; ++i)
+        Expected[i] = M[i];
+
+    if(M.Determinant() != 0) {
+        printf("test/matrix: Singular determinant is %f\n", M.Determinant());
+        ++Failures;
+    }
+
+    Check("Singular Inverted", 0, M.Inverted(), Expected);
+}
+
+
+/* Batched results must match the single-element operations */
+#define BATCH_SIZE 37
+
+bakge::Matrix RandomMatrix()
+{
+    bakge::Matrix M;
+
+    for(int i = 0; i < 16; ++i)
+        M[i] = (bakge::Scalar)RandomValue();
+
+    return M;
+}
+
+
+void CheckScalar(const char* Name, int Sample, bakge::Scalar Result,
+                                                    bakge::Scalar Expected)
+{
+    double Error = fabs(Result - Expected);
+    double Scale = fabs(Expected) > 1 ? fabs(Expected) : 1;
+
+    if(Error / Scale > TOLERANCE) {
+        printf("test/matrix: %s failed on element %d: got %f, expected %f\n",
+                                        Name, Sample, Result, Expected);
+        ++Failures;
+    }
+}
+
+
+void TestBatch()
+{
+    bakge::Matrix M = RandomMatrix();
+    bakge::Matrix* Left = new bakge::Matrix[BATCH_SIZE];
+    bakge::Matrix* Right = new bakge::Matrix[BATCH_SIZE];
+    bakge::Matrix* Out = new bakge::Matrix[BATCH_SIZE];
+    bakge::Vector4* Vectors = new bakge::Vector4[BATCH_SIZE];
+    bakge::Vector4* Transformed = new bakge::Vector4[BATCH_SIZE];
+    bakge::Scalar Packed[BATCH_SIZE * 3];
+    bakge::Scalar X[BATCH_SIZE], Y[BATCH_SIZE], Z[BATCH_SIZE];
+    bakge::Scalar SoALeft[BATCH_SIZE * 16], SoARight[BATCH_SIZE * 16];
+    bakge::Scalar SoAOut[BATCH_SIZE * 16];
+
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        Left[i] = RandomMatrix();
+        Right[i] = RandomMatrix();
+        Vectors[i] = bakge::Vector4((bakge::Scalar)RandomValue(),
+                                    (bakge::Scalar)RandomValue(),
+                                    (bakge::Scalar)RandomValue(),
+                                    (bakge::Scalar)RandomValue());
+
+        for(int e = 0; e < 16; ++e) {
+            SoALeft[e * BATCH_SIZE + i] = Left[i][e];
+            SoARight[e * BATCH_SIZE + i] = Right[i][e];
+        }
+
+        for(int c = 0; c < 3; ++c)
+            Packed[i * 3 + c] = Vectors[i][c];
+
+        X[i] = Vectors[i][0];
+        Y[i] = Vectors[i][1];
+        Z[i] = Vectors[i][2];
+    }
+
+    bakge::TransformVectors(M, Vectors, Transformed, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Vector4 Expected = M * Vectors[i];
+        for(int c = 0; c < 4; ++c)
+            CheckScalar("TransformVectors", i, Transformed[i][c],
+                                                        Expected[c]);
+    }
+
+    bakge::MultiplyMatrices(Left, M, Out, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Matrix Expected = Left[i] * M;
+        for(int e = 0; e < 16; ++e)
+            CheckScalar("MultiplyMatrices", i, Out[i][e], Expected[e]);
+    }
+
+    bakge::MultiplyMatrixPairs(Left, Right, Out, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Matrix Expected = Left[i] * Right[i];
+        for(int e = 0; e < 16; ++e)
+            CheckScalar("MultiplyMatrixPairs", i, Out[i][e], Expected[e]);
+    }
+
+    bakge::MultiplyMatricesSoA(SoALeft, M, SoAOut, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Matrix Expected = Left[i] * M;
+        for(int e = 0; e < 16; ++e)
+            CheckScalar("MultiplyMatricesSoA", i,
+                    SoAOut[e * BATCH_SIZE + i], Expected[e]);
+    }
+
+    /* In place on the right hand side */
+    bakge::MultiplyMatrixPairsSoA(SoALeft, SoARight, SoARight, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Matrix Expected = Left[i] * Right[i];
+        for(int e = 0; e < 16; ++e)
+            CheckScalar("MultiplyMatrixPairsSoA", i,
+                    SoARight[e * BATCH_SIZE + i], Expected[e]);
+    }
+
+    bakge::TransformPoints(M, Packed, Packed, BATCH_SIZE);
+    bakge::TransformPointsSoA(M, X, Y, Z, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Vector4 Expected = M * bakge::Vector4(Vectors[i][0],
+                                        Vectors[i][1], Vectors[i][2], 1);
+        for(int c = 0; c < 3; ++c)
+            CheckScalar("TransformPoints", i, Packed[i * 3 + c],
+                                                        Expected[c]);
+
+        CheckScalar("TransformPointsSoA", i, X[i], Expected[0]);
+        CheckScalar("TransformPointsSoA", i, Y[i], Expected[1]);
+        CheckScalar("TransformPointsSoA", i, Z[i], Expected[2]);
+    }
+
+    bakge::NormalizeVectors(Vectors, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i)
+        CheckScalar("NormalizeVectors", i, Vectors[i].Length(), 1);
+
+    delete[] Left;
+    delete[] Right;
+    delete[] Out;
+    delete[] Vectors;
+    delete[] Transformed;
+}
+
+
+/* Affine must agree with the equivalent 4x4 Matrix operations */
+bakge::Affine RandomAffine()
+{
+    return bakge::Affine::FromMatrix(bakge::Matrix::Scaling(
+                            (bakge::Scalar)(RandomValue() * 0.1 + 1.5),
+                            (bakge::Scalar)(RandomValue() * 0.1 + 1.5),
+                            (bakge::Scalar)(RandomValue() * 0.1 + 1.5))
+                * bakge::Matrix::Rotation((bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue())
+                * bakge::Matrix::Translation((bakge::Scalar)RandomValue(),
+                                    (bakge::Scalar)RandomValue(),
+                                    (bakge::Scalar)RandomValue()));
+}
+
+
+void CheckAffine(const char* Name, int Sample, bakge::Affine BGE_NCP Result,
+                                                bakge::Matrix BGE_NCP M)
+{
+    double Expected[16];
+
+    for(int i = 0; i < 16; ++i)
+        Expected[i] = M[i];
+
+    Check(Name, Sample, Result.ToMatrix(), Expected);
+}
+
+
+void TestAffine()
+{
+    for(int s = 0; s < NUM_SAMPLES; ++s) {
+        bakge::Affine A = RandomAffine();
+        bakge::Affine B = RandomAffine();
+        bakge::Matrix MA = A.ToMatrix();
+        bakge::Matrix MB = B.ToMatrix();
+
+        CheckAffine("Affine FromMatrix", s,
+                            bakge::Affine::FromMatrix(MA), MA);
+        CheckAffine("Affine compose", s, A * B, MA * MB);
+        CheckAffine("Affine Inverted", s, A.Inverted(), MA.AffineInverted());
+
+        bakge::Vector4 P((bakge::Scalar)RandomValue(),
+                        (bakge::Scalar)RandomValue(),
+                        (bakge::Scalar)RandomValue(), 7);
+        bakge::Vector4 TP = A.TransformPoint(P);
+        bakge::Vector4 TV = A.TransformVector(P);
+        bakge::Vector4 EP = MA * bakge::Vector4(P[0], P[1], P[2], 1);
+        bakge::Vector4 EV = MA * bakge::Vector4(P[0], P[1], P[2], 0);
+
+        for(int c = 0; c < 4; ++c) {
+            CheckScalar("Affine TransformPoint", s, TP[c], EP[c]);
+            CheckScalar("Affine TransformVector", s, TV[c], EV[c]);
+        }
+
+        /* Rigid inverse and decomposition round trips */
+        bakge::Quaternion Q = bakge::Quaternion::FromEulerAngles(
+                                    (bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue(),
+                                    (bakge::Radians)RandomValue());
+        bakge::Vector4 T((bakge::Scalar)RandomValue(),
+                        (bakge::Scalar)RandomValue(),
+                        (bakge::Scalar)RandomValue(), 1);
+        bakge::Vector4 S((bakge::Scalar)(RandomValue() * 0.1 + 1.5),
+                        (bakge::Scalar)(RandomValue() * 0.1 + 1.5),
+                        (bakge::Scalar)(RandomValue() * 0.1 + 1.5), 0);
+
+        bakge::Affine R = bakge::Affine::FromTransform(T, Q,
+                                        bakge::Vector4(1, 1, 1, 0));
+        CheckAffine("Affine RigidInverted", s, R.RigidInverted(),
+                                        R.ToMatrix().AffineInverted());
+
+        bakge::Affine C = bakge::Affine::FromTransform(T, Q, S);
+        bakge::Matrix MC = bakge::Matrix::Scaling(S[0], S[1], S[2])
+                            * Q.ToMatrix()
+                            * bakge::Matrix::Translation(T[0], T[1], T[2]);
+        CheckAffine("Affine FromTransform", s, C, MC);
+        CheckAffine("Affine decompose", s, bakge::Affine::FromTransform(
+                C.GetTranslation(), C.GetRotation(), C.GetScale()), MC);
+    }
+}
+
+
+/* Reference slerp or nlerp of quaternion i of two SoA arrays in doubles */
+void ReferenceInterpolate(const bakge::Scalar* From, const bakge::Scalar* To,
+                    bakge::Scalar T, int i, bool Spherical, double* Out)
+{
+    double A[4], B[4], Dot = 0;
+
+    for(int c = 0; c < 4; ++c) {
+        A[c] = From[c * BATCH_SIZE + i];
+        B[c] = To[c * BATCH_SIZE + i];
+        Dot += A[c] * B[c];
+    }
+
+    double Sign = Dot < 0 ? -1 : 1;
+    double WA = 1 - T, WB = T;
+    Dot *= Sign;
+
+    if(Spherical && Dot < 0.9999) {
+        double Theta = acos(Dot);
+        WA = sin((1 - T) * Theta) / sin(Theta);
+        WB = sin(T * Theta) / sin(Theta);
+    }
+
+    double Len = 0;
+    for(int c = 0; c < 4; ++c) {
+        Out[c] = WA * A[c] + WB * Sign * B[c];
+        Len += Out[c] * Out[c];
+    }
+
+    if(!Spherical) {
+        for(int c = 0; c < 4; ++c)
+            Out[c] /= sqrt(Len);
+    }
+}
+
+
+void TestQuaternionBatch()
+{
+    bakge::Scalar A[BATCH_SIZE * 4], B[BATCH_SIZE * 4];
+    bakge::Scalar Out[BATCH_SIZE * 4], T[BATCH_SIZE];
+    bakge::Scalar Rotations[BATCH_SIZE * 9];
+    bakge::Matrix* Matrices = new bakge::Matrix[BATCH_SIZE];
+
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        for(int c = 0; c < 4; ++c) {
+            A[c * BATCH_SIZE + i] = (bakge::Scalar)RandomValue();
+            B[c * BATCH_SIZE + i] = (bakge::Scalar)RandomValue();
+        }
+
+        T[i] = (bakge::Scalar)(RandomValue() * 0.05 + 0.5);
+    }
+
+    /* Nearly equal and nearly opposite pairs hit the small angle paths */
+    for(int c = 0; c < 4; ++c) {
+        B[c * BATCH_SIZE] = A[c * BATCH_SIZE] * 1.001f;
+        B[c * BATCH_SIZE + 1] = -A[c * BATCH_SIZE + 1];
+    }
+
+    bakge::NormalizeQuaternionsSoA(A, BATCH_SIZE);
+    bakge::NormalizeQuaternionsSoA(B, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Scalar Len = 0;
+        for(int c = 0; c < 4; ++c)
+            Len += A[c * BATCH_SIZE + i] * A[c * BATCH_SIZE + i];
+
+        CheckScalar("NormalizeQuaternionsSoA", i, Len, 1);
+    }
+
+    bakge::QuaternionsToMatricesSoA(A, Matrices, BATCH_SIZE);
+    bakge::QuaternionsToRotationsSoA(A, Rotations, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Matrix Expected = bakge::Quaternion(A[i],
+                    A[BATCH_SIZE + i], A[BATCH_SIZE * 2 + i],
+                    A[BATCH_SIZE * 3 + i]).ToMatrix();
+
+        for(int e = 0; e < 16; ++e)
+            CheckScalar("QuaternionsToMatricesSoA", i, Matrices[i][e],
+                                                            Expected[e]);
+
+        for(int c = 0; c < 3; ++c) {
+            for(int r = 0; r < 3; ++r) {
+                CheckScalar("QuaternionsToRotationsSoA", i,
+                    Rotations[(c * 3 + r) * BATCH_SIZE + i],
+                    Expected[c * 4 + r]);
+            }
+        }
+    }
+
+    bakge::MultiplyQuaternionsSoA(A, B, Out, BATCH_SIZE);
+    bakge::QuaternionsToMatricesSoA(Out, Matrices, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        bakge::Quaternion QA(A[i], A[BATCH_SIZE + i],
+                    A[BATCH_SIZE * 2 + i], A[BATCH_SIZE * 3 + i]);
+        bakge::Quaternion QB(B[i], B[BATCH_SIZE + i],
+                    B[BATCH_SIZE * 2 + i], B[BATCH_SIZE * 3 + i]);
+        bakge::Matrix Expected = (QA * QB).ToMatrix();
+
+        for(int e = 0; e < 16; ++e)
+            CheckScalar("MultiplyQuaternionsSoA", i, Matrices[i][e],
+                                                            Expected[e]);
+    }
+
+    bakge::SlerpQuaternionsSoA(A, B, T, Out, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        double Expected[4];
+        ReferenceInterpolate(A, B, T[i], i, true, Expected);
+
+        for(int c = 0; c < 4; ++c)
+            CheckScalar("SlerpQuaternionsSoA", i, Out[c * BATCH_SIZE + i],
+                                                    (float)Expected[c]);
+    }
+
+    bakge::NlerpQuaternionsSoA(A, B, T, Out, BATCH_SIZE);
+    for(int i = 0; i < BATCH_SIZE; ++i) {
+        double Expected[4];
+        ReferenceInterpolate(A, B, T[i], i, false, Expected);
+
+        for(int c = 0; c < 4; ++c)
+            CheckScalar("NlerpQuaternionsSoA", i, Out[c * BATCH_SIZE + i],
+                                                    (float)Expected[c]);
+    }
+
+    delete[] Matrices;
+}
+
+
+int main(int argc, char* argv[])
+{
+    /* Run every test with each set of math kernels this machine supports */
+    for(int i = 0; i < bakge::NUM_MATH_ISAS; ++i) {
+        bakge::MATH_ISA ISA = (bakge::MATH_ISA)i;
+
+        if(!bakge::IsMathISASupported(ISA))
+            continue;
+
+        bakge::SetMathISA(ISA);
+        printf("test/matrix: Testing %s kernels\n",
+                        bakge::GetMathISAName(ISA));
+
+        srand(1234);
+
+        TestGeneralInverse();
+        TestAffineInverse();
+        TestRigidInverse();
+        TestSingular();
+        TestBatch();
+        TestAffine();
+        TestQuaternionBatch();
+    }
+
+    if(Failures > 0) {
+        printf("test/matrix: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/matrix: All tests passed\n");
+
+    return 0;
+}
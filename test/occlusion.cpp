@@ -0,0 +1,188 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bakge/Bakge.h>
+
+#define BUFFER_WIDTH 256
+#define BUFFER_HEIGHT 128
+#define NUM_THREADS 4
+
+int Failures = 0;
+
+
+void Check(const char* Name, bool Result, bool Expected)
+{
+    if(Result != Expected) {
+        printf("test/occlusion: %s failed: got %s, expected %s\n", Name,
+                                    Result ? "visible" : "hidden",
+                                    Expected ? "visible" : "hidden");
+        ++Failures;
+    }
+}
+
+
+/* Camera at (0, 0, 10) looking at the origin, as Camera3D sets it up */
+bakge::Matrix TestViewProjection()
+{
+    bakge::Matrix Proj, View;
+
+    Proj.SetPerspective(60.0f, 2.0f, 1.0f, 100.0f);
+    View.SetLookAt(bakge::Vector4::Point(0, 0, 10),
+                bakge::Vector4::Point(0, 0, 0),
+                bakge::Vector4::Vector(0, 1, 0));
+
+    return View * Proj;
+}
+
+
+bakge::AABB Box(bakge::Scalar X, bakge::Scalar Y, bakge::Scalar Z,
+                                            bakge::Scalar HalfSize)
+{
+    return bakge::AABB::FromCenterAndExtents(bakge::Vector4::Point(X, Y, Z),
+                        bakge::Vector4::Vector(HalfSize, HalfSize, HalfSize));
+}
+
+
+/* A 10x10 wall in the XY plane, facing the camera */
+const bakge::Scalar WallPositions[] = {
+    -5, -5, 0,
+     5, -5, 0,
+     5,  5, 0,
+    -5,  5, 0,
+};
+
+const int WallIndices[] = {
+    0, 1, 2,
+    0, 2, 3,
+};
+
+
+void TestScene(bakge::OcclusionCuller* C, int NumThreads)
+{
+    C->ClearOccluders();
+    C->AddOccluder(4, WallPositions, 2, WallIndices,
+                            bakge::Affine::Identity);
+    C->Render(TestViewProjection(), NumThreads);
+
+    Check("Box in front of the wall", C->IsVisible(Box(0, 0, 5, 1)), true);
+    Check("Box behind the wall", C->IsVisible(Box(0, 0, -5, 1)), false);
+    Check("Box behind the wall's corner",
+                        C->IsVisible(Box(3, 3, -5, 1)), false);
+    Check("Box beside the wall", C->IsVisible(Box(12, 0, -5, 1)), true);
+    Check("Box larger than the wall",
+                        C->IsVisible(Box(0, 0, -10, 8)), true);
+    Check("Box through the wall", C->IsVisible(Box(0, 0, 0, 1)), true);
+    Check("Box around the camera", C->IsVisible(Box(0, 0, 10, 1)), true);
+
+    /* Same boxes through the SoA path */
+    bakge::Scalar Boxes[6 * 3] = {
+        0, 0, 12,
+        0, 0, 0,
+        5, -5, -5,
+        1, 1, 1,
+        1, 1, 1,
+        1, 1, 1,
+    };
+    bakge::uint32 Visible = 0x7;
+
+    int Hidden = C->TestBoxesSoA(Boxes, 3, &Visible);
+    if(Hidden != 1 || Visible != 0x5) {
+        printf("test/occlusion: TestBoxesSoA failed: %d hidden, mask "
+                                            "%x\n", Hidden, Visible);
+        ++Failures;
+    }
+
+    /* Moving the wall out of the way uncovers the box */
+    C->ClearOccluders();
+    C->AddOccluder(4, WallPositions, 2, WallIndices,
+            bakge::Affine::FromTransform(bakge::Vector4::Point(30, 0, 0),
+                        bakge::Quaternion::Identity,
+                        bakge::Vector4::Vector(1, 1, 1)));
+    C->Render(TestViewProjection(), NumThreads);
+
+    Check("Box behind the moved wall", C->IsVisible(Box(0, 0, -5, 1)),
+                                                                    true);
+
+    /* *
+     * Widen the wall so its right edge lands three quarters into a pixel.
+     * A box a fraction of a pixel across showing past it in that pixel
+     * must stay visible, while one in the pixel before is hidden
+     * */
+    C->ClearOccluders();
+    C->AddOccluder(4, WallPositions, 2, WallIndices,
+            bakge::Affine::FromTransform(bakge::Vector4::Point(0, 0, 0),
+                        bakge::Quaternion::Identity,
+                        bakge::Vector4::Vector(1.00588f, 1, 1)));
+    C->Render(TestViewProjection(), NumThreads);
+
+    Check("Box just past the wall's edge",
+                        C->IsVisible(Box(7.545f, 0, -5, 0.02f)), true);
+    Check("Box just inside the wall's edge",
+                        C->IsVisible(Box(7.375f, 0, -5, 0.02f)), false);
+}
+
+
+int main(int argc, char* argv[])
+{
+    bakge::OcclusionCuller* C = bakge::OcclusionCuller::Create(BUFFER_WIDTH,
+                                                            BUFFER_HEIGHT);
+    if(C == NULL) {
+        printf("test/occlusion: Couldn't create OcclusionCuller\n");
+        return 1;
+    }
+
+    printf("test/occlusion: Testing on one thread\n");
+    TestScene(C, 1);
+
+    printf("test/occlusion: Testing on %d threads\n", NUM_THREADS);
+    TestScene(C, NUM_THREADS);
+
+    /* Results must not depend on how rows are split between threads */
+    int Size = C->GetWidth() * C->GetHeight();
+    bakge::Scalar* Single = new bakge::Scalar[Size];
+
+    C->Render(TestViewProjection(), 1);
+    memcpy(Single, C->GetDepthBuffer(), sizeof(bakge::Scalar) * Size);
+    C->Render(TestViewProjection(), NUM_THREADS);
+
+    if(memcmp(Single, C->GetDepthBuffer(), sizeof(bakge::Scalar) * Size)) {
+        printf("test/occlusion: Threaded depth buffer differs\n");
+        ++Failures;
+    }
+
+    delete[] Single;
+    delete C;
+
+    if(Failures > 0) {
+        printf("test/occlusion: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/occlusion: All tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,445 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <bakge/Bakge.h>
+
+#define NUM_SORTED 300
+#define SORTED_LAYERS 40
+#define TRACE_SIZE 2048
+
+int Failures = 0;
+
+/* Every bind and draw replayed from a CommandList, in order */
+char Calls[TRACE_SIZE];
+char Draws[TRACE_SIZE];
+
+
+void Trace(char* Log, const char* Call, const char* Name, int Count)
+{
+    char Entry[64];
+
+    if(Count > 0)
+        sprintf(Entry, "%s(%s,%d) ", Call, Name, Count);
+    else
+        sprintf(Entry, "%s(%s) ", Call, Name);
+
+    if(strlen(Log) + strlen(Entry) < TRACE_SIZE)
+        strcat(Log, Entry);
+}
+
+
+void ClearTrace()
+{
+    Calls[0] = 0;
+    Draws[0] = 0;
+}
+
+
+/* *
+ * Stand-ins for the objects the Renderer binds. They trace their binds
+ * and draws instead of making OpenGL calls, so nothing needs a context
+ * */
+class TestShader : public bakge::Shader
+{
+
+public:
+
+    const char* Name;
+
+    bakge::Result Bind() const
+    {
+        Trace(Calls, "P", Name, 0);
+        return BGE_SUCCESS;
+    }
+
+    bakge::Result Unbind() const
+    {
+        Trace(Calls, "p", Name, 0);
+        return BGE_SUCCESS;
+    }
+};
+
+
+class TestTexture : public bakge::Texture
+{
+
+public:
+
+    const char* Name;
+
+    bakge::Result Bind() const
+    {
+        Trace(Calls, "T", Name, 0);
+        return BGE_SUCCESS;
+    }
+
+    bakge::Result Unbind() const
+    {
+        Trace(Calls, "t", Name, 0);
+        return BGE_SUCCESS;
+    }
+};
+
+
+class TestMesh : public bakge::Mesh
+{
+
+public:
+
+    const char* Name;
+
+    TestMesh()
+    {
+        /* A unit cube around the origin, as if positions were set */
+        Bounds = bakge::AABB::FromCenterAndExtents(
+                                bakge::Vector4::Point(0, 0, 0),
+                                bakge::Vector4::Vector(1, 1, 1));
+    }
+
+    bakge::Result Bind() const
+    {
+        Trace(Calls, "M", Name, 0);
+        return BGE_SUCCESS;
+    }
+
+    bakge::Result Unbind() const
+    {
+        Trace(Calls, "m", Name, 0);
+        return BGE_SUCCESS;
+    }
+
+    bakge::Result Draw() const
+    {
+        Trace(Calls, "D", Name, 0);
+        Trace(Draws, "D", Name, 0);
+        return BGE_SUCCESS;
+    }
+
+    bakge::Result DrawInstanced(int Count) const
+    {
+        Trace(Calls, "I", Name, Count);
+        Trace(Draws, "I", Name, Count);
+        return BGE_SUCCESS;
+    }
+};
+
+
+class TestNode;
+
+/* Nodes bound by the Renderer, in order */
+const TestNode* Bound[NUM_SORTED];
+int NumBound = 0;
+
+
+class TestNode : public bakge::Node
+{
+
+public:
+
+    const char* Name;
+    int Layer;
+
+    /* Instances to draw; 0 for a node with a single model transform */
+    int Members;
+
+    TestNode()
+    {
+        Name = "";
+        Layer = 0;
+        Members = 0;
+    }
+
+    bakge::Result GetModelTransform(bakge::Affine* Model) const
+    {
+        /* Like a Crowd, nodes with members must be bound to draw */
+        if(Members > 0)
+            return BGE_FAILURE;
+
+        return bakge::Node::GetModelTransform(Model);
+    }
+
+    int GetNumInstances() const
+    {
+        return Members > 0 ? Members : 1;
+    }
+
+    bakge::Result Bind() const
+    {
+        Trace(Calls, "N", Name, 0);
+
+        if(NumBound < NUM_SORTED)
+            Bound[NumBound++] = this;
+
+        return BGE_SUCCESS;
+    }
+
+    bakge::Result Unbind() const
+    {
+        Trace(Calls, "n", Name, 0);
+        return BGE_SUCCESS;
+    }
+};
+
+
+TestShader ProgramA, ProgramB;
+TestTexture TextureX;
+TestMesh Mesh1, Mesh2, Mesh3;
+TestNode Nodes[6], Group;
+TestNode Sorted[NUM_SORTED];
+
+
+void CheckCount(const char* Name, int Result, int Expected)
+{
+    if(Result != Expected) {
+        printf("test/renderer: %s is %d, expected %d\n", Name, Result,
+                                                            Expected);
+        ++Failures;
+    }
+}
+
+
+void CheckTrace(const char* Name, const char* Result, const char* Expected)
+{
+    if(strcmp(Result, Expected) != 0) {
+        printf("test/renderer: %s failed\n  got:      %s\n  expected: %s\n",
+                                                Name, Result, Expected);
+        ++Failures;
+    }
+}
+
+
+/* Camera at (0, 0, 10) looking at the origin, as Camera3D sets it up */
+void SetTestCamera()
+{
+    bakge::Matrix Proj, View;
+
+    Proj.SetPerspective(60.0f, 2.0f, 1.0f, 100.0f);
+    View.SetLookAt(bakge::Vector4::Point(0, 0, 10),
+                bakge::Vector4::Point(0, 0, 0),
+                bakge::Vector4::Vector(0, 1, 0));
+
+    bakge::FrameUniforms::SetCamera(Proj, View,
+                                    bakge::Vector4::Point(0, 0, 10));
+}
+
+
+/* Submitted out of order; layers must still come out in order */
+void SubmitScene(bakge::Renderer* R)
+{
+    R->Submit(2, &ProgramB, NULL, &Mesh2, &Group);
+    R->Submit(0, &ProgramA, &TextureX, &Mesh1, &Nodes[0]);
+    R->Submit(1, &ProgramA, &TextureX, &Mesh2, &Nodes[3]);
+    R->Submit(0, &ProgramA, &TextureX, &Mesh1, &Nodes[4]);
+    R->Submit(0, &ProgramA, &TextureX, &Mesh1, &Nodes[1]);
+    R->Submit(2, &ProgramB, NULL, &Mesh2, NULL);
+    R->Submit(0, &ProgramA, &TextureX, &Mesh1, &Nodes[5]);
+    R->Submit(0, &ProgramA, &TextureX, &Mesh1, &Nodes[2]);
+}
+
+
+/* *
+ * Layer 0 draws Mesh1 three times in one instanced draw; two more are
+ * behind the camera and off to its side. Layer 1 keeps the program and
+ * texture but changes mesh. Layer 2 changes program and drops the
+ * texture, drawing without a model, then the group with its members
+ * */
+const char* SceneCalls =
+    "P(A) T(X) M(M1) I(M1,3) "
+    "m(M1) M(M2) D(M2) "
+    "n(N3) m(M2) P(B) t(X) M(M2) D(M2) N(G) I(M2,7) "
+    "n(G) m(M2) p(B) ";
+
+
+void TestScene(bakge::Renderer* R)
+{
+    bakge::CommandList* List = bakge::CommandList::Create(0);
+
+    SubmitScene(R);
+    CheckCount("Queued items", R->GetNumItems(), 8);
+
+    ClearTrace();
+    if(R->Record(List) == BGE_FAILURE) {
+        printf("test/renderer: Record failed\n");
+        ++Failures;
+    }
+
+    CheckCount("Items after Record", R->GetNumItems(), 0);
+    CheckCount("Visible draws", R->GetNumVisible(), 6);
+    CheckCount("Culled draws", R->GetNumCulled(), 2);
+    CheckCount("Draw calls", R->GetNumDraws(), 4);
+    CheckCount("Instanced draws", R->GetNumInstanced(), 3);
+    CheckCount("Binds", R->GetNumBinds(), 7);
+
+    /* Every call traced, plus setting the models of the two runs */
+    CheckCount("Recorded commands", List->GetNumCommands(), 18 + 2);
+
+    /* *
+     * Without a context there's no InstanceBuffer to set models in, so
+     * the replay reports failure; every bind and draw is still issued
+     * */
+    List->Execute();
+    CheckTrace("Recorded scene", Calls, SceneCalls);
+
+    /* Flush must issue the same calls */
+    SubmitScene(R);
+    ClearTrace();
+    R->Flush();
+    CheckTrace("Flushed scene", Calls, SceneCalls);
+
+    /* Without culling the hidden draws join the instanced run */
+    R->SetCulling(false);
+    SubmitScene(R);
+    ClearTrace();
+    R->Flush();
+    R->SetCulling(true);
+
+    CheckCount("Culled draws without culling", R->GetNumCulled(), 0);
+    CheckCount("Instanced draws without culling", R->GetNumInstanced(), 5);
+    CheckTrace("Draws without culling", Draws,
+                            "I(M1,5) D(M2) D(M2) I(M2,7) ");
+
+    delete List;
+}
+
+
+void TestBackToFront(bakge::Renderer* R)
+{
+    /* Mid, near and far from the camera */
+    Nodes[0].SetPosition(0, 0, 0);
+    Nodes[1].SetPosition(0, 0, 3);
+    Nodes[2].SetPosition(0, 0, -5);
+
+    R->SetBackToFront(3, true);
+    R->Submit(3, &ProgramA, &TextureX, &Mesh1, &Nodes[0]);
+    R->Submit(3, &ProgramA, &TextureX, &Mesh3, &Nodes[1]);
+    R->Submit(3, &ProgramA, &TextureX, &Mesh2, &Nodes[2]);
+
+    ClearTrace();
+    R->Flush();
+    R->SetBackToFront(3, false);
+
+    CheckTrace("Back to front draws", Draws, "D(M2) D(M1) D(M3) ");
+
+    Nodes[1].SetPosition(2, 0, 0);
+    Nodes[2].SetPosition(-2, 0, 0);
+}
+
+
+/* Many draws over many layers and depths, to exercise every sort pass */
+void TestSort(bakge::Renderer* R)
+{
+    srand(1);
+
+    for(int i=0;i<NUM_SORTED;++i) {
+        Sorted[i].Name = "S";
+        Sorted[i].Layer = rand() % SORTED_LAYERS;
+        Sorted[i].Members = 1;
+        Sorted[i].SetPosition(0, 0, (bakge::Scalar)(rand() % 25 - 20));
+
+        R->Submit(Sorted[i].Layer, &ProgramA, &TextureX, &Mesh1,
+                                                        &Sorted[i]);
+    }
+
+    NumBound = 0;
+    ClearTrace();
+    R->Flush();
+
+    CheckCount("Sorted draws", NumBound, NUM_SORTED);
+
+    for(int i=1;i<NumBound;++i) {
+        const TestNode* Last = Bound[i - 1];
+        const TestNode* Node = Bound[i];
+
+        /* Layers in order; front to back within a layer */
+        if(Node->Layer < Last->Layer || (Node->Layer == Last->Layer
+                    && Node->GetPosition()[2] > Last->GetPosition()[2])) {
+            printf("test/renderer: Draw %d out of order\n", i);
+            ++Failures;
+            break;
+        }
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    ProgramA.Name = "A";
+    ProgramB.Name = "B";
+    TextureX.Name = "X";
+    Mesh1.Name = "M1";
+    Mesh2.Name = "M2";
+    Mesh3.Name = "M3";
+
+    const char* NodeNames[] = { "N0", "N1", "N2", "N3", "N4", "N5" };
+    for(int i=0;i<6;++i)
+        Nodes[i].Name = NodeNames[i];
+
+    Nodes[0].SetPosition(0, 0, 0);
+    Nodes[1].SetPosition(2, 0, 0);
+    Nodes[2].SetPosition(-2, 0, 0);
+    Nodes[3].SetPosition(0, 2, 0);
+    Nodes[4].SetPosition(0, 0, 50);
+    Nodes[5].SetPosition(100, 0, 0);
+
+    Group.Name = "G";
+    Group.Members = 7;
+
+    SetTestCamera();
+
+    bakge::Renderer* R = bakge::Renderer::Create(4);
+    if(R == NULL) {
+        printf("test/renderer: Couldn't create Renderer\n");
+        return 1;
+    }
+
+    printf("test/renderer: Testing a recorded scene\n");
+    TestScene(R);
+
+    printf("test/renderer: Testing back to front layers\n");
+    TestBackToFront(R);
+
+    printf("test/renderer: Testing sort order\n");
+    TestSort(R);
+
+    if(R->Submit(BGE_RENDER_LAYERS, &ProgramA, NULL, &Mesh1, NULL)
+                                                        == BGE_SUCCESS
+            || R->Submit(0, NULL, NULL, &Mesh1, NULL) == BGE_SUCCESS) {
+        printf("test/renderer: Submit accepted an invalid draw\n");
+        ++Failures;
+    }
+
+    delete R;
+
+    if(Failures > 0) {
+        printf("test/renderer: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/renderer: All tests passed\n");
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+/* *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2013 Paul Holden et al. (See AUTHORS)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <bakge/Bakge.h>
+
+#define NUM_NODES 500
+#define NUM_THREADS 4
+
+int Failures = 0;
+
+
+bakge::Scalar RandomValue(double Range)
+{
+    return (bakge::Scalar)(((double)rand() / RAND_MAX) * 2 * Range - Range);
+}
+
+
+bakge::Affine RandomTransform()
+{
+    return bakge::Affine::FromTransform(
+                bakge::Vector4::Point(RandomValue(10), RandomValue(10),
+                                                    RandomValue(10)),
+                bakge::Quaternion::FromEulerAngles(RandomValue(3),
+                                    RandomValue(3), RandomValue(3)),
+                bakge::Vector4::Vector(1 + RandomValue(0.5),
+                        1 + RandomValue(0.5), 1 + RandomValue(0.5)));
+}
+
+
+/* World transform composed by walking up the parents */
+bakge::Affine ExpectedWorld(const bakge::SceneGraph* G, int Handle)
+{
+    int Parent = G->GetParent(Handle);
+    if(Parent < 0)
+        return G->GetLocal(Handle);
+
+    return G->GetLocal(Handle) * ExpectedWorld(G, Parent);
+}
+
+
+void CheckWorlds(const char* Name, const bakge::SceneGraph* G,
+                                const int* Handles, const bool* Alive)
+{
+    for(int i = 0; i < NUM_NODES; ++i) {
+        if(!Alive[i])
+            continue;
+
+        bakge::Affine Expected = ExpectedWorld(G, Handles[i]);
+        bakge::Affine BGE_NCP World = G->GetWorld(Handles[i]);
+
+        for(int j = 0; j < 12; ++j) {
+            double Error = fabs(World[j] - Expected[j]);
+            double Scale = fabs(Expected[j]) > 1 ? fabs(Expected[j]) : 1;
+            if(Error / Scale > 1e-4) {
+                printf("test/scenegraph: %s failed on node %d: got %f, "
+                        "expected %f\n", Name, i, World[j], Expected[j]);
+                ++Failures;
+                break;
+            }
+        }
+    }
+}
+
+
+void TestSceneGraph(int NumThreads)
+{
+    int Handles[NUM_NODES];
+    bool Alive[NUM_NODES];
+
+    /* Start small so the graph has to grow */
+    bakge::SceneGraph* G = bakge::SceneGraph::Create(4);
+
+    /* Random forest; parents are picked from nodes already added */
+    for(int i = 0; i < NUM_NODES; ++i) {
+        int Parent = -1;
+        if(i > 0 && rand() % 8 != 0)
+            Parent = Handles[rand() % i];
+
+        Handles[i] = G->AddNode(Parent, RandomTransform());
+        Alive[i] = true;
+    }
+
+    G->Update(NumThreads);
+    CheckWorlds("Update after AddNode", G, Handles, Alive);
+
+    /* Change a few nodes; only their subtrees should be recomputed */
+    for(int i = 0; i < NUM_NODES / 10; ++i)
+        G->SetLocal(Handles[rand() % NUM_NODES], RandomTransform());
+
+    G->Update(NumThreads);
+    CheckWorlds("Update after SetLocal", G, Handles, Alive);
+
+    /* Remove a few subtrees */
+    for(int i = 0; i < 5; ++i) {
+        int Victim = rand() % NUM_NODES;
+        if(!Alive[Victim])
+            continue;
+
+        G->RemoveNode(Handles[Victim]);
+
+        /* Removed nodes' handles become invalid */
+        for(int j = 0; j < NUM_NODES; ++j)
+            Alive[j] = Alive[j] && G->IsValid(Handles[j]);
+    }
+
+    int Count = 0;
+    for(int i = 0; i < NUM_NODES; ++i)
+        Count += Alive[i] ? 1 : 0;
+
+    if(Count != G->GetNumNodes()) {
+        printf("test/scenegraph: RemoveNode left %d nodes, expected %d\n",
+                                                G->GetNumNodes(), Count);
+        ++Failures;
+    }
+
+    G->Update(NumThreads);
+    CheckWorlds("Update after RemoveNode", G, Handles, Alive);
+
+    /* Removed and out of range handles read the identity transform */
+    for(int i = 0; i < NUM_NODES + 2; ++i) {
+        int Handle = i < NUM_NODES ? Handles[i] : (i == NUM_NODES ? -1
+                                                        : NUM_NODES * 4);
+        if(i < NUM_NODES && Alive[i])
+            continue;
+
+        if(&G->GetLocal(Handle) != &bakge::Affine::Identity
+                || &G->GetWorld(Handle) != &bakge::Affine::Identity) {
+            printf("test/scenegraph: Invalid handle %d read a node\n",
+                                                                Handle);
+            ++Failures;
+        }
+    }
+
+    delete G;
+}
+
+
+/* Add a node whose local transform is a reference into the graph */
+void TestAddFromReference(int Reserve)
+{
+    bakge::SceneGraph* G = bakge::SceneGraph::Create(Reserve);
+
+    int Root = G->AddNode(-1, RandomTransform());
+    int First = G->AddNode(Root, RandomTransform());
+    G->AddNode(Root, RandomTransform());
+    int Last = G->AddNode(Root, RandomTransform());
+    bakge::Affine Expected = G->GetLocal(Last);
+
+    /* Goes right after First, moving its siblings along */
+    int Added = G->AddNode(First, G->GetLocal(Last));
+
+    bakge::Affine BGE_NCP Local = G->GetLocal(Added);
+    for(int i = 0; i < 12; ++i) {
+        if(Local[i] != Expected[i]) {
+            printf("test/scenegraph: AddNode from a sibling's transform "
+                        "got %f, expected %f\n", Local[i], Expected[i]);
+            ++Failures;
+            break;
+        }
+    }
+
+    delete G;
+}
+
+
+int main(int argc, char* argv[])
+{
+    srand(1234);
+
+    printf("test/scenegraph: Testing serial updates\n");
+    TestSceneGraph(1);
+
+    printf("test/scenegraph: Testing parallel updates\n");
+    TestSceneGraph(NUM_THREADS);
+
+    printf("test/scenegraph: Testing AddNode from a reference\n");
+    TestAddFromReference(16);
+
+    /* Full after four nodes, so the graph grows as well */
+    TestAddFromReference(4);
+
+    if(Failures > 0) {
+        printf("test/scenegraph: %d failures\n", Failures);
+        return 1;
+    }
+
+    printf("test/scenegraph: All tests passed\n");
+
+    return 0;
+}